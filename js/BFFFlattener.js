@@ -6,9 +6,14 @@
  * 2. 纯JS模式：WASM不可用时的备选方案
  */
 
+import { UVPacker } from './UVPacker.js';
+import { PatternExporter } from './PatternExporter.js';
+import { encodeBatch, decodeBatchResult, batchOptionsToNative } from './BatchCodec.js';
+
 export class BFFFlattener {
     constructor() {
         this.wasmModule = null;
+        this.handle = -1;          // WASM展开器句柄
         this.isWasmReady = false;
         this.useWasm = false;
         
@@ -19,6 +24,21 @@ export class BFFFlattener {
         this.uvResult = null;
     }
     
+    /**
+     * 浏览器是否支持WASM SIMD（决定加载 bff_wasm.js 还是 bff_wasm_scalar.js）
+     */
+    static supportsWasmSimd() {
+        try {
+            // 只含一条 i8x16.splat 指令的最小模块
+            return WebAssembly.validate(new Uint8Array([
+                0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3,
+                2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+            ]));
+        } catch (e) {
+            return false;
+        }
+    }
+    
     /**
      * 初始化（尝试加载WASM模块）
      */
@@ -27,7 +47,7 @@ export class BFFFlattener {
             // 尝试动态导入WASM模块
             if (typeof BFFModule !== 'undefined') {
                 this.wasmModule = await BFFModule();
-                this.wasmModule.init();
+                this.handle = this.wasmModule.createFlattener();
                 this.isWasmReady = true;
                 this.useWasm = true;
                 console.log('BFF: 使用WASM加速模式');
@@ -49,28 +69,80 @@ export class BFFFlattener {
      */
     setMesh(vertices, faces) {
         if (this.useWasm && this.wasmModule) {
-            // 转换为扁平数组
-            const flatVerts = new Float64Array(vertices.length * 3);
+            // 直接写入WASM内存中的缓冲区，避免逐元素跨边界调用
+            // 每个视图取得后立即填充：后续分配可能使之前的视图失效
+            const vertView = this.wasmModule.getVertexUploadView(this.handle, vertices.length);
             for (let i = 0; i < vertices.length; i++) {
-                flatVerts[i * 3] = vertices[i].x;
-                flatVerts[i * 3 + 1] = vertices[i].y;
-                flatVerts[i * 3 + 2] = vertices[i].z;
+                vertView[i * 3] = vertices[i].x;
+                vertView[i * 3 + 1] = vertices[i].y;
+                vertView[i * 3 + 2] = vertices[i].z;
             }
             
-            const flatFaces = new Int32Array(faces.length * 3);
+            const faceView = this.wasmModule.getFaceUploadView(this.handle, faces.length);
             for (let i = 0; i < faces.length; i++) {
-                flatFaces[i * 3] = faces[i][0];
-                flatFaces[i * 3 + 1] = faces[i][1];
-                flatFaces[i * 3 + 2] = faces[i][2];
+                faceView[i * 3] = faces[i][0];
+                faceView[i * 3 + 1] = faces[i][1];
+                faceView[i * 3 + 2] = faces[i][2];
             }
             
-            this.wasmModule.setMesh(flatVerts, flatFaces);
+            if (!this.wasmModule.commitMesh(this.handle)) {
+                throw new Error(this.wasmModule.getError(this.handle));
+            }
         } else {
             this.vertices = vertices;
             this.faces = faces;
         }
     }
     
+    /**
+     * 设置上传网格时的重排方式（仅WASM模式），下次setMesh生效
+     * 扫描网格索引局部性差时，按RCM或Morton曲线重排内部存储可提高后续各步的缓存命中；
+     * 缝线、固定点、UV和展开结果仍按传入的顶点和面编号
+     * @param {string} ordering - 'original' | 'rcm' | 'morton'
+     */
+    setMeshOrdering(ordering) {
+        if (this.useWasm && this.wasmModule) {
+            const mode = { original: 0, rcm: 1, morton: 2 }[ordering];
+            if (mode === undefined) throw new Error(`Unknown mesh ordering: ${ordering}`);
+            this.wasmModule.setMeshOrdering(this.handle, mode);
+        }
+    }
+    
+    /**
+     * 设置上传网格时的拓扑修复（仅WASM模式），下次setMesh生效
+     * 修复后的网格即此后使用的编号（缝线、固定点、展开结果），与上传编号的对应见 getRepairResult
+     * @param {Object} options - { weldTolerance: >0 时焊接顶点并删除退化面, splitNonManifold: 拆分非流形顶点 }
+     */
+    setRepairOptions(options) {
+        if (this.useWasm && this.wasmModule) {
+            this.wasmModule.setRepairOptions(this.handle, options || {});
+        }
+    }
+    
+    /**
+     * 上一次setMesh的修复结果（仅WASM模式）
+     * @returns {Object|null} { faces: Int32Array（修复后的面）, vertexSource, faceSource（修复后 -> 上传的编号，
+     *                          未启用修复时为空）, inputVertices, inputFaces, weldedVertices, degenerateFaces,
+     *                          splitVertices, boundaryLoops, weldMs, splitMs }
+     */
+    getRepairResult() {
+        if (!this.useWasm || !this.wasmModule) return null;
+        return this.wasmModule.getRepairResult(this.handle);
+    }
+    
+    /**
+     * 沿网格边的最短路径依次连接路标顶点（如排好序的红点），路径上的边加入缝线（仅WASM模式）
+     * @param {Int32Array|Array<number>} path - 路标顶点
+     * @param {boolean} closed - 是否首尾相连
+     * @returns {number} 新增的缝线边数，路标越界时为-1
+     */
+    addSeamPath(path, closed = false) {
+        if (!this.useWasm || !this.wasmModule) {
+            throw new Error('Seam paths require the WASM module');
+        }
+        return this.wasmModule.addSeamPath(this.handle, path, closed);
+    }
+    
     /**
      * 添加缝线边
      * @param {number} v1 - 顶点1索引
@@ -78,24 +150,72 @@ export class BFFFlattener {
      */
     addSeamEdge(v1, v2) {
         if (this.useWasm && this.wasmModule) {
-            this.wasmModule.addSeamEdge(v1, v2);
+            this.wasmModule.addSeamEdge(this.handle, v1, v2);
         } else {
             const key = v1 < v2 ? `${v1}_${v2}` : `${v2}_${v1}`;
             this.seamEdges.add(key);
         }
     }
     
+    /**
+     * 一次替换全部缝线（WASM模式下只有一次调用）
+     * @param {Int32Array|Array<number>} edges - 顶点对 [a0,b0, a1,b1, ...]
+     */
+    setSeamEdges(edges) {
+        if (this.useWasm && this.wasmModule) {
+            this.wasmModule.setSeams(this.handle, edges);
+        } else {
+            this.seamEdges.clear();
+            for (let i = 0; i + 1 < edges.length; i += 2) {
+                const v1 = edges[i], v2 = edges[i + 1];
+                this.seamEdges.add(v1 < v2 ? `${v1}_${v2}` : `${v2}_${v1}`);
+            }
+        }
+    }
+    
     /**
      * 清除缝线
      */
     clearSeams() {
         if (this.useWasm && this.wasmModule) {
-            this.wasmModule.clearSeams();
+            this.wasmModule.clearSeams(this.handle);
         } else {
             this.seamEdges.clear();
         }
     }
     
+    /**
+     * 固定UV顶点位置（仅WASM模式）
+     * 只拖动已有固定点时，重新展开复用缓存的分解，适合跟随鼠标交互
+     * @param {number} uvIndex - UV顶点索引（展开结果uvs的下标）
+     * @param {number} u - 片段归一化坐标
+     * @param {number} v - 片段归一化坐标
+     */
+    setPin(uvIndex, u, v) {
+        if (this.useWasm && this.wasmModule) {
+            this.wasmModule.setPin(this.handle, uvIndex, u, v);
+        }
+    }
+    
+    /**
+     * 取消固定
+     * @param {number} uvIndex - UV顶点索引
+     */
+    removePin(uvIndex) {
+        if (this.useWasm && this.wasmModule) {
+            this.wasmModule.removePin(this.handle, uvIndex);
+        }
+    }
+    
+    /**
+     * 清除所有固定点
+     */
+    clearPins() {
+        if (this.useWasm && this.wasmModule) {
+            this.wasmModule.clearPins(this.handle);
+        }
+    }
+    
     /**
      * 执行展开
      * @param {Function} onProgress - 进度回调
@@ -109,22 +229,88 @@ export class BFFFlattener {
         }
     }
     
+    /**
+     * ARAP展开（仅WASM模式），参数与 ARAPFlattener.flatten(iterations, options) 相同
+     * 在共形展开结果上继续ARAP迭代，全局矩阵按片段预分解并缓存；固定点（setPin）保持不动，
+     * 此时结果不再归一化
+     * @param {number} iterations - ARAP迭代次数
+     * @param {Object} options - boundaryConstraints / smoothBoundary / smoothIterations /
+     *                           boundaryStiffness / internalStiffness /
+     *                           tolerance（相对能量下降低于此值时提前结束，iterations为上限）/
+     *                           initialUV（[{u, v}, ...]，按网格顶点或按结果的UV索引，代替共形结果作为初值；
+     *                           长度与两者都不符时忽略）
+     * @param {Function} onProgress - 进度回调
+     * @returns {Promise<Object>} 展开结果
+     */
+    async flattenARAP(iterations = 10, options = {}, onProgress = null) {
+        if (!this.useWasm || !this.wasmModule) {
+            throw new Error('ARAP mode requires the WASM module');
+        }
+        
+        const initialUV = (options && options.initialUV) || [];
+        const uvArray = new Float64Array(initialUV.length * 2);
+        initialUV.forEach((uv, i) => {
+            uvArray[i * 2] = uv.u;
+            uvArray[i * 2 + 1] = uv.v;
+        });
+        this.wasmModule.setFlattenMethod(this.handle, 1);
+        this.wasmModule.setARAPOptions(this.handle, iterations, options);
+        this.wasmModule.setARAPInitialUV(this.handle, uvArray);
+        try {
+            return await this.flattenWasm(onProgress);
+        } finally {
+            this.wasmModule.setFlattenMethod(this.handle, 0);
+            this.wasmModule.setARAPInitialUV(this.handle, new Float64Array(0));
+        }
+    }
+    
+    /**
+     * 渐进展开（仅WASM模式）：先在粗网格上求解，通过onPreview给出近似结果，再完成全分辨率展开
+     * @param {Function} onPreview - (result) 预览结果，格式同返回值，stats.preview为true
+     * @param {Object} options - targetVertices：预览时每个片段的目标顶点数
+     * @param {Function} onProgress - 进度回调
+     * @returns {Promise<Object>} 展开结果
+     */
+    async flattenProgressive(onPreview, { targetVertices = 2000 } = {}, onProgress = null) {
+        if (!this.useWasm || !this.wasmModule) {
+            return this.flattenJS(onProgress);
+        }
+        
+        if (!this.wasmModule.flattenPreview(this.handle, targetVertices)) {
+            throw new Error(this.wasmModule.getError(this.handle));
+        }
+        if (onPreview) onPreview(this.collectWasmResult());
+        
+        // 让出一次事件循环，预览先绘制出来
+        await new Promise(resolve => setTimeout(resolve, 0));
+        return this.flattenWasm(onProgress);
+    }
+    
     /**
      * WASM展开
      */
     async flattenWasm(onProgress) {
         if (onProgress) onProgress(10);
         
-        const success = this.wasmModule.flatten();
+        const success = this.wasmModule.flatten(this.handle);
         
         if (!success) {
-            throw new Error(this.wasmModule.getError());
+            throw new Error(this.wasmModule.getError(this.handle));
         }
         
         if (onProgress) onProgress(90);
-        
-        const uvArray = this.wasmModule.getUVCoords();
-        const uvCount = this.wasmModule.getUVCount();
+        const result = this.collectWasmResult();
+        if (onProgress) onProgress(100);
+        return result;
+    }
+    
+    /**
+     * 读取WASM展开器中的当前结果
+     */
+    collectWasmResult() {
+        // 直接读取WASM内存中的结果视图，读取期间不调用其它WASM函数
+        const uvArray = this.wasmModule.getUVCoordsView(this.handle);
+        const uvCount = uvArray.length / 2;
         
         // 转换为UV对象数组
         const uvs = [];
@@ -135,14 +321,167 @@ export class BFFFlattener {
             });
         }
         
-        if (onProgress) onProgress(100);
+        // 片段信息：沿缝线切开后，缝线上的顶点会被复制，
+        // uvs按切分后顶点索引，vertexSource给出对应的原顶点
+        const uvFaces = this.wasmModule.getUVFaces(this.handle).slice();
+        const vertexSource = this.wasmModule.getSplitVertexSource(this.handle).slice();
+        const facePieces = this.wasmModule.getFacePieces(this.handle);
+        const islands = [];
+        for (let i = 0; i < this.wasmModule.getPieceCount(this.handle); i++) {
+            islands.push({ faces: [], vertices: new Set() });
+        }
+        for (let f = 0; f < facePieces.length; f++) {
+            const island = islands[facePieces[f]];
+            island.faces.push(f);
+            island.vertices.add(uvFaces[f * 3]);
+            island.vertices.add(uvFaces[f * 3 + 1]);
+            island.vertices.add(uvFaces[f * 3 + 2]);
+        }
         
         return {
             uvs: uvs,
+            islands: islands,
+            uvFaces: uvFaces,
+            vertexSource: vertexSource,
+            stats: this.wasmModule.getFlattenStats(this.handle),
             success: true
         };
     }
     
+    /**
+     * 批量展开多个零件（仅WASM模式），与当前网格无关
+     * 多线程构建中各零件并行展开；单个零件失败不影响其他零件
+     * @param {Array<Object>} parts - { vertices, faces, seams }，见 BatchCodec.encodeBatch
+     * @param {Object} options - { method: 'conformal'|'arap', iterations, arap, ordering }
+     * @returns {Array<Object>} 每个零件 { status, error, uvs, uvFaces }，status见 BatchStatus
+     */
+    flattenBatch(parts, options = {}) {
+        if (!this.useWasm || !this.wasmModule) {
+            throw new Error('Batch flatten requires the WASM module');
+        }
+        const input = encodeBatch(parts);
+        const job = this.wasmModule.createBatchJob();
+        try {
+            this.wasmModule.getBatchUploadView(job, input.length).set(input);
+            const output = this.wasmModule.flattenBatch(job, batchOptionsToNative(options));
+            if (!output) {
+                throw new Error(this.wasmModule.getBatchError(job));
+            }
+            return decodeBatchResult(output.slice());
+        } finally {
+            this.wasmModule.destroyBatchJob(job);
+        }
+    }
+    
+    /**
+     * 把展开结果的各片段排进定宽条带（仅WASM模式，flatten之后调用）
+     * 片段先按3D面积缩放回网格单位，stripWidth、spacing同为网格单位
+     * @param {Object} options - stripWidth（<=0按总面积自动）/ spacing / allowRotation / alignToBounds
+     * @returns {Object} { transforms: [{scale, rotation, tx, ty}]（与islands一一对应）,
+     *                     uvs: Float64Array（排料后的 [u0,v0, ...]，下标同flatten结果的uvs）,
+     *                     width, height, utilization }
+     */
+    packIslands(options = {}) {
+        if (!this.useWasm || !this.wasmModule) {
+            throw new Error('UV packing requires the WASM module');
+        }
+        const packed = this.wasmModule.packIslands(this.handle, options);
+        if (!packed) {
+            throw new Error(this.wasmModule.getError(this.handle));
+        }
+        return {
+            ...packed,
+            transforms: UVPacker.unpackTransforms(packed.transforms),
+            uvs: this.wasmModule.getPackedUVsView(this.handle).slice()
+        };
+    }
+    
+    /**
+     * 当前展开结果的畸变指标（仅WASM模式，首次调用时计算，供UV热图使用）
+     * 逐面数组按网格面编号；片段先按3D面积缩放回网格单位再比较面积和边界长度
+     * @returns {Object|null} { conformal（σ1/σ2）, area（log2面积比）: Float32Array, flipped: Uint8Array,
+     *                          boundaryError: Float32Array（每个片段的边界长度相对误差）,
+     *                          flippedFaces, meanConformal, maxConformal, meanAreaError, maxBoundaryError }，
+     *                          没有展开结果时为null
+     */
+    getDistortion() {
+        if (!this.useWasm || !this.wasmModule) return null;
+        return this.wasmModule.getDistortion(this.handle);
+    }
+    
+    /**
+     * 把当前结果导出为纸样（仅WASM模式，已排料时用排料后的UV），逐块写入writable
+     * @param {WritableStream} writable
+     * @param {Object} options - { format: 'svg' | 'dxf', interior, scale, padding, chunkSize }，见 PatternExporter.js
+     * @returns {Promise<Object|null>} { loops, bytes }，没有展开结果时为null
+     */
+    async exportPatterns(writable, options = {}) {
+        if (!this.useWasm || !this.wasmModule) {
+            throw new Error('Pattern export requires the WASM module');
+        }
+        const exporter = new PatternExporter();
+        exporter.setWasmModule(this.wasmModule);
+        return exporter.exportFlattener(this.handle, writable, options);
+    }
+    
+    /**
+     * 保存网格缓存（网格、半边拓扑、缝线、片段划分和UV，仅WASM模式）
+     * 返回的Uint8Array是独立副本，可直接存入IndexedDB（见 MeshCacheStore.js）
+     * @returns {Uint8Array}
+     */
+    saveCache() {
+        if (!this.useWasm || !this.wasmModule) {
+            throw new Error('Mesh cache requires the WASM module');
+        }
+        return this.wasmModule.saveCache(this.handle).slice();
+    }
+    
+    /**
+     * 从网格缓存恢复，替换当前网格和缝线（固定点清空）
+     * @param {Uint8Array|ArrayBuffer} bytes - saveCache的输出
+     * @returns {Object|null} 缓存含UV时返回与flatten相同的展开结果，否则为null（需重新flatten）
+     */
+    loadCache(bytes) {
+        if (!this.useWasm || !this.wasmModule) {
+            throw new Error('Mesh cache requires the WASM module');
+        }
+        const data = bytes instanceof Uint8Array ? bytes : new Uint8Array(bytes);
+        this.wasmModule.getCacheUploadView(this.handle, data.length).set(data);
+        if (!this.wasmModule.commitCache(this.handle)) {
+            throw new Error(this.wasmModule.getError(this.handle));
+        }
+        return this.wasmModule.getUVCount(this.handle) > 0 ? this.collectWasmResult() : null;
+    }
+    
+    /**
+     * 获取WASM展开结果的扁平UV数组副本 [u0,v0, u1,v1, ...]
+     * @param {boolean} float32 - 返回Float32Array（渲染和SVG导出精度足够，数据量减半）
+     * @returns {Float32Array|Float64Array|null}
+     */
+    getUVBuffer(float32 = false) {
+        if (!this.useWasm || !this.wasmModule) return null;
+        
+        const view = float32
+            ? this.wasmModule.getUVCoordsF32View(this.handle)
+            : this.wasmModule.getUVCoordsView(this.handle);
+        return view.slice();
+    }
+
+    /**
+     * WASM内核的剖析数据（需加载 make profile 生成的 bff_wasm_profile.js，其他构建中 enabled 为false）
+     * 数据在模块内全局累计，不区分展开器实例，resetProfile()清空
+     * @param {Object} options - { trace: true } 返回Chrome trace-event JSON字符串（chrome://tracing、Perfetto）
+     * @returns {Object|string|null} { enabled, stages: [{name, calls, totalMs, maxMs}], counters, peakBytes, events, droppedEvents }
+     */
+    getProfile(options = {}) {
+        if (!this.useWasm || !this.wasmModule) return null;
+        return options.trace ? this.wasmModule.getProfileTrace() : this.wasmModule.getProfile();
+    }
+
+    resetProfile() {
+        if (this.useWasm && this.wasmModule) this.wasmModule.resetProfile();
+    }
+
     /**
      * 纯JavaScript展开（优化版）
      */
@@ -545,8 +884,9 @@ export class BFFFlattener {
      */
     dispose() {
         if (this.wasmModule) {
-            this.wasmModule.cleanup();
+            this.wasmModule.destroyFlattener(this.handle);
             this.wasmModule = null;
+            this.handle = -1;
         }
         this.vertices = [];
         this.faces = [];
@@ -0,0 +1,319 @@
+/**
+ * BFF Worker客户端 - 在Web Worker中运行WASM展开器
+ *
+ * 与 BFFFlattener.js 的WASM模式算法相同，区别在于：
+ * 1. 展开在Worker线程执行，主线程（编辑器）不被阻塞
+ * 2. 一个Worker内可持有多个展开器（句柄），各自保存网格、缝线和缓存
+ * 3. 网格和结果缓冲区以Transferable传递，不复制
+ * 4. flatten支持进度回调和AbortSignal取消
+ */
+
+import { encodeBatch, decodeBatchResult, batchOptionsToNative } from './BatchCodec.js';
+
+export class BFFWorkerClient {
+    /**
+     * @param {string|URL} workerUrl - bff.worker.js 地址
+     * @param {string|URL} wasmBaseUrl - bff_wasm.js / bff_wasm_scalar.js / bff_wasm_mt.js 所在目录
+     * @param {boolean} useThreads - 页面跨源隔离时使用多线程版本
+     */
+    constructor(workerUrl = new URL('./bff.worker.js', import.meta.url),
+                wasmBaseUrl = new URL('./', import.meta.url),
+                useThreads = true) {
+        this.workerUrl = workerUrl;
+        this.wasmBaseUrl = String(wasmBaseUrl);
+        this.worker = null;
+        this.nextId = 1;
+        this.pending = new Map();   // 请求id -> { resolve, reject, onProgress, onPreview }
+        this.useThreads = useThreads;
+        this.simd = false;
+        this.threads = false;
+    }
+
+    /**
+     * 启动Worker并加载WASM模块（按浏览器支持选择多线程、SIMD或标量版本）
+     */
+    async init() {
+        if (this.worker) return true;
+        this.worker = new Worker(this.workerUrl);
+        this.worker.onmessage = (event) => this.handleMessage(event.data);
+        this.worker.onerror = (event) => {
+            console.error('BFF Worker错误:', event.message);
+        };
+
+        const { simd, threads } = await this.request('init', {
+            baseUrl: this.wasmBaseUrl,
+            threads: this.useThreads
+        });
+        this.simd = simd;
+        this.threads = threads;
+        console.log(`BFF Worker: WASM已加载（${threads ? '多线程' : simd ? 'SIMD' : '标量'}版本）`);
+        return true;
+    }
+
+    handleMessage(msg) {
+        const entry = this.pending.get(msg.id);
+        if (!entry) return;
+
+        if (msg.type === 'progress') {
+            if (entry.onProgress) entry.onProgress(msg.done, msg.total);
+            return;
+        }
+        if (msg.type === 'preview') {
+            if (entry.onPreview) entry.onPreview(msg.data);
+            return;
+        }
+
+        this.pending.delete(msg.id);
+        if (msg.type === 'result') {
+            entry.resolve(msg.data);
+        } else {
+            const error = new Error(msg.message);
+            if (msg.cancelled) error.name = 'AbortError';
+            entry.reject(error);
+        }
+    }
+
+    /**
+     * 发送请求
+     * @param {string} type - 请求类型
+     * @param {Object} payload - 参数
+     * @param {Array} transfer - 移交给Worker的ArrayBuffer
+     * @param {Object} control - { onProgress, onPreview, signal }
+     */
+    request(type, payload = {}, transfer = [], control = {}) {
+        if (!this.worker) {
+            return Promise.reject(new Error('BFF Worker not initialized'));
+        }
+
+        const id = this.nextId++;
+        const { onProgress = null, onPreview = null, signal = null } = control;
+
+        return new Promise((resolve, reject) => {
+            if (signal && signal.aborted) {
+                const error = new Error('Flatten cancelled');
+                error.name = 'AbortError';
+                reject(error);
+                return;
+            }
+
+            // 请求结束（完成、失败或Worker终止）时移除取消监听，长期复用的signal不累积监听器
+            const onAbort = () => this.worker.postMessage({ type: 'cancel', target: id });
+            if (signal) signal.addEventListener('abort', onAbort, { once: true });
+            const settle = (callback) => (value) => {
+                if (signal) signal.removeEventListener('abort', onAbort);
+                callback(value);
+            };
+
+            this.pending.set(id, { resolve: settle(resolve), reject: settle(reject), onProgress, onPreview });
+            this.worker.postMessage({ id, type, ...payload }, transfer);
+        });
+    }
+
+    /**
+     * 创建展开器
+     * @returns {Promise<number>} 句柄
+     */
+    async createFlattener() {
+        const { handle } = await this.request('create');
+        return handle;
+    }
+
+    /**
+     * 销毁展开器
+     */
+    destroyFlattener(handle) {
+        return this.request('destroy', { handle });
+    }
+
+    /**
+     * 设置网格
+     * TypedArray参数的缓冲区会移交给Worker，调用后在主线程不可再用；
+     * 需要保留时传入副本
+     * @param {number} handle - 展开器句柄
+     * @param {Float64Array|Array} vertices - [x,y,z,...] 或 [{x,y,z}, ...]
+     * @param {Int32Array|Array} faces - [a,b,c,...] 或 [[a,b,c], ...]；
+     *                               多边形面按扇形三角化（同 PhysicsFlattener），结果中的面编号为三角形编号
+     * @returns {Promise<Object>} { nonManifoldEdges: Int32Array }
+     */
+    setMesh(handle, vertices, faces) {
+        const vertArray = BFFWorkerClient.toFloat64Vertices(vertices);
+        const faceArray = BFFWorkerClient.toInt32Faces(faces);
+        return this.request('setMesh', { handle, vertices: vertArray, faces: faceArray },
+                            [vertArray.buffer, faceArray.buffer]);
+    }
+
+    /**
+     * 批量展开多个零件（见 BFFFlattener.flattenBatch），一次往返
+     * 多线程版本中各零件并行展开；单个零件失败不影响其他零件
+     * @param {Array<Object>} parts - { vertices, faces, seams }
+     * @param {Object} options - { method: 'conformal'|'arap', iterations, arap, ordering }
+     * @returns {Promise<Array<Object>>} 每个零件 { status, error, uvs, uvFaces }
+     */
+    async flattenBatch(parts, options = {}) {
+        const batch = encodeBatch(parts);
+        const { result } = await this.request('flattenBatch',
+            { batch, options: batchOptionsToNative(options) }, [batch.buffer]);
+        return decodeBatchResult(result);
+    }
+
+    /**
+     * 排列展开结果的各片段（见 BFFFlattener.packIslands），flatten之后调用
+     * @param {number} handle - 展开器句柄
+     * @param {Object} options - stripWidth / spacing / allowRotation / alignToBounds
+     * @returns {Promise<Object>} { transforms: Float64Array [scale, rotation, tx, ty, ...],
+     *                              uvs: Float64Array, width, height, utilization }
+     */
+    packIslands(handle, options = {}) {
+        return this.request('pack', { handle, options });
+    }
+
+    /**
+     * 设置上传网格时的重排方式，下次setMesh / loadOBJ生效（见 BFFFlattener.setMeshOrdering）
+     * @param {number} handle - 展开器句柄
+     * @param {string} ordering - 'original' | 'rcm' | 'morton'
+     */
+    setMeshOrdering(handle, ordering) {
+        return this.request('setMeshOrdering', { handle, ordering });
+    }
+
+    /**
+     * 在Worker内读取OBJ文件并设置为网格（文件内容不经过主线程）
+     * @param {number} handle - 展开器句柄
+     * @param {File|Blob} file - OBJ文件
+     * @param {boolean} dedupVertices - 合并坐标完全相同的顶点
+     * @returns {Promise<Object>} { info, positions, triangles, colors, vertexRemap, nonManifoldEdges }
+     *          字段含义同 OBJStreamReader.read / getMesh
+     */
+    loadOBJ(handle, file, dedupVertices = true) {
+        return this.request('loadOBJ', { handle, file, dedupVertices });
+    }
+
+    /**
+     * 保存网格缓存
+     * @returns {Promise<Uint8Array>} 可直接存入IndexedDB
+     */
+    async saveCache(handle) {
+        const { cache } = await this.request('saveCache', { handle });
+        return cache;
+    }
+
+    /**
+     * 从网格缓存恢复网格、缝线、片段划分和UV
+     * 缓冲区移交给Worker，需要保留时传入副本
+     * @param {Uint8Array} cache - saveCache的输出
+     * @returns {Promise<Object>} { hasUVs, pieceCount }
+     */
+    loadCache(handle, cache) {
+        const bytes = cache instanceof Uint8Array ? cache : new Uint8Array(cache);
+        return this.request('loadCache', { handle, cache: bytes }, [bytes.buffer]);
+    }
+
+    /**
+     * 替换缝线
+     * @param {Int32Array|Array} edges - [a0,b0, a1,b1, ...] 或 [[a,b], ...]
+     */
+    setSeams(handle, edges) {
+        const edgeArray = edges instanceof Int32Array ? edges : Int32Array.from(edges.flat());
+        return this.request('setSeams', { handle, edges: edgeArray }, [edgeArray.buffer]);
+    }
+
+    /**
+     * 替换固定点
+     * @param {Array} pins - [{ index, u, v }, ...]，index为UV顶点索引，坐标为片段归一化坐标
+     */
+    setPins(handle, pins) {
+        const pinArray = new Float64Array(pins.length * 3);
+        pins.forEach((pin, i) => {
+            pinArray[i * 3] = pin.index;
+            pinArray[i * 3 + 1] = pin.u;
+            pinArray[i * 3 + 2] = pin.v;
+        });
+        return this.request('setPins', { handle, pins: pinArray }, [pinArray.buffer]);
+    }
+
+    /**
+     * 展开
+     * @param {number} handle - 展开器句柄
+     * @param {Object} options
+     * @param {string} options.method - 'conformal' | 'arap'
+     * @param {number} options.iterations - ARAP迭代次数
+     * @param {Object} options.options - ARAP参数（同 BFFFlattener.flattenARAP）
+     * @param {boolean} options.float32 - UV以Float32Array返回
+     * @param {Function} options.onProgress - (done, total) 已完成片段数
+     * @param {boolean} options.preview - 先在粗网格上求解并通过onPreview给出近似结果
+     * @param {number} options.targetVertices - 预览时每个片段的目标顶点数
+     * @param {Function} options.onPreview - (result) 预览结果，格式同返回值，stats.preview为true
+     * @param {AbortSignal} options.signal - 取消信号，取消后Promise以AbortError拒绝
+     * @returns {Promise<Object>} { uvs, uvFaces, facePieces, vertexSource, pieceCount, stats }
+     *          stats为迭代次数、残差、ARAP能量和各阶段耗时（同WASM的getFlattenStats）
+     */
+    flatten(handle, { method = 'conformal', iterations = 10, options = {}, float32 = false,
+                      preview = false, targetVertices = 2000,
+                      onProgress = null, onPreview = null, signal = null } = {}) {
+        return this.request('flatten',
+                            { handle, method, iterations, options, float32, preview, targetVertices }, [],
+                            { onProgress, onPreview, signal });
+    }
+
+    /**
+     * 读取当前展开结果（loadCache恢复了UV时无需flatten）
+     * @returns {Promise<Object>} 同 flatten
+     */
+    getResult(handle, { float32 = false } = {}) {
+        return this.request('getResult', { handle, float32 });
+    }
+
+    /**
+     * 当前展开结果的畸变指标，只在需要显示热图时请求
+     * @returns {Promise<Object|null>} 同 BFFFlattener.getDistortion
+     */
+    getDistortion(handle) {
+        return this.request('getDistortion', { handle });
+    }
+
+    /**
+     * 终止Worker，未完成的请求全部拒绝
+     */
+    terminate() {
+        if (!this.worker) return;
+        this.worker.terminate();
+        this.worker = null;
+        for (const entry of this.pending.values()) {
+            entry.reject(new Error('BFF Worker terminated'));
+        }
+        this.pending.clear();
+    }
+
+    static toFloat64Vertices(vertices) {
+        if (vertices instanceof Float64Array) return vertices;
+        if (vertices.length > 0 && typeof vertices[0] === 'object') {
+            const array = new Float64Array(vertices.length * 3);
+            for (let i = 0; i < vertices.length; i++) {
+                array[i * 3] = vertices[i].x;
+                array[i * 3 + 1] = vertices[i].y;
+                array[i * 3 + 2] = vertices[i].z;
+            }
+            return array;
+        }
+        return Float64Array.from(vertices);
+    }
+
+    static toInt32Faces(faces) {
+        if (faces instanceof Int32Array) return faces;
+        if (faces.length > 0 && Array.isArray(faces[0])) {
+            let count = 0;
+            for (const face of faces) count += Math.max(face.length - 2, 0);
+            const array = new Int32Array(count * 3);
+            let t = 0;
+            for (const face of faces) {
+                for (let j = 1; j + 1 < face.length; j++, t += 3) {
+                    array[t] = face[0];
+                    array[t + 1] = face[j];
+                    array[t + 2] = face[j + 1];
+                }
+            }
+            return array;
+        }
+        return Int32Array.from(faces);
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * 批量展开容器的编码和解码（布局见 wasm/src/batch_flatten.h）
+ *
+ * 输入：多个零件的顶点、面和缝线边打包成一个Uint8Array，一次调用 flattenBatch 全部展开
+ * 输出：每个零件的状态码、错误信息、UV和面的角 -> 切分后顶点
+ * 不依赖WASM模块，Worker客户端和服务端批处理共用
+ */
+
+const INPUT_MAGIC = 0x49464642;    // "BFFI"
+const OUTPUT_MAGIC = 0x4f464642;   // "BFFO"
+const VERSION = 1;
+const HEADER_SIZE = 16;
+const PART_HEADER_SIZE = 16;
+
+// 零件状态码，与 BatchStatus 对应
+export const BatchStatus = {
+    OK: 0,
+    INVALID_MESH: 1,
+    FLATTEN_FAILED: 2
+};
+
+const align8 = (x) => (x + 7) & ~7;
+
+/**
+ * 打包零件
+ * @param {Array<Object>} parts - { vertices: [x,y,z,...], faces: [a,b,c,...], seams: [a0,b0, ...]（可省略） }
+ * @returns {Uint8Array}
+ */
+export function encodeBatch(parts) {
+    let size = HEADER_SIZE + PART_HEADER_SIZE * parts.length;
+    const layout = parts.map(part => {
+        const numVertices = part.vertices.length / 3;
+        const numFaces = part.faces.length / 3;
+        const numSeamEdges = part.seams ? part.seams.length >> 1 : 0;
+        const vertices = size = align8(size);
+        const faces = size = align8(size + numVertices * 24);
+        const seams = size = align8(size + numFaces * 12);
+        size += numSeamEdges * 8;
+        return { numVertices, numFaces, numSeamEdges, vertices, faces, seams };
+    });
+
+    const bytes = new Uint8Array(align8(size));
+    const view = new DataView(bytes.buffer);
+    view.setUint32(0, INPUT_MAGIC, true);
+    view.setUint32(4, VERSION, true);
+    view.setUint32(8, parts.length, true);
+
+    parts.forEach((part, i) => {
+        const l = layout[i];
+        const head = HEADER_SIZE + PART_HEADER_SIZE * i;
+        view.setUint32(head, l.numVertices, true);
+        view.setUint32(head + 4, l.numFaces, true);
+        view.setUint32(head + 8, l.numSeamEdges, true);
+        // 偏移8字节对齐，可直接建立TypedArray视图（小端平台）
+        new Float64Array(bytes.buffer, l.vertices, l.numVertices * 3).set(part.vertices);
+        new Int32Array(bytes.buffer, l.faces, l.numFaces * 3).set(part.faces);
+        if (l.numSeamEdges > 0) {
+            new Int32Array(bytes.buffer, l.seams, l.numSeamEdges * 2).set(part.seams.subarray
+                ? part.seams.subarray(0, l.numSeamEdges * 2)
+                : part.seams.slice(0, l.numSeamEdges * 2));
+        }
+    });
+    return bytes;
+}
+
+/**
+ * 解码输出容器，UV和uvFaces为输出缓冲区上的视图（不复制）
+ * @param {Uint8Array} bytes - flattenBatch 的输出
+ * @returns {Array<Object>} 每个零件 { status, error, uvs: Float64Array, uvFaces: Int32Array }
+ */
+export function decodeBatchResult(bytes) {
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    if (bytes.byteLength < HEADER_SIZE || view.getUint32(0, true) !== OUTPUT_MAGIC) {
+        throw new Error('Not a BFF batch result');
+    }
+    if (view.getUint32(4, true) !== VERSION) {
+        throw new Error('Unsupported batch result version');
+    }
+
+    // 输出缓冲区可能不在8字节边界上（例如来自更大的ArrayBuffer），此时复制一次
+    if (bytes.byteOffset % 8 !== 0) bytes = bytes.slice();
+    const decoder = new TextDecoder();
+    const numParts = view.getUint32(8, true);
+    const results = [];
+    let offset = HEADER_SIZE + PART_HEADER_SIZE * numParts;
+    for (let i = 0; i < numParts; i++) {
+        const head = HEADER_SIZE + PART_HEADER_SIZE * i;
+        const status = view.getInt32(head, true);
+        const numUVs = view.getUint32(head + 4, true);
+        const numFaces = view.getUint32(head + 8, true);
+        const errorLength = view.getUint32(head + 12, true);
+
+        const uvStart = offset = align8(offset);
+        const faceStart = offset = align8(offset + numUVs * 16);
+        const errorStart = offset = align8(offset + numFaces * 12);
+        offset += errorLength;
+        results.push({
+            status,
+            error: errorLength > 0 ? decoder.decode(bytes.subarray(errorStart, errorStart + errorLength)) : '',
+            uvs: new Float64Array(bytes.buffer, bytes.byteOffset + uvStart, numUVs * 2),
+            uvFaces: new Int32Array(bytes.buffer, bytes.byteOffset + faceStart, numFaces * 3)
+        });
+    }
+    return results;
+}
+
+/**
+ * JS选项 -> flattenBatch 的原生选项
+ * @param {Object} options - { method: 'conformal'|'arap', iterations, arap: ARAP参数, ordering: 'original'|'rcm'|'morton' }
+ */
+export function batchOptionsToNative(options = {}) {
+    const native = { method: options.method === 'arap' ? 1 : 0 };
+    if (options.iterations !== undefined) native.iterations = options.iterations;
+    if (options.arap) native.arap = options.arap;
+    if (options.ordering) {
+        const mode = { original: 0, rcm: 1, morton: 2 }[options.ordering];
+        if (mode === undefined) throw new Error(`Unknown mesh ordering: ${options.ordering}`);
+        native.ordering = mode;
+    }
+    return native;
+}
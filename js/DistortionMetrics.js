@@ -0,0 +1,108 @@
+/**
+ * 展开畸变指标（原生实现见 wasm/src/distortion_metrics.cpp）
+ *
+ * 逐面：共形畸变 σ1/σ2、面积畸变 log2(UV面积/3D面积)（片段先按总面积缩放回网格单位）、翻转；
+ * 逐片段：边界长度相对3D的偏差（PhysicsFlattener的“边界保持长度”目标）
+ * 未设置WASM模块时 compute() 返回null
+ */
+
+export class DistortionMetrics {
+    constructor() {
+        this.wasmModule = null;
+    }
+
+    /**
+     * @param {Object} wasmModule - BFFModule实例（传入null关闭）
+     */
+    setWasmModule(wasmModule) {
+        this.wasmModule = wasmModule;
+    }
+
+    get isAvailable() {
+        return !!this.wasmModule;
+    }
+
+    /**
+     * 计算展开结果中各片段的指标
+     * @param {Array<Object>} pieces - flattenedData.pieces：{ localVertices[i].pos3D, localFaces, uv }，
+     *                                 uv[i] 与 localVertices[i] 对应
+     * @returns {Object|null} { conformal, area: Float32Array, flipped: Uint8Array,
+     *          pieceOffsets: Int32Array（片段p的第i个面为 pieceOffsets[p] + i），boundaryError: Float32Array,
+     *          flippedFaces, meanConformal, maxConformal, meanAreaError, maxBoundaryError }
+     */
+    compute(pieces) {
+        if (!this.wasmModule || !pieces || pieces.length === 0) return null;
+
+        // 多边形按扇形三角化，triFace记录三角形所属的面
+        let numVertices = 0, numFaces = 0, numTris = 0;
+        let trianglesOnly = true;
+        for (const piece of pieces) {
+            numVertices += piece.uv.length;
+            numFaces += piece.localFaces.length;
+            for (const face of piece.localFaces) {
+                numTris += Math.max(face.length - 2, 0);
+                if (face.length !== 3) trianglesOnly = false;
+            }
+        }
+        const positions = new Float64Array(numVertices * 3);
+        const uvs = new Float64Array(numVertices * 2);
+        const tris = new Int32Array(numTris * 3);
+        const triPieces = new Int32Array(numTris);
+        const triFace = new Int32Array(numTris);
+        const pieceOffsets = new Int32Array(pieces.length + 1);
+
+        let base = 0, f = 0, t = 0;
+        pieces.forEach((piece, p) => {
+            const { localVertices, localFaces, uv } = piece;
+            for (let i = 0; i < uv.length; i++) {
+                const pos = localVertices[i] ? localVertices[i].pos3D : null;
+                positions[(base + i) * 3] = pos ? pos.x : 0;
+                positions[(base + i) * 3 + 1] = pos ? pos.y : 0;
+                positions[(base + i) * 3 + 2] = pos ? pos.z : 0;
+                uvs[(base + i) * 2] = uv[i].u;
+                uvs[(base + i) * 2 + 1] = uv[i].v;
+            }
+            for (const face of localFaces) {
+                for (let k = 1; k + 1 < face.length; k++) {
+                    tris[t * 3] = base + face[0];
+                    tris[t * 3 + 1] = base + face[k];
+                    tris[t * 3 + 2] = base + face[k + 1];
+                    triPieces[t] = p;
+                    triFace[t] = f;
+                    t++;
+                }
+                f++;
+            }
+            base += uv.length;
+            pieceOffsets[p + 1] = f;
+        });
+        if (numTris === 0) return null;
+
+        const metrics = this.wasmModule.computeDistortionMetrics(positions, tris, uvs, tris, triPieces);
+        if (!metrics) return null;
+        metrics.pieceOffsets = pieceOffsets;
+        if (trianglesOnly) return metrics;
+
+        // 多边形取各三角形的平均畸变，任一三角形翻转即视为翻转
+        const conformal = new Float32Array(numFaces);
+        const area = new Float32Array(numFaces);
+        const flipped = new Uint8Array(numFaces);
+        const count = new Int32Array(numFaces);
+        for (let i = 0; i < numTris; i++) {
+            const face = triFace[i];
+            conformal[face] += metrics.conformal[i];
+            area[face] += metrics.area[i];
+            flipped[face] |= metrics.flipped[i];
+            count[face]++;
+        }
+        let flippedFaces = 0;
+        for (let i = 0; i < numFaces; i++) {
+            if (count[i] > 0) {
+                conformal[i] /= count[i];
+                area[i] /= count[i];
+            }
+            flippedFaces += flipped[i];
+        }
+        return { ...metrics, conformal, area, flipped, flippedFaces };
+    }
+}
@@ -9,6 +9,16 @@
  * 【新增】激光切缝(Kerf)概念：
  * - 红色顶点/面片被视为切割废料，直接丢弃
  * - 裁片边缘会自动内缩一圈，保证绝对干净
+ *
+ * WASM加速:
+ *   - setWasmModule() 后邻接、泛洪和红线面分配在原生分割器中完成（flood_segmenter.cpp），
+ *     缝线边按整数对传入，整个过程不生成边的字符串key；结果与JS实现相同
+ *   - 网格只在第一次分割时上传，编辑缝线后重新分割只传缝线和红点；
+ *     原生分割器只重新泛洪改动边所在的岛屿
+ *
+ * 增量分割:
+ *   - options.previous 传入上一次的结果时，面集合与切缝都未变化的部件直接复用原对象，
+ *     调用方可据此只重新展开变化的部件
  */
 
 export class FloodSegmenter {
@@ -16,6 +26,25 @@ export class FloodSegmenter {
     // 最小面数阈值 - 小于此值的区域会被丢弃
     static MIN_FACES = 500;
 
+    static wasmModule = null;
+    static wasmHandle = -1;
+    static wasmFaces = null;    // 已上传到原生分割器的 mesh.faces
+    static wasmParts = null;    // 原生分割器上一次结果构建的子网格
+
+    /**
+     * 使用WASM模块中的原生分割器（传入null恢复纯JS实现）
+     * @param {Object} wasmModule - BFFModule实例
+     */
+    static setWasmModule(wasmModule) {
+        if (this.wasmModule && this.wasmHandle >= 0) {
+            this.wasmModule.destroySegmenter(this.wasmHandle);
+        }
+        this.wasmModule = wasmModule;
+        this.wasmHandle = wasmModule ? wasmModule.createSegmenter() : -1;
+        this.wasmFaces = null;
+        this.wasmParts = null;
+    }
+
     /**
      * 兼容旧签名：基于红顶点的围墙分割
      */
@@ -43,6 +72,8 @@ export class FloodSegmenter {
      * @param {Object} mesh - {vertices, faces}
      * @param {Set} seamEdges - 规范化的边 key 集合 (v1_v2)
      * @param {Object} options
+     * @param {Int32Array} options.seamEdgePairs - 缝线边整数对 [a0,b0, ...]，WASM分割时代替seamEdges
+     * @param {Array} options.previous - 上一次的分割结果，未变化的部件原样复用
      * @param {number} options.minFaces - 保留的最小面数
      * @param {boolean} options.assignBoundaryFaces - 是否把缝线邻近的面分配回最近Patch
      * @param {Set} options.redVertices - 红色顶点集合，用于激光切缝剔除
@@ -51,7 +82,9 @@ export class FloodSegmenter {
         const {
             minFaces = this.MIN_FACES,
             assignBoundaryFaces = true,
-            redVertices = null
+            redVertices = null,
+            seamEdgePairs = null,
+            previous = null
         } = options;
 
         console.log('========================================');
@@ -59,8 +92,29 @@ export class FloodSegmenter {
         console.log('========================================');
 
         const startTime = Date.now();
-        const wallSet = seamEdges instanceof Set ? seamEdges : new Set(seamEdges || []);
         const redSet = redVertices instanceof Set ? redVertices : new Set(redVertices || []);
+
+        const native = this.segmentLabels(mesh, seamEdgePairs || seamEdges, redSet, { minFaces, assignBoundaryFaces });
+        if (native) {
+            console.log(`输入: ${mesh.faces.length} 面, 红点: ${redSet.size} (WASM)`);
+            console.log(`检测到 ${native.boundaryFaces} 个边界面片（红线面）`);
+            console.log(`第一轮聚类完成: 发现 ${native.islands} 个基础Patch (重新泛洪 ${native.refloodedFaces} 面)`);
+            if (assignBoundaryFaces && native.islands > 0) {
+                console.log(`红线分配完成: ${native.boundaryFaces - native.unassignedFaces} 个面已归顺, ${native.unassignedFaces} 个面被丢弃`);
+            }
+            const patches = [];
+            for (let p = 0; p + 1 < native.offsets.length; p++) {
+                patches.push(Array.from(native.faces.subarray(native.offsets[p], native.offsets[p + 1])));
+            }
+            // dirty标记相对于原生分割器的上一次结果，previous不是它时逐面比较
+            const dirty = previous && previous === this.wasmParts ? native.dirty : null;
+            const subMeshes = this.buildPatchSubMeshes(mesh, patches, redSet, minFaces, previous, dirty);
+            this.wasmParts = subMeshes;
+            console.log(`总耗时: ${Date.now() - startTime}ms`);
+            return subMeshes;
+        }
+
+        const wallSet = seamEdges instanceof Set ? seamEdges : new Set(seamEdges || []);
         console.log(`输入: ${mesh.faces.length} 面, 墙边: ${wallSet.size} 条, 红点: ${redSet.size}`);
 
         // 1. 识别边界面（包含缝线边的面）
@@ -86,9 +140,87 @@ export class FloodSegmenter {
         console.log(`过滤 ${filteredCount} 个碎片 (面数<${minFaces})，最终保留 ${validIslands.length} 个大裁片`);
 
         // 6. 构建最终子网格（应用激光切缝剔除）
+        const subMeshes = this.buildPatchSubMeshes(mesh, validIslands, redSet, minFaces, previous);
+
+        console.log(`总耗时: ${Date.now() - startTime}ms`);
+        return subMeshes;
+    }
+
+    /**
+     * 原生分割：面 -> Patch 标签
+     * @param {Object} mesh - {vertices, faces}，只支持三角形面
+     * @param {Int32Array|Set} seamEdges - 缝线边整数对 [a0,b0, ...]，或规范化的边 key 集合 (v1_v2)
+     * @param {Set} redVertices - 红色顶点集合（激光切缝）
+     * @param {Object} options - { minFaces, assignBoundaryFaces }
+     * @returns {Object|null} { labels: Int32Array（-1为丢弃）, offsets, faces（Patch p 剔除切缝前的面为
+     *          faces[offsets[p] .. offsets[p+1])）, dirty（Uint8Array，0为与上一次调用相同）,
+     *          islands, boundaryFaces, unassignedFaces, refloodedFaces, revotedFaces }；
+     *          未设置WASM模块或含非三角形面时返回null
+     */
+    static segmentLabels(mesh, seamEdges, redVertices, options = {}) {
+        const module = this.wasmModule;
+        if (!module || this.wasmHandle < 0) return null;
+
+        if (this.wasmFaces !== mesh.faces) {
+            const faces = mesh.faces;
+            const triangles = new Int32Array(faces.length * 3);
+            for (let f = 0; f < faces.length; f++) {
+                const face = faces[f];
+                if (face.length !== 3) return null;
+                triangles[f * 3] = face[0];
+                triangles[f * 3 + 1] = face[1];
+                triangles[f * 3 + 2] = face[2];
+            }
+            if (!module.segmenterSetMesh(this.wasmHandle, triangles, mesh.vertices.length)) return null;
+            this.wasmFaces = faces;
+            this.wasmParts = null;
+        }
+
+        let pairs = seamEdges;
+        if (!ArrayBuffer.isView(pairs)) {
+            // 旧接口的字符串key
+            const keys = seamEdges ? [...seamEdges] : [];
+            pairs = new Int32Array(keys.length * 2);
+            keys.forEach((key, i) => {
+                const [v1, v2] = key.split('_').map(Number);
+                pairs[i * 2] = v1;
+                pairs[i * 2 + 1] = v2;
+            });
+        }
+
+        const redMask = new Uint8Array(mesh.vertices.length);
+        if (redVertices) {
+            for (const v of redVertices) redMask[v] = 1;
+        }
+
+        return module.segmentFaces(this.wasmHandle, pairs, redMask, options);
+    }
+
+    /**
+     * 由各Patch的面构建子网格，剔除切缝后面数不足的丢弃
+     * @param {Array} previous - 上一次的子网格；同一Patch（面及顺序相同、红点集合相同）直接复用
+     * @param {Uint8Array} dirty - 原生分割器的变化标记，给出时不再逐面比较
+     */
+    static buildPatchSubMeshes(mesh, patches, redSet, minFaces, previous = null, dirty = null) {
+        // Patch的第一个面是泛洪起点，不同Patch不会相同
+        const previousByStart = new Map();
+        if (previous) {
+            for (const subMesh of previous) {
+                if (subMesh.patchFaces) previousByStart.set(subMesh.patchFaces[0], subMesh);
+            }
+        }
+
         const subMeshes = [];
-        for (let idx = 0; idx < validIslands.length; idx++) {
-            const faceIndices = validIslands[idx];
+        let reused = 0;
+        for (let idx = 0; idx < patches.length; idx++) {
+            const faceIndices = patches[idx];
+
+            const old = previousByStart.get(faceIndices[0]);
+            if (old && (dirty ? !dirty[idx] : this.isSamePatch(old, faceIndices, redSet))) {
+                subMeshes.push(old);
+                reused++;
+                continue;
+            }
             
             // 在剔除红边前，先记录该区域包含的红点（用于后续分类）
             const internalRedVertices = new Set();
@@ -101,15 +233,30 @@ export class FloodSegmenter {
             const subMesh = this.buildSubMeshWithKerf(mesh, faceIndices, redSet);
             if (subMesh && subMesh.faces.length >= minFaces) {
                 subMesh.internalRedVertices = internalRedVertices; // 附加红点信息
+                subMesh.patchFaces = Int32Array.from(faceIndices); // 剔除切缝前的面，用于增量复用
+                subMesh.kerfRedVertices = redSet;
                 console.log(`  裁片 #${idx}: ${subMesh.faces.length} 面, ${subMesh.vertices.length} 顶点, 包含 ${internalRedVertices.size} 个红点`);
                 subMeshes.push(subMesh);
             }
         }
-
-        console.log(`总耗时: ${Date.now() - startTime}ms`);
+        if (reused > 0) {
+            console.log(`  复用 ${reused} 个未变化的裁片`);
+        }
         return subMeshes;
     }
 
+    /**
+     * 上一次的子网格是否由同样的面（同样顺序）和同一红点集合构建
+     */
+    static isSamePatch(subMesh, faceIndices, redSet) {
+        const patchFaces = subMesh.patchFaces;
+        if (subMesh.kerfRedVertices !== redSet || patchFaces.length !== faceIndices.length) return false;
+        for (let i = 0; i < patchFaces.length; i++) {
+            if (patchFaces[i] !== faceIndices[i]) return false;
+        }
+        return true;
+    }
+
     /**
      * 构建面邻接图
      * adjacency[faceIdx] = [{neighborFaceIdx, sharedEdge: [v1, v2]}, ...]
@@ -8,8 +8,12 @@
  * 支持两种模式：
  * 1. 传入完整网格+缝线边 - 自动切割
  * 2. 传入已切割的子网格列表 - 直接展开（推荐）
+ *
+ * setWasmModule() 后UV岛用原生skyline排料（uv_packer.cpp）排列，可旋转90度
  */
 
+import { UVPacker } from './UVPacker.js';
+
 export class LSCMFlattener {
     constructor() {
         this.vertices = [];
@@ -17,6 +21,15 @@ export class LSCMFlattener {
         this.seamEdges = new Set();
         this.subMeshes = null;  // 已切割的子网格
         this.uvResult = null;
+        this.packer = new UVPacker();
+    }
+    
+    /**
+     * 使用WASM模块中的原生排料（传入null恢复行排列）
+     * @param {Object} wasmModule - BFFModule实例
+     */
+    setWasmModule(wasmModule) {
+        this.packer.setWasmModule(wasmModule);
     }
     
     /**
@@ -915,6 +928,21 @@ export class LSCMFlattener {
     arrangeIslands(uvs, islands) {
         if (islands.length <= 1) return;
         
+        // 原生排料：缝线上被多个岛共用的顶点只按第一个岛变换一次
+        const islandVertices = islands.map(island => Array.from(island.vertices));
+        const packed = this.packer.pack(islandVertices.map(vs => vs.map(v => uvs[v])), { spacing: 0.05 });
+        if (packed) {
+            const moved = new Set();
+            islandVertices.forEach((vs, i) => {
+                for (const v of vs) {
+                    if (moved.has(v)) continue;
+                    moved.add(v);
+                    UVPacker.apply(packed.transforms[i], uvs[v]);
+                }
+            });
+            return;
+        }
+        
         // 计算每个岛的边界框
         const bounds = islands.map(island => {
             let minU = Infinity, maxU = -Infinity;
@@ -0,0 +1,71 @@
+/**
+ * 网格缓存存储 - 把 BFFFlattener.saveCache() 的输出存入IndexedDB
+ *
+ * 缓存按调用方给定的key保存（例如文件名 + 文件大小 + 修改时间），
+ * 值为Uint8Array，由IndexedDB结构化克隆保存，不做任何转换
+ */
+
+export class MeshCacheStore {
+    /**
+     * @param {string} dbName - 数据库名
+     * @param {string} storeName - 对象仓库名
+     */
+    constructor(dbName = 'bff-mesh-cache', storeName = 'meshes') {
+        this.dbName = dbName;
+        this.storeName = storeName;
+        this.db = null;
+    }
+
+    async open() {
+        if (this.db) return this.db;
+        this.db = await new Promise((resolve, reject) => {
+            const request = indexedDB.open(this.dbName, 1);
+            request.onupgradeneeded = () => {
+                request.result.createObjectStore(this.storeName);
+            };
+            request.onsuccess = () => resolve(request.result);
+            request.onerror = () => reject(request.error);
+        });
+        return this.db;
+    }
+
+    async transaction(mode, action) {
+        const db = await this.open();
+        return new Promise((resolve, reject) => {
+            const tx = db.transaction(this.storeName, mode);
+            const request = action(tx.objectStore(this.storeName));
+            tx.oncomplete = () => resolve(request.result);
+            tx.onerror = () => reject(tx.error);
+            tx.onabort = () => reject(tx.error);
+        });
+    }
+
+    /**
+     * 保存缓存
+     * @param {string} key
+     * @param {Uint8Array} bytes - saveCache的输出
+     */
+    put(key, bytes) {
+        return this.transaction('readwrite', store => store.put(bytes, key));
+    }
+
+    /**
+     * 读取缓存
+     * @returns {Promise<Uint8Array|undefined>} 不存在时为undefined
+     */
+    get(key) {
+        return this.transaction('readonly', store => store.get(key));
+    }
+
+    delete(key) {
+        return this.transaction('readwrite', store => store.delete(key));
+    }
+
+    /**
+     * 文件对应的缓存key：内容变化（大小或修改时间不同）时自然失效
+     * @param {File} file
+     */
+    static keyForFile(file) {
+        return `${file.name}:${file.size}:${file.lastModified}`;
+    }
+}
@@ -12,6 +12,16 @@
  */
 
 export class MeshScissor {
+    // 设置后 mergeVertices / cutAlongEdges 在WASM中完成（topology_repair.cpp）
+    static wasmModule = null;
+    
+    /**
+     * @param {Object} wasmModule - BFFModule实例（传入null关闭）
+     */
+    static setWasmModule(wasmModule) {
+        this.wasmModule = wasmModule;
+    }
+    
     constructor() {
         this.originalVertices = [];
         this.originalFaces = [];
@@ -199,6 +209,10 @@ export class MeshScissor {
         const { vertices, faces } = mesh;
         const n = vertices.length;
         
+        if (this.wasmModule && n > 0) {
+            return this.mergeVerticesNative(mesh, tolerance);
+        }
+        
         // 使用空间哈希加速查找
         const cellSize = tolerance * 10;
         const spatialHash = new Map();
@@ -290,6 +304,43 @@ export class MeshScissor {
         };
     }
     
+    /**
+     * mergeVertices的WASM路径：空间哈希焊接在WASM中完成，vertexMap为Int32Array（旧索引 -> 新索引）
+     * 顶点并入容差内编号最小的已保留顶点
+     */
+    static mergeVerticesNative(mesh, tolerance) {
+        const { vertices, faces } = mesh;
+        const n = vertices.length;
+        const positions = new Float64Array(n * 3);
+        for (let i = 0; i < n; i++) {
+            positions[i * 3] = vertices[i].x;
+            positions[i * 3 + 1] = vertices[i].y;
+            positions[i * 3 + 2] = vertices[i].z;
+        }
+        const { remap, source } = this.wasmModule.weldVertices(positions, tolerance);
+        
+        const newVertices = Array.from(source, i => ({ ...vertices[i] }));
+        const validFaces = [];
+        for (const face of faces) {
+            const newFace = face.map(v => remap[v]);
+            const degenerate = newFace.length === 3
+                ? newFace[0] === newFace[1] || newFace[1] === newFace[2] || newFace[2] === newFace[0]
+                : new Set(newFace).size < 3;
+            if (!degenerate) validFaces.push(newFace);
+        }
+        
+        const mergedCount = n - source.length;
+        console.log(`焊接完成(WASM): ${n} -> ${source.length} 顶点（合并了 ${mergedCount} 个重复顶点）`);
+        console.log(`面数: ${faces.length} -> ${validFaces.length}`);
+        
+        return {
+            vertices: newVertices,
+            faces: validFaces,
+            vertexMap: remap,
+            mergedCount: mergedCount
+        };
+    }
+    
     /**
      * 静态方法：沿边切割网格（不分离组件）
      * 用于内部红线切割，只做顶点分裂，不分离成多个子网格
@@ -307,6 +358,11 @@ export class MeshScissor {
         
         const { vertices, faces } = mesh;
         
+        if (this.wasmModule && faces.every(face => face.length === 3)) {
+            const result = this.cutAlongEdgesNative(mesh, seamEdges);
+            if (result) return result;
+        }
+        
         // 构建边到面的映射
         const edgeToFaces = new Map();
         for (let faceIdx = 0; faceIdx < faces.length; faceIdx++) {
@@ -430,6 +486,45 @@ export class MeshScissor {
         };
     }
     
+    /**
+     * cutAlongEdges的WASM路径（三角网格），面组和顶点副本的规则及编号与JS路径相同
+     * @returns {Object|null} 同cutAlongEdges，索引越界时为null
+     */
+    static cutAlongEdgesNative(mesh, seamEdges) {
+        const { vertices, faces } = mesh;
+        const flat = new Int32Array(faces.length * 3);
+        faces.forEach((face, i) => {
+            flat[i * 3] = face[0];
+            flat[i * 3 + 1] = face[1];
+            flat[i * 3 + 2] = face[2];
+        });
+        const pairs = new Int32Array(seamEdges.size * 2);
+        let k = 0;
+        for (const edgeKey of seamEdges) {
+            const sep = edgeKey.indexOf('_');
+            pairs[k++] = Number(edgeKey.slice(0, sep));
+            pairs[k++] = Number(edgeKey.slice(sep + 1));
+        }
+        
+        const result = this.wasmModule.cutMeshAlongEdges(flat, vertices.length, pairs);
+        if (!result) return null;
+        const { vertexSource } = result;
+        const newFaces = [];
+        for (let i = 0; i < result.faces.length; i += 3) {
+            newFaces.push([result.faces[i], result.faces[i + 1], result.faces[i + 2]]);
+        }
+        const localToGlobal = Array.from(vertexSource, v => mesh.localToGlobal ? mesh.localToGlobal[v] : v);
+        console.log(`  顶点(WASM): ${vertices.length} -> ${vertexSource.length} (分裂了 ${vertexSource.length - vertices.length} 个)`);
+        
+        return {
+            vertices: Array.from(vertexSource, v => ({ ...vertices[v] })),
+            faces: newFaces,
+            localToGlobal: localToGlobal,
+            globalToLocal: mesh.globalToLocal,
+            originalFaceIndices: mesh.originalFaceIndices
+        };
+    }
+    
     /**
      * 主函数：物理切割网格
      * @param {Object} mesh - 原始网格 {vertices, faces}
@@ -54,6 +54,68 @@ export class OBJParser {
             }
         }
         
+        return this.buildResult();
+    }
+    
+    /**
+     * 由 OBJStreamReader.getMesh() 的扁平数组构建与parse相同格式的网格数据，不经过文本
+     * 读取时须关闭顶点合并（dedupVertices: false），顶点编号才与文件一致
+     * 同一f行扇形三角化得到的三角形还原为原来的多边形面（有三角形被剔除时保留为三角形）
+     * @param {Object} mesh - { positions, colors, texcoords, normals, triangles, trianglePolygons }
+     * @returns {Object} 同parse
+     */
+    fromStreamMesh(mesh) {
+        const { positions, colors, texcoords, normals, triangles, trianglePolygons } = mesh;
+        this.vertices = [];
+        this.vertexColors = [];
+        this.normals = [];
+        this.uvs = [];
+        this.faces = [];
+        this.edges = new Map();
+        this.hasVertexColors = !!colors;
+        
+        for (let i = 0; i < positions.length / 3; i++) {
+            this.vertices.push({ x: positions[i * 3], y: positions[i * 3 + 1], z: positions[i * 3 + 2] });
+            this.vertexColors.push(colors
+                ? { r: colors[i * 3], g: colors[i * 3 + 1], b: colors[i * 3 + 2] }
+                : { r: 1, g: 1, b: 1 });
+        }
+        for (let i = 0; i < normals.length / 3; i++) {
+            this.normals.push({ x: normals[i * 3], y: normals[i * 3 + 1], z: normals[i * 3 + 2] });
+        }
+        for (let i = 0; i < texcoords.length / 2; i++) {
+            this.uvs.push({ u: texcoords[i * 2], v: texcoords[i * 2 + 1] });
+        }
+        
+        const numTriangles = triangles.length / 3;
+        for (let start = 0; start < numTriangles;) {
+            let end = start + 1;
+            while (end < numTriangles && trianglePolygons[end] === trianglePolygons[start]) end++;
+            
+            // 扇形 (0, k, k+1)：后一个三角形从前一个的最后一条边继续
+            const face = [triangles[start * 3], triangles[start * 3 + 1], triangles[start * 3 + 2]];
+            let isFan = true;
+            for (let t = start + 1; t < end && isFan; t++) {
+                isFan = triangles[t * 3] === face[0] && triangles[t * 3 + 1] === face[face.length - 1];
+                face.push(triangles[t * 3 + 2]);
+            }
+            if (isFan) {
+                this.faces.push(face);
+            } else {
+                for (let t = start; t < end; t++) {
+                    this.faces.push([triangles[t * 3], triangles[t * 3 + 1], triangles[t * 3 + 2]]);
+                }
+            }
+            start = end;
+        }
+        
+        return this.buildResult();
+    }
+    
+    /**
+     * 由解析出的顶点和面构建边、邻接关系和返回结果
+     */
+    buildResult() {
         // 构建边数据
         this.buildEdges();
         
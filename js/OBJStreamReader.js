@@ -0,0 +1,110 @@
+/**
+ * OBJ流式读取器 - OBJParser.js 的WASM版本
+ *
+ * 文件按块读入WASM内存解析，不生成整文件字符串和逐顶点对象，
+ * 结果是扁平的TypedArray，可直接设置给BFF展开器（大型扫描模型不会耗尽标签页内存）
+ * 多边形按扇形三角化，坐标完全相同的顶点默认合并
+ */
+
+export class OBJStreamReader {
+    /**
+     * @param {Object} wasmModule - 已初始化的BFFModule实例
+     * @param {Object} options
+     * @param {boolean} options.dedupVertices - 合并坐标完全相同的顶点
+     * @param {number} options.chunkSize - 每次写入WASM内存的字节数
+     */
+    constructor(wasmModule, { dedupVertices = true, chunkSize = 4 << 20 } = {}) {
+        this.wasmModule = wasmModule;
+        this.chunkSize = chunkSize;
+        this.handle = wasmModule.createObjReader(dedupVertices);
+        this.info = null;
+    }
+
+    /**
+     * 读取OBJ
+     * @param {File|Blob|ArrayBuffer|Uint8Array|ReadableStream} source - 文件或字节流
+     * @param {Function} onProgress - (已读字节, 总字节)，总字节未知时为0
+     * @returns {Promise<Object>} { vertices, triangles, polygons, skippedFaces,
+     *                              hasVertexColors, hasTexcoords, hasNormals }
+     */
+    async read(source, onProgress = null) {
+        const total = source.size ?? source.byteLength ?? 0;
+        let loaded = 0;
+
+        const feed = (bytes) => {
+            for (let offset = 0; offset < bytes.length; offset += this.chunkSize) {
+                const piece = bytes.subarray(offset, Math.min(bytes.length, offset + this.chunkSize));
+                // 暂存区视图取得后立即写入：解析中的内存增长会使视图失效
+                this.wasmModule.getObjChunkView(this.handle, piece.length).set(piece);
+                this.wasmModule.objReaderFeed(this.handle, piece.length);
+            }
+            loaded += bytes.length;
+            if (onProgress) onProgress(loaded, total);
+        };
+
+        if (source instanceof ArrayBuffer) {
+            feed(new Uint8Array(source));
+        } else if (ArrayBuffer.isView(source)) {
+            feed(new Uint8Array(source.buffer, source.byteOffset, source.byteLength));
+        } else {
+            const stream = typeof source.stream === 'function' ? source.stream() : source;
+            const reader = stream.getReader();
+            for (;;) {
+                const { done, value } = await reader.read();
+                if (done) break;
+                feed(value);
+            }
+        }
+
+        if (!this.wasmModule.objReaderFinish(this.handle)) {
+            throw new Error(this.wasmModule.getObjError(this.handle));
+        }
+        this.info = this.wasmModule.getObjInfo(this.handle);
+        return this.info;
+    }
+
+    /**
+     * 把网格直接设置给展开器（不经过JS数组）
+     * @param {BFFFlattener|number} flattener - BFFFlattener实例或WASM展开器句柄
+     */
+    loadInto(flattener) {
+        const handle = typeof flattener === 'number' ? flattener : flattener.handle;
+        if (!this.wasmModule.objReaderLoadInto(this.handle, handle)) {
+            throw new Error('Failed to load OBJ mesh into flattener');
+        }
+    }
+
+    /**
+     * 网格数据副本（渲染和缝线提取使用）
+     * @returns {Object} { positions: Float64Array [x,y,z,...], triangles: Int32Array [a,b,c,...],
+     *                     colors: Float32Array|null, texcoords, normals, triangleTexcoords,
+     *                     triangleNormals, trianglePolygons, vertexRemap }
+     *          vertexRemap为文件中的顶点 -> 合并后顶点，按原文件顶点编号的缝线需先经它转换
+     */
+    getMesh() {
+        const m = this.wasmModule;
+        const h = this.handle;
+        const info = this.info || m.getObjInfo(h);
+        return {
+            positions: m.getObjPositionsView(h).slice(),
+            triangles: m.getObjTrianglesView(h).slice(),
+            colors: info.hasVertexColors ? m.getObjColorsView(h).slice() : null,
+            texcoords: m.getObjTexcoordsView(h).slice(),
+            normals: m.getObjNormalsView(h).slice(),
+            triangleTexcoords: info.hasTexcoords ? m.getObjTriangleTexcoordsView(h).slice() : null,
+            triangleNormals: info.hasNormals ? m.getObjTriangleNormalsView(h).slice() : null,
+            trianglePolygons: m.getObjTrianglePolygonsView(h).slice(),
+            vertexRemap: m.getObjVertexRemapView(h).slice()
+        };
+    }
+
+    /**
+     * 释放WASM内存中的读取结果
+     */
+    dispose() {
+        if (this.handle >= 0) {
+            this.wasmModule.destroyObjReader(this.handle);
+            this.handle = -1;
+        }
+    }
+}
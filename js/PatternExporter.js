@@ -0,0 +1,122 @@
+/**
+ * 纸样导出（SVG / DXF，原生实现见 wasm/src/pattern_export.cpp）
+ *
+ * 片段边界首尾相接成闭合折线，可选输出内部网格边；输出逐块写入WritableStream
+ * （showSaveFilePicker().createWritable() 或 PatternExporter.blobSink()），整个文件不拼成一个字符串
+ * 未设置WASM模块时各导出方法返回null；每次导出占用一个WASM导出句柄，多个导出可同时进行
+ */
+
+export class PatternExporter {
+    constructor() {
+        this.wasmModule = null;
+    }
+
+    /**
+     * @param {Object} wasmModule - BFFModule实例（传入null关闭）
+     */
+    setWasmModule(wasmModule) {
+        this.wasmModule = wasmModule;
+    }
+
+    get isAvailable() {
+        return !!this.wasmModule;
+    }
+
+    /**
+     * 导出展开结果中的各片段
+     * @param {Array<Object>} pieces - flattenedData.pieces：{ localFaces, uv }
+     * @param {WritableStream} writable
+     * @param {Object} options - { format: 'svg' | 'dxf', interior, scale, padding（<0自动）, chunkSize }
+     * @returns {Promise<Object|null>} { loops, bytes }
+     */
+    async exportPieces(pieces, writable, options = {}) {
+        if (!this.wasmModule || !pieces || pieces.length === 0) return null;
+
+        // 多边形按扇形三角化；内部边只在两侧三角形都存在时输出，扇形的对角线也会计入内部边
+        let numUVs = 0, numTris = 0;
+        for (const piece of pieces) {
+            numUVs += piece.uv.length;
+            for (const face of piece.localFaces) numTris += Math.max(face.length - 2, 0);
+        }
+        const uvs = new Float64Array(numUVs * 2);
+        const tris = new Int32Array(numTris * 3);
+        const triPieces = new Int32Array(numTris);
+
+        let base = 0, t = 0;
+        pieces.forEach((piece, p) => {
+            const { localFaces, uv } = piece;
+            for (let i = 0; i < uv.length; i++) {
+                uvs[(base + i) * 2] = uv[i].u;
+                uvs[(base + i) * 2 + 1] = uv[i].v;
+            }
+            for (const face of localFaces) {
+                for (let k = 1; k + 1 < face.length; k++) {
+                    tris[t * 3] = base + face[0];
+                    tris[t * 3 + 1] = base + face[k];
+                    tris[t * 3 + 2] = base + face[k + 1];
+                    triPieces[t] = p;
+                    t++;
+                }
+            }
+            base += uv.length;
+        });
+        if (numTris === 0) return null;
+
+        const job = this.wasmModule.createPatternExport();
+        const loops = this.wasmModule.beginPatternExportFrom(job, uvs, tris, triPieces, options);
+        return this.stream(writable, job, loops);
+    }
+
+    /**
+     * 导出BFFFlattener（WASM句柄）的当前结果，已排料时用排料后的UV
+     * @returns {Promise<Object|null>} { loops, bytes }
+     */
+    async exportFlattener(handle, writable, options = {}) {
+        if (!this.wasmModule) return null;
+        const job = this.wasmModule.createPatternExport();
+        const loops = this.wasmModule.beginPatternExport(job, handle, options);
+        return this.stream(writable, job, loops);
+    }
+
+    /**
+     * 逐块写入并释放导出句柄；视图在下一次nextPatternExportChunk前有效，写入前复制
+     * loops < 0（输入无效）时不写入并返回null；写入失败时中止writable并抛出
+     */
+    async stream(writable, job, loops) {
+        if (loops < 0) {
+            this.wasmModule.destroyPatternExport(job);
+            return null;
+        }
+        const writer = writable.getWriter();
+        let bytes = 0;
+        try {
+            let view;
+            while ((view = this.wasmModule.nextPatternExportChunk(job)) !== null) {
+                bytes += view.length;
+                await writer.write(view.slice());
+            }
+            await writer.close();
+        } catch (error) {
+            await writer.abort(error).catch(() => {});
+            throw error;
+        } finally {
+            // 释放WASM中的副本（中途失败时一并丢弃剩余输出）
+            this.wasmModule.destroyPatternExport(job);
+        }
+        return { loops, bytes };
+    }
+
+    /**
+     * 没有文件系统访问API时的写入目标：各块收集为Blob，close后由 blob() 取得
+     */
+    static blobSink(type) {
+        const parts = [];
+        let resolveBlob;
+        const blob = new Promise(resolve => { resolveBlob = resolve; });
+        const writable = new WritableStream({
+            write(chunk) { parts.push(chunk); },
+            close() { resolveBlob(new Blob(parts, { type })); }
+        });
+        return { writable, blob: () => blob };
+    }
+}
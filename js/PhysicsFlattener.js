@@ -16,6 +16,11 @@
  * 边界自由度:
  *   - 不固定边界点（只钉中心一点防漂移）
  *   - 效果：直硬的切口线会自动弯曲形成物理弧度
+ * 
+ * WASM加速:
+ *   - setWasmModule() 后使用原生XPBD求解器（physics_solver.cpp），
+ *     刚度设置相同，每步约束投影代替显式欧拉弹簧力，少量步数即可收敛
+ *   - 所有步数在WASM内一次执行完，JS不逐步参与
  */
 
 import * as THREE from 'three';
@@ -24,6 +29,20 @@ class PhysicsFlattener {
     constructor() {
         this.iterations = 200;
         this.debug = false;
+        this.wasmModule = null;
+        this.wasmHandle = -1;
+    }
+    
+    /**
+     * 使用WASM模块中的原生求解器（传入null恢复纯JS实现）
+     * @param {Object} wasmModule - BFFModule实例
+     */
+    setWasmModule(wasmModule) {
+        if (this.wasmModule && this.wasmHandle >= 0) {
+            this.wasmModule.destroyPhysicsSolver(this.wasmHandle);
+        }
+        this.wasmModule = wasmModule;
+        this.wasmHandle = wasmModule ? wasmModule.createPhysicsSolver() : -1;
     }
     
     /**
@@ -51,6 +70,12 @@ class PhysicsFlattener {
             return initialUV || this.createFallbackUVs(vertexCount);
         }
         
+        if (this.wasmModule) {
+            return this.relaxNative(subMesh, initialUV, {
+                iterations, boundaryStiffness, internalStiffness, pinBoundary
+            });
+        }
+        
         // 转换初始UV为Float32Array
         const currentUVs = new Float32Array(vertexCount * 2);
         for (let i = 0; i < vertexCount; i++) {
@@ -129,6 +154,67 @@ class PhysicsFlattener {
         return uvs;
     }
     
+    /**
+     * 原生XPBD松弛：iterations为最大步数，收敛时提前结束
+     */
+    relaxNative(subMesh, initialUV, options) {
+        const { vertices, faces } = subMesh;
+        const vertexCount = vertices.length;
+        const module = this.wasmModule;
+        const handle = this.wasmHandle;
+        
+        const positions = new Float64Array(vertexCount * 3);
+        for (let i = 0; i < vertexCount; i++) {
+            positions[i * 3] = vertices[i].x;
+            positions[i * 3 + 1] = vertices[i].y;
+            positions[i * 3 + 2] = vertices[i].z;
+        }
+        
+        // 多边形面按扇形三角化
+        const triangles = [];
+        for (const face of faces) {
+            if (!face) continue;
+            for (let j = 1; j + 1 < face.length; j++) {
+                triangles.push(face[0], face[j], face[j + 1]);
+            }
+        }
+        
+        const startTime = Date.now();
+        if (!module.physicsSetup(handle, positions, Int32Array.from(triangles), options)) {
+            console.warn('PhysicsFlattener: WASM求解器输入无效，使用JS实现');
+            const wasm = this.wasmModule;
+            this.wasmModule = null;
+            try {
+                return this.relaxDifferentiated(subMesh, initialUV, options);
+            } finally {
+                this.wasmModule = wasm;
+            }
+        }
+        
+        const uvIn = new Float64Array(vertexCount * 2);
+        for (let i = 0; i < vertexCount; i++) {
+            uvIn[i * 2] = initialUV[i]?.u || 0;
+            uvIn[i * 2 + 1] = initialUV[i]?.v || 0;
+        }
+        if (!module.physicsSetUVs(handle, uvIn)) {
+            throw new Error('PhysicsFlattener: 初始UV数量与顶点数不符');
+        }
+        
+        const steps = module.physicsStep(handle, options.iterations);
+        const stats = module.getPhysicsStats(handle);
+        console.log(`  PhysicsFlattener (WASM XPBD): ${stats.constraints} 条约束, ` +
+                    `边界 ${stats.boundaryConstraints} 条, ${steps} 步` +
+                    `${stats.converged ? '（已收敛）' : ''}, ${Date.now() - startTime}ms`);
+        
+        // 读取期间不调用其它WASM函数
+        const view = module.getPhysicsUVsView(handle);
+        const uvs = [];
+        for (let i = 0; i < vertexCount; i++) {
+            uvs.push({ u: view[i * 2], v: view[i * 2 + 1] });
+        }
+        return uvs;
+    }
+    
     /**
      * 识别边界顶点和边界边
      */
@@ -31,6 +31,10 @@ export class Renderer2D {
         this.flattenedData = null;
         this.seamData = null;
         
+        // 畸变热图（DistortionMetrics.compute的结果），mode为 'conformal' | 'area'
+        this.distortion = null;
+        this.distortionMode = null;
+        
         // 选中的UV岛
         this.selectedIsland = -1;
         this.onIslandSelected = null;  // 选中回调
@@ -194,6 +198,7 @@ export class Renderer2D {
             bounds: flattenedData.bounds
         } : null);
         
+        if (flattenedData !== this.flattenedData) this.distortion = null;  // 指标属于上一次的结果
         this.flattenedData = flattenedData;
         this.seamData = seamData;
         
@@ -315,15 +320,17 @@ export class Renderer2D {
             
             // 绘制面（对于大模型，只绘制边界或简化）
             const maxFacesToDraw = 10000; // 限制绘制的面数
-            const facesToDraw = localFaces.length > maxFacesToDraw 
-                ? localFaces.filter((_, i) => i % Math.ceil(localFaces.length / maxFacesToDraw) === 0)
-                : localFaces;
+            const step = localFaces.length > maxFacesToDraw
+                ? Math.ceil(localFaces.length / maxFacesToDraw)
+                : 1;
+            const heatOffset = this.distortion ? this.distortion.pieceOffsets[pieceIndex] : -1;
             
-            facesToDraw.forEach(face => {
-                if (!face || face.length < 3) return;
+            for (let faceIndex = 0; faceIndex < localFaces.length; faceIndex += step) {
+                const face = localFaces[faceIndex];
+                if (!face || face.length < 3) continue;
                 
                 const firstPoint = uv[face[0]];
-                if (!firstPoint) return;
+                if (!firstPoint) continue;
                 
                 this.ctx.beginPath();
                 
@@ -345,7 +352,10 @@ export class Renderer2D {
                 // 拓扑错误的用红色系，正常的用蓝绿色系
                 let fillColor, strokeColor;
                 
-                if (hasTopologyError) {
+                if (heatOffset >= 0) {
+                    fillColor = this.distortionColor(heatOffset + faceIndex);
+                    strokeColor = isSelected ? '#ffffff' : fillColor;
+                } else if (hasTopologyError) {
                     // 拓扑错误 - 红色/橙色，提示需要补刀
                     if (isSelected) {
                         fillColor = 'rgba(255, 60, 60, 0.6)';
@@ -372,7 +382,7 @@ export class Renderer2D {
                 this.ctx.strokeStyle = strokeColor;
                 this.ctx.lineWidth = isSelected ? 1.5 : 0.5;
                 this.ctx.stroke();
-            });
+            }
             
             // 绘制UV岛标签
             this.drawIslandLabel(piece, pieceIndex, isSelected, hasTopologyError);
@@ -527,6 +537,34 @@ export class Renderer2D {
         }
     }
     
+    /**
+     * 设置畸变热图
+     * @param {Object|null} metrics - DistortionMetrics.compute 的结果，null关闭热图
+     * @param {string} mode - 'conformal'（1为绿，>=2为红）| 'area'（压缩为蓝，拉伸为红）
+     */
+    setDistortionOverlay(metrics, mode = 'conformal') {
+        this.distortion = metrics;
+        this.distortionMode = mode;
+        this.redraw();
+    }
+    
+    /**
+     * 热图中第index个面的颜色，翻转的面为品红
+     */
+    distortionColor(index) {
+        const d = this.distortion;
+        if (d.flipped[index]) return 'rgba(255, 0, 255, 0.85)';
+        
+        if (this.distortionMode === 'area') {
+            // log2面积比，±1（2倍）时饱和
+            const t = Math.max(-1, Math.min(1, d.area[index]));
+            const hue = t < 0 ? 220 : 0;
+            return `hsla(${hue}, ${Math.round(Math.abs(t) * 90)}%, 50%, 0.7)`;
+        }
+        const t = Math.max(0, Math.min(1, d.conformal[index] - 1));
+        return `hsla(${Math.round(120 * (1 - t))}, 85%, 50%, 0.7)`;
+    }
+    
     /**
      * 设置缝线颜色
      */
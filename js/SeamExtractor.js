@@ -5,6 +5,10 @@
  * 1. DBSCAN 聚类：距离超过 epsilon 的点绝对禁止连接
  * 2. 组内连线：只在每个 Group 内部使用最近邻连接
  * 3. 直接使用网格边：红点之间如果有网格边，直接作为缝线
+ *
+ * WASM加速:
+ *   - setWasmModule() 后聚类和最近邻排序使用原生k-d树（spatial_index.cpp），
+ *     邻域查询不再两两比较所有红点，结果与JS实现相同
  */
 
 export class SeamExtractor {
@@ -13,7 +17,17 @@ export class SeamExtractor {
         this.redVertices = [];      // 红色顶点索引
         this.seamPaths = [];        // 连接后的缝线路径
         this.seamEdges = new Set(); // 缝线边集合（只包含真实网格边）
+        this.seamEdgePairs = new Int32Array(0); // 同一组边的整数对 [a0,b0, ...]（a<b）
         this.modelSize = 1.0;
+        this.wasmModule = null;
+    }
+    
+    /**
+     * 使用WASM模块中的原生空间索引（传入null恢复纯JS实现）
+     * @param {Object} wasmModule - BFFModule实例
+     */
+    setWasmModule(wasmModule) {
+        this.wasmModule = wasmModule;
     }
     
     /**
@@ -30,6 +44,7 @@ export class SeamExtractor {
         this.redVertices = [];
         this.seamPaths = [];
         this.seamEdges.clear();
+        this.seamEdgePairs = new Int32Array(0);
     }
     
     /**
@@ -157,6 +172,20 @@ export class SeamExtractor {
      * DBSCAN 聚类
      */
     dbscanCluster(eps) {
+        if (this.wasmModule) {
+            const { offsets, members } = this.wasmModule.clusterSeamPoints(
+                this.packPositions(this.redVertices), eps);
+            const clusters = [];
+            for (let i = 0; i + 1 < offsets.length; i++) {
+                const cluster = [];
+                for (let k = offsets[i]; k < offsets[i + 1]; k++) {
+                    cluster.push(this.redVertices[members[k]]);
+                }
+                clusters.push(cluster);
+            }
+            return clusters;
+        }
+        
         const vertices = this.meshData.vertices;
         const visited = new Set();
         const clusters = [];
@@ -201,6 +230,9 @@ export class SeamExtractor {
      */
     extractRedEdges(redSet) {
         const faces = this.meshData.faces;
+        const vertexCount = this.meshData.vertices.length;
+        const seen = new Set();     // 整数key去重，每条边只生成一次字符串key
+        const pairs = [];
         
         for (const face of faces) {
             for (let i = 0; i < face.length; i++) {
@@ -209,11 +241,17 @@ export class SeamExtractor {
                 
                 // 两端都是红点 -> 这是一条缝线边
                 if (redSet.has(v1) && redSet.has(v2)) {
-                    const edgeKey = v1 < v2 ? `${v1}_${v2}` : `${v2}_${v1}`;
-                    this.seamEdges.add(edgeKey);
+                    const a = Math.min(v1, v2);
+                    const b = Math.max(v1, v2);
+                    const key = a * vertexCount + b;
+                    if (seen.has(key)) continue;
+                    seen.add(key);
+                    pairs.push(a, b);
+                    this.seamEdges.add(`${a}_${b}`);
                 }
             }
         }
+        this.seamEdgePairs = new Int32Array(pairs);
     }
     
     /**
@@ -222,6 +260,11 @@ export class SeamExtractor {
     orderByNearestNeighbor(vertexIndices) {
         if (vertexIndices.length <= 2) return [...vertexIndices];
         
+        if (this.wasmModule) {
+            const order = this.wasmModule.orderSeamPath(this.packPositions(vertexIndices));
+            return Array.from(order, k => vertexIndices[k]);
+        }
+        
         const vertices = this.meshData.vertices;
         const remaining = new Set(vertexIndices);
         const result = [];
@@ -256,6 +299,21 @@ export class SeamExtractor {
         return result;
     }
     
+    /**
+     * 顶点坐标打包为 Float64Array [x,y,z,...]（原生聚类的输入）
+     */
+    packPositions(vertexIndices) {
+        const vertices = this.meshData.vertices;
+        const positions = new Float64Array(vertexIndices.length * 3);
+        for (let i = 0; i < vertexIndices.length; i++) {
+            const v = vertices[vertexIndices[i]];
+            positions[i * 3] = v.x;
+            positions[i * 3 + 1] = v.y;
+            positions[i * 3 + 2] = v.z;
+        }
+        return positions;
+    }
+    
     /**
      * 计算欧氏距离
      */
@@ -327,6 +385,13 @@ export class SeamExtractor {
     getSeamEdgeSet() {
         return this.seamEdges;
     }
+    
+    /**
+     * 获取缝线边整数对 [a0,b0, ...]（用于WASM泛洪分割）
+     */
+    getSeamEdgePairs() {
+        return this.seamEdgePairs;
+    }
 
     /**
      * 构建邻接表
@@ -20,6 +20,7 @@ export class SeamProcessor {
         this.seams = [];
         this.seamEdges.clear();
         this.cutEdges.clear();
+        this.meshEdges = this.buildMeshEdges(meshData);
         
         // 支持多种JSON格式
         let seams = seamData.seams || seamData.cuts || seamData;
@@ -118,15 +119,37 @@ export class SeamProcessor {
     }
     
     /**
-     * 验证边是否有效
+     * 网格的边键集合，没有面数据时为null
+     */
+    buildMeshEdges(meshData) {
+        if (!meshData || !meshData.faces) return null;
+        const edges = new Set();
+        meshData.faces.forEach(face => {
+            for (let i = 0; i < face.length; i++) {
+                edges.add(this.getEdgeKey(face[i], face[(i + 1) % face.length]));
+            }
+        });
+        return edges;
+    }
+    
+    /**
+     * 验证边是否有效：越界或首尾相同时返回false；两端不相邻时告警并返回false
+     * （与命令行工具的 seam_json.cpp 报同样的错误）
      */
     isValidEdge(v1, v2, meshData) {
         if (v1 === undefined || v2 === undefined) return false;
         if (v1 === v2) return false;
         if (!meshData || !meshData.vertices) return true;
         
-        return v1 >= 0 && v1 < meshData.vertices.length &&
-               v2 >= 0 && v2 < meshData.vertices.length;
+        if (!(v1 >= 0 && v1 < meshData.vertices.length &&
+              v2 >= 0 && v2 < meshData.vertices.length)) {
+            return false;
+        }
+        if (this.meshEdges && !this.meshEdges.has(this.getEdgeKey(v1, v2))) {
+            console.warn(`Seam edge ${v1}-${v2} is not an edge of the mesh`);
+            return false;
+        }
+        return true;
     }
     
     /**
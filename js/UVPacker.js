@@ -0,0 +1,77 @@
+/**
+ * UV排料（原生实现见 wasm/src/uv_packer.cpp）
+ *
+ * 把各片段放进定宽条带（布料幅宽），skyline算法，可旋转90度；
+ * 每个片段得到一个变换 u' = R(rotation) * (scale * u) + t
+ * 未设置WASM模块时 pack() 返回null，调用方沿用原有的行排列
+ */
+
+export class UVPacker {
+    constructor() {
+        this.wasmModule = null;
+    }
+
+    /**
+     * @param {Object} wasmModule - BFFModule实例（传入null关闭原生排料）
+     */
+    setWasmModule(wasmModule) {
+        this.wasmModule = wasmModule;
+    }
+
+    get isAvailable() {
+        return !!this.wasmModule;
+    }
+
+    /**
+     * 排列片段
+     * @param {Array<Array<{u, v}>>} islands - 每个片段的UV点（只用凸包，传边界点即可）
+     * @param {Object} options - stripWidth（<=0按总面积自动）/ spacing / allowRotation / alignToBounds
+     * @param {Array<number>} scales - 每个片段的预缩放，可省略
+     * @returns {Object|null} { transforms: [{scale, rotation, tx, ty}], width, height, utilization }
+     */
+    pack(islands, options = {}, scales = null) {
+        if (!this.wasmModule || islands.length === 0) return null;
+
+        let total = 0;
+        for (const island of islands) total += island.length;
+        const points = new Float64Array(total * 2);
+        const offsets = new Int32Array(islands.length + 1);
+        let p = 0;
+        islands.forEach((island, i) => {
+            for (const uv of island) {
+                points[p * 2] = uv.u;
+                points[p * 2 + 1] = uv.v;
+                p++;
+            }
+            offsets[i + 1] = p;
+        });
+
+        const packed = this.wasmModule.packUVIslands(points, offsets,
+            scales ? Float64Array.from(scales) : null, options);
+        if (!packed) return null;
+        return { ...packed, transforms: UVPacker.unpackTransforms(packed.transforms) };
+    }
+
+    /**
+     * Float64Array [scale, rotation, tx, ty, ...] -> [{scale, rotation, tx, ty}]
+     */
+    static unpackTransforms(flat) {
+        const transforms = [];
+        for (let i = 0; i + 3 < flat.length; i += 4) {
+            transforms.push({ scale: flat[i], rotation: flat[i + 1], tx: flat[i + 2], ty: flat[i + 3] });
+        }
+        return transforms;
+    }
+
+    /**
+     * 对UV原地应用变换
+     * @param {Object} t - { scale, rotation, tx, ty }
+     * @param {{u, v}} uv
+     */
+    static apply(t, uv) {
+        const c = Math.cos(t.rotation), s = Math.sin(t.rotation);
+        const u = uv.u, v = uv.v;
+        uv.u = t.scale * (c * u - s * v) + t.tx;
+        uv.v = t.scale * (s * u + c * v) + t.ty;
+    }
+}
@@ -0,0 +1,320 @@
+/**
+ * BFF展开 Web Worker
+ * 在独立线程中运行WASM展开器，展开大网格时主线程保持响应
+ *
+ * 由 BFFWorkerClient.js 创建（经典Worker，用importScripts加载Emscripten模块）
+ * 请求：{ id, type, ...参数 }，type见下方handlers
+ * 响应：{ id, type: 'result', data } / { id, type: 'error', message, cancelled }
+ * 进度：{ id, type: 'progress', done, total }（按片段计）
+ * 预览：{ id, type: 'preview', data }（flatten带preview时，格式同result）
+ */
+
+let wasm = null;
+const cancelled = new Set();      // 已请求取消的任务id（只记录排队中或执行中的任务）
+const pending = new Set();        // 排队中或执行中的任务id
+let queue = Promise.resolve();    // 任务按到达顺序串行执行，cancel消息立即处理
+
+function supportsWasmSimd() {
+    try {
+        // 只含一条 i8x16.splat 指令的最小模块
+        return WebAssembly.validate(new Uint8Array([
+            0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3,
+            2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+        ]));
+    } catch (e) {
+        return false;
+    }
+}
+
+// 让出事件循环以接收cancel消息（MessageChannel没有setTimeout的最小延迟）
+function yieldToEventLoop() {
+    return new Promise(resolve => {
+        const channel = new MessageChannel();
+        channel.port1.onmessage = () => {
+            channel.port1.close();
+            resolve();
+        };
+        channel.port2.postMessage(null);
+    });
+}
+
+function cancelError() {
+    const error = new Error('Flatten cancelled');
+    error.cancelled = true;
+    return error;
+}
+
+function getHandle(msg) {
+    if (!wasm) throw new Error('Worker not initialized');
+    return msg.handle;
+}
+
+// 展开结果：从WASM内存复制一次，随后作为Transferable移交主线程，不再复制
+function collectResult(h, float32) {
+    const uvs = float32
+        ? wasm.getUVCoordsF32View(h).slice()
+        : wasm.getUVCoordsView(h).slice();
+    const uvFaces = wasm.getUVFaces(h).slice();
+    const facePieces = wasm.getFacePieces(h).slice();
+    const vertexSource = wasm.getSplitVertexSource(h).slice();
+
+    return {
+        data: {
+            uvs,
+            uvFaces,
+            facePieces,
+            vertexSource,
+            pieceCount: wasm.getPieceCount(h),
+            stats: wasm.getFlattenStats(h)
+        },
+        transfer: [uvs.buffer, uvFaces.buffer, facePieces.buffer, vertexSource.buffer]
+    };
+}
+
+const handlers = {
+    async init(msg) {
+        if (!wasm) {
+            // 跨源隔离的页面可以使用SharedArrayBuffer，加载多线程版本（同样使用SIMD）
+            const simd = supportsWasmSimd();
+            const threads = simd && msg.threads !== false &&
+                self.crossOriginIsolated === true && typeof SharedArrayBuffer !== 'undefined';
+            const file = threads ? 'bff_wasm_mt.js' : simd ? 'bff_wasm.js' : 'bff_wasm_scalar.js';
+            importScripts(msg.baseUrl + file);
+            wasm = await BFFModule();
+            wasm.simd = simd;
+            wasm.threads = threads;
+        }
+        return { data: { simd: wasm.simd, threads: wasm.threads } };
+    },
+
+    create() {
+        if (!wasm) throw new Error('Worker not initialized');
+        return { data: { handle: wasm.createFlattener() } };
+    },
+
+    destroy(msg) {
+        wasm.destroyFlattener(getHandle(msg));
+        return { data: {} };
+    },
+
+    // vertices: Float64Array [x,y,z,...]，faces: Int32Array [a,b,c,...]
+    setMesh(msg) {
+        const h = getHandle(msg);
+        // 每个视图取得后立即填充：后续分配可能使之前的视图失效
+        wasm.getVertexUploadView(h, msg.vertices.length / 3).set(msg.vertices);
+        wasm.getFaceUploadView(h, msg.faces.length / 3).set(msg.faces);
+        if (!wasm.commitMesh(h)) {
+            throw new Error(wasm.getError(h));
+        }
+        const nonManifoldEdges = wasm.getNonManifoldEdges(h);
+        return { data: { nonManifoldEdges }, transfer: [nonManifoldEdges.buffer] };
+    },
+
+    // batch: Uint8Array，BatchCodec.encodeBatch的输出；options为原生选项（batchOptionsToNative）
+    // 不占用展开器句柄，与各展开器的网格无关；每次调用使用单独的批次句柄，结束即释放
+    flattenBatch(msg) {
+        if (!wasm) throw new Error('Worker not initialized');
+        const job = wasm.createBatchJob();
+        try {
+            wasm.getBatchUploadView(job, msg.batch.length).set(msg.batch);
+            const output = wasm.flattenBatch(job, msg.options || {});
+            if (!output) throw new Error(wasm.getBatchError(job));
+            const result = output.slice();
+            return { data: { result }, transfer: [result.buffer] };
+        } finally {
+            wasm.destroyBatchJob(job);
+        }
+    },
+
+    // 排料：flatten之后调用，返回排料后的UV和每个片段的变换 [scale, rotation, tx, ty, ...]
+    pack(msg) {
+        const h = getHandle(msg);
+        const packed = wasm.packIslands(h, msg.options || {});
+        if (!packed) throw new Error(wasm.getError(h));
+        const uvs = wasm.getPackedUVsView(h).slice();
+        return {
+            data: { ...packed, uvs },
+            transfer: [uvs.buffer, packed.transforms.buffer]
+        };
+    },
+
+    // ordering: 'original' | 'rcm' | 'morton'，下次setMesh / loadOBJ生效
+    setMeshOrdering(msg) {
+        const mode = { original: 0, rcm: 1, morton: 2 }[msg.ordering];
+        if (mode === undefined) throw new Error(`Unknown mesh ordering: ${msg.ordering}`);
+        wasm.setMeshOrdering(getHandle(msg), mode);
+        return { data: {} };
+    },
+
+    // file: File/Blob（结构化克隆不复制内容），在Worker内分块读取解析后直接设置为网格
+    // 返回渲染和缝线提取需要的扁平数组
+    async loadOBJ(msg) {
+        const h = getHandle(msg);
+        const reader = wasm.createObjReader(msg.dedupVertices !== false);
+        try {
+            const stream = msg.file.stream().getReader();
+            for (;;) {
+                const { done, value } = await stream.read();
+                if (done) break;
+                wasm.getObjChunkView(reader, value.length).set(value);
+                wasm.objReaderFeed(reader, value.length);
+            }
+            if (!wasm.objReaderFinish(reader)) {
+                throw new Error(wasm.getObjError(reader));
+            }
+            if (!wasm.objReaderLoadInto(reader, h)) {
+                throw new Error(wasm.getError(h));
+            }
+
+            const info = wasm.getObjInfo(reader);
+            const positions = wasm.getObjPositionsView(reader).slice();
+            const triangles = wasm.getObjTrianglesView(reader).slice();
+            const colors = info.hasVertexColors ? wasm.getObjColorsView(reader).slice() : null;
+            const vertexRemap = wasm.getObjVertexRemapView(reader).slice();
+            const nonManifoldEdges = wasm.getNonManifoldEdges(h);
+            const transfer = [positions.buffer, triangles.buffer, vertexRemap.buffer, nonManifoldEdges.buffer];
+            if (colors) transfer.push(colors.buffer);
+            return {
+                data: { info, positions, triangles, colors, vertexRemap, nonManifoldEdges },
+                transfer
+            };
+        } finally {
+            wasm.destroyObjReader(reader);
+        }
+    },
+
+    // 网格缓存（网格、拓扑、缝线、片段划分和UV），返回可存入IndexedDB的副本
+    saveCache(msg) {
+        const cache = wasm.saveCache(getHandle(msg)).slice();
+        return { data: { cache }, transfer: [cache.buffer] };
+    },
+
+    // cache: Uint8Array，saveCache的输出；hasUVs为true时可直接读取结果，无需flatten
+    loadCache(msg) {
+        const h = getHandle(msg);
+        wasm.getCacheUploadView(h, msg.cache.length).set(msg.cache);
+        if (!wasm.commitCache(h)) {
+            throw new Error(wasm.getError(h));
+        }
+        return { data: { hasUVs: wasm.getUVCount(h) > 0, pieceCount: wasm.getPieceCount(h) } };
+    },
+
+    // edges: Int32Array [a0,b0, a1,b1, ...]，替换原有缝线
+    setSeams(msg) {
+        const h = getHandle(msg);
+        wasm.setSeams(h, msg.edges);
+        return { data: {} };
+    },
+
+    // pins: Float64Array [uvIndex0,u0,v0, ...]，替换原有固定点
+    setPins(msg) {
+        const h = getHandle(msg);
+        wasm.clearPins(h);
+        const pins = msg.pins;
+        for (let i = 0; i + 2 < pins.length; i += 3) {
+            wasm.setPin(h, pins[i], pins[i + 1], pins[i + 2]);
+        }
+        return { data: {} };
+    },
+
+    async flatten(msg, id) {
+        const h = getHandle(msg);
+        const arap = msg.method === 'arap';
+        wasm.setFlattenMethod(h, arap ? 1 : 0);
+        if (arap) {
+            wasm.setARAPOptions(h, msg.iterations ?? 10, msg.options || {});
+            const initialUV = (msg.options && msg.options.initialUV) || [];
+            const uvArray = new Float64Array(initialUV.length * 2);
+            initialUV.forEach((uv, i) => {
+                uvArray[i * 2] = uv.u;
+                uvArray[i * 2 + 1] = uv.v;
+            });
+            wasm.setARAPInitialUV(h, uvArray);
+        }
+
+        // 先在粗网格上给出预览，再继续完整展开（预览结果作为迭代初值）
+        if (msg.preview) {
+            if (!wasm.flattenPreview(h, msg.targetVertices ?? 2000)) {
+                throw new Error(wasm.getError(h));
+            }
+            const preview = collectResult(h, msg.float32);
+            self.postMessage({ id, type: 'preview', data: preview.data }, preview.transfer);
+            await yieldToEventLoop();
+            if (cancelled.has(id)) throw cancelError();
+        }
+
+        if (!wasm.beginFlatten(h)) {
+            throw new Error(wasm.getError(h));
+        }
+
+        // 每批展开约一帧时间的片段，批次之间上报进度并检查取消
+        const total = wasm.getIslandCount(h);
+        let remaining = total;
+        while (remaining > 0) {
+            const start = performance.now();
+            do {
+                remaining = wasm.flattenStep(h, 1);
+            } while (remaining > 0 && performance.now() - start < 16);
+
+            self.postMessage({ id, type: 'progress', done: total - remaining, total });
+            if (remaining > 0) {
+                await yieldToEventLoop();
+                if (cancelled.has(id)) throw cancelError();
+            }
+        }
+
+        if (!wasm.finishFlatten(h)) {
+            throw new Error(wasm.getError(h));
+        }
+        return collectResult(h, msg.float32);
+    },
+
+    // 当前结果（loadCache恢复UV后无需flatten即可读取）
+    getResult(msg) {
+        return collectResult(getHandle(msg), msg.float32);
+    },
+
+    // 畸变指标（首次请求时计算），没有展开结果时data为null
+    getDistortion(msg) {
+        const metrics = wasm.getDistortion(getHandle(msg));
+        if (!metrics) return { data: null };
+        return {
+            data: metrics,
+            transfer: [metrics.conformal.buffer, metrics.area.buffer,
+                metrics.flipped.buffer, metrics.boundaryError.buffer]
+        };
+    }
+};
+
+self.onmessage = (event) => {
+    const msg = event.data;
+
+    // 取消：排队中的任务在开始前丢弃，执行中的flatten在下一批片段前中止
+    // 已结束或未知的任务不记录，否则集合在长时间会话中只增不减
+    if (msg.type === 'cancel') {
+        if (pending.has(msg.target)) cancelled.add(msg.target);
+        return;
+    }
+
+    const handler = handlers[msg.type];
+    pending.add(msg.id);
+    queue = queue.then(async () => {
+        const id = msg.id;
+        try {
+            if (!handler) throw new Error(`Unknown request: ${msg.type}`);
+            if (cancelled.has(id)) throw cancelError();
+            const { data, transfer } = await handler(msg, id);
+            self.postMessage({ id, type: 'result', data }, transfer || []);
+        } catch (e) {
+            self.postMessage({
+                id,
+                type: 'error',
+                message: e && e.message ? e.message : String(e),
+                cancelled: !!(e && e.cancelled)
+            });
+        } finally {
+            pending.delete(id);
+            cancelled.delete(id);
+        }
+    });
+};
@@ -22,6 +22,10 @@ import { MeshScissor } from './MeshScissor.js';
 import { ARAPFlattener } from './ARAPFlattener.js';
 import { TopologyRepair } from './TopologyRepair.js';
 import { FloodSegmenter } from './FloodSegmenter.js';  // 泛洪分割模块
+import { OBJStreamReader } from './OBJStreamReader.js';  // OBJ流式读取（WASM）
+import { UVPacker } from './UVPacker.js';  // 原生UV排料
+import { DistortionMetrics } from './DistortionMetrics.js';  // 原生畸变指标（热图）
+import { PatternExporter } from './PatternExporter.js';  // 原生纸样导出（SVG / DXF，分块写出）
 import { Renderer2D } from './Renderer2D.js';
 import { TubeUnroller, tubeUnroller } from './TubeUnroller.js';  // 滚筒展开模块
 import { PhysicsFlattener, physicsFlattener } from './PhysicsFlattener.js';  // 物理弹簧松弛模块
@@ -59,6 +63,7 @@ class ClothFlattenerApp {
         this.redVerticesSet = null;   // 红点集合
         this.barrierEdges = null;     // 泛洪围墙边
         this.pipelineStage = 0;       // 当前流程阶段: 0=未开始, 1=已分割, 2=已展开
+        this.partFlattenCache = new WeakMap();  // 部件 -> 展开结果，编辑缝线后未变化的部件直接复用
         
         // 模型数据
         this.mesh3D = null;
@@ -85,9 +90,13 @@ class ClothFlattenerApp {
             flattenMethod: 'lscm', // 默认使用LSCM算法
             autoExtractSeams: true,  // 自动从红色顶点提取缝线
             iterations: 50,  // ARAP迭代次数（增加到50以获得更好效果）
-            preserveRatio: true
+            preserveRatio: true,
+            distortionOverlay: 'none'  // 畸变热图：'none' | 'conformal' | 'area'
         };
         
+        // 畸变指标按展开结果缓存，只在热图打开时计算
+        this.distortionCache = { data: null, metrics: null };
+        
         // 初始化（使用Promise处理异步）
         this.init().catch(err => {
             console.error('初始化失败:', err);
@@ -121,8 +130,21 @@ class ClothFlattenerApp {
             this.arapFlattener = new ARAPFlattener();  // ARAP展开器
             this.seamExtractor = new SeamExtractor();
             this.meshScissor = new MeshScissor();  // 物理切割模块
+            this.uvPacker = new UVPacker();
+            this.distortionMetrics = new DistortionMetrics();
+            this.patternExporter = new PatternExporter();
             
             await this.bffFlattener.init();
+            if (this.bffFlattener.useWasm) {
+                physicsFlattener.setWasmModule(this.bffFlattener.wasmModule);
+                this.seamExtractor.setWasmModule(this.bffFlattener.wasmModule);
+                FloodSegmenter.setWasmModule(this.bffFlattener.wasmModule);
+                MeshScissor.setWasmModule(this.bffFlattener.wasmModule);
+                this.uvPacker.setWasmModule(this.bffFlattener.wasmModule);
+                this.distortionMetrics.setWasmModule(this.bffFlattener.wasmModule);
+                this.patternExporter.setWasmModule(this.bffFlattener.wasmModule);
+                this.lscmFlattener.setWasmModule(this.bffFlattener.wasmModule);
+            }
             console.log('展开器初始化完成');
             
             this.updateStatus('就绪 - 加载带红色标记的OBJ模型，按红线物理切割并展开');
@@ -419,6 +441,11 @@ class ClothFlattenerApp {
             }
         });
         
+        document.getElementById('distortion-overlay').addEventListener('change', (e) => {
+            this.settings.distortionOverlay = e.target.value;
+            this.updateDistortionOverlay();
+        });
+        
         document.getElementById('flatten-method').addEventListener('change', (e) => {
             this.settings.flattenMethod = e.target.value;
         });
@@ -443,6 +470,10 @@ class ClothFlattenerApp {
             this.exportSVG();
         });
         
+        document.getElementById('export-dxf-btn').addEventListener('click', () => {
+            this.exportPattern('dxf');
+        });
+        
         // 面板折叠
         document.getElementById('panel-toggle').addEventListener('click', () => {
             document.getElementById('side-panel').classList.toggle('collapsed');
@@ -473,12 +504,7 @@ class ClothFlattenerApp {
         
         try {
             console.log('开始读取文件内容...');
-            const text = await file.text();
-            console.log('文件内容长度:', text.length);
-            console.log('文件前100字符:', text.substring(0, 100));
-            
-            const parser = new OBJParser();
-            this.meshData = parser.parse(text);
+            this.meshData = await this.readOBJ(file);
             console.log('解析结果:', this.meshData.vertices.length, '顶点,', this.meshData.faces.length, '面');
             
             // 创建Three.js几何体
@@ -559,6 +585,29 @@ class ClothFlattenerApp {
         }
     }
     
+    /**
+     * 读取OBJ：WASM可用时按块流式读取（不生成整文件字符串和逐行数组），否则用OBJParser解析文本
+     * @returns {Promise<Object>} 同 OBJParser.parse
+     */
+    async readOBJ(file) {
+        const wasmModule = this.bffFlattener && this.bffFlattener.isWasmReady ? this.bffFlattener.wasmModule : null;
+        if (!wasmModule) {
+            const text = await file.text();
+            console.log('文件内容长度:', text.length);
+            return new OBJParser().parse(text);
+        }
+        
+        // 不合并顶点：保持文件中的顶点编号（缝线JSON按它索引）
+        const reader = new OBJStreamReader(wasmModule, { dedupVertices: false });
+        try {
+            const info = await reader.read(file);
+            console.log(`流式读取: ${file.size} 字节, ${info.polygons} 个面, 跳过 ${info.skippedFaces} 个`);
+            return new OBJParser().fromStreamMesh(reader.getMesh());
+        } finally {
+            reader.dispose();
+        }
+    }
+    
     /**
      * 加载缝线JSON文件
      */
@@ -870,6 +919,32 @@ class ClothFlattenerApp {
         }
     }
     
+    /**
+     * 按设置显示或关闭2D视图的畸变热图，指标只在首次显示某个展开结果时计算
+     */
+    updateDistortionOverlay() {
+        if (!this.renderer2D) return;
+        const mode = this.settings.distortionOverlay;
+        if (mode === 'none' || !this.flattenedData || !this.distortionMetrics?.isAvailable) {
+            this.renderer2D.setDistortionOverlay(null);
+            return;
+        }
+        
+        if (this.distortionCache.data !== this.flattenedData) {
+            this.distortionCache = {
+                data: this.flattenedData,
+                metrics: this.distortionMetrics.compute(this.flattenedData.pieces)
+            };
+        }
+        const metrics = this.distortionCache.metrics;
+        this.renderer2D.setDistortionOverlay(metrics, mode);
+        if (metrics) {
+            this.updateStatus(`畸变: 平均保角 ${metrics.meanConformal.toFixed(3)}，` +
+                `面积误差 ${metrics.meanAreaError.toFixed(3)}，翻转 ${metrics.flippedFaces} 面，` +
+                `边界长度误差 ${(metrics.maxBoundaryError * 100).toFixed(1)}%`);
+        }
+    }
+    
     /**
      * 更新缝线颜色
      */
@@ -1047,7 +1122,8 @@ class ClothFlattenerApp {
                 {
                     minFaces: FloodSegmenter.MIN_FACES,
                     assignBoundaryFaces: true,
-                    redVertices: this.redVerticesSet
+                    redVertices: this.redVerticesSet,
+                    seamEdgePairs: this.seamExtractor.getSeamEdgePairs()
                 }
             );
             this.segmentedParts = subMeshes;
@@ -1083,6 +1159,51 @@ class ClothFlattenerApp {
         }
     }
     
+    /**
+     * 【增量】编辑缝线边后重新分割和展开
+     * 只重新泛洪改动边附近的区域；面集合未变化的部件沿用原对象，展开结果从缓存复用，
+     * 只有拓扑变化的部件重新展开
+     * @param {Object} edits
+     * @param {Array<[number, number]>} edits.add - 新增的缝线边（焊接后网格的顶点编号）
+     * @param {Array<[number, number]>} edits.remove - 删除的缝线边
+     */
+    async editSeamEdges({ add = [], remove = [] } = {}) {
+        if (this.pipelineStage < 1 || !this.weldedMesh || !this.barrierEdges) {
+            this.updateStatus('请先完成部件分割');
+            return;
+        }
+        
+        const startTime = Date.now();
+        const edgeKey = (a, b) => a < b ? `${a}_${b}` : `${b}_${a}`;
+        for (const [a, b] of add) this.barrierEdges.add(edgeKey(a, b));
+        for (const [a, b] of remove) this.barrierEdges.delete(edgeKey(a, b));
+        
+        const pairs = new Int32Array(this.barrierEdges.size * 2);
+        let n = 0;
+        for (const key of this.barrierEdges) {
+            const sep = key.indexOf('_');
+            pairs[n++] = +key.slice(0, sep);
+            pairs[n++] = +key.slice(sep + 1);
+        }
+        
+        const wasFlattened = this.pipelineStage === 2;
+        this.segmentedParts = FloodSegmenter.segmentWithSeams(this.weldedMesh, this.barrierEdges, {
+            minFaces: FloodSegmenter.MIN_FACES,
+            assignBoundaryFaces: true,
+            redVertices: this.redVerticesSet,
+            seamEdgePairs: pairs,
+            previous: this.segmentedParts
+        });
+        this.pipelineStage = 1;
+        console.log(`缝线编辑: +${add.length} -${remove.length} 条边，${this.segmentedParts.length} 个部件 (${Date.now() - startTime}ms)`);
+        
+        if (wasFlattened) {
+            await this.flattenMesh();
+        } else {
+            this.visualizeSegmentation(this.segmentedParts);
+        }
+    }
+    
     /**
      * 确保 OrbitControls 处于启用状态
      */
@@ -1289,10 +1410,22 @@ class ClothFlattenerApp {
             console.log(`待处理部件数: ${subMeshes.length}`);
             
             const finalPatterns = [];
+            let reusedCount = 0;
             
             for (let i = 0; i < subMeshes.length; i++) {
                 let subMesh = subMeshes[i];
                 
+                // 部件未变化（增量分割复用了同一对象）且红点相同：复用上次的展开结果
+                const cached = this.partFlattenCache.get(subMesh);
+                if (cached && cached.redVertices === this.redVerticesSet) {
+                    const uvs = cached.uvs.map(uv => ({ u: uv.u, v: uv.v }));
+                    finalPatterns.push(this.createPatternFromSubMesh(cached.subMesh, uvs, i, false));
+                    reusedCount++;
+                    console.log(`\n部件 #${i}: 未变化，复用上次展开结果`);
+                    this.showProgress(((i + 1) / subMeshes.length) * 90);
+                    continue;
+                }
+                
                 console.log(`\n╔═══════════ 处理部件 #${i} ═══════════╗`);
                 console.log(`║ 输入: ${subMesh.vertices.length} 顶点, ${subMesh.faces.length} 面`);
                 
@@ -1435,6 +1568,13 @@ class ClothFlattenerApp {
                     uvs = this.projectPlanarUV(subMesh);
                 }
                 
+                // arrangePatterns会平移UV，缓存排列前的副本
+                this.partFlattenCache.set(subMeshes[i], {
+                    subMesh,
+                    uvs: uvs.map(uv => ({ u: uv.u, v: uv.v })),
+                    redVertices: this.redVerticesSet
+                });
+                
                 const pattern = this.createPatternFromSubMesh(subMesh, uvs, i, false);
                 finalPatterns.push(pattern);
                 
@@ -1468,7 +1608,7 @@ class ClothFlattenerApp {
             console.log('\n╔══════════════════════════════════════════════╗');
             console.log(`║ ✅ V10.0 展开完成！耗时: ${elapsed}ms`);
             console.log(`║   输入: ${subMeshes.length} 个部件`);
-            console.log(`║   输出: ${finalPatterns.length} 个裁片`);
+            console.log(`║   输出: ${finalPatterns.length} 个裁片 (复用 ${reusedCount} 个)`);
             console.log('║');
             console.log('║ 预期效果:');
             console.log('║   • 袖子: 直筒→扇形，边缘圆润弧线');
@@ -1479,6 +1619,7 @@ class ClothFlattenerApp {
             // 渲染2D结果
             this.renderer2D.render(this.flattenedData, this.seamData);
             this.renderer2D.setSeamColor(this.settings.seamColor);
+            this.updateDistortionOverlay();
             
             // 设置UV岛选择回调
             this.renderer2D.onIslandSelected = (islandIndex) => {
@@ -2079,7 +2220,7 @@ class ClothFlattenerApp {
     /**
      * 将颜色数组重新映射到焊接后的网格
      * @param {Array} originalColors - 原始颜色数组
-     * @param {Map} vertexMap - 旧索引 -> 新索引的映射
+     * @param {Map|Int32Array} vertexMap - 旧索引 -> 新索引的映射（WASM焊接时为Int32Array）
      * @param {number} newVertexCount - 新网格的顶点数量
      * @returns {Array} 重新映射后的颜色数组
      */
@@ -2099,7 +2240,7 @@ class ClothFlattenerApp {
         // 映射颜色到新索引
         // 如果多个旧顶点映射到同一个新顶点，保留红色值最高的
         for (let oldIdx = 0; oldIdx < originalColors.length; oldIdx++) {
-            const newIdx = vertexMap.get(oldIdx);
+            const newIdx = vertexMap.get ? vertexMap.get(oldIdx) : vertexMap[oldIdx];
             if (newIdx !== undefined && newIdx < newVertexCount) {
                 const oldColor = originalColors[oldIdx];
                 if (oldColor) {
@@ -2229,11 +2370,30 @@ class ClothFlattenerApp {
     }
     
     /**
-     * 排列UV图案避免重叠 (简单行排列)
+     * 排列UV图案避免重叠
+     * WASM可用时用原生skyline排料（可旋转90度），否则简单行排列
      */
     arrangePatterns(patterns) {
         if (patterns.length === 0) return;
         
+        const packed = this.uvPacker?.pack(patterns.map(p => p.uv), { stripWidth: 4.0, spacing: 0.02 });
+        if (packed) {
+            patterns.forEach((pattern, i) => {
+                const b = { minU: Infinity, maxU: -Infinity, minV: Infinity, maxV: -Infinity };
+                for (const uv of pattern.uv) {
+                    UVPacker.apply(packed.transforms[i], uv);
+                    b.minU = Math.min(b.minU, uv.u);
+                    b.maxU = Math.max(b.maxU, uv.u);
+                    b.minV = Math.min(b.minV, uv.v);
+                    b.maxV = Math.max(b.maxV, uv.v);
+                }
+                pattern.bounds = b;
+            });
+            console.log(`排料: ${patterns.length} 个图案，${packed.width.toFixed(3)} × ${packed.height.toFixed(3)}，` +
+                        `利用率 ${(packed.utilization * 100).toFixed(1)}%`);
+            return;
+        }
+        
         const padding = 0.02;  // 间距
         let currentX = 0;
         let currentY = 0;
@@ -2595,13 +2755,17 @@ class ClothFlattenerApp {
     }
     
     /**
-     * 导出SVG
+     * 导出SVG（有WASM时为原生纸样导出的片段轮廓）
      */
     exportSVG() {
         if (!this.flattenedData) {
             this.updateStatus('请先展开模型');
             return;
         }
+        if (this.patternExporter?.isAvailable) {
+            this.exportPattern('svg');
+            return;
+        }
         
         const svg = this.renderer2D.exportSVG(this.flattenedData, this.seamData);
         
@@ -2619,6 +2783,65 @@ class ClothFlattenerApp {
         this.updateStatus('SVG已导出');
     }
     
+    /**
+     * 原生纸样导出：逐块写入用户选择的文件（File System Access API），不支持时收集为Blob下载
+     * 坐标与2D视图的SVG导出相同（缩放200、留白20）
+     * @param {string} format - 'svg' | 'dxf'
+     */
+    async exportPattern(format) {
+        if (!this.flattenedData) {
+            this.updateStatus('请先展开模型');
+            return;
+        }
+        if (!this.patternExporter?.isAvailable) {
+            this.updateStatus('纸样导出需要WASM模块');
+            return;
+        }
+        
+        const fileName = `flattened-pattern.${format}`;
+        const type = format === 'dxf' ? 'application/dxf' : 'image/svg+xml';
+        let writable, sink = null;
+        if (window.showSaveFilePicker) {
+            try {
+                const fileHandle = await window.showSaveFilePicker({
+                    suggestedName: fileName,
+                    types: [{ description: format.toUpperCase(), accept: { [type]: [`.${format}`] } }]
+                });
+                writable = await fileHandle.createWritable();
+            } catch (error) {
+                if (error.name === 'AbortError') return;
+                console.warn('无法打开保存对话框，改为下载:', error);
+            }
+        }
+        if (!writable) {
+            sink = PatternExporter.blobSink(type);
+            writable = sink.writable;
+        }
+        
+        try {
+            const result = await this.patternExporter.exportPieces(this.flattenedData.pieces, writable,
+                                                                   { format, scale: 200, padding: 20 });
+            if (!result) {
+                this.updateStatus('没有可导出的片段');
+                return;
+            }
+            if (sink) {
+                const url = URL.createObjectURL(await sink.blob());
+                const a = document.createElement('a');
+                a.href = url;
+                a.download = fileName;
+                document.body.appendChild(a);
+                a.click();
+                document.body.removeChild(a);
+                URL.revokeObjectURL(url);
+            }
+            this.updateStatus(`${format.toUpperCase()}已导出（${result.loops} 条轮廓，${(result.bytes / 1024).toFixed(0)} KB）`);
+        } catch (error) {
+            console.error('纸样导出失败:', error);
+            this.updateStatus('纸样导出失败: ' + error.message);
+        }
+    }
+    
     /**
      * 重置场景
      */
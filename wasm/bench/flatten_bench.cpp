@@ -0,0 +1,594 @@
+/**
+ * 展开器原生基准测试（不经过Emscripten）
+ * 对示例网格、逐级细分的示例网格和合成网格计时 setMesh（含半边构建）、
+ * 片段展开（flattenPiece）和共形求解（optimizeConformal），结果输出为JSON，
+ * 用于按版本跟踪吞吐量；--check 检查网格上传的耗时随规模的增长阶数，
+ * 超线性（例如逐对查找twin的O(H²)实现）时返回非0，并检查泛洪分割的增量更新
+ * 在一串随机缝线编辑后与从头分割的结果（Patch、面的顺序）完全相同，以及带固定点的ARAP展开
+ * 保持固定点不动且畸变不超过不带固定点的结果
+ * --shuffle 把每个网格的顶点和面随机打乱（模拟扫描网格的索引顺序），
+ * --ordering 选择上传时的重排方式，两者配合比较重排的效果
+ *
+ * 用法: flatten_bench [--examples DIR] [--out FILE] [--max-faces N] [--repeat N] [--check]
+ *                     [--shuffle] [--ordering original|rcm|morton]
+ */
+
+#include "bff_flattener.h"
+#include "flood_segmenter.h"
+#include "obj_reader.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct BenchMesh {
+    std::string name;
+    std::string series;               // 同一系列的网格按规模比较增长阶数
+    std::vector<double> positions;    // [x,y,z, ...]
+    std::vector<int> triangles;       // [a,b,c, ...]
+    std::vector<int> seams;           // 缝线边 [a0,b0, a1,b1, ...]
+
+    int numVertices() const { return positions.size() / 3; }
+    int numFaces() const { return triangles.size() / 3; }
+};
+
+struct BenchResult {
+    std::string name;
+    std::string series;
+    int vertices = 0;
+    int faces = 0;
+    int seams = 0;
+    int pieces = 0;
+    int runs = 0;
+    bool success = false;
+    double setMeshMs = 0;
+    double reorderMs = 0;
+    double geometryMs = 0;
+    double halfEdgeMs = 0;
+    double boundaryMs = 0;
+    double splitMs = 0;
+    double flattenPieceMs = 0;    // 各片段flattenPiece之和
+    double unfoldMs = 0;
+    double conformalMs = 0;       // 各片段optimizeConformal之和
+    double flattenMs = 0;         // flatten墙钟时间
+    int iterations = 0;
+    double maxResidual = 0;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double median(std::vector<double> values) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/**
+ * 从缝线JSON中取出 "type": "cut" 的折线，按相邻顶点拆成边
+ * 只识别示例文件的格式：每条缝线对象先写type再写vertices
+ */
+void parseCutSeams(const std::string& json, const std::vector<int>& remap, std::vector<int>& seams) {
+    size_t pos = 0;
+    while ((pos = json.find("\"type\"", pos)) != std::string::npos) {
+        size_t colon = json.find(':', pos);
+        size_t quote = json.find('"', colon + 1);
+        size_t close = json.find('"', quote + 1);
+        if (colon == std::string::npos || quote == std::string::npos || close == std::string::npos) break;
+        pos = close + 1;
+        if (json.compare(quote + 1, close - quote - 1, "cut") != 0) continue;
+
+        size_t key = json.find("\"vertices\"", pos);
+        size_t open = json.find('[', key);
+        size_t end = json.find(']', open);
+        if (key == std::string::npos || open == std::string::npos || end == std::string::npos) break;
+        std::vector<int> path;
+        const char* p = json.c_str() + open + 1;
+        const char* stop = json.c_str() + end;
+        while (p < stop) {
+            char* next = nullptr;
+            long v = std::strtol(p, &next, 10);
+            if (next == p) { p++; continue; }
+            if (v >= 0 && v < (long)remap.size()) path.push_back(remap[v]);
+            p = next;
+        }
+        for (size_t i = 1; i < path.size(); i++) {
+            seams.push_back(path[i - 1]);
+            seams.push_back(path[i]);
+        }
+        pos = end;
+    }
+}
+
+bool loadExample(const std::string& dir, const std::string& name, BenchMesh& mesh) {
+    std::string obj;
+    if (!readFile(dir + "/" + name + ".obj", obj)) return false;
+    bff::ObjReader reader;
+    reader.feed(obj.data(), obj.size());
+    if (!reader.finish()) return false;
+
+    mesh.name = name;
+    mesh.series = name;
+    mesh.positions = reader.positions();
+    mesh.triangles = reader.triangles();
+    std::string json;
+    if (readFile(dir + "/" + name + "_seams.json", json)) {
+        parseCutSeams(json, reader.vertexRemap(), mesh.seams);
+    }
+    return true;
+}
+
+/**
+ * 中点细分：每个三角形分成四个，缝线边的两半仍是缝线
+ */
+BenchMesh subdivide(const BenchMesh& in) {
+    BenchMesh out;
+    out.series = in.series;
+    out.positions = in.positions;
+    out.triangles.reserve(in.triangles.size() * 4);
+
+    std::unordered_map<uint64_t, int> midpoint;
+    midpoint.reserve(in.triangles.size() * 2);
+    auto key = [](int a, int b) {
+        if (a > b) std::swap(a, b);
+        return (uint64_t(uint32_t(a)) << 32) | uint32_t(b);
+    };
+    auto split = [&](int a, int b) {
+        auto it = midpoint.emplace(key(a, b), (int)out.positions.size() / 3);
+        if (it.second) {
+            for (int d = 0; d < 3; d++) {
+                out.positions.push_back(0.5 * (in.positions[a * 3 + d] + in.positions[b * 3 + d]));
+            }
+        }
+        return it.first->second;
+    };
+
+    for (size_t t = 0; t < in.triangles.size(); t += 3) {
+        int a = in.triangles[t], b = in.triangles[t + 1], c = in.triangles[t + 2];
+        int ab = split(a, b), bc = split(b, c), ca = split(c, a);
+        const int tris[12] = {a, ab, ca, ab, b, bc, ca, bc, c, ab, bc, ca};
+        out.triangles.insert(out.triangles.end(), tris, tris + 12);
+    }
+    for (size_t s = 0; s < in.seams.size(); s += 2) {
+        int a = in.seams[s], b = in.seams[s + 1];
+        auto it = midpoint.find(key(a, b));
+        if (it == midpoint.end()) continue;
+        const int halves[4] = {a, it->second, it->second, b};
+        out.seams.insert(out.seams.end(), halves, halves + 4);
+    }
+    return out;
+}
+
+/**
+ * 合成网格：n x n 的起伏方格，每格两个三角形，整体为一个圆盘
+ */
+BenchMesh syntheticGrid(int n) {
+    BenchMesh mesh;
+    mesh.series = "grid";
+    mesh.name = "grid_" + std::to_string(2 * n * n);
+    for (int j = 0; j <= n; j++) {
+        for (int i = 0; i <= n; i++) {
+            double x = double(i) / n, y = double(j) / n;
+            mesh.positions.push_back(x);
+            mesh.positions.push_back(y);
+            mesh.positions.push_back(0.1 * std::sin(6.0 * x) * std::cos(4.0 * y));
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            int v = j * (n + 1) + i;
+            const int tris[6] = {v, v + 1, v + n + 2, v, v + n + 2, v + n + 1};
+            mesh.triangles.insert(mesh.triangles.end(), tris, tris + 6);
+        }
+    }
+    return mesh;
+}
+
+// 顶点和面按固定种子随机重排，缝线随顶点编号一起换算
+void shuffleMesh(BenchMesh& mesh) {
+    std::mt19937 rng(12345);
+    std::vector<int> vertexOrder(mesh.numVertices()), faceOrder(mesh.numFaces());
+    std::iota(vertexOrder.begin(), vertexOrder.end(), 0);
+    std::iota(faceOrder.begin(), faceOrder.end(), 0);
+    std::shuffle(vertexOrder.begin(), vertexOrder.end(), rng);
+    std::shuffle(faceOrder.begin(), faceOrder.end(), rng);
+
+    std::vector<int> rank(vertexOrder.size());
+    for (size_t v = 0; v < vertexOrder.size(); v++) rank[vertexOrder[v]] = v;
+    std::vector<double> positions(mesh.positions.size());
+    for (size_t v = 0; v < vertexOrder.size(); v++) {
+        std::copy_n(&mesh.positions[vertexOrder[v] * 3], 3, &positions[v * 3]);
+    }
+    std::vector<int> triangles(mesh.triangles.size());
+    for (size_t f = 0; f < faceOrder.size(); f++) {
+        for (int i = 0; i < 3; i++) triangles[f * 3 + i] = rank[mesh.triangles[faceOrder[f] * 3 + i]];
+    }
+    for (int& v : mesh.seams) v = rank[v];
+    mesh.positions.swap(positions);
+    mesh.triangles.swap(triangles);
+}
+
+BenchResult runCase(const BenchMesh& mesh, int repeat, bff::MeshOrdering ordering) {
+    BenchResult r;
+    r.name = mesh.name;
+    r.series = mesh.series;
+    r.vertices = mesh.numVertices();
+    r.faces = mesh.numFaces();
+    r.seams = mesh.seams.size() / 2;
+
+    std::vector<double> setMesh, reorder, geometry, halfEdge, boundary, split, piece, unfold, conformal, flatten;
+    r.success = true;
+    // 单次超过kSlowRunMs的大网格不再重复，取中位数的意义不大
+    const double kSlowRunMs = 2000;
+    for (int k = 0; k < repeat; k++) {
+        // 每次用新实例，不命中片段缓存
+        bff::BFFFlattener flattener;
+        flattener.setMeshOrdering(ordering);
+        auto start = std::chrono::steady_clock::now();
+        flattener.setMesh(mesh.positions.data(), r.vertices, mesh.triangles.data(), r.faces);
+        setMesh.push_back(elapsedMs(start));
+        const bff::MeshSetupStats& setup = flattener.getSetupStats();
+        reorder.push_back(setup.reorderMs);
+        geometry.push_back(setup.geometryMs);
+        halfEdge.push_back(setup.halfEdgeMs);
+        boundary.push_back(setup.boundaryMs);
+
+        for (size_t s = 0; s < mesh.seams.size(); s += 2) {
+            flattener.addSeamEdge(mesh.seams[s], mesh.seams[s + 1]);
+        }
+        r.success = flattener.flatten() && r.success;
+
+        const bff::FlattenStats& stats = flattener.getResult().stats;
+        double pieceSum = 0;
+        for (const bff::PieceStats& p : stats.pieces) pieceSum += p.unfoldMs + p.conformalMs + p.arapMs;
+        split.push_back(stats.splitMs);
+        piece.push_back(pieceSum);
+        unfold.push_back(stats.unfoldMs);
+        conformal.push_back(stats.conformalMs);
+        flatten.push_back(stats.totalMs);
+        r.pieces = flattener.getIslandCount();
+        r.iterations = stats.totalIterations;
+        r.maxResidual = stats.maxResidual;
+        r.runs = k + 1;
+        if (setMesh.back() + stats.totalMs > kSlowRunMs) break;
+    }
+    r.setMeshMs = median(setMesh);
+    r.reorderMs = median(reorder);
+    r.geometryMs = median(geometry);
+    r.halfEdgeMs = median(halfEdge);
+    r.boundaryMs = median(boundary);
+    r.splitMs = median(split);
+    r.flattenPieceMs = median(piece);
+    r.unfoldMs = median(unfold);
+    r.conformalMs = median(conformal);
+    r.flattenMs = median(flatten);
+    return r;
+}
+
+// 同一系列中最大的两个规模之间的增长阶数 log(t2/t1) / log(n2/n1)；耗时太短时无意义，返回0
+double scalingExponent(const std::vector<const BenchResult*>& series, double BenchResult::*field) {
+    if (series.size() < 2) return 0;
+    const BenchResult* a = series[series.size() - 2];
+    const BenchResult* b = series[series.size() - 1];
+    if (a->*field < 1.0 || b->faces <= a->faces) return 0;
+    return std::log(b->*field / a->*field) / std::log(double(b->faces) / a->faces);
+}
+
+/**
+ * 增量分割检查：同一分割器上反复编辑缝线（单条边开关、一段连续缝线、红点开关）后segment，
+ * 每一步与新建分割器从头分割的结果比较；dirty为0的Patch必须与上一次同一起始面的Patch完全相同
+ * （JS据此原样复用上一次的子网格）
+ * @return 不一致的步数
+ */
+int checkIncrementalSegmentation(const BenchMesh& mesh, int edits, unsigned seed) {
+    std::mt19937 rng(seed);
+    int numFaces = mesh.numFaces();
+    int numVertices = mesh.numVertices();
+    bff::SegmentOptions options;
+    options.minFaces = std::max(1, numFaces / 40);
+
+    std::vector<std::vector<int>> neighbors(numVertices);
+    for (int h = 0; h < numFaces * 3; h++) {
+        neighbors[mesh.triangles[h]].push_back(mesh.triangles[h - h % 3 + (h + 1) % 3]);
+    }
+    auto key = [](int a, int b) { return a < b ? (uint64_t(a) << 32) | uint32_t(b) : (uint64_t(b) << 32) | uint32_t(a); };
+    std::unordered_map<uint64_t, int> seamIndex;   // 边 -> seams中的位置
+    std::vector<int> seams;
+    auto toggle = [&](int a, int b) {
+        auto it = seamIndex.find(key(a, b));
+        if (it == seamIndex.end()) {
+            seamIndex[key(a, b)] = seams.size();
+            seams.push_back(a);
+            seams.push_back(b);
+            return;
+        }
+        int i = it->second;
+        seamIndex.erase(it);
+        int last = seams.size() - 2;
+        if (i != last) {
+            seams[i] = seams[last];
+            seams[i + 1] = seams[last + 1];
+            seamIndex[key(seams[i], seams[i + 1])] = i;
+        }
+        seams.resize(last);
+    };
+    for (size_t i = 0; i + 1 < mesh.seams.size(); i += 2) {
+        if (!seamIndex.count(key(mesh.seams[i], mesh.seams[i + 1]))) toggle(mesh.seams[i], mesh.seams[i + 1]);
+    }
+    std::vector<uint8_t> red(numVertices, 0);
+
+    bff::FloodSegmenter incremental;
+    incremental.setMesh(mesh.triangles.data(), numFaces, numVertices);
+    std::unordered_map<int, std::vector<int>> previous;   // 起始面 -> 上一次的Patch
+    int mismatches = 0;
+    for (int step = 0; step <= edits; step++) {
+        if (step > 0) {
+            int kind = rng() % 10;
+            int v = mesh.triangles[rng() % (numFaces * 3)];
+            if (kind < 5) {
+                toggle(v, neighbors[v][rng() % neighbors[v].size()]);
+            } else if (kind < 9) {
+                // 沿网格边随机走一段，整段开关
+                int length = 2 + rng() % std::max(2, (int)std::sqrt(double(numFaces)) / 2);
+                for (int k = 0; k < length; k++) {
+                    int w = neighbors[v][rng() % neighbors[v].size()];
+                    toggle(v, w);
+                    v = w;
+                }
+            } else {
+                red[v] ^= 1;
+            }
+        }
+
+        incremental.segment(seams.data(), seams.size() / 2, red.data(), options);
+        bff::FloodSegmenter full;
+        full.setMesh(mesh.triangles.data(), numFaces, numVertices);
+        full.segment(seams.data(), seams.size() / 2, red.data(), options);
+
+        bool same = incremental.labels() == full.labels() && incremental.patchOffsets() == full.patchOffsets() &&
+                    incremental.patchFaces() == full.patchFaces();
+        const std::vector<int>& offsets = incremental.patchOffsets();
+        const std::vector<int>& faces = incremental.patchFaces();
+        std::unordered_map<int, std::vector<int>> current;
+        for (int p = 0; p < incremental.numPatches(); p++) {
+            std::vector<int> patch(faces.begin() + offsets[p], faces.begin() + offsets[p + 1]);
+            if (step > 0 && !incremental.patchDirty()[p] && !patch.empty()) {
+                auto it = previous.find(patch[0]);
+                same = same && it != previous.end() && it->second == patch;
+            }
+            if (!patch.empty()) current[patch[0]] = std::move(patch);
+        }
+        previous.swap(current);
+        if (!same) mismatches++;
+    }
+    return mismatches;
+}
+
+/**
+ * ARAP固定点检查：先不带固定点做ARAP展开作参照，在第一个片段上按参照坐标固定三个相距较远的UV顶点后
+ * 重新展开；固定点必须不动，翻转面不能增加，按面积加权的共形畸变和面积畸变不能明显超过参照
+ * （固定点与静止形状的尺度不一致时片段被拉伸或折叠）
+ * @return 是否通过
+ */
+bool checkPinnedARAP(const BenchMesh& mesh, double& pinError, double& conformal, double& referenceConformal) {
+    bff::BFFFlattener flattener;
+    flattener.setMesh(mesh.positions.data(), mesh.numVertices(), mesh.triangles.data(), mesh.numFaces());
+    for (size_t s = 0; s < mesh.seams.size(); s += 2) {
+        flattener.addSeamEdge(mesh.seams[s], mesh.seams[s + 1]);
+    }
+    flattener.setMethod(bff::FlattenMethod::ARAP);
+    if (!flattener.flatten()) return false;
+    std::vector<double> reference(flattener.getUVCoords().begin(), flattener.getUVCoords().end());
+    bff::DistortionMetrics before = flattener.getDistortion();
+
+    // 第一个片段中：任取一点，离它最远的点，再取离前两点都远的点
+    const bff::FlattenResult& result = flattener.getResult();
+    std::vector<int> candidates;
+    for (int f : result.pieces[0]) {
+        for (int k = 0; k < 3; k++) candidates.push_back(result.uvFaces[f * 3 + k]);
+    }
+    auto dist = [&](int a, int b) { return std::hypot(reference[a * 2] - reference[b * 2], reference[a * 2 + 1] - reference[b * 2 + 1]); };
+    std::vector<int> pins = {candidates[0]};
+    while (pins.size() < 3) {
+        int best = pins[0];
+        double bestDist = -1;
+        for (int c : candidates) {
+            double d = 1e300;
+            for (int p : pins) d = std::min(d, dist(c, p));
+            if (d > bestDist) {
+                bestDist = d;
+                best = c;
+            }
+        }
+        pins.push_back(best);
+    }
+    for (int p : pins) flattener.setPin(p, reference[p * 2], reference[p * 2 + 1]);
+    if (!flattener.flatten()) return false;
+
+    const std::vector<bff::Real>& uvs = flattener.getUVCoords();
+    pinError = 0;
+    for (int p : pins) {
+        pinError = std::max(pinError, std::hypot(uvs[p * 2] - reference[p * 2], uvs[p * 2 + 1] - reference[p * 2 + 1]));
+    }
+    const bff::DistortionMetrics& after = flattener.getDistortion();
+    conformal = after.meanConformal;
+    referenceConformal = before.meanConformal;
+    return pinError <= 1e-6 && after.flippedFaces <= before.flippedFaces &&
+           after.meanConformal <= before.meanConformal * 1.05 + 0.01 &&
+           after.meanAreaError <= before.meanAreaError + 0.05;
+}
+
+double perSecond(int count, double ms) {
+    return ms > 0 ? count / (ms / 1000.0) : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string examplesDir = "../examples";
+    std::string outPath;
+    int maxFaces = 1000000;
+    int repeat = 3;
+    bool check = false;
+    bool shuffle = false;
+    std::string orderingName = "original";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--examples" && i + 1 < argc) examplesDir = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+        else if (arg == "--max-faces" && i + 1 < argc) maxFaces = std::atoi(argv[++i]);
+        else if (arg == "--repeat" && i + 1 < argc) repeat = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--check") check = true;
+        else if (arg == "--shuffle") shuffle = true;
+        else if (arg == "--ordering" && i + 1 < argc) orderingName = argv[++i];
+        else {
+            std::fprintf(stderr, "用法: %s [--examples DIR] [--out FILE] [--max-faces N] [--repeat N] [--check] "
+                         "[--shuffle] [--ordering original|rcm|morton]\n", argv[0]);
+            return 2;
+        }
+    }
+    bff::MeshOrdering ordering;
+    if (orderingName == "original") ordering = bff::MeshOrdering::Original;
+    else if (orderingName == "rcm") ordering = bff::MeshOrdering::RCM;
+    else if (orderingName == "morton") ordering = bff::MeshOrdering::Morton;
+    else {
+        std::fprintf(stderr, "未知的重排方式: %s\n", orderingName.c_str());
+        return 2;
+    }
+
+    std::vector<BenchMesh> meshes;
+    for (const char* name : {"cylinder", "shirt_front"}) {
+        BenchMesh base;
+        if (!loadExample(examplesDir, name, base)) {
+            std::fprintf(stderr, "无法读取示例网格: %s/%s.obj\n", examplesDir.c_str(), name);
+            return 1;
+        }
+        meshes.push_back(base);
+        for (int level = 1; meshes.back().numFaces() * 4 <= maxFaces; level++) {
+            meshes.push_back(subdivide(meshes.back()));
+            meshes.back().name = std::string(name) + "_sub" + std::to_string(level);
+        }
+    }
+    for (int faces = 1000; faces <= maxFaces; faces *= 10) {
+        meshes.push_back(syntheticGrid((int)std::lround(std::sqrt(faces / 2.0))));
+    }
+
+    if (shuffle) {
+        for (BenchMesh& mesh : meshes) shuffleMesh(mesh);
+    }
+
+    std::vector<BenchResult> results;
+    for (const BenchMesh& mesh : meshes) {
+        std::fprintf(stderr, "%-20s %8d faces ...", mesh.name.c_str(), mesh.numFaces());
+        results.push_back(runCase(mesh, repeat, ordering));
+        std::fprintf(stderr, " setMesh %.2f ms, flatten %.2f ms\n", results.back().setMeshMs, results.back().flattenMs);
+    }
+
+    FILE* out = outPath.empty() ? stdout : std::fopen(outPath.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "无法写入: %s\n", outPath.c_str());
+        return 1;
+    }
+    std::fprintf(out, "{\n  \"benchmark\": \"bff_flattener\",\n  \"formatVersion\": 1,\n");
+    std::fprintf(out, "  \"threads\": %d,\n  \"repeat\": %d,\n  \"shuffle\": %s,\n  \"ordering\": \"%s\",\n  \"cases\": [\n",
+                 bff::schedulerThreadCount(), repeat, shuffle ? "true" : "false", orderingName.c_str());
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        std::fprintf(out,
+            "    {\"name\": \"%s\", \"series\": \"%s\", \"vertices\": %d, \"faces\": %d, \"seams\": %d, "
+            "\"pieces\": %d, \"runs\": %d, \"success\": %s,\n"
+            "     \"setMeshMs\": %.4f, \"reorderMs\": %.4f, \"geometryMs\": %.4f, \"halfEdgeMs\": %.4f, \"boundaryMs\": %.4f,\n"
+            "     \"splitMs\": %.4f, \"flattenPieceMs\": %.4f, \"unfoldMs\": %.4f, \"conformalMs\": %.4f, "
+            "\"flattenMs\": %.4f,\n"
+            "     \"iterations\": %d, \"maxResidual\": %.3e, "
+            "\"setMeshFacesPerSec\": %.0f, \"flattenFacesPerSec\": %.0f}%s\n",
+            r.name.c_str(), r.series.c_str(), r.vertices, r.faces, r.seams, r.pieces, r.runs, r.success ? "true" : "false",
+            r.setMeshMs, r.reorderMs, r.geometryMs, r.halfEdgeMs, r.boundaryMs,
+            r.splitMs, r.flattenPieceMs, r.unfoldMs, r.conformalMs, r.flattenMs,
+            r.iterations, r.maxResidual,
+            perSecond(r.faces, r.setMeshMs), perSecond(r.faces, r.flattenMs),
+            i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ],\n  \"scaling\": [\n");
+
+    // 网格上传应为线性（指数约为1），flatten含稀疏分解，只记录不检查
+    const double kMaxSetupExponent = 1.5;
+    bool superlinear = false;
+    std::vector<std::string> seriesNames;
+    for (const BenchResult& r : results) {
+        if (std::find(seriesNames.begin(), seriesNames.end(), r.series) == seriesNames.end()) {
+            seriesNames.push_back(r.series);
+        }
+    }
+    for (size_t s = 0; s < seriesNames.size(); s++) {
+        std::vector<const BenchResult*> series;
+        for (const BenchResult& r : results) {
+            if (r.series == seriesNames[s]) series.push_back(&r);
+        }
+        double setMesh = scalingExponent(series, &BenchResult::setMeshMs);
+        double halfEdge = scalingExponent(series, &BenchResult::halfEdgeMs);
+        double flatten = scalingExponent(series, &BenchResult::flattenMs);
+        if (setMesh > kMaxSetupExponent || halfEdge > kMaxSetupExponent) {
+            superlinear = true;
+            std::fprintf(stderr, "警告: %s 的网格上传耗时增长阶数为 %.2f（半边 %.2f）\n",
+                         seriesNames[s].c_str(), setMesh, halfEdge);
+        }
+        std::fprintf(out, "    {\"series\": \"%s\", \"setMesh\": %.3f, \"halfEdge\": %.3f, \"flatten\": %.3f}%s\n",
+                     seriesNames[s].c_str(), setMesh, halfEdge, flatten,
+                     s + 1 < seriesNames.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    if (out != stdout) std::fclose(out);
+
+    bool failed = std::any_of(results.begin(), results.end(), [](const BenchResult& r) { return !r.success; });
+    if (failed) std::fprintf(stderr, "有网格展开失败\n");
+
+    // 每一步都从头分割一次作对照，只检查较小的网格
+    const int kSegmentCheckMaxFaces = 200000;
+    const int kSegmentEdits = 40;
+    bool segmentMismatch = false;
+    if (check) {
+        for (const BenchMesh& mesh : meshes) {
+            if (mesh.numFaces() > kSegmentCheckMaxFaces) continue;
+            int mismatches = checkIncrementalSegmentation(mesh, kSegmentEdits, 12345);
+            std::fprintf(stderr, "%-20s 增量分割 %d 步，不一致 %d 步\n", mesh.name.c_str(), kSegmentEdits, mismatches);
+            segmentMismatch = segmentMismatch || mismatches > 0;
+        }
+        if (segmentMismatch) std::fprintf(stderr, "增量分割与从头分割的结果不同\n");
+    }
+
+    // ARAP固定点检查展开两次，同样只检查较小的网格
+    const int kPinnedARAPMaxFaces = 100000;
+    bool pinnedARAPFailed = false;
+    if (check) {
+        for (const BenchMesh& mesh : meshes) {
+            if (mesh.numFaces() > kPinnedARAPMaxFaces) continue;
+            double pinError = 0, conformal = 0, referenceConformal = 0;
+            bool ok = checkPinnedARAP(mesh, pinError, conformal, referenceConformal);
+            std::fprintf(stderr, "%-20s ARAP固定点偏移 %.2e，共形畸变 %.4f（无固定点 %.4f）%s\n", mesh.name.c_str(),
+                         pinError, conformal, referenceConformal, ok ? "" : "  不通过");
+            pinnedARAPFailed = pinnedARAPFailed || !ok;
+        }
+        if (pinnedARAPFailed) std::fprintf(stderr, "带固定点的ARAP展开移动了固定点或畸变过大\n");
+    }
+    return failed || (check && (superlinear || segmentMismatch || pinnedARAPFailed)) ? 1 : 0;
+}
@@ -29,13 +29,15 @@ mkdir -p ../js
 
 # 编译
 echo "编译中..."
-make all
+make all scalar threads
 
 if [ $? -eq 0 ]; then
     echo ""
     echo "=========================================="
     echo "编译成功!"
     echo "输出文件: js/bff_wasm.js"
+    echo "标量版本: js/bff_wasm_scalar.js"
+    echo "多线程版本: js/bff_wasm_mt.js"
     echo "=========================================="
 else
     echo ""
@@ -0,0 +1,323 @@
+/**
+ * 展开器命令行工具（本机编译，不经过Emscripten/浏览器）
+ * 读取OBJ和缝线JSON（examples/ 的格式），输出带vt的OBJ和纸样轮廓（SVG / DXF），供服务端批处理：
+ * 与浏览器使用同一 BFFFlattener 核心，多个任务经 parallelFor 分配到所有核心，
+ * 单个任务内部的片段展开也会被空闲线程窃取
+ *
+ * 任务：--jobs DIR 下的每个 NAME.obj（缝线取同目录的 NAME_seams.json，缺失时不切开），
+ *       或命令行直接列出的OBJ文件
+ * 输出：OUT/NAME_uv.obj（原顶点 + 排料后的vt）、OUT/NAME.svg / OUT/NAME.dxf（各片段轮廓，网格单位；
+ *       --interior 同时输出内部网格边，DXF在图层8）
+ * 退出码：全部成功为0，有任务失败为1，参数错误为2
+ *
+ * 用法: bff_flatten [--jobs DIR] [--out DIR] [--method conformal|arap] [--iterations N]
+ *                   [--ordering original|rcm|morton] [--strip-width W] [--spacing S]
+ *                   [--no-pack] [--format obj,svg,dxf] [--interior] [FILE.obj ...]
+ */
+
+#include "bff_flattener.h"
+#include "obj_reader.h"
+#include "pattern_export.h"
+#include "seam_json.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct CliOptions {
+    std::string outDir = ".";
+    bff::FlattenMethod method = bff::FlattenMethod::Conformal;
+    int iterations = 10;
+    bff::MeshOrdering ordering = bff::MeshOrdering::Original;
+    bool pack = true;
+    bff::PackOptions packOptions;
+    bool writeObj = true;
+    bool writeSvg = true;
+    bool writeDxf = false;
+    bool interiorEdges = false;
+};
+
+struct Job {
+    fs::path obj;
+    fs::path seams;                   // 为空时不切开
+    std::string name;
+};
+
+struct JobResult {
+    bool success = false;
+    std::string error;
+    int vertices = 0;
+    int faces = 0;
+    int seams = 0;
+    int pieces = 0;
+    double utilization = 0;
+    double ms = 0;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool readFile(const fs::path& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// 按块读入，大文件不需要整块的中间字符串
+bool readObj(const fs::path& path, bff::ObjReader& reader) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::vector<char> chunk(1 << 20);
+    while (in) {
+        in.read(chunk.data(), chunk.size());
+        reader.feed(chunk.data(), in.gcount());
+    }
+    return reader.finish();
+}
+
+void writeUVObj(FILE* out, const bff::ObjReader& reader, const std::vector<bff::Real>& uvs,
+                const std::vector<int>& uvFaces) {
+    std::fprintf(out, "# bff_flatten: %d vertices, %d uv vertices, %d faces\n",
+                 reader.numVertices(), int(uvs.size() / 2), reader.numTriangles());
+    const std::vector<double>& p = reader.positions();
+    for (size_t i = 0; i < p.size(); i += 3) {
+        std::fprintf(out, "v %.9g %.9g %.9g\n", p[i], p[i + 1], p[i + 2]);
+    }
+    for (size_t i = 0; i < uvs.size(); i += 2) {
+        std::fprintf(out, "vt %.9g %.9g\n", double(uvs[i]), double(uvs[i + 1]));
+    }
+    const std::vector<int>& t = reader.triangles();
+    for (size_t i = 0; i < t.size(); i += 3) {
+        std::fprintf(out, "f %d/%d %d/%d %d/%d\n", t[i] + 1, uvFaces[i] + 1, t[i + 1] + 1, uvFaces[i + 1] + 1,
+                     t[i + 2] + 1, uvFaces[i + 2] + 1);
+    }
+}
+
+// 纸样（片段轮廓，可选内部网格边）按块写出，见 pattern_export.h
+void writePattern(FILE* out, const std::vector<bff::Real>& uvs, const bff::FlattenResult& result,
+                  const bff::ExportOptions& exportOptions) {
+    bff::ExportSource source;
+    source.uvs = uvs.data();
+    source.numUVs = uvs.size() / 2;
+    source.uvFaces = result.uvFaces.data();
+    source.numFaces = result.uvFaces.size() / 3;
+    source.facePiece = result.facePiece.data();
+    source.numPieces = std::max<int>(result.pieces.size(), 1);
+    bff::PatternExporter exporter;
+    exporter.begin(source, exportOptions);
+    std::string chunk;
+    while (exporter.next(chunk)) std::fwrite(chunk.data(), 1, chunk.size(), out);
+}
+
+bool writeOutput(const fs::path& path, const std::function<void(FILE*)>& write, std::string& error) {
+    FILE* out = std::fopen(path.string().c_str(), "wb");
+    if (!out) {
+        error = "Cannot write " + path.string();
+        return false;
+    }
+    write(out);
+    if (std::fclose(out) != 0) {
+        error = "Cannot write " + path.string();
+        return false;
+    }
+    return true;
+}
+
+JobResult runJob(const Job& job, const CliOptions& options) {
+    JobResult r;
+    auto start = std::chrono::steady_clock::now();
+
+    bff::ObjReader reader;
+    if (!readObj(job.obj, reader)) {
+        r.error = reader.getError().empty() ? "Cannot read " + job.obj.string() : reader.getError();
+        return r;
+    }
+    r.vertices = reader.numVertices();
+    r.faces = reader.numTriangles();
+
+    std::vector<int> seams;
+    if (!job.seams.empty()) {
+        std::string json;
+        if (!readFile(job.seams, json)) {
+            r.error = "Cannot read " + job.seams.string();
+            return r;
+        }
+        if (!bff::readCutSeams(json, reader.vertexRemap(), reader.triangles(), seams, r.error)) return r;
+    }
+    r.seams = seams.size() / 2;
+
+    bff::BFFFlattener flattener;
+    flattener.setMeshOrdering(options.ordering);
+    flattener.setMethod(options.method);
+    bff::ARAPOptions arap;
+    arap.iterations = options.iterations;
+    flattener.setARAPOptions(arap);
+    if (!reader.loadInto(flattener)) {
+        r.error = flattener.getError();
+        return r;
+    }
+    flattener.setSeamEdges(seams.data(), seams.size() / 2);
+    if (!flattener.flatten()) {
+        r.error = flattener.getError();
+        return r;
+    }
+
+    const bff::FlattenResult& result = flattener.getResult();
+    r.pieces = result.pieces.size();
+    const std::vector<bff::Real>* uvs = &flattener.getUVCoords();
+    if (options.pack) {
+        if (!flattener.packIslands(options.packOptions)) {
+            r.error = flattener.getError();
+            return r;
+        }
+        uvs = &flattener.getPackedUVCoords();
+        r.utilization = flattener.getPackResult().utilization;
+    }
+
+    fs::path base = fs::path(options.outDir) / job.name;
+    if (options.writeObj &&
+        !writeOutput(base.string() + "_uv.obj",
+                     [&](FILE* out) { writeUVObj(out, reader, *uvs, result.uvFaces); }, r.error)) {
+        return r;
+    }
+    bff::ExportOptions exportOptions;
+    exportOptions.interiorEdges = options.interiorEdges;
+    exportOptions.padding = -1;
+    if (options.writeSvg &&
+        !writeOutput(base.string() + ".svg",
+                     [&](FILE* out) { writePattern(out, *uvs, result, exportOptions); }, r.error)) {
+        return r;
+    }
+    exportOptions.format = bff::ExportFormat::DXF;
+    if (options.writeDxf &&
+        !writeOutput(base.string() + ".dxf",
+                     [&](FILE* out) { writePattern(out, *uvs, result, exportOptions); }, r.error)) {
+        return r;
+    }
+    r.success = true;
+    r.ms = elapsedMs(start);
+    return r;
+}
+
+Job makeJob(const fs::path& obj) {
+    Job job;
+    job.obj = obj;
+    job.name = obj.stem().string();
+    fs::path seams = obj.parent_path() / (job.name + "_seams.json");
+    std::error_code ec;
+    if (fs::is_regular_file(seams, ec)) job.seams = seams;
+    return job;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (c >= 0x20 || c < 0) out += c;
+    }
+    return out;
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "用法: %s [--jobs DIR] [--out DIR] [--method conformal|arap] [--iterations N]\n"
+                 "       [--ordering original|rcm|morton] [--strip-width W] [--spacing S] [--no-pack]\n"
+                 "       [--format obj,svg,dxf] [--interior] [FILE.obj ...]\n", argv0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CliOptions options;
+    std::vector<Job> jobs;
+    std::string jobsDir;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc) jobsDir = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) options.outDir = argv[++i];
+        else if (arg == "--method" && i + 1 < argc) {
+            std::string m = argv[++i];
+            if (m == "arap") options.method = bff::FlattenMethod::ARAP;
+            else if (m != "conformal") { usage(argv[0]); return 2; }
+        }
+        else if (arg == "--iterations" && i + 1 < argc) options.iterations = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--ordering" && i + 1 < argc) {
+            std::string o = argv[++i];
+            if (o == "rcm") options.ordering = bff::MeshOrdering::RCM;
+            else if (o == "morton") options.ordering = bff::MeshOrdering::Morton;
+            else if (o != "original") { usage(argv[0]); return 2; }
+        }
+        else if (arg == "--strip-width" && i + 1 < argc) options.packOptions.stripWidth = std::atof(argv[++i]);
+        else if (arg == "--spacing" && i + 1 < argc) options.packOptions.spacing = std::atof(argv[++i]);
+        else if (arg == "--no-pack") options.pack = false;
+        else if (arg == "--format" && i + 1 < argc) {
+            std::string f = std::string(",") + argv[++i] + ",";
+            options.writeObj = f.find(",obj,") != std::string::npos;
+            options.writeSvg = f.find(",svg,") != std::string::npos;
+            options.writeDxf = f.find(",dxf,") != std::string::npos;
+        }
+        else if (arg == "--interior") options.interiorEdges = true;
+        else if (!arg.empty() && arg[0] != '-') jobs.push_back(makeJob(arg));
+        else { usage(argv[0]); return 2; }
+    }
+
+    if (!jobsDir.empty()) {
+        std::error_code ec;
+        std::vector<fs::path> objs;
+        for (const fs::directory_entry& entry : fs::directory_iterator(jobsDir, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".obj") objs.push_back(entry.path());
+        }
+        if (ec) {
+            std::fprintf(stderr, "无法读取任务目录: %s\n", jobsDir.c_str());
+            return 2;
+        }
+        std::sort(objs.begin(), objs.end());
+        for (const fs::path& obj : objs) jobs.push_back(makeJob(obj));
+    }
+    if (jobs.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+    std::error_code ec;
+    fs::create_directories(options.outDir, ec);
+
+    // 每个任务一个块；结果按任务顺序输出，与完成顺序无关
+    auto start = std::chrono::steady_clock::now();
+    std::vector<JobResult> results(jobs.size());
+    std::atomic<int> done(0);
+    bff::parallelFor(jobs.size(), 1, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            results[i] = runJob(jobs[i], options);
+            std::fprintf(stderr, "[%d/%zu] %s %s\n", ++done, jobs.size(), jobs[i].name.c_str(),
+                         results[i].success ? "ok" : results[i].error.c_str());
+        }
+    });
+    double totalMs = elapsedMs(start);
+
+    int failed = 0;
+    long long totalFaces = 0;
+    std::printf("{\n  \"threads\": %d,\n  \"jobs\": [\n", bff::schedulerThreadCount());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const JobResult& r = results[i];
+        if (!r.success) failed++;
+        totalFaces += r.faces;
+        std::printf("    {\"name\": \"%s\", \"success\": %s, \"error\": \"%s\", \"vertices\": %d, \"faces\": %d, "
+                    "\"seams\": %d, \"pieces\": %d, \"utilization\": %.4f, \"ms\": %.2f}%s\n",
+                    jsonEscape(jobs[i].name).c_str(), r.success ? "true" : "false", jsonEscape(r.error).c_str(), r.vertices, r.faces,
+                    r.seams, r.pieces, r.utilization, r.ms, i + 1 < jobs.size() ? "," : "");
+    }
+    std::printf("  ],\n  \"failed\": %d,\n  \"totalMs\": %.2f,\n  \"facesPerSec\": %.0f\n}\n",
+                failed, totalMs, totalMs > 0 ? totalFaces * 1000.0 / totalMs : 0.0);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+/**
+ * 缝线JSON读取实现：递归下降解析成树，再按SeamProcessor.js的规则取边
+ */
+
+#include "seam_json.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace bff {
+
+namespace {
+
+struct JsonValue {
+    enum Type { Null, Bool, Number, String, Array, Object } type = Null;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> items;                              // Array
+    std::vector<std::pair<std::string, JsonValue>> members;    // Object
+
+    const JsonValue* get(const char* key) const {
+        if (type != Object) return nullptr;
+        for (const auto& m : members) {
+            if (m.first == key) return &m.second;
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    JsonParser(const std::string& text) : p(text.c_str()), begin(text.c_str()), end(text.c_str() + text.size()) {}
+
+    bool parse(JsonValue& out, std::string& error) {
+        if (!value(out, 0) || (skip(), p != end)) {
+            error = "Invalid seam JSON at offset " + std::to_string(p - begin);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    const char* p;
+    const char* begin;
+    const char* end;
+
+    void skip() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+    }
+
+    bool literal(const char* word) {
+        size_t n = std::strlen(word);
+        if (size_t(end - p) < n || std::strncmp(p, word, n) != 0) return false;
+        p += n;
+        return true;
+    }
+
+    bool string(std::string& out) {
+        if (p >= end || *p != '"') return false;
+        p++;
+        while (p < end && *p != '"') {
+            if (*p == '\\') {
+                if (++p >= end) return false;
+                switch (*p) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u':
+                        // 键和type只用到ASCII，其他字符原样保留转义
+                        if (end - p < 5) return false;
+                        out.append(p - 1, 6);
+                        p += 4;
+                        break;
+                    default: out += *p; break;
+                }
+                p++;
+            } else {
+                out += *p++;
+            }
+        }
+        if (p >= end) return false;
+        p++;
+        return true;
+    }
+
+    bool value(JsonValue& out, int depth) {
+        if (depth > 64) return false;
+        skip();
+        if (p >= end) return false;
+        switch (*p) {
+            case '{': {
+                out.type = JsonValue::Object;
+                p++;
+                skip();
+                if (p < end && *p == '}') { p++; return true; }
+                while (true) {
+                    skip();
+                    std::pair<std::string, JsonValue> member;
+                    if (!string(member.first)) return false;
+                    skip();
+                    if (p >= end || *p++ != ':') return false;
+                    if (!value(member.second, depth + 1)) return false;
+                    out.members.push_back(std::move(member));
+                    skip();
+                    if (p < end && *p == ',') { p++; continue; }
+                    if (p < end && *p == '}') { p++; return true; }
+                    return false;
+                }
+            }
+            case '[': {
+                out.type = JsonValue::Array;
+                p++;
+                skip();
+                if (p < end && *p == ']') { p++; return true; }
+                while (true) {
+                    out.items.emplace_back();
+                    if (!value(out.items.back(), depth + 1)) return false;
+                    skip();
+                    if (p < end && *p == ',') { p++; continue; }
+                    if (p < end && *p == ']') { p++; return true; }
+                    return false;
+                }
+            }
+            case '"':
+                out.type = JsonValue::String;
+                return string(out.string);
+            case 't':
+                out.type = JsonValue::Bool;
+                out.number = 1;
+                return literal("true");
+            case 'f':
+                out.type = JsonValue::Bool;
+                return literal("false");
+            case 'n':
+                return literal("null");
+            default: {
+                // 文本以'\0'结尾，strtod不会越过end
+                char* next = nullptr;
+                out.type = JsonValue::Number;
+                out.number = std::strtod(p, &next);
+                if (next == p) return false;
+                p = next;
+                return true;
+            }
+        }
+    }
+};
+
+// 取边时的上下文：edges为网格的无向边（小端点在高32位），升序
+struct SeamContext {
+    const std::vector<int>& remap;
+    std::vector<uint64_t> edges;
+    std::vector<int>& seams;
+    std::string error;
+};
+
+uint64_t edgeKey(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return (uint64_t(uint32_t(a)) << 32) | uint32_t(b);
+}
+
+bool vertexIndex(const JsonValue* v, const std::vector<int>& remap, long& file, int& out) {
+    if (!v || v->type != JsonValue::Number) return false;
+    double x = v->number;
+    if (x < 0 || x >= double(remap.size()) || x != double(long(x))) return false;
+    file = long(x);
+    out = remap[file];
+    return true;
+}
+
+// 越界或首尾相同的顶点对忽略，两端不相邻时报错（同SeamProcessor.js的isValidEdge）
+bool addEdge(const JsonValue* a, const JsonValue* b, SeamContext& context) {
+    long f1, f2;
+    int v1, v2;
+    if (!vertexIndex(a, context.remap, f1, v1) || !vertexIndex(b, context.remap, f2, v2) || v1 == v2) return true;
+    if (!std::binary_search(context.edges.begin(), context.edges.end(), edgeKey(v1, v2))) {
+        context.error = "Seam edge " + std::to_string(f1) + "-" + std::to_string(f2) + " is not an edge of the mesh";
+        return false;
+    }
+    context.seams.push_back(v1);
+    context.seams.push_back(v2);
+    return true;
+}
+
+bool addPath(const JsonValue& path, SeamContext& context) {
+    for (size_t i = 1; i < path.items.size(); i++) {
+        if (!addEdge(&path.items[i - 1], &path.items[i], context)) return false;
+    }
+    return true;
+}
+
+bool addSeam(const JsonValue& seam, SeamContext& context) {
+    const JsonValue* type = seam.get("type");
+    if (type && type->type == JsonValue::String && type->string == "sew") return true;
+
+    const JsonValue* edges = seam.get("edges");
+    const JsonValue* vertices = seam.get("vertices");
+    const JsonValue* path = seam.get("path");
+    if (edges && edges->type == JsonValue::Array) {
+        for (const JsonValue& e : edges->items) {
+            bool ok = true;
+            if (e.type == JsonValue::Array && e.items.size() >= 2) {
+                ok = addEdge(&e.items[0], &e.items[1], context);
+            } else if (e.type == JsonValue::Object) {
+                ok = addEdge(e.get("start") ? e.get("start") : e.get("v1"),
+                             e.get("end") ? e.get("end") : e.get("v2"), context);
+            }
+            if (!ok) return false;
+        }
+    } else if (vertices && vertices->type == JsonValue::Array) {
+        return addPath(*vertices, context);
+    } else if (path && path->type == JsonValue::Array) {
+        return addPath(*path, context);
+    }
+    return true;
+}
+
+} // namespace
+
+bool readCutSeams(const std::string& json, const std::vector<int>& remap, const std::vector<int>& triangles,
+                  std::vector<int>& seams, std::string& error) {
+    JsonValue root;
+    JsonParser parser(json);
+    if (!parser.parse(root, error)) return false;
+
+    SeamContext context{remap, {}, seams, {}};
+    context.edges.reserve(triangles.size());
+    for (size_t t = 0; t + 2 < triangles.size(); t += 3) {
+        for (int k = 0; k < 3; k++) context.edges.push_back(edgeKey(triangles[t + k], triangles[t + (k + 1) % 3]));
+    }
+    std::sort(context.edges.begin(), context.edges.end());
+
+    const JsonValue* list = root.get("seams");
+    if (!list) list = root.get("cuts");
+    if (!list) list = &root;
+    bool ok = true;
+    if (list->type == JsonValue::Array) {
+        for (const JsonValue& seam : list->items) {
+            if (ok && seam.type == JsonValue::Object) ok = addSeam(seam, context);
+        }
+    } else if (list->type == JsonValue::Object) {
+        ok = addSeam(*list, context);
+    }
+    if (!ok) error = context.error;
+    return ok;
+}
+
+} // namespace bff
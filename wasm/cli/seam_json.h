@@ -0,0 +1,29 @@
+/**
+ * 缝线JSON读取（SeamProcessor.js 的 validateSeams 的原生实现，供命令行工具使用）
+ * 支持README中的格式：{ seams | cuts: [...] }、缝线数组或单条缝线；
+ * 每条缝线用 edges（[[a,b], ...] 或 [{start,end} | {v1,v2}, ...]）、vertices 或 path 给出，
+ * type为 "sew" 的缝线不切开，其余（含缺省）按切割边处理
+ */
+
+#ifndef BFF_SEAM_JSON_H
+#define BFF_SEAM_JSON_H
+
+#include <string>
+#include <vector>
+
+namespace bff {
+
+/**
+ * 取出切割边
+ * @param json 缝线JSON文本
+ * @param remap OBJ文件中的顶点 -> 合并后顶点（ObjReader::vertexRemap），越界的顶点被忽略
+ * @param triangles 合并后的三角形（ObjReader::triangles），两端不相邻的顶点对视为错误
+ * @param seams 输出 [a0,b0, a1,b1, ...]（合并后顶点编号）
+ * @return JSON语法错误或顶点对不是网格的边时返回false，error给出位置或顶点对（文件中的编号）
+ */
+bool readCutSeams(const std::string& json, const std::vector<int>& remap, const std::vector<int>& triangles,
+                  std::vector<int>& seams, std::string& error);
+
+} // namespace bff
+
+#endif // BFF_SEAM_JSON_H
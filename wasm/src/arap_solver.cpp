@@ -0,0 +1,338 @@
+/**
+ * ARAP展开实现
+ */
+
+#include "arap_solver.h"
+#include "bff_flattener.h"
+#include "task_scheduler.h"
+#include <algorithm>
+#include <cmath>
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+namespace bff {
+
+// 单个三角形的最优旋转：S = Σ w (u边)(x边)^T，R取S的极分解中的旋转部分
+static inline void fitRotationScalar(int T, int t,
+                                     const double* ex, const double* ey, const double* ew,
+                                     const double* eu, const double* ev,
+                                     double* outCos, double* outSin) {
+    double a = 0, b = 0, c = 0, d = 0;
+    for (int k = 0; k < 3; k++) {
+        int off = k * T + t;
+        double wu = ew[off] * eu[off];
+        double wv = ew[off] * ev[off];
+        a += wu * ex[off];
+        b += wu * ey[off];
+        c += wv * ex[off];
+        d += wv * ey[off];
+    }
+    double cs = a + d;
+    double sn = c - b;
+    double r = std::sqrt(cs * cs + sn * sn);
+    if (r > 1e-20) {
+        outCos[t] = cs / r;
+        outSin[t] = sn / r;
+    } else {
+        outCos[t] = 1.0;
+        outSin[t] = 0.0;
+    }
+}
+
+// 三角形 [begin, end) 的最优旋转，输入输出均为SoA布局（边k的数据位于 k * T + t）
+static void fitRotations(int T, int begin, int end,
+                         const double* ex, const double* ey, const double* ew,
+                         const double* eu, const double* ev,
+                         double* outCos, double* outSin) {
+    int t = begin;
+#ifdef __wasm_simd128__
+    const v128_t eps = wasm_f64x2_splat(1e-20);
+    const v128_t one = wasm_f64x2_splat(1.0);
+    const v128_t zero = wasm_f64x2_splat(0.0);
+    for (; t + 2 <= end; t += 2) {
+        v128_t a = zero, b = zero, c = zero, d = zero;
+        for (int k = 0; k < 3; k++) {
+            int off = k * T + t;
+            v128_t w = wasm_v128_load(ew + off);
+            v128_t x = wasm_v128_load(ex + off);
+            v128_t y = wasm_v128_load(ey + off);
+            v128_t wu = wasm_f64x2_mul(w, wasm_v128_load(eu + off));
+            v128_t wv = wasm_f64x2_mul(w, wasm_v128_load(ev + off));
+            a = wasm_f64x2_add(a, wasm_f64x2_mul(wu, x));
+            b = wasm_f64x2_add(b, wasm_f64x2_mul(wu, y));
+            c = wasm_f64x2_add(c, wasm_f64x2_mul(wv, x));
+            d = wasm_f64x2_add(d, wasm_f64x2_mul(wv, y));
+        }
+        v128_t cs = wasm_f64x2_add(a, d);
+        v128_t sn = wasm_f64x2_sub(c, b);
+        v128_t r = wasm_f64x2_sqrt(wasm_f64x2_add(wasm_f64x2_mul(cs, cs), wasm_f64x2_mul(sn, sn)));
+        v128_t valid = wasm_f64x2_gt(r, eps);
+        v128_t safe = wasm_v128_bitselect(r, one, valid);
+        cs = wasm_v128_bitselect(wasm_f64x2_div(cs, safe), one, valid);
+        sn = wasm_v128_bitselect(wasm_f64x2_div(sn, safe), zero, valid);
+        wasm_v128_store(outCos + t, cs);
+        wasm_v128_store(outSin + t, sn);
+    }
+#endif
+    for (; t < end; t++) {
+        fitRotationScalar(T, t, ex, ey, ew, eu, ev, outCos, outSin);
+    }
+}
+
+void ARAPSolver::setup(const std::vector<Vec3>& points,
+                       const std::vector<int>& tris,
+                       const std::vector<char>& boundaryEdge,
+                       const std::vector<int>& pinned,
+                       const ARAPOptions& options) {
+    ready = false;
+    setupOptions = options;
+    pinnedVertices = pinned;
+    numVertices = points.size();
+    numTriangles = tris.size() / 3;
+    triangles = tris;
+    int T = numTriangles;
+
+    // 边界平滑只作用于局部副本，不修改网格
+    std::vector<Vec3> pts = points;
+    if (options.smoothBoundary && options.smoothIterations > 0) {
+        std::vector<std::vector<int>> boundaryNeighbors(numVertices);
+        for (int t = 0; t < T; t++) {
+            for (int k = 0; k < 3; k++) {
+                if (!boundaryEdge[t * 3 + k]) continue;
+                int a = tris[t * 3 + (k + 1) % 3];
+                int b = tris[t * 3 + (k + 2) % 3];
+                boundaryNeighbors[a].push_back(b);
+                boundaryNeighbors[b].push_back(a);
+            }
+        }
+
+        std::vector<std::vector<int>> incidentTriangles(numVertices);
+        for (int t = 0; t < T; t++) {
+            for (int k = 0; k < 3; k++) {
+                int v = tris[t * 3 + k];
+                if (!boundaryNeighbors[v].empty()) incidentTriangles[v].push_back(t);
+            }
+        }
+
+        // 锯齿程度按平均边界边长归一化，与模型尺度无关
+        double boundaryLength = 0;
+        int boundaryCount = 0;
+        for (int v = 0; v < numVertices; v++) {
+            for (int nb : boundaryNeighbors[v]) {
+                boundaryLength += (pts[nb] - pts[v]).length();
+                boundaryCount++;
+            }
+        }
+        double invEdge = boundaryCount > 0 && boundaryLength > 1e-12
+            ? boundaryCount / boundaryLength : 1.0;
+
+        std::vector<Vec3> next;
+        for (int iter = 0; iter < options.smoothIterations; iter++) {
+            next = pts;
+            for (int v = 0; v < numVertices; v++) {
+                const auto& nbs = boundaryNeighbors[v];
+                if (nbs.empty()) continue;
+                Vec3 avg;
+                for (int nb : nbs) avg = avg + pts[nb];
+                avg = avg * (1.0 / nbs.size());
+
+                // 自适应平滑因子：锯齿越大，平滑越强
+                double curvature = (pts[v] - avg).length() * invEdge;
+                double factor = std::min(0.6, 0.3 + curvature * 2);
+                next[v] = pts[v] + (avg - pts[v]) * factor;
+            }
+            
+            // 平滑不能使相邻三角形翻折，否则保留该顶点原位置
+            for (int v = 0; v < numVertices; v++) {
+                if (boundaryNeighbors[v].empty()) continue;
+                for (int t : incidentTriangles[v]) {
+                    const int* tri = &tris[t * 3];
+                    const Vec3& q0 = tri[0] == v ? next[v] : pts[tri[0]];
+                    const Vec3& q1 = tri[1] == v ? next[v] : pts[tri[1]];
+                    const Vec3& q2 = tri[2] == v ? next[v] : pts[tri[2]];
+                    Vec3 n = (q1 - q0).cross(q2 - q0);
+                    Vec3 n0 = (points[tri[1]] - points[tri[0]]).cross(points[tri[2]] - points[tri[0]]);
+                    if (n.dot(n0) <= 0) {
+                        next[v] = pts[v];
+                        break;
+                    }
+                }
+            }
+            pts.swap(next);
+        }
+    }
+
+    // 每个三角形展开到等距的局部2D坐标系
+    edgeX.assign(3 * T, 0.0);
+    edgeY.assign(3 * T, 0.0);
+    edgeW.assign(3 * T, 0.0);
+    edgeU.assign(3 * T, 0.0);
+    edgeV.assign(3 * T, 0.0);
+    rotCos.assign(T, 1.0);
+    rotSin.assign(T, 0.0);
+
+    std::vector<double> cotans = cotanWeights(pts, tris);
+    for (int t = 0; t < T; t++) {
+        const Vec3& p0 = pts[tris[t * 3]];
+        Vec3 e1 = pts[tris[t * 3 + 1]] - p0;
+        Vec3 e2 = pts[tris[t * 3 + 2]] - p0;
+        double l1 = e1.length();
+        double lx[3] = {0, l1, 0};
+        double ly[3] = {0, 0, 0};
+        if (l1 > 1e-12) {
+            lx[2] = e2.dot(e1) / l1;
+            ly[2] = e1.cross(e2).length() / l1;
+        }
+
+        for (int k = 0; k < 3; k++) {
+            int j = (k + 1) % 3;
+            int kk = (k + 2) % 3;
+            double stiffness = options.boundaryConstraints && boundaryEdge[t * 3 + k]
+                ? options.boundaryStiffness : options.internalStiffness;
+            // 钝角的负余切会使加权矩阵不定，截断为小正数
+            cotans[t * 3 + k] = std::max(cotans[t * 3 + k], 1e-3) * stiffness;
+
+            int off = k * T + t;
+            edgeX[off] = lx[j] - lx[kk];
+            edgeY[off] = ly[j] - ly[kk];
+            edgeW[off] = 0.5 * cotans[t * 3 + k];
+        }
+    }
+
+    // 全局矩阵只依赖几何、权重和固定顶点，消去固定顶点后预分解
+    CSRMatrix L = assembleCotanLaplacian(numVertices, tris, cotans);
+    std::vector<char> isFixed(numVertices, 0);
+    if (pinned.empty()) {
+        if (numVertices > 0) isFixed[0] = 1;
+    } else {
+        for (int v : pinned) isFixed[v] = 1;
+    }
+    freeIndex.assign(numVertices, -1);
+    numFree = 0;
+    for (int v = 0; v < numVertices; v++) {
+        if (!isFixed[v]) freeIndex[v] = numFree++;
+    }
+    reduceDirichlet(L, freeIndex, numFree, reduced, coupling);
+
+    factor = LDLTFactorization();
+    factorValid = false;
+    if (numFree > 0) {
+        factorValid = factor.analyze(reduced) && factor.factorize(reduced);
+    }
+    ready = true;
+}
+
+void ARAPSolver::localStep(const std::vector<Vec2>& uvs) {
+    int T = numTriangles;
+    
+    // 各三角形互不相关，按块分给调度器：收集当前UV边向量并拟合旋转
+    parallelFor(T, 1024, [&](int begin, int end) {
+        for (int t = begin; t < end; t++) {
+            const int* tri = &triangles[t * 3];
+            for (int k = 0; k < 3; k++) {
+                const Vec2& pj = uvs[tri[(k + 1) % 3]];
+                const Vec2& pk = uvs[tri[(k + 2) % 3]];
+                edgeU[k * T + t] = pj.x - pk.x;
+                edgeV[k * T + t] = pj.y - pk.y;
+            }
+        }
+        fitRotations(T, begin, end, edgeX.data(), edgeY.data(), edgeW.data(),
+                     edgeU.data(), edgeV.data(), rotCos.data(), rotSin.data());
+    });
+}
+
+ARAPStats ARAPSolver::solve(std::vector<Vec2>& uvs, int iterations, double tolerance) {
+    ARAPStats stats;
+    if (!ready || numVertices < 3 || numFree == 0) {
+        stats.converged = true;
+        return stats;
+    }
+    int T = numTriangles;
+
+    // 固定顶点保持输入坐标，其贡献移到右端项
+    std::vector<double> bu(numVertices), bv(numVertices);
+    std::vector<double> fixedU(numVertices, 0.0), fixedV(numVertices, 0.0);
+    std::vector<double> xu(numFree), xv(numFree), cu(numFree), cv(numFree);
+    for (int v = 0; v < numVertices; v++) {
+        if (freeIndex[v] >= 0) continue;
+        fixedU[v] = uvs[v].x;
+        fixedV[v] = uvs[v].y;
+    }
+    coupling.multiply(fixedU.data(), cu.data());
+    coupling.multiply(fixedV.data(), cv.data());
+
+    double prevEnergy = -1;
+    for (int iter = 0; iter < iterations; iter++) {
+        // 局部步骤：每个三角形的最优旋转
+        localStep(uvs);
+        stats.iterations = iter + 1;
+
+        // 全局步骤：右端项 b_j = Σ w R (x_j - x_k)，同时累计当前能量
+        std::fill(bu.begin(), bu.end(), 0.0);
+        std::fill(bv.begin(), bv.end(), 0.0);
+        double energy = 0;
+        for (int t = 0; t < T; t++) {
+            const int* tri = &triangles[t * 3];
+            double c = rotCos[t];
+            double s = rotSin[t];
+            for (int k = 0; k < 3; k++) {
+                int off = k * T + t;
+                double w = edgeW[off];
+                double ex = c * edgeX[off] - s * edgeY[off];
+                double ey = s * edgeX[off] + c * edgeY[off];
+                double du = edgeU[off] - ex;
+                double dv = edgeV[off] - ey;
+                energy += w * (du * du + dv * dv);
+                double rx = w * ex;
+                double ry = w * ey;
+                int j = tri[(k + 1) % 3];
+                int kk = tri[(k + 2) % 3];
+                bu[j] += rx;
+                bv[j] += ry;
+                bu[kk] -= rx;
+                bv[kk] -= ry;
+            }
+        }
+
+        for (int v = 0; v < numVertices; v++) {
+            int fi = freeIndex[v];
+            if (fi < 0) continue;
+            xu[fi] = bu[v] - cu[fi];
+            xv[fi] = bv[v] - cv[fi];
+        }
+
+        if (factorValid) {
+            factor.solve(xu);
+            factor.solve(xv);
+        } else {
+            std::vector<double> ru(xu), rv(xv);
+            for (int v = 0; v < numVertices; v++) {
+                int fi = freeIndex[v];
+                if (fi < 0) continue;
+                xu[fi] = uvs[v].x;
+                xv[fi] = uvs[v].y;
+            }
+            solvePCG(reduced, ru, xu);
+            solvePCG(reduced, rv, xv);
+        }
+
+        for (int v = 0; v < numVertices; v++) {
+            int fi = freeIndex[v];
+            if (fi < 0) continue;
+            uvs[v].x = xu[fi];
+            uvs[v].y = xv[fi];
+        }
+        
+        // 能量相对下降足够小时结束（本次全局步骤已完成）
+        stats.energy = energy;
+        if (prevEnergy >= 0 && prevEnergy - energy <= tolerance * prevEnergy) {
+            stats.converged = true;
+            break;
+        }
+        prevEnergy = energy;
+    }
+    return stats;
+}
+
+} // namespace bff
@@ -0,0 +1,96 @@
+/**
+ * ARAP (As-Rigid-As-Possible) 展开
+ * 局部步骤：每个三角形求最优旋转（2x2矩阵的极分解，SIMD并行，多线程构建中按块并行）
+ * 全局步骤：预分解的加权余切拉普拉斯，每次迭代只做回代
+ */
+
+#ifndef ARAP_SOLVER_H
+#define ARAP_SOLVER_H
+
+#include <vector>
+#include "sparse_solver.h"
+#include "scalar_types.h"
+
+namespace bff {
+
+// 与 ARAPFlattener.js 的 flatten(iterations, options) 对应
+struct ARAPOptions {
+    int iterations = 10;
+    bool boundaryConstraints = true;   // 边界边使用 boundaryStiffness 权重
+    bool smoothBoundary = true;        // 展开前对3D边界做拉普拉斯平滑（消除锯齿）
+    int smoothIterations = 5;
+    double boundaryStiffness = 10.0;   // 边界刚性权重
+    double internalStiffness = 1.0;    // 内部弹性权重
+    double tolerance = 1e-6;           // 相对能量下降低于此值时提前结束（iterations为上限）
+
+    // 影响预分解的参数是否相同（iterations和tolerance不影响）
+    bool sameSetup(const ARAPOptions& o) const {
+        return boundaryConstraints == o.boundaryConstraints &&
+               smoothBoundary == o.smoothBoundary &&
+               smoothIterations == o.smoothIterations &&
+               boundaryStiffness == o.boundaryStiffness &&
+               internalStiffness == o.internalStiffness;
+    }
+};
+
+// 迭代统计
+struct ARAPStats {
+    int iterations = 0;
+    double energy = 0;         // 最后一次局部步骤后的ARAP能量 Σ w |u_e - R x_e|^2
+    bool converged = false;    // 相对能量下降低于tolerance
+};
+
+class ARAPSolver {
+public:
+    /**
+     * 建立局部坐标系、权重并预分解全局矩阵
+     * @param points 片段3D顶点
+     * @param triangles 片段三角形 [a0,b0,c0, ...]
+     * @param boundaryEdge 每个角对边是否为边界边 [3*T]，角k的对边为 (k+1, k+2)
+     * @param pinned 固定顶点（升序），全局步骤中保持初始UV；为空时只固定顶点0消除平移自由度
+     * @param options 展开参数
+     */
+    void setup(const std::vector<Vec3>& points,
+               const std::vector<int>& triangles,
+               const std::vector<char>& boundaryEdge,
+               const std::vector<int>& pinned,
+               const ARAPOptions& options);
+
+    /**
+     * 从初始UV开始执行局部/全局交替迭代，能量相对下降低于tolerance时提前结束
+     * @param uvs 输入初始UV（固定顶点取其中的坐标），输出结果（3D尺度，未归一化）
+     * @param iterations 最大迭代次数
+     */
+    ARAPStats solve(std::vector<Vec2>& uvs, int iterations, double tolerance = 0.0);
+
+    bool isReady() const { return ready; }
+    const ARAPOptions& options() const { return setupOptions; }
+    const std::vector<int>& pinned() const { return pinnedVertices; }
+
+private:
+    bool ready = false;
+    ARAPOptions setupOptions;
+    std::vector<int> pinnedVertices;
+    int numVertices = 0;
+    int numTriangles = 0;
+    std::vector<int> triangles;
+
+    // SoA：每个三角形三条边的等距局部坐标 (x_j - x_k) 和权重，下标 k * T + t
+    std::vector<double> edgeX, edgeY, edgeW;
+
+    // 每次迭代复用的缓冲区
+    std::vector<double> edgeU, edgeV;   // 当前UV边向量
+    std::vector<double> rotCos, rotSin; // 每个三角形的旋转
+
+    std::vector<int> freeIndex;         // 局部顶点 -> 自由变量编号，固定为-1
+    int numFree = 0;
+    CSRMatrix reduced, coupling;
+    LDLTFactorization factor;
+    bool factorValid = false;
+
+    void localStep(const std::vector<Vec2>& uvs);
+};
+
+} // namespace bff
+
+#endif // ARAP_SOLVER_H
@@ -0,0 +1,91 @@
+/**
+ * 线性（bump）分配器
+ * 拓扑构建时的临时数组从同一块内存顺序分配，reset后保留容量，
+ * 同一实例反复setMesh时不再向系统申请内存
+ */
+
+#ifndef BFF_ARENA_H
+#define BFF_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace bff {
+
+class Arena {
+public:
+    /**
+     * 分配count个未初始化元素，只用于平凡类型
+     * 返回的指针在下一次reset之前有效
+     */
+    template <typename T>
+    T* alloc(size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Arena only holds trivial types");
+        return static_cast<T*>(allocBytes(count * sizeof(T), alignof(T)));
+    }
+
+    // 分配并填充初值
+    template <typename T>
+    T* alloc(size_t count, T value) {
+        T* p = alloc<T>(count);
+        for (size_t i = 0; i < count; i++) p[i] = value;
+        return p;
+    }
+
+    // 释放全部分配；使用过多块时合并为一块，下次同样规模的使用只占一块
+    void reset() {
+        if (blocks.size() > 1) {
+            size_t total = 0;
+            for (const Block& b : blocks) total += b.size;
+            blocks.clear();
+            addBlock(total);
+        }
+        offset = 0;
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Block& b : blocks) total += b.size;
+        return total;
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    static constexpr size_t kMinBlock = 64 * 1024;
+
+    std::vector<Block> blocks;
+    size_t offset = 0;   // 当前（最后一个）块内的已用字节
+
+    void addBlock(size_t size) {
+        blocks.push_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+        offset = 0;
+    }
+
+    void* allocBytes(size_t bytes, size_t align) {
+        if (!blocks.empty()) {
+            Block& b = blocks.back();
+            size_t start = (offset + align - 1) & ~(align - 1);
+            if (start + bytes <= b.size) {
+                offset = start + bytes;
+                return b.data.get() + start;
+            }
+        }
+        size_t last = blocks.empty() ? 0 : blocks.back().size;
+        size_t size = kMinBlock;
+        if (size < last * 2) size = last * 2;
+        if (size < bytes + align) size = bytes + align;
+        addBlock(size);
+        return allocBytes(bytes, align);
+    }
+};
+
+} // namespace bff
+
+#endif // BFF_ARENA_H
@@ -0,0 +1,160 @@
+/**
+ * 批量展开实现
+ */
+
+#include "batch_flatten.h"
+#include "profiler.h"
+#include <cstring>
+
+namespace bff {
+
+namespace {
+
+inline uint64_t align8(uint64_t x) {
+    return (x + 7) & ~uint64_t(7);
+}
+
+// 输入容器中一个零件的数组偏移
+struct PartLayout {
+    BatchPartHeader header;
+    uint64_t vertices;
+    uint64_t faces;
+    uint64_t seams;
+};
+
+struct PartResult {
+    int32_t status = BatchOk;
+    std::string error;
+    std::vector<double> uvs;
+    std::vector<int> uvFaces;
+};
+
+bool readLayout(const uint8_t* data, size_t size, std::vector<PartLayout>& parts, std::string& error) {
+    if (!data || size < sizeof(BatchHeader)) {
+        error = "Batch too small";
+        return false;
+    }
+    BatchHeader head;
+    std::memcpy(&head, data, sizeof(head));
+    if (head.magic != kBatchInputMagic) {
+        error = "Not a BFF batch";
+        return false;
+    }
+    if (head.version != kBatchVersion) {
+        error = "Unsupported batch version";
+        return false;
+    }
+    uint64_t offset = sizeof(BatchHeader) + uint64_t(sizeof(BatchPartHeader)) * head.partCount;
+    if (offset > size) {
+        error = "Truncated batch";
+        return false;
+    }
+
+    parts.resize(head.partCount);
+    for (uint32_t i = 0; i < head.partCount; i++) {
+        PartLayout& p = parts[i];
+        std::memcpy(&p.header, data + sizeof(BatchHeader) + sizeof(BatchPartHeader) * i, sizeof(BatchPartHeader));
+        // 各计数不超过32位，64位下累加不会溢出
+        offset = align8(offset);
+        p.vertices = offset;
+        offset = align8(offset + uint64_t(p.header.numVertices) * 3 * sizeof(double));
+        p.faces = offset;
+        offset = align8(offset + uint64_t(p.header.numFaces) * 3 * sizeof(int32_t));
+        p.seams = offset;
+        offset += uint64_t(p.header.numSeamEdges) * 2 * sizeof(int32_t);
+        if (offset > size || p.header.numVertices > 0x7fffffff / 3 || p.header.numFaces > 0x7fffffff / 3 ||
+            p.header.numSeamEdges > 0x7fffffff / 2) {
+            error = "Truncated batch";
+            parts.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void flattenPart(const uint8_t* data, const PartLayout& part, const BatchOptions& options, PartResult& out) {
+    BFF_PROFILE_SCOPE("batchPart");
+    const BatchPartHeader& h = part.header;
+    BFFFlattener flattener;
+    flattener.setMeshOrdering(options.ordering);
+    flattener.setMethod(options.method);
+    flattener.setARAPOptions(options.arap);
+    flattener.setSolverOptions(options.solver);
+
+    // 输入容器不保证按double对齐，逐个复制
+    Real* vertices = flattener.vertexUploadBuffer(h.numVertices);
+    const uint8_t* src = data + part.vertices;
+    for (size_t i = 0; i < size_t(h.numVertices) * 3; i++) {
+        double x;
+        std::memcpy(&x, src + i * sizeof(double), sizeof(double));
+        vertices[i] = static_cast<Real>(x);
+    }
+    std::memcpy(flattener.faceUploadBuffer(h.numFaces), data + part.faces, sizeof(int32_t) * h.numFaces * 3);
+    if (!flattener.commitMeshUpload()) {
+        out.status = BatchInvalidMesh;
+        out.error = flattener.getError();
+        return;
+    }
+
+    std::vector<int> seams(size_t(h.numSeamEdges) * 2);
+    if (!seams.empty()) std::memcpy(seams.data(), data + part.seams, sizeof(int32_t) * seams.size());
+    flattener.setSeamEdges(seams.data(), h.numSeamEdges);
+
+    if (!flattener.flatten()) {
+        out.status = BatchFlattenFailed;
+        out.error = flattener.getError();
+        return;
+    }
+    const std::vector<Real>& uvs = flattener.getUVCoords();
+    out.uvs.assign(uvs.begin(), uvs.end());
+    out.uvFaces = flattener.getResult().uvFaces;
+}
+
+} // namespace
+
+bool flattenBatch(const uint8_t* data, size_t size, const BatchOptions& options,
+                  std::vector<uint8_t>& out, std::string& error) {
+    BFF_PROFILE_SCOPE("batch");
+    std::vector<PartLayout> parts;
+    if (!readLayout(data, size, parts, error)) return false;
+
+    // 每个零件一个任务；零件内部的parallelFor由空闲线程窃取执行
+    int numParts = parts.size();
+    std::vector<PartResult> results(numParts);
+    parallelFor(numParts, 1, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            flattenPart(data, parts[i], options, results[i]);
+        }
+    });
+
+    // 各零件UV、面的角和错误信息的偏移
+    uint64_t offset = sizeof(BatchHeader) + uint64_t(sizeof(BatchPartOutput)) * numParts;
+    std::vector<BatchPartOutput> table(numParts);
+    std::vector<uint64_t> sections(numParts * 3);
+    for (int i = 0; i < numParts; i++) {
+        const PartResult& r = results[i];
+        table[i] = BatchPartOutput{r.status, uint32_t(r.uvs.size() / 2), uint32_t(r.uvFaces.size() / 3),
+                                   uint32_t(r.error.size())};
+        sections[i * 3] = offset = align8(offset);
+        sections[i * 3 + 1] = offset = align8(offset + sizeof(double) * r.uvs.size());
+        sections[i * 3 + 2] = offset = align8(offset + sizeof(int32_t) * r.uvFaces.size());
+        offset += r.error.size();
+    }
+
+    // 对齐填充为0，相同输入的输出逐字节相同
+    out.assign(align8(offset), 0);
+    BatchHeader head{kBatchOutputMagic, kBatchVersion, uint32_t(numParts), 0};
+    std::memcpy(out.data(), &head, sizeof(head));
+    if (numParts > 0) std::memcpy(out.data() + sizeof(head), table.data(), sizeof(BatchPartOutput) * numParts);
+    for (int i = 0; i < numParts; i++) {
+        const PartResult& r = results[i];
+        if (!r.uvs.empty()) std::memcpy(&out[sections[i * 3]], r.uvs.data(), sizeof(double) * r.uvs.size());
+        if (!r.uvFaces.empty()) {
+            std::memcpy(&out[sections[i * 3 + 1]], r.uvFaces.data(), sizeof(int32_t) * r.uvFaces.size());
+        }
+        if (!r.error.empty()) std::memcpy(&out[sections[i * 3 + 2]], r.error.data(), r.error.size());
+    }
+    return true;
+}
+
+} // namespace bff
@@ -0,0 +1,81 @@
+/**
+ * 批量展开：一个输入容器装多个网格及其缝线，一次调用全部展开，结果写入一个输出容器
+ * 服务端批处理上千个零件时省去逐零件、逐缝线边的JS调用；有多线程时各零件并行展开
+ *
+ * 输入布局（小端）：
+ *   BatchHeader（16字节，magic为 "BFFI"）
+ *   BatchPartHeader[partCount]（每项16字节）
+ *   各零件依次为 double[3V] 顶点、int32[3F] 面、int32[2S] 缝线边，每个数组起始偏移8字节对齐
+ * 输出布局：
+ *   BatchHeader（magic为 "BFFO"）
+ *   BatchPartOutput[partCount]
+ *   各零件依次为 double[2V'] UV、int32[3F] 面的角 -> 切分后顶点、char[errorLength] 错误信息，同样8字节对齐
+ * 失败的零件V'为0，只有状态码和错误信息
+ */
+
+#ifndef BFF_BATCH_FLATTEN_H
+#define BFF_BATCH_FLATTEN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "bff_flattener.h"
+
+namespace bff {
+
+const uint32_t kBatchInputMagic = 0x49464642;    // "BFFI"
+const uint32_t kBatchOutputMagic = 0x4f464642;   // "BFFO"
+const uint32_t kBatchVersion = 1;
+
+// 零件状态码
+enum BatchStatus : int32_t {
+    BatchOk = 0,
+    BatchInvalidMesh = 1,        // 面索引越界等，setMesh失败
+    BatchFlattenFailed = 2       // 展开失败（例如片段无法求解）
+};
+
+struct BatchHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t partCount;
+    uint32_t reserved;
+};
+
+struct BatchPartHeader {
+    uint32_t numVertices;
+    uint32_t numFaces;
+    uint32_t numSeamEdges;
+    uint32_t reserved;
+};
+
+struct BatchPartOutput {
+    int32_t status;              // BatchStatus
+    uint32_t numUVs;             // 切分后顶点数
+    uint32_t numFaces;
+    uint32_t errorLength;        // 字节数，不含结尾0
+};
+
+static_assert(sizeof(BatchHeader) == 16, "BatchHeader layout is fixed");
+static_assert(sizeof(BatchPartHeader) == 16, "BatchPartHeader layout is fixed");
+static_assert(sizeof(BatchPartOutput) == 16, "BatchPartOutput layout is fixed");
+
+// 所有零件共用的展开设置
+struct BatchOptions {
+    FlattenMethod method = FlattenMethod::Conformal;
+    ARAPOptions arap;
+    SolverOptions solver;
+    MeshOrdering ordering = MeshOrdering::Original;
+};
+
+/**
+ * 展开输入容器中的全部零件，写出输出容器
+ * 单个零件失败不影响其他零件，失败原因记在该零件的状态码和错误信息中
+ * @return 输入容器本身损坏（magic、版本不符或越界）时返回false，error给出原因
+ */
+bool flattenBatch(const uint8_t* data, size_t size, const BatchOptions& options,
+                  std::vector<uint8_t>& out, std::string& error);
+
+} // namespace bff
+
+#endif // BFF_BATCH_FLATTEN_H
@@ -3,12 +3,51 @@
  */
 
 #include "bff_flattener.h"
-#include <queue>
+#include "sparse_solver.h"
+#include "mesh_cache.h"
+#include "profiler.h"
+#include <unordered_map>
+#include <chrono>
+#include <cmath>
 #include <cstring>
 #include <limits>
+#include <type_traits>
 
 namespace bff {
 
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 按Real精度复制数组；精度相同时直接memcpy
+template <typename Dst, typename Src>
+void copyScalars(Dst* dst, const Src* src, size_t count) {
+    if (std::is_same<Dst, Src>::value) {
+        std::memcpy(dst, src, sizeof(Src) * count);
+    } else {
+        for (size_t i = 0; i < count; i++) dst[i] = static_cast<Dst>(src[i]);
+    }
+}
+
+// getUVCoordsFloat：单精度构建直接返回结果，双精度构建转换到缓存
+template <typename T>
+const std::vector<float>& uvAsFloat(const std::vector<T>& uvs, std::vector<float>& cache, bool& valid) {
+    if constexpr (std::is_same<T, float>::value) {
+        return uvs;
+    } else {
+        if (!valid) {
+            BFF_PROFILE_SCOPE("readback");
+            cache.assign(uvs.begin(), uvs.end());
+            valid = true;
+        }
+        return cache;
+    }
+}
+
+} // namespace
+
 BFFFlattener::BFFFlattener() {
 }
 
@@ -17,112 +56,577 @@ BFFFlattener::~BFFFlattener() {
 
 void BFFFlattener::setMesh(const double* vertices, int numVertices,
                            const int* faces, int numFaces) {
-    mesh.vertices.clear();
-    mesh.faces.clear();
+    copyScalars(vertexUploadBuffer(numVertices), vertices, size_t(numVertices) * 3);
+    std::memcpy(faceUploadBuffer(numFaces), faces, sizeof(int) * numFaces * 3);
+    commitMeshUpload();
+}
+
+Real* BFFFlattener::vertexUploadBuffer(int numVertices) {
+    // Vec3与Real[3]布局一致，调用方直接写入顶点存储
+    mesh.vertices.resize(numVertices);
+    return reinterpret_cast<Real*>(mesh.vertices.data());
+}
+
+int* BFFFlattener::faceUploadBuffer(int numFaces) {
+    // 面索引直接写入网格的扁平三角形数组
+    mesh.triangles.resize(numFaces * 3);
+    return mesh.triangles.data();
+}
+
+bool BFFFlattener::commitMeshUpload() {
+    BFF_PROFILE_SCOPE("upload");
+    auto start = std::chrono::steady_clock::now();
+    int numVertices = mesh.vertices.size();
+    int numFaces = mesh.numFaces();
+    resetMeshState();
+    
+    for (int idx : mesh.triangles) {
+        if (idx < 0 || idx >= numVertices) {
+            errorMsg = "Face index out of range";
+            mesh.vertices.clear();
+            mesh.triangles.clear();
+            return false;
+        }
+    }
+    
+    auto stage = std::chrono::steady_clock::now();
+    weldMesh();
+    numFaces = mesh.numFaces();
+    setupStats.repairMs = elapsedMs(stage);
+    
+    stage = std::chrono::steady_clock::now();
+    reorderMesh();
+    setupStats.reorderMs = elapsedMs(stage);
+    
+    stage = std::chrono::steady_clock::now();
+    computeFaceGeometry(mesh.vertices.data(), mesh.triangles.data(), numFaces, mesh.geometry);
+    setupStats.geometryMs = elapsedMs(stage);
+    
+    // 构建半边结构
+    stage = std::chrono::steady_clock::now();
+    buildHalfEdgeStructure();
+    if (!vertexOrder.empty()) {
+        for (auto& e : mesh.nonManifoldEdges) e = std::make_pair(vertexOrder[e.first], vertexOrder[e.second]);
+        std::sort(mesh.nonManifoldEdges.begin(), mesh.nonManifoldEdges.end());
+    }
+    setupStats.halfEdgeMs = elapsedMs(stage);
+    stage = std::chrono::steady_clock::now();
+    repairTopology();
+    setupStats.repairMs += elapsedMs(stage);
+    stage = std::chrono::steady_clock::now();
+    identifyBoundaries();
+    setupStats.boundaryMs = elapsedMs(stage);
+    setupStats.totalMs = elapsedMs(start);
+    return true;
+}
+
+void BFFFlattener::resetMeshState() {
+    // 只清空不释放，同一实例处理下一个网格时复用已有容量
     mesh.halfEdges.clear();
-    mesh.vertexHalfEdge.clear();
-    mesh.isBoundaryVertex.clear();
     mesh.seamEdges.clear();
+    mesh.nonManifoldEdges.clear();
+    mesh.geometry.clear();
+    faceLocalIndex.clear();
+    vertexOrder.clear();
+    vertexRank.clear();
+    faceOrder.clear();
+    repairStats = RepairStats();
+    repairVertexSource.clear();
+    repairFaceSource.clear();
+    pathFinder = EdgePathFinder();
+    islandCaches.clear();
+    pins.clear();
+    topologyDirty = true;
+    result = FlattenResult();
+    setupStats = MeshSetupStats();
+    nextIsland = 0;
+    pieceOk.clear();
     uvResult.clear();
+    uvFloatValid = false;
+    distortion = DistortionMetrics();
+    distortionValid = false;
+    packResult = PackResult();
+    packedUV.clear();
+    errorMsg.clear();
+}
+
+void BFFFlattener::weldMesh() {
+    if (!repairOptions.enabled()) return;
+    int numVertices = mesh.numVertices();
+    int numFaces = mesh.numFaces();
+    repairStats.inputVertices = numVertices;
+    repairStats.inputFaces = numFaces;
+    repairVertexSource.resize(numVertices);
+    for (int v = 0; v < numVertices; v++) repairVertexSource[v] = v;
+    repairFaceSource.resize(numFaces);
+    for (int f = 0; f < numFaces; f++) repairFaceSource[f] = f;
+    if (repairOptions.weldTolerance <= 0) return;
     
-    // 复制顶点
-    mesh.vertices.resize(numVertices);
-    for (int i = 0; i < numVertices; i++) {
-        mesh.vertices[i] = Vec3(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> remap(numVertices);
+    int welded = weldVertices(mesh.vertices.data(), numVertices, repairOptions.weldTolerance, remap.data(),
+                              repairVertexSource);
+    if (welded < numVertices) {
+        // 保留的顶点按原顺序，source[v] >= v，可以原地前移
+        for (int& idx : mesh.triangles) idx = remap[idx];
+        for (int v = 0; v < welded; v++) mesh.vertices[v] = mesh.vertices[repairVertexSource[v]];
+        mesh.vertices.resize(welded);
+    }
+    int kept = removeDegenerateFaces(mesh.triangles.data(), numFaces, repairFaceSource);
+    mesh.triangles.resize(kept * 3);
+    repairStats.weldedVertices = numVertices - welded;
+    repairStats.degenerateFaces = numFaces - kept;
+    repairStats.weldMs = elapsedMs(start);
+}
+
+void BFFFlattener::repairTopology() {
+    if (!repairOptions.enabled()) return;
+    BFF_PROFILE_SCOPE("repair");
+    auto start = std::chrono::steady_clock::now();
+    int numVertices = mesh.numVertices();
+    int numFaces = mesh.numFaces();
+    int numHE = numFaces * 3;
+    
+    std::vector<int> twin(numHE);
+    for (int heIdx = 0; heIdx < numHE; heIdx++) twin[heIdx] = mesh.halfEdges[heIdx].twin;
+    
+    // 对偶关系只在扇区内部，拆分后不变；逐面几何量也不变（位置相同）
+    if (repairOptions.splitNonManifold) {
+        // 按调用方的面顺序访问，拆分结果与是否重排无关
+        std::vector<int> corner(numHE), source, order;
+        if (!faceOrder.empty()) {
+            order.resize(numHE);
+            for (int f = 0; f < numFaces; f++) {
+                for (int k = 0; k < 3; k++) order[faceOrder[f] * 3 + k] = f * 3 + k;
+            }
+        }
+        int added = splitCornerFans(mesh.triangles.data(), twin.data(), nullptr, order.empty() ? nullptr : order.data(),
+                                    numFaces, numVertices, corner.data(), source);
+        if (added > 0) {
+            int total = source.size();
+            mesh.triangles.swap(corner);
+            mesh.vertices.resize(total);
+            mesh.vertexHalfEdge.assign(total, -1);
+            mesh.isBoundaryVertex.assign(total, false);
+            for (int v = numVertices; v < total; v++) mesh.vertices[v] = mesh.vertices[source[v]];
+            for (int heIdx = 0; heIdx < numHE; heIdx++) {
+                mesh.halfEdges[heIdx].vertex = mesh.triangles[heNext(heIdx)];
+                int& first = mesh.vertexHalfEdge[mesh.triangles[heIdx]];
+                if (first == -1) first = heIdx;
+            }
+            // 新顶点的内部编号与调用方编号相同
+            for (int v = numVertices; v < total; v++) {
+                int upload = repairVertexSource[callerVertex(source[v])];
+                repairVertexSource.push_back(upload);
+                if (!vertexOrder.empty()) {
+                    vertexOrder.push_back(v);
+                    vertexRank.push_back(v);
+                }
+            }
+        }
+        repairStats.splitVertices = added;
     }
+    repairStats.boundaryLoops = countBoundaryLoops(mesh.triangles.data(), twin.data(), numFaces, mesh.numVertices());
+    repairStats.splitMs = elapsedMs(start);
+}
+
+void BFFFlattener::getMeshTriangles(std::vector<int>& out) const {
+    int numFaces = mesh.numFaces();
+    out.resize(numFaces * 3);
+    for (int f = 0; f < numFaces; f++) {
+        int cf = faceOrder.empty() ? f : faceOrder[f];
+        for (int k = 0; k < 3; k++) out[cf * 3 + k] = callerVertex(mesh.triangles[f * 3 + k]);
+    }
+}
+
+void BFFFlattener::reorderMesh() {
+    if (meshOrdering == MeshOrdering::Original || mesh.triangles.empty()) return;
+    BFF_PROFILE_SCOPE("reorder");
+    int numVertices = mesh.numVertices();
+    int numFaces = mesh.numFaces();
     
-    // 复制面（三角形）
-    mesh.faces.resize(numFaces);
-    for (int i = 0; i < numFaces; i++) {
-        mesh.faces[i] = {faces[i * 3], faces[i * 3 + 1], faces[i * 3 + 2]};
+    vertexOrder = meshOrdering == MeshOrdering::RCM
+        ? rcmVertexOrder(mesh.triangles.data(), numFaces, numVertices)
+        : mortonVertexOrder(mesh.vertices.data(), numVertices);
+    vertexRank.resize(numVertices);
+    for (int v = 0; v < numVertices; v++) vertexRank[vertexOrder[v]] = v;
+    faceOrder = faceOrderByVertex(mesh.triangles.data(), numFaces, vertexRank);
+    applyMeshOrder(mesh.vertices, mesh.triangles, vertexOrder, vertexRank, faceOrder);
+}
+
+const std::vector<uint8_t>& BFFFlattener::saveCache() {
+    int numVertices = mesh.numVertices();
+    int numFaces = mesh.numFaces();
+    
+    std::vector<int> twins(mesh.halfEdges.size());
+    for (size_t h = 0; h < twins.size(); h++) twins[h] = mesh.halfEdges[h].twin;
+    
+    std::vector<int> nonManifold;
+    nonManifold.reserve(mesh.nonManifoldEdges.size() * 2);
+    for (const auto& e : mesh.nonManifoldEdges) {
+        nonManifold.push_back(e.first);
+        nonManifold.push_back(e.second);
     }
     
-    mesh.vertexHalfEdge.resize(numVertices, -1);
-    mesh.isBoundaryVertex.resize(numVertices, false);
+    // 缝线按key排序，相同状态写出的缓存逐字节相同
+    std::vector<uint64_t> seamKeys(mesh.seamEdges.begin(), mesh.seamEdges.end());
+    std::sort(seamKeys.begin(), seamKeys.end());
+    std::vector<int> seams;
+    seams.reserve(seamKeys.size() * 2);
+    for (uint64_t key : seamKeys) {
+        seams.push_back(static_cast<int>(key >> 32));
+        seams.push_back(static_cast<int>(key & 0xffffffffu));
+    }
     
-    // 构建半边结构
-    buildHalfEdgeStructure();
+    CacheHeader header{};
+    header.numVertices = numVertices;
+    header.numFaces = numFaces;
+    
+    // 缓存中的顶点始终为double，与构建精度无关
+    std::vector<double> positions(size_t(numVertices) * 3);
+    copyScalars(positions.data(), reinterpret_cast<const Real*>(mesh.vertices.data()), positions.size());
+    
+    CacheWriter writer;
+    writer.add(CacheVertices, positions.data(), positions.size());
+    writer.add(CacheTriangles, mesh.triangles.data(), mesh.triangles.size());
+    writer.add(CacheHalfEdgeTwins, twins.data(), twins.size());
+    writer.add(CacheNonManifoldEdges, nonManifold.data(), nonManifold.size());
+    writer.add(CacheSeamEdges, seams.data(), seams.size());
+    if (!vertexOrder.empty()) {
+        writer.add(CacheVertexOrder, vertexOrder.data(), vertexOrder.size());
+        writer.add(CacheFaceOrder, faceOrder.data(), faceOrder.size());
+    }
+    
+    // 片段划分只在与当前缝线一致时写出（缝线改动后尚未重新展开则省略）
+    if (!topologyDirty && numFaces > 0 && (int)result.facePiece.size() == numFaces) {
+        int numSplit = result.splitVertexSource.size();
+        header.numSplitVertices = numSplit;
+        header.numIslands = islands.size();
+        writer.add(CacheFacePieces, result.facePiece.data(), result.facePiece.size());
+        writer.add(CacheUVFaces, result.uvFaces.data(), result.uvFaces.size());
+        writer.add(CacheSplitVertexSource, result.splitVertexSource.data(), numSplit);
+        if (result.success && (int)uvResult.size() == numSplit * 2) {
+            writer.add(CacheUVs, uvResult.data(), uvResult.size());
+        }
+    }
+    
+    writer.finish(header, cacheBuffer);
+    return cacheBuffer;
+}
+
+uint8_t* BFFFlattener::cacheUploadBuffer(size_t size) {
+    cacheBuffer.resize(size);
+    return cacheBuffer.data();
+}
+
+bool BFFFlattener::commitCacheUpload() {
+    bool ok = loadCache(cacheBuffer.data(), cacheBuffer.size());
+    std::vector<uint8_t>().swap(cacheBuffer);
+    return ok;
+}
+
+bool BFFFlattener::loadCache(const uint8_t* data, size_t size) {
+    CacheReader reader;
+    std::string error;
+    auto fail = [this](const std::string& message) {
+        mesh.vertices.clear();
+        mesh.triangles.clear();
+        resetMeshState();
+        errorMsg = message;
+        return false;
+    };
+    if (!reader.open(data, size, error)) return fail(error);
+    
+    const CacheHeader& header = reader.header();
+    if (header.numVertices > (1u << 28) || header.numFaces > (1u << 28) ||
+        header.numSplitVertices > (1u << 29)) {
+        return fail("Cache mesh too large");
+    }
+    int numVertices = header.numVertices;
+    int numFaces = header.numFaces;
+    int numHE = numFaces * 3;
+    
+    mesh.vertices.resize(numVertices);
+    mesh.triangles.resize(numHE);
+    std::vector<int> twins(numHE);
+    std::vector<double> positions(size_t(numVertices) * 3);
+    if (!reader.read(CacheVertices, positions.data(), positions.size()) ||
+        !reader.read(CacheTriangles, mesh.triangles.data(), numHE) ||
+        !reader.read(CacheHalfEdgeTwins, twins.data(), numHE)) {
+        return fail("Cache is missing mesh sections");
+    }
+    copyScalars(reinterpret_cast<Real*>(mesh.vertices.data()), positions.data(), positions.size());
+    resetMeshState();
+    
+    for (int idx : mesh.triangles) {
+        if (idx < 0 || idx >= numVertices) return fail("Face index out of range");
+    }
+    
+    // 半边的next/prev/face由面顺序决定，只有twin需要恢复；逐条检查对偶关系
+    initFaceHalfEdges();
+    for (int h = 0; h < numHE; h++) {
+        int t = twins[h];
+        if (t == -1) continue;
+        if (t < 0 || t >= numHE || twins[t] != h || t / 3 == h / 3 ||
+            mesh.triangles[t] != mesh.halfEdges[h].vertex ||
+            mesh.halfEdges[t].vertex != mesh.triangles[h]) {
+            return fail("Corrupt half-edge topology in cache");
+        }
+        mesh.halfEdges[h].twin = t;
+    }
     identifyBoundaries();
+    
+    // 重排过的网格：两个顺序须同时存在且都是排列
+    if (reader.has(CacheVertexOrder) || reader.has(CacheFaceOrder)) {
+        vertexOrder.resize(numVertices);
+        faceOrder.resize(numFaces);
+        if (!reader.read(CacheVertexOrder, vertexOrder.data(), numVertices) ||
+            !reader.read(CacheFaceOrder, faceOrder.data(), numFaces)) {
+            return fail("Corrupt mesh ordering in cache");
+        }
+        vertexRank.assign(numVertices, -1);
+        for (int v = 0; v < numVertices; v++) {
+            int c = vertexOrder[v];
+            if (c < 0 || c >= numVertices || vertexRank[c] != -1) return fail("Corrupt mesh ordering in cache");
+            vertexRank[c] = v;
+        }
+        std::vector<char> seen(numFaces, 0);
+        for (int c : faceOrder) {
+            if (c < 0 || c >= numFaces || seen[c]) return fail("Corrupt mesh ordering in cache");
+            seen[c] = 1;
+        }
+    }
+    
+    size_t numNonManifold = reader.count<int>(CacheNonManifoldEdges);
+    size_t numSeamInts = reader.count<int>(CacheSeamEdges);
+    std::vector<int> nonManifold(numNonManifold), seams(numSeamInts);
+    reader.read(CacheNonManifoldEdges, nonManifold.data(), numNonManifold);
+    reader.read(CacheSeamEdges, seams.data(), numSeamInts);
+    for (size_t i = 0; i + 1 < nonManifold.size(); i += 2) {
+        mesh.nonManifoldEdges.emplace_back(nonManifold[i], nonManifold[i + 1]);
+    }
+    for (size_t i = 0; i + 1 < seams.size(); i += 2) {
+        mesh.seamEdges.insert(edgeHashKey(seams[i], seams[i + 1]));
+    }
+    
+    computeFaceGeometry(mesh.vertices.data(), mesh.triangles.data(), numFaces, mesh.geometry);
+    
+    // 片段划分：直接恢复切分结果，跳过并查集和洪泛
+    if (reader.has(CacheFacePieces) && numFaces > 0) {
+        int numSplit = header.numSplitVertices;
+        int numIslands = header.numIslands;
+        result.facePiece.resize(numFaces);
+        result.uvFaces.resize(numHE);
+        result.splitVertexSource.resize(numSplit);
+        if (!reader.read(CacheFacePieces, result.facePiece.data(), numFaces) ||
+            !reader.read(CacheUVFaces, result.uvFaces.data(), numHE) ||
+            !reader.read(CacheSplitVertexSource, result.splitVertexSource.data(), numSplit)) {
+            return fail("Corrupt island partition in cache");
+        }
+        for (int p : result.facePiece) {
+            if (p < 0 || p >= numIslands) return fail("Corrupt island partition in cache");
+        }
+        for (int v : result.splitVertexSource) {
+            if (v < 0 || v >= numVertices) return fail("Corrupt island partition in cache");
+        }
+        for (int h = 0; h < numHE; h++) {
+            int sv = result.uvFaces[callerHalfEdge(h)];
+            if (sv < 0 || sv >= numSplit || result.splitVertexSource[sv] != callerVertex(mesh.triangles[h])) {
+                return fail("Corrupt island partition in cache");
+            }
+        }
+        
+        markSeamHalfEdges();
+        arena.reset();
+        buildIslands(numIslands);
+        rebindIslandCaches();
+        topologyDirty = false;
+        
+        uvResult.resize(numSplit * 2);
+        if (reader.read(CacheUVs, uvResult.data(), numSplit * 2)) {
+            result.success = true;
+        } else {
+            uvResult.clear();
+        }
+    }
+    return true;
 }
 
 void BFFFlattener::addSeamEdge(int v1, int v2) {
-    auto key = edgeKey(v1, v2);
-    if (mesh.seamEdges.empty()) {
-        mesh.seamEdges.resize(1);
+    if (!vertexRank.empty()) {
+        int n = vertexRank.size();
+        if (v1 < 0 || v1 >= n || v2 < 0 || v2 >= n) return;
+        v1 = vertexRank[v1];
+        v2 = vertexRank[v2];
+    }
+    if (mesh.seamEdges.insert(edgeHashKey(v1, v2)).second) {
+        topologyDirty = true;
+    }
+}
+
+void BFFFlattener::setSeamEdges(const int* edges, int numEdges) {
+    int n = vertexRank.size();
+    std::unordered_set<uint64_t> seams;
+    seams.reserve(numEdges);
+    for (int i = 0; i < numEdges; i++) {
+        int v1 = edges[i * 2];
+        int v2 = edges[i * 2 + 1];
+        if (n > 0) {
+            if (v1 < 0 || v1 >= n || v2 < 0 || v2 >= n) continue;
+            v1 = vertexRank[v1];
+            v2 = vertexRank[v2];
+        }
+        seams.insert(edgeHashKey(v1, v2));
+    }
+    if (seams != mesh.seamEdges) {
+        mesh.seamEdges.swap(seams);
+        topologyDirty = true;
     }
-    mesh.seamEdges[0].insert(key.first * 1000000 + key.second);
+}
+
+int BFFFlattener::addSeamPath(const int* path, int count, bool closed) {
+    int numVertices = mesh.numVertices();
+    std::vector<int> waypoints(count);
+    for (int i = 0; i < count; i++) {
+        int v = path[i];
+        if (v < 0 || v >= numVertices) return -1;
+        waypoints[i] = vertexRank.empty() ? v : vertexRank[v];
+    }
+    if (count < 2) return 0;
+    
+    BFF_PROFILE_SCOPE("seamPath");
+    if (pathFinder.empty()) {
+        pathFinder.build(mesh.vertices.data(), numVertices, mesh.triangles.data(), mesh.numFaces());
+    }
+    int added = 0;
+    int segments = closed && count > 2 ? count : count - 1;
+    std::vector<int> segment;
+    for (int i = 0; i < segments; i++) {
+        int a = waypoints[i];
+        int b = waypoints[(i + 1) % count];
+        if (a == b || !pathFinder.find(a, b, segment)) continue;
+        for (size_t j = 0; j + 1 < segment.size(); j++) {
+            if (mesh.seamEdges.insert(edgeHashKey(segment[j], segment[j + 1])).second) added++;
+        }
+    }
+    if (added > 0) topologyDirty = true;
+    return added;
 }
 
 void BFFFlattener::clearSeams() {
+    if (!mesh.seamEdges.empty()) {
+        topologyDirty = true;
+    }
     mesh.seamEdges.clear();
 }
 
-void BFFFlattener::buildHalfEdgeStructure() {
-    mesh.halfEdges.clear();
-    
-    std::map<std::pair<int, int>, int> edgeToHalfEdge;
+void BFFFlattener::setPin(int uvIndex, double u, double v) {
+    pins[uvIndex] = Vec2(u, v);
+}
+
+void BFFFlattener::removePin(int uvIndex) {
+    pins.erase(uvIndex);
+}
+
+void BFFFlattener::clearPins() {
+    pins.clear();
+}
+
+void BFFFlattener::initFaceHalfEdges() {
+    int numFaces = mesh.numFaces();
+    mesh.halfEdges.resize(numFaces * 3);
+    mesh.vertexHalfEdge.assign(mesh.numVertices(), -1);
+    mesh.isBoundaryVertex.assign(mesh.numVertices(), false);
     
-    for (int faceIdx = 0; faceIdx < (int)mesh.faces.size(); faceIdx++) {
-        const auto& face = mesh.faces[faceIdx];
-        int numVerts = face.size();
-        int firstHE = mesh.halfEdges.size();
+    for (int faceIdx = 0; faceIdx < numFaces; faceIdx++) {
+        const int* face = &mesh.triangles[faceIdx * 3];
+        int firstHE = faceIdx * 3;
         
-        for (int i = 0; i < numVerts; i++) {
-            HalfEdge he;
-            he.vertex = face[(i + 1) % numVerts];
-            he.face = faceIdx;
-            he.next = firstHE + (i + 1) % numVerts;
-            he.prev = firstHE + (i + numVerts - 1) % numVerts;
+        for (int i = 0; i < 3; i++) {
+            HalfEdge& he = mesh.halfEdges[firstHE + i];
+            he.vertex = face[(i + 1) % 3];
             he.twin = -1;
             he.isBoundary = false;
             he.isSeam = false;
             
-            int heIdx = mesh.halfEdges.size();
-            mesh.halfEdges.push_back(he);
-            
-            // 记录边到半边的映射
+            // 设置顶点的半边引用（以该顶点为起点的半边）
             int v1 = face[i];
-            int v2 = face[(i + 1) % numVerts];
-            edgeToHalfEdge[edgeKey(v1, v2)] = heIdx;
-            
-            // 设置顶点的半边引用
             if (mesh.vertexHalfEdge[v1] == -1) {
-                mesh.vertexHalfEdge[v1] = heIdx;
+                mesh.vertexHalfEdge[v1] = firstHE + i;
             }
         }
     }
+}
+
+void BFFFlattener::buildHalfEdgeStructure() {
+    BFF_PROFILE_SCOPE("halfEdgeBuild");
+    initFaceHalfEdges();
+    int numHE = mesh.halfEdges.size();
+    BFF_PROFILE_COUNT("halfEdges", numHE);
     
-    // 设置twin半边
-    for (int heIdx = 0; heIdx < (int)mesh.halfEdges.size(); heIdx++) {
-        HalfEdge& he = mesh.halfEdges[heIdx];
-        int v1 = mesh.faces[he.face][heIdx % 3];
-        int v2 = he.vertex;
+    // 按无向边分组：每条边记录前两条半边和出现次数，开放寻址哈希表，O(H)
+    struct EdgeSlot {
+        uint64_t key;
+        int first;
+        int second;
+        int count;
+    };
+    const uint64_t emptyKey = ~uint64_t(0);
+    size_t tableSize = 16;
+    while (tableSize < (size_t)numHE * 2) tableSize <<= 1;
+    size_t mask = tableSize - 1;
+    
+    arena.reset();
+    EdgeSlot* slots = arena.alloc<EdgeSlot>(tableSize, EdgeSlot{emptyKey, -1, -1, 0});
+    
+    for (int heIdx = 0; heIdx < numHE; heIdx++) {
+        uint64_t key = edgeHashKey(heOrigin(heIdx), mesh.halfEdges[heIdx].vertex);
+        size_t h = ((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        while (slots[h].key != emptyKey && slots[h].key != key) h = (h + 1) & mask;
         
-        auto twinKey = edgeKey(v2, v1);
-        auto it = edgeToHalfEdge.find(twinKey);
+        EdgeSlot& slot = slots[h];
+        if (slot.key == emptyKey) {
+            slot = EdgeSlot{key, heIdx, -1, 1};
+            continue;
+        }
+        if (slot.count == 1) {
+            slot.second = heIdx;
+        }
+        slot.count++;
+    }
+    
+    // 设置twin半边
+    for (size_t i = 0; i < tableSize; i++) {
+        const EdgeSlot& slot = slots[i];
+        if (slot.count <= 1) continue;  // 空槽或边界边
         
-        // 需要找到反向的边
-        for (int otherHeIdx = 0; otherHeIdx < (int)mesh.halfEdges.size(); otherHeIdx++) {
-            if (otherHeIdx == heIdx) continue;
-            HalfEdge& otherHe = mesh.halfEdges[otherHeIdx];
-            
-            int ov1 = mesh.faces[otherHe.face][otherHeIdx % 3];
-            int ov2 = otherHe.vertex;
-            
-            if (ov1 == v2 && ov2 == v1) {
-                he.twin = otherHeIdx;
-                break;
-            }
+        int a = slot.first;
+        int b = slot.second;
+        if (slot.count > 2) {
+            // 非流形边：不设置twin，记录下来交给调用方处理
+            mesh.nonManifoldEdges.emplace_back(heOrigin(a), mesh.halfEdges[a].vertex);
+            continue;
         }
+        
+        // 两条半边方向相同说明相邻面朝向不一致，同样按边界处理
+        if (heOrigin(a) != mesh.halfEdges[b].vertex) continue;
+        
+        mesh.halfEdges[a].twin = b;
+        mesh.halfEdges[b].twin = a;
     }
+    
+    std::sort(mesh.nonManifoldEdges.begin(), mesh.nonManifoldEdges.end());
+    BFF_PROFILE_MEMORY("halfEdges", mesh.halfEdges.capacity() * sizeof(HalfEdge));
+    BFF_PROFILE_MEMORY("arena", arena.capacity());
 }
 
 void BFFFlattener::identifyBoundaries() {
+    BFF_PROFILE_SCOPE("boundaries");
     for (int heIdx = 0; heIdx < (int)mesh.halfEdges.size(); heIdx++) {
         if (mesh.halfEdges[heIdx].twin == -1) {
             mesh.halfEdges[heIdx].isBoundary = true;
             
-            int v1 = mesh.faces[mesh.halfEdges[heIdx].face][heIdx % 3];
+            int v1 = heOrigin(heIdx);
             int v2 = mesh.halfEdges[heIdx].vertex;
             
             mesh.isBoundaryVertex[v1] = true;
@@ -131,271 +635,838 @@ void BFFFlattener::identifyBoundaries() {
     }
 }
 
+// 并查集查找（路径减半）
+static int findRoot(int* parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+// 定长位图，用于遍历时的访问标记
+struct BitSet {
+    std::vector<uint64_t> words;
+    explicit BitSet(int size) : words((size + 63) / 64, 0) {}
+    bool test(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    void set(int i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+};
+
+// 平移并等比缩放到单位正方形
+template <typename T>
+static void normalizeToUnitSquare(std::vector<Vec2T<T>>& uvs) {
+    BFF_PROFILE_SCOPE("normalize");
+    double minU = std::numeric_limits<double>::max();
+    double maxU = std::numeric_limits<double>::lowest();
+    double minV = std::numeric_limits<double>::max();
+    double maxV = std::numeric_limits<double>::lowest();
+    
+    for (const Vec2T<T>& uv : uvs) {
+        minU = std::min<double>(minU, uv.x);
+        maxU = std::max<double>(maxU, uv.x);
+        minV = std::min<double>(minV, uv.y);
+        maxV = std::max<double>(maxV, uv.y);
+    }
+    
+    double scale = std::max(maxU - minU, maxV - minV);
+    if (scale > 1e-10) {
+        for (Vec2T<T>& uv : uvs) {
+            uv.x = (uv.x - minU) / scale;
+            uv.y = (uv.y - minV) / scale;
+        }
+    }
+}
+
 bool BFFFlattener::flatten() {
-    if (mesh.vertices.empty() || mesh.faces.empty()) {
+    if (!beginFlatten()) return false;
+    flattenStep(islands.size());
+    return finishFlatten();
+}
+
+bool BFFFlattener::beginFlatten() {
+    flattenStart = std::chrono::steady_clock::now();
+    nextIsland = 0;
+    pieceOk.clear();
+    result.stats = FlattenStats();
+    if (mesh.vertices.empty() || mesh.triangles.empty()) {
         errorMsg = "Empty mesh";
         return false;
     }
     
+    // 沿缝线切分为独立片段，缝线未变化时沿用上次结果和缓存
+    if (topologyDirty) {
+        splitBySeams();
+        rebindIslandCaches();
+        topologyDirty = false;
+    }
+    result.stats.splitMs = elapsedMs(flattenStart);
+    BFF_PROFILE_COUNT("islands", islands.size());
+    result.stats.pieces.assign(islands.size(), PieceStats());
+    
+    int numSplit = result.splitVertexSource.size();
     uvResult.clear();
-    uvResult.resize(mesh.vertices.size() * 2, 0.0);
+    uvResult.resize(numSplit * 2, 0.0);
+    BFF_PROFILE_MEMORY("uvResult", uvResult.capacity() * sizeof(Real));
+    uvFloatValid = false;
+    distortion = DistortionMetrics();
+    distortionValid = false;
+    packResult = PackResult();
+    packedUV.clear();
+    pieceOk.assign(islands.size(), 1);
+    return true;
+}
+
+int BFFFlattener::flattenStep(int maxIslands) {
+    // pieceOk只在beginFlatten中建立，未开始或网格已重设时不展开任何片段
+    BFF_PROFILE_SCOPE("flattenStep");
+    int first = nextIsland;
+    int count = std::max(0, std::min(maxIslands, (int)pieceOk.size() - first));
     
-    // 对于简单情况，直接展开整个网格
-    std::vector<int> allFaces;
-    for (int i = 0; i < (int)mesh.faces.size(); i++) {
-        allFaces.push_back(i);
-    }
+    // 各片段互不相关，可独立（并行）展开，结果写入不相交的顶点位置
+    auto flattenIsland = [&](int k) {
+        int i = first + k;
+        const Island& island = islands[i];
+        std::vector<Vec2> uvs(island.numVertices());
+        pieceOk[i] = flattenPiece(island, islandCaches[i], uvs, result.stats.pieces[i]);
+        
+        for (int l = 0; l < island.numVertices(); l++) {
+            int sv = island.splitVertices[l];
+            uvResult[sv * 2] = uvs[l].x;
+            uvResult[sv * 2 + 1] = uvs[l].y;
+        }
+    };
     
-    std::vector<Vec2> uvs(mesh.vertices.size());
-    std::map<int, int> identityMap;
-    for (int i = 0; i < (int)mesh.vertices.size(); i++) {
-        identityMap[i] = i;
-    }
+    parallelFor(count, 1, [&](int begin, int end) {
+        for (int k = begin; k < end; k++) flattenIsland(k);
+    });
     
-    if (!flattenPiece(allFaces, uvs, identityMap)) {
-        return false;
+    nextIsland = first + count;
+    return pieceOk.size() - nextIsland;
+}
+
+bool BFFFlattener::finishFlatten() {
+    FlattenStats& stats = result.stats;
+    for (const PieceStats& piece : stats.pieces) {
+        stats.unfoldMs += piece.unfoldMs;
+        stats.conformalMs += piece.conformalMs;
+        stats.arapMs += piece.arapMs;
+        stats.totalIterations += piece.conformalIterations + piece.arapIterations;
+        stats.maxResidual = std::max(stats.maxResidual, piece.conformalResidual);
+        if (!piece.converged) stats.unconvergedPieces++;
     }
+    stats.totalMs = elapsedMs(flattenStart);
     
-    // 复制结果
-    for (int i = 0; i < (int)uvs.size(); i++) {
-        uvResult[i * 2] = uvs[i].x;
-        uvResult[i * 2 + 1] = uvs[i].y;
+    result.success = !pieceOk.empty() && nextIsland == (int)pieceOk.size() &&
+                     std::find(pieceOk.begin(), pieceOk.end(), 0) == pieceOk.end();
+    result.errorMessage = result.success ? "" :
+        nextIsland < (int)pieceOk.size() || pieceOk.empty() ? "Flatten not finished" : "Failed to flatten piece";
+    if (!result.success) {
+        errorMsg = result.errorMessage;
     }
     
-    return true;
+    return result.success;
 }
 
-bool BFFFlattener::flattenPiece(const std::vector<int>& faceIndices,
-                                 std::vector<Vec2>& uvs,
-                                 std::map<int, int>& vertexMap) {
-    if (faceIndices.empty()) return true;
+bool BFFFlattener::flattenPreview(int targetVertices) {
+    if (!beginFlatten()) return false;
+    BFF_PROFILE_SCOPE("flattenPreview");
+    result.stats.preview = true;
+    int target = std::max(targetVertices, 3);
     
-    std::set<int> placedVertices;
-    std::set<int> processedFaces;
-    std::queue<int> faceQueue;
+    parallelFor(islands.size(), 1, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const Island& island = islands[i];
+            IslandCache& cache = islandCaches[i];
+            std::vector<Vec2> uvs(island.numVertices());
+            pieceOk[i] = previewPiece(island, cache, uvs, result.stats.pieces[i], target);
+            cache.warmStart = uvs;
+            
+            for (int l = 0; l < island.numVertices(); l++) {
+                int sv = island.splitVertices[l];
+                uvResult[sv * 2] = uvs[l].x;
+                uvResult[sv * 2 + 1] = uvs[l].y;
+            }
+        }
+    });
     
-    // 从第一个面开始
-    int firstFace = faceIndices[0];
-    const auto& face = mesh.faces[firstFace];
+    nextIsland = islands.size();
+    return finishFlatten();
+}
+
+bool BFFFlattener::previewPiece(const Island& island, IslandCache& cache, std::vector<Vec2>& uvs,
+                                PieceStats& stats, int targetVertices) const {
+    if (island.faces.empty()) return true;
+    BFF_PROFILE_SCOPE("previewPiece");
+    
+    std::vector<int> pinned;
+    preparePiece(island, cache, uvs, pinned, stats);
+    
+    auto start = std::chrono::steady_clock::now();
+    SolveStats conformal;
+    if (island.numVertices() <= targetVertices) {
+        // 小片段完整求解，分解同样留给后续的完整展开
+        conformal = optimizeConformal(uvs, island, cache, pinned);
+    } else {
+        markIslandBoundary(island, cache);
+        std::vector<char> keep = cache.isBoundary;
+        for (int v : pinned) keep[v] = 1;
+        if (!cache.lod.matches(targetVertices, keep)) {
+            std::vector<Vec3> points(island.numVertices());
+            for (int v = 0; v < island.numVertices(); v++) {
+                points[v] = mesh.vertices[island.vertices[v]];
+            }
+            cache.lod.build(points, island.triangles, keep, targetVertices);
+        }
+        conformal = cache.lod.solve(uvs, conformalAnchors(island, cache, pinned), solverOptions);
+        if (pinned.empty()) normalizeToUnitSquare(uvs);
+    }
+    stats.conformalMs = elapsedMs(start);
+    stats.conformalIterations = conformal.iterations;
+    stats.conformalResidual = conformal.residual;
+    stats.converged = conformal.converged;
+    return true;
+}
+
+// 片段拓扑哈希（FNV-1a），面集合和局部三角形都相同时视为同一片段
+static uint64_t islandSignature(const Island& island) {
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](int value) {
+        uint32_t x = static_cast<uint32_t>(value);
+        for (int b = 0; b < 4; b++) {
+            h ^= (x >> (b * 8)) & 0xff;
+            h *= 1099511628211ull;
+        }
+    };
+    for (int f : island.faces) mix(f);
+    for (int v : island.triangles) mix(v);
+    return h;
+}
+
+void BFFFlattener::rebindIslandCaches() {
+    std::unordered_map<uint64_t, int> oldBySignature;
+    for (int i = 0; i < (int)islandCaches.size(); i++) {
+        oldBySignature[islandCaches[i].signature] = i;
+    }
     
-    // 放置第一个三角形
-    const Vec3& v0 = mesh.vertices[face[0]];
-    const Vec3& v1 = mesh.vertices[face[1]];
-    const Vec3& v2 = mesh.vertices[face[2]];
+    // 拓扑未变的片段继承旧缓存，其余片段（缝线变化涉及的）从空缓存开始
+    std::vector<IslandCache> caches(islands.size());
+    for (int i = 0; i < (int)islands.size(); i++) {
+        uint64_t sig = islandSignature(islands[i]);
+        auto it = oldBySignature.find(sig);
+        if (it != oldBySignature.end()) {
+            caches[i] = std::move(islandCaches[it->second]);
+            oldBySignature.erase(it);
+        }
+        caches[i].signature = sig;
+    }
+    islandCaches = std::move(caches);
+}
+
+void BFFFlattener::splitBySeams() {
+    BFF_PROFILE_SCOPE("split");
+    int numVertices = mesh.vertices.size();
+    int numFaces = mesh.numFaces();
+    int numHE = mesh.halfEdges.size();
     
-    double e01 = edgeLength(face[0], face[1]);
-    double e02 = edgeLength(face[0], face[2]);
-    double e12 = edgeLength(face[1], face[2]);
+    markSeamHalfEdges();
     
-    // 第一个顶点在原点
-    uvs[face[0]] = Vec2(0, 0);
-    placedVertices.insert(face[0]);
+    // 角点（以半边起点表示）跨非缝线内部边合并：同一扇区的角点属于同一个切分后顶点
+    arena.reset();
+    int* parent = arena.alloc<int>(numHE);
+    for (int i = 0; i < numHE; i++) parent[i] = i;
     
-    // 第二个顶点在x轴上
-    uvs[face[1]] = Vec2(e01, 0);
-    placedVertices.insert(face[1]);
+    auto unite = [&](int a, int b) {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a != b) parent[b] = a;
+    };
     
-    // 第三个顶点用余弦定理计算
-    double cosA = (e01 * e01 + e02 * e02 - e12 * e12) / (2.0 * e01 * e02);
-    cosA = std::max(-1.0, std::min(1.0, cosA));
-    double sinA = std::sqrt(1.0 - cosA * cosA);
-    uvs[face[2]] = Vec2(e02 * cosA, e02 * sinA);
-    placedVertices.insert(face[2]);
+    for (int heIdx = 0; heIdx < numHE; heIdx++) {
+        const HalfEdge& he = mesh.halfEdges[heIdx];
+        if (he.twin < heIdx || he.isSeam) continue;
+        unite(heIdx, heNext(he.twin));  // 起点处的两个角
+        unite(heNext(heIdx), he.twin);  // 终点处的两个角
+    }
     
-    processedFaces.insert(firstFace);
-    faceQueue.push(firstFace);
+    // 分配切分后顶点编号：每个原顶点的第一个扇区沿用原编号，其余追加在末尾
+    // 切分结果（编号、uvFaces、facePiece）按调用方的顶点和面编号给出
+    result.splitVertexSource.resize(numVertices);
+    for (int v = 0; v < numVertices; v++) result.splitVertexSource[v] = v;
     
-    // 构建面邻接关系
-    std::map<std::pair<int, int>, std::vector<int>> edgeToFaces;
-    for (int fIdx : faceIndices) {
-        const auto& f = mesh.faces[fIdx];
-        for (int i = 0; i < 3; i++) {
-            int v1 = f[i];
-            int v2 = f[(i + 1) % 3];
-            edgeToFaces[edgeKey(v1, v2)].push_back(fIdx);
+    int* rootSplit = arena.alloc<int>(numHE, -1);
+    char* originalUsed = arena.alloc<char>(numVertices, 0);
+    result.uvFaces.resize(numHE);
+    
+    for (int heIdx = 0; heIdx < numHE; heIdx++) {
+        int root = findRoot(parent, heIdx);
+        if (rootSplit[root] == -1) {
+            int v = heOrigin(heIdx);
+            if (!originalUsed[v]) {
+                originalUsed[v] = 1;
+                rootSplit[root] = callerVertex(v);
+            } else {
+                rootSplit[root] = result.splitVertexSource.size();
+                result.splitVertexSource.push_back(callerVertex(v));
+            }
         }
+        // 三角形面f的第i条半边下标为3f+i，起点为face[i]
+        result.uvFaces[callerHalfEdge(heIdx)] = rootSplit[root];
     }
     
-    // BFS展开
-    while (!faceQueue.empty()) {
-        int currentFace = faceQueue.front();
-        faceQueue.pop();
-        
-        const auto& cf = mesh.faces[currentFace];
+    // 跨非缝线边洪泛，得到连通片段（编号按片段的最小内部面索引递增）
+    int islandCount = 0;
+    result.facePiece.assign(numFaces, -1);
+    int* stack = arena.alloc<int>(numFaces);  // 每个面至多入栈一次
+    
+    for (int seed = 0; seed < numFaces; seed++) {
+        if (result.facePiece[seed] != -1) continue;
         
-        // 检查相邻面
-        for (int i = 0; i < 3; i++) {
-            int ev1 = cf[i];
-            int ev2 = cf[(i + 1) % 3];
-            auto key = edgeKey(ev1, ev2);
-            
-            for (int neighborFace : edgeToFaces[key]) {
-                if (processedFaces.count(neighborFace)) continue;
-                
-                const auto& nf = mesh.faces[neighborFace];
-                
-                // 找到共享边和新顶点
-                int sharedV1 = -1, sharedV2 = -1, newV = -1;
-                for (int v : nf) {
-                    if (placedVertices.count(v)) {
-                        if (sharedV1 == -1) sharedV1 = v;
-                        else sharedV2 = v;
-                    } else {
-                        newV = v;
-                    }
+        int pieceIdx = islandCount++;
+        result.facePiece[seed] = pieceIdx;
+        int stackSize = 0;
+        stack[stackSize++] = seed;
+        while (stackSize > 0) {
+            int f = stack[--stackSize];
+            for (int i = 0; i < 3; i++) {
+                const HalfEdge& he = mesh.halfEdges[f * 3 + i];
+                if (he.twin < 0 || he.isSeam) continue;
+                int nf = heFace(he.twin);
+                if (result.facePiece[nf] == -1) {
+                    result.facePiece[nf] = pieceIdx;
+                    stack[stackSize++] = nf;
                 }
-                
-                if (sharedV1 == -1 || sharedV2 == -1 || newV == -1) continue;
-                
-                // 计算新顶点位置
-                const Vec2& p1 = uvs[sharedV1];
-                const Vec2& p2 = uvs[sharedV2];
-                
-                double len12 = edgeLength(sharedV1, sharedV2);
-                double len1n = edgeLength(sharedV1, newV);
-                double len2n = edgeLength(sharedV2, newV);
-                
-                if (len12 < 1e-10) continue;
-                
-                // 使用余弦定理
-                double cosAngle = (len12 * len12 + len1n * len1n - len2n * len2n) / (2.0 * len12 * len1n);
-                cosAngle = std::max(-1.0, std::min(1.0, cosAngle));
-                double sinAngle = std::sqrt(1.0 - cosAngle * cosAngle);
-                
-                // 计算方向
-                Vec2 dir = (p2 - p1).normalize();
-                Vec2 perp(-dir.y, dir.x);
-                
-                // 新顶点位置（选择使三角形朝向正确的方向）
-                Vec2 newPos = p1 + dir * (len1n * cosAngle) + perp * (len1n * sinAngle);
-                
-                // 检查三角形朝向
-                Vec2 e1 = p2 - p1;
-                Vec2 e2 = newPos - p1;
-                double cross = e1.x * e2.y - e1.y * e2.x;
-                
-                if (cross < 0) {
-                    // 翻转
-                    newPos = p1 + dir * (len1n * cosAngle) - perp * (len1n * sinAngle);
-                }
-                
-                uvs[newV] = newPos;
-                placedVertices.insert(newV);
-                processedFaces.insert(neighborFace);
-                faceQueue.push(neighborFace);
             }
         }
     }
+    if (!faceOrder.empty()) {
+        int* piece = arena.alloc<int>(numFaces);
+        std::copy(result.facePiece.begin(), result.facePiece.end(), piece);
+        for (int f = 0; f < numFaces; f++) result.facePiece[faceOrder[f]] = piece[f];
+    }
     
-    // 处理未放置的顶点
-    for (int fIdx : faceIndices) {
-        for (int v : mesh.faces[fIdx]) {
-            if (!placedVertices.count(v)) {
-                uvs[v] = Vec2(0, 0);
-                placedVertices.insert(v);
+    buildIslands(islandCount);
+}
+
+void BFFFlattener::markSeamHalfEdges() {
+    for (int heIdx = 0; heIdx < (int)mesh.halfEdges.size(); heIdx++) {
+        HalfEdge& he = mesh.halfEdges[heIdx];
+        he.isSeam = !mesh.seamEdges.empty() &&
+                    mesh.seamEdges.count(edgeHashKey(heOrigin(heIdx), he.vertex)) > 0;
+    }
+}
+
+void BFFFlattener::buildIslands(int islandCount) {
+    int numFaces = mesh.numFaces();
+    islands.resize(islandCount);
+    result.pieces.assign(islandCount, std::vector<int>());
+    faceLocalIndex.assign(numFaces, -1);
+    
+    // 已有的Island对象原地复用；按面索引顺序分桶，各片段的面自然升序
+    for (Island& island : islands) {
+        island.faces.clear();
+        island.vertices.clear();
+        island.splitVertices.clear();
+        island.triangles.clear();
+    }
+    for (int f = 0; f < numFaces; f++) {
+        Island& island = islands[result.facePiece[faceOrder.empty() ? f : faceOrder[f]]];
+        faceLocalIndex[f] = island.faces.size();
+        island.faces.push_back(f);
+    }
+    
+    int* localIndex = arena.alloc<int>(result.splitVertexSource.size(), -1);
+    for (int pieceIdx = 0; pieceIdx < islandCount; pieceIdx++) {
+        Island& island = islands[pieceIdx];
+        island.triangles.reserve(island.faces.size() * 3);
+        for (int f : island.faces) {
+            for (int i = 0; i < 3; i++) {
+                int sv = result.uvFaces[callerHalfEdge(f * 3 + i)];
+                if (localIndex[sv] == -1) {
+                    localIndex[sv] = island.splitVertices.size();
+                    island.splitVertices.push_back(sv);
+                    int v = result.splitVertexSource[sv];
+                    island.vertices.push_back(vertexRank.empty() ? v : vertexRank[v]);
+                }
+                island.triangles.push_back(localIndex[sv]);
             }
         }
+        
+        for (int sv : island.splitVertices) localIndex[sv] = -1;
+        std::vector<int>& piece = result.pieces[pieceIdx];
+        piece = island.faces;
+        if (!faceOrder.empty()) {
+            for (int& f : piece) f = faceOrder[f];
+            std::sort(piece.begin(), piece.end());
+        }
+    }
+}
+
+bool BFFFlattener::packIslands(const PackOptions& options) {
+    int numSplit = result.splitVertexSource.size();
+    if (!result.success || (int)uvResult.size() != numSplit * 2 || islands.empty()) {
+        errorMsg = "No flatten result to pack";
+        return false;
     }
+    BFF_PROFILE_SCOPE("pack");
     
-    // 共形优化
-    optimizeConformal(uvs, faceIndices, vertexMap, 20);
+    // 各片段归一化到单位正方形时丢失了相对大小，按面积比恢复
+    int numIslands = islands.size();
+    std::vector<double> points;
+    std::vector<int> offsets(1, 0);
+    std::vector<double> scales(numIslands, 1.0);
+    for (int i = 0; i < numIslands; i++) {
+        const Island& island = islands[i];
+        for (int sv : island.splitVertices) {
+            points.push_back(uvResult[sv * 2]);
+            points.push_back(uvResult[sv * 2 + 1]);
+        }
+        offsets.push_back(points.size() / 2);
+        
+        double area3D = 0, areaUV = 0;
+        const double* uv = &points[offsets[i] * 2];
+        for (int fIdx = 0; fIdx < island.numFaces(); fIdx++) {
+            area3D += mesh.geometry.area[island.faces[fIdx]];
+            const int* t = &island.triangles[fIdx * 3];
+            double ax = uv[t[1] * 2] - uv[t[0] * 2], ay = uv[t[1] * 2 + 1] - uv[t[0] * 2 + 1];
+            double bx = uv[t[2] * 2] - uv[t[0] * 2], by = uv[t[2] * 2 + 1] - uv[t[0] * 2 + 1];
+            areaUV += 0.5 * std::fabs(ax * by - ay * bx);
+        }
+        if (areaUV > 1e-20 && area3D > 0) scales[i] = std::sqrt(area3D / areaUV);
+    }
     
-    // 归一化UV坐标
-    double minU = std::numeric_limits<double>::max();
-    double maxU = std::numeric_limits<double>::lowest();
-    double minV = std::numeric_limits<double>::max();
-    double maxV = std::numeric_limits<double>::lowest();
+    packResult = bff::packIslands(points.data(), offsets.data(), numIslands, scales.data(), options);
     
-    for (int fIdx : faceIndices) {
-        for (int v : mesh.faces[fIdx]) {
-            minU = std::min(minU, uvs[v].x);
-            maxU = std::max(maxU, uvs[v].x);
-            minV = std::min(minV, uvs[v].y);
-            maxV = std::max(maxV, uvs[v].y);
+    packedUV.assign(numSplit * 2, 0);
+    for (int i = 0; i < numIslands; i++) {
+        const IslandTransform& t = packResult.transforms[i];
+        for (int sv : islands[i].splitVertices) {
+            double u, v;
+            t.apply(uvResult[sv * 2], uvResult[sv * 2 + 1], u, v);
+            packedUV[sv * 2] = u;
+            packedUV[sv * 2 + 1] = v;
         }
     }
+    return true;
+}
+
+const DistortionMetrics& BFFFlattener::getDistortion() {
+    if (distortionValid) return distortion;
+    int numFaces = mesh.numFaces();
+    int numSplit = result.splitVertexSource.size();
+    distortion = DistortionMetrics();
+    if (!result.success || numFaces == 0 || (int)uvResult.size() != numSplit * 2 ||
+        (int)result.uvFaces.size() != numFaces * 3) {
+        return distortion;
+    }
     
-    double scale = std::max(maxU - minU, maxV - minV);
-    if (scale > 1e-10) {
-        for (int fIdx : faceIndices) {
-            for (int v : mesh.faces[fIdx]) {
-                uvs[v].x = (uvs[v].x - minU) / scale;
-                uvs[v].y = (uvs[v].y - minV) / scale;
+    // 几何量按内部面编号，UV索引和片段按调用方编号
+    DistortionInput input;
+    input.numFaces = numFaces;
+    input.cotan = mesh.geometry.cotan.data();
+    input.edgeLength = mesh.geometry.edgeLength.data();
+    input.area = mesh.geometry.area.data();
+    input.faceOrder = faceOrder.empty() ? nullptr : faceOrder.data();
+    input.uvFaces = result.uvFaces.data();
+    input.uvs = uvResult.data();
+    input.numUVs = numSplit;
+    input.facePiece = result.facePiece.data();
+    input.numPieces = result.pieces.size();
+    computeDistortion(input, distortion);
+    distortionValid = true;
+    return distortion;
+}
+
+const std::vector<float>& BFFFlattener::getUVCoordsFloat() {
+    return uvAsFloat(uvResult, uvResultFloat, uvFloatValid);
+}
+
+void BFFFlattener::preparePiece(const Island& island, IslandCache& cache, std::vector<Vec2>& uvs,
+                                std::vector<int>& pinned, PieceStats& stats) const {
+    // 铺展结果只依赖片段拓扑，缓存后重复使用
+    auto start = std::chrono::steady_clock::now();
+    if (cache.unfolded.empty()) {
+        unfoldPiece(island, cache.unfolded);
+        stats.unfoldMs = elapsedMs(start);
+    } else {
+        BFF_PROFILE_COUNT("unfoldCacheHits", 1);
+    }
+    uvs = cache.unfolded;
+    
+    // 应用固定点
+    pinned.clear();
+    if (!pins.empty()) {
+        for (int v = 0; v < island.numVertices(); v++) {
+            auto it = pins.find(island.splitVertices[v]);
+            if (it != pins.end()) {
+                uvs[v] = it->second;
+                pinned.push_back(v);
             }
         }
     }
+}
+
+bool BFFFlattener::flattenPiece(const Island& island, IslandCache& cache, std::vector<Vec2>& uvs,
+                                PieceStats& stats) const {
+    if (island.faces.empty()) return true;
+    BFF_PROFILE_SCOPE("flattenPiece");
+    
+    std::vector<int> pinned;
+    preparePiece(island, cache, uvs, pinned, stats);
+    
+    // 预览结果作为内部顶点的初值（边界和固定点仍取铺展和固定点坐标）
+    if (cache.warmStart.size() == uvs.size()) {
+        markIslandBoundary(island, cache);
+        for (int v = 0, p = 0; v < island.numVertices(); v++) {
+            while (p < (int)pinned.size() && pinned[p] < v) p++;
+            bool isPinned = p < (int)pinned.size() && pinned[p] == v;
+            if (!cache.isBoundary[v] && !isPinned) uvs[v] = cache.warmStart[v];
+        }
+    }
+    cache.warmStart.clear();
+    
+    // 共形优化；ARAP模式给定初值时以其代替
+    auto start = std::chrono::steady_clock::now();
+    if (method != FlattenMethod::ARAP || !applyARAPInitialUV(island, pinned, uvs)) {
+        SolveStats conformal = optimizeConformal(uvs, island, cache, pinned);
+        stats.conformalMs = elapsedMs(start);
+        stats.conformalIterations = conformal.iterations;
+        stats.conformalResidual = conformal.residual;
+        stats.converged = conformal.converged;
+    }
+    
+    if (method == FlattenMethod::ARAP) {
+        start = std::chrono::steady_clock::now();
+        ARAPStats arap = optimizeARAP(uvs, island, cache, pinned);
+        stats.arapMs = elapsedMs(start);
+        stats.arapIterations = arap.iterations;
+        stats.arapEnergy = arap.energy;
+        stats.converged = stats.converged && arap.converged;
+    }
     
     return true;
 }
 
-void BFFFlattener::optimizeConformal(std::vector<Vec2>& uvs,
-                                      const std::vector<int>& faceIndices,
-                                      const std::map<int, int>& vertexMap,
-                                      int iterations) {
-    // 构建顶点邻接关系
-    std::map<int, std::vector<int>> vertexNeighbors;
-    for (int fIdx : faceIndices) {
-        const auto& f = mesh.faces[fIdx];
-        for (int i = 0; i < 3; i++) {
-            int v = f[i];
-            int vn = f[(i + 1) % 3];
-            int vp = f[(i + 2) % 3];
-            vertexNeighbors[v].push_back(vn);
-            vertexNeighbors[v].push_back(vp);
+void BFFFlattener::setARAPInitialUV(const double* uvs, int count) {
+    arapInitialUV.resize(count);
+    for (int i = 0; i < count; i++) arapInitialUV[i] = Vec2(Real(uvs[i * 2]), Real(uvs[i * 2 + 1]));
+}
+
+bool BFFFlattener::applyARAPInitialUV(const Island& island, const std::vector<int>& pinned,
+                                      std::vector<Vec2>& uvs) const {
+    int count = arapInitialUV.size();
+    bool bySplitVertex = count == (int)result.splitVertexSource.size();
+    if (count == 0 || (!bySplitVertex && count != (int)mesh.vertices.size())) return false;
+    for (int v = 0, p = 0; v < island.numVertices(); v++) {
+        while (p < (int)pinned.size() && pinned[p] < v) p++;
+        if (p < (int)pinned.size() && pinned[p] == v) continue;
+        int sv = island.splitVertices[v];
+        uvs[v] = arapInitialUV[bySplitVertex ? sv : result.splitVertexSource[sv]];
+    }
+    return true;
+}
+
+ARAPStats BFFFlattener::optimizeARAP(std::vector<Vec2>& uvs, const Island& island, IslandCache& cache,
+                                     const std::vector<int>& pinned) const {
+    BFF_PROFILE_SCOPE("arap");
+    if (!cache.arap.isReady() || !cache.arap.options().sameSetup(arapOptions) ||
+        cache.arap.pinned() != pinned) {
+        std::vector<Vec3> points(island.numVertices());
+        for (int v = 0; v < island.numVertices(); v++) {
+            points[v] = mesh.vertices[island.vertices[v]];
         }
+        
+        // 角k的对边 (k+1, k+2) 即该面的第k+1条半边
+        std::vector<char> boundaryEdge(island.triangles.size(), 0);
+        for (int fIdx = 0; fIdx < island.numFaces(); fIdx++) {
+            int f = island.faces[fIdx];
+            for (int k = 0; k < 3; k++) {
+                const HalfEdge& he = mesh.halfEdges[f * 3 + (k + 1) % 3];
+                boundaryEdge[fIdx * 3 + k] = he.twin < 0 || he.isSeam;
+            }
+        }
+        
+        cache.arap.setup(points, island.triangles, boundaryEdge, pinned, arapOptions);
+    }
+    
+    // 静止形状是3D尺度，初值和固定点是片段归一化坐标；按UV与3D的面积比换到3D尺度再迭代，
+    // 固定点给定了UV坐标系，迭代后按同一比例换回，没有固定点时重新归一化
+    double uvArea = 0, meshArea = 0;
+    for (int fIdx = 0; fIdx < island.numFaces(); fIdx++) {
+        const int* tri = &island.triangles[fIdx * 3];
+        Vec2 e1 = uvs[tri[1]] - uvs[tri[0]];
+        Vec2 e2 = uvs[tri[2]] - uvs[tri[0]];
+        uvArea += 0.5 * (double(e1.x) * e2.y - double(e1.y) * e2.x);
+        meshArea += mesh.geometry.area[island.faces[fIdx]];
     }
+    double scale = meshArea > 0 && uvArea != 0 ? std::sqrt(std::fabs(uvArea) / meshArea) : 1.0;
+    std::vector<Vec2> pinnedUV(pinned.size());
+    for (size_t p = 0; p < pinned.size(); p++) pinnedUV[p] = uvs[pinned[p]];
+    for (Vec2& uv : uvs) uv = Vec2(Real(uv.x / scale), Real(uv.y / scale));
     
-    // 去重
-    for (auto& pair : vertexNeighbors) {
-        std::sort(pair.second.begin(), pair.second.end());
-        pair.second.erase(std::unique(pair.second.begin(), pair.second.end()), pair.second.end());
+    ARAPStats stats = cache.arap.solve(uvs, arapOptions.iterations, arapOptions.tolerance);
+    if (pinned.empty()) {
+        normalizeToUnitSquare(uvs);
+    } else {
+        for (Vec2& uv : uvs) uv = Vec2(Real(uv.x * scale), Real(uv.y * scale));
+        for (size_t p = 0; p < pinned.size(); p++) uvs[pinned[p]] = pinnedUV[p];
     }
+    return stats;
+}
+
+void BFFFlattener::unfoldPiece(const Island& island, std::vector<Vec2>& uvs) const {
+    BFF_PROFILE_SCOPE("unfold");
+    // 逐面铺展的误差沿BFS累积，单精度构建中同样按double计算，归一化后再转为Real
+    using Point = Vec2T<double>;
+    std::vector<Point> pos(island.numVertices(), Point(0, 0));
+    
+    const std::vector<int>& tris = island.triangles;
+    int numFaces = island.numFaces();
+    const std::vector<Real>& edgeLengths = mesh.geometry.edgeLength;
+    
+    // 访问标记用位图，队列中每个面至多入队一次，定长数组即可
+    BitSet placedVertices(island.numVertices());
+    BitSet processedFaces(numFaces);
+    std::vector<int> faceQueue(numFaces);
+    int queueHead = 0, queueTail = 0;
+    
+    // 从第一个面开始
+    const int* face = &tris[0];
+    
+    // 放置第一个三角形（预计算边长，角k的对边位于 3*f + k）
+    const Real* firstLen = &edgeLengths[island.faces[0] * 3];
+    double e01 = firstLen[2];
+    double e02 = firstLen[1];
+    double e12 = firstLen[0];
+    
+    // 第一个顶点在原点
+    pos[face[0]] = Point(0, 0);
+    placedVertices.set(face[0]);
+    
+    // 第二个顶点在x轴上
+    pos[face[1]] = Point(e01, 0);
+    placedVertices.set(face[1]);
+    
+    // 第三个顶点用余弦定理计算
+    double cosA = (e01 * e01 + e02 * e02 - e12 * e12) / (2.0 * e01 * e02);
+    cosA = std::max(-1.0, std::min(1.0, cosA));
+    double sinA = std::sqrt(1.0 - cosA * cosA);
+    pos[face[2]] = Point(e02 * cosA, e02 * sinA);
+    placedVertices.set(face[2]);
     
-    // 迭代优化（拉普拉斯平滑 + 边长保持）
-    double alpha = 0.5;
+    processedFaces.set(0);
+    faceQueue[queueTail++] = 0;
     
-    for (int iter = 0; iter < iterations; iter++) {
-        std::vector<Vec2> newUVs = uvs;
+    // BFS展开，相邻面取自半边twin（缝线和边界边不跨越，与切分片段时一致）
+    while (queueHead < queueTail) {
+        int currentFace = faceQueue[queueHead++];
+        int globalFace = island.faces[currentFace];
         
-        for (auto& pair : vertexNeighbors) {
-            int v = pair.first;
-            const auto& neighbors = pair.second;
+        // 检查相邻面
+        for (int i = 0; i < 3; i++) {
+            const HalfEdge& he = mesh.halfEdges[globalFace * 3 + i];
+            if (he.twin < 0 || he.isSeam) continue;
+            int neighborGlobal = heFace(he.twin);
+            int neighborFace = faceLocalIndex[neighborGlobal];
+            if (processedFaces.test(neighborFace)) continue;
             
-            if (neighbors.size() < 2) continue;
+            const int* nf = &tris[neighborFace * 3];
             
-            // 计算邻居的平均位置
-            Vec2 avg(0, 0);
-            for (int n : neighbors) {
-                avg = avg + uvs[n];
+            // 找到共享边和新顶点，共享边按该面的环绕顺序取，保证铺展后朝向一致
+            int sharedV1 = -1, sharedV2 = -1, newV = -1, newCorner = -1;
+            int unplaced = 0;
+            for (int k = 0; k < 3; k++) {
+                if (!placedVertices.test(nf[k])) {
+                    unplaced++;
+                    newV = nf[k];
+                    newCorner = k;
+                    sharedV1 = nf[(k + 1) % 3];
+                    sharedV2 = nf[(k + 2) % 3];
+                }
             }
-            avg = avg * (1.0 / neighbors.size());
             
-            // 拉普拉斯平滑
-            newUVs[v] = uvs[v] * (1.0 - alpha) + avg * alpha;
+            // 两个顶点未放置时等待从其他方向到达
+            if (unplaced > 1) continue;
+            
+            // 三个顶点都已放置，只需继续向外扩展
+            if (unplaced == 0) {
+                processedFaces.set(neighborFace);
+                faceQueue[queueTail++] = neighborFace;
+                continue;
+            }
+            
+            // 计算新顶点位置
+            const Point& p1 = pos[sharedV1];
+            const Point& p2 = pos[sharedV2];
+            
+            const Real* faceLen = &edgeLengths[neighborGlobal * 3];
+            double len12 = faceLen[newCorner];
+            double len1n = faceLen[(newCorner + 2) % 3];
+            double len2n = faceLen[(newCorner + 1) % 3];
+            
+            if (len12 < 1e-10) continue;
+            
+            // 使用余弦定理
+            double cosAngle = (len12 * len12 + len1n * len1n - len2n * len2n) / (2.0 * len12 * len1n);
+            cosAngle = std::max(-1.0, std::min(1.0, cosAngle));
+            double sinAngle = std::sqrt(1.0 - cosAngle * cosAngle);
+            
+            // 计算方向
+            Point dir = (p2 - p1).normalize();
+            Point perp(-dir.y, dir.x);
+            
+            // 新顶点位于共享边左侧（三角形逆时针）
+            pos[newV] = p1 + dir * (len1n * cosAngle) + perp * (len1n * sinAngle);
+            placedVertices.set(newV);
+            processedFaces.set(neighborFace);
+            faceQueue[queueTail++] = neighborFace;
+        }
+    }
+    
+    // 归一化UV坐标（未放置的顶点保持在原点）
+    normalizeToUnitSquare(pos);
+    uvs.resize(pos.size());
+    for (size_t v = 0; v < pos.size(); v++) uvs[v] = Vec2(Real(pos[v].x), Real(pos[v].y));
+}
+
+void BFFFlattener::markIslandBoundary(const Island& island, IslandCache& cache) const {
+    if (!cache.isBoundary.empty()) return;
+    cache.isBoundary.assign(island.numVertices(), 0);
+    cache.boundaryEdges.clear();
+    for (int fIdx = 0; fIdx < island.numFaces(); fIdx++) {
+        int f = island.faces[fIdx];
+        for (int i = 0; i < 3; i++) {
+            const HalfEdge& he = mesh.halfEdges[f * 3 + i];
+            if (he.twin < 0 || he.isSeam) {
+                int a = island.triangles[fIdx * 3 + i];
+                int b = island.triangles[fIdx * 3 + (i + 1) % 3];
+                cache.isBoundary[a] = 1;
+                cache.isBoundary[b] = 1;
+                cache.boundaryEdges.push_back(a);
+                cache.boundaryEdges.push_back(b);
+            }
         }
-        
-        uvs = newUVs;
     }
 }
 
-double BFFFlattener::computeAngle(const Vec3& a, const Vec3& b, const Vec3& c) {
-    Vec3 ba = a - b;
-    Vec3 bc = c - b;
+std::vector<int> BFFFlattener::conformalAnchors(const Island& island, const IslandCache& cache,
+                                               const std::vector<int>& pinned) const {
+    std::vector<int> anchors = pinned;
+    if (anchors.size() >= 2 || cache.boundaryEdges.empty()) return anchors;
+    
+    // 按铺展坐标（不受固定点取值影响）取边界上相距最远的顶点，移动固定点不会改变锚点
+    const std::vector<Vec2>& pos = cache.unfolded;
+    auto farthestFrom = [&](int from) {
+        int best = -1;
+        double bestDist = -1;
+        for (int v = 0; v < island.numVertices(); v++) {
+            if (!cache.isBoundary[v]) continue;
+            double du = pos[v].x - pos[from].x;
+            double dv = pos[v].y - pos[from].y;
+            if (du * du + dv * dv > bestDist) {
+                bestDist = du * du + dv * dv;
+                best = v;
+            }
+        }
+        return best;
+    };
+    if (anchors.empty()) anchors.push_back(farthestFrom(cache.boundaryEdges[0]));
+    int other = farthestFrom(anchors[0]);
+    if (other != anchors[0]) anchors.push_back(other);
+    std::sort(anchors.begin(), anchors.end());
+    return anchors;
+}
+
+SolveStats BFFFlattener::optimizeConformal(std::vector<Vec2>& uvs,
+                                            const Island& island,
+                                            IslandCache& cache,
+                                            const std::vector<int>& pinned) const {
+    BFF_PROFILE_SCOPE("conformal");
+    int n = island.numVertices();
     
-    double dot = ba.dot(bc);
-    double lenA = ba.length();
-    double lenC = bc.length();
+    // 片段边界与拉普拉斯只依赖拓扑和3D几何，首次求解时建立
+    markIslandBoundary(island, cache);
+    if (cache.laplacian.rows == 0) {
+        // 余切取自网格预计算结果，片段三角形与原网格面的角顺序一致
+        std::vector<double> cotans(island.triangles.size());
+        for (int fIdx = 0; fIdx < island.numFaces(); fIdx++) {
+            const Real* faceCot = &mesh.geometry.cotan[island.faces[fIdx] * 3];
+            for (int k = 0; k < 3; k++) cotans[fIdx * 3 + k] = faceCot[k];
+        }
+        BFF_PROFILE_SCOPE("assembleLaplacian");
+        cache.laplacian = assembleCotanLaplacian(n, island.triangles, cotans);
+    }
     
-    if (lenA < 1e-10 || lenC < 1e-10) return 0;
+    // 固定顶点集合（固定点和锚点）变化时重新消元和分解
+    std::vector<int> fixedVertices = conformalAnchors(island, cache, pinned);
+    if (cache.freeIndex.empty() || fixedVertices != cache.fixedVertices) {
+        BFF_PROFILE_SCOPE("factorize");
+        BFF_PROFILE_COUNT("factorizations", 1);
+        cache.fixedVertices = fixedVertices;
+        cache.freeIndex.assign(2 * n, -1);
+        cache.numFree = 0;
+        std::vector<char> isFixed(n, 0);
+        for (int v : fixedVertices) isFixed[v] = 1;
+        for (int i = 0; i < 2 * n; i++) {
+            if (!isFixed[i / 2]) cache.freeIndex[i] = cache.numFree++;
+        }
+        
+        CSRMatrix lscm = assembleLSCM(cache.laplacian, cache.boundaryEdges);
+        reduceDirichlet(lscm, cache.freeIndex, cache.numFree, cache.reduced, cache.coupling);
+        cache.factor = LDLTFactorization();
+        cache.factorValid = false;
+        if (fixedVertices.size() >= 2 && cache.numFree > 0) {
+            // 填充超过上限时analyze失败，改用PCG
+            cache.factorValid = cache.factor.analyze(cache.reduced) && cache.factor.factorize(cache.reduced);
+            BFF_PROFILE_MEMORY("ldltFactor", size_t(cache.factor.factorNonZeros()) * (sizeof(double) + sizeof(int)));
+        }
+    }
     
-    double cosAngle = dot / (lenA * lenC);
-    cosAngle = std::max(-1.0, std::min(1.0, cosAngle));
+    // 少于两个固定顶点（封闭片段且固定点不足）时共形能量没有唯一极小，保持铺展结果
+    SolveStats stats;
+    stats.converged = true;
+    int numFree = cache.numFree;
+    if (fixedVertices.size() < 2 || numFree == 0) return stats;
     
-    return std::acos(cosAngle);
-}
-
-double BFFFlattener::edgeLength(int v1, int v2) {
-    return (mesh.vertices[v2] - mesh.vertices[v1]).length();
+    std::vector<double> fixedCoord(2 * n), rhs(numFree), x(numFree), ax(numFree);
+    for (int v = 0; v < n; v++) {
+        fixedCoord[2 * v] = uvs[v].x;
+        fixedCoord[2 * v + 1] = uvs[v].y;
+    }
+    for (int i = 0; i < 2 * n; i++) {
+        if (cache.freeIndex[i] >= 0) x[cache.freeIndex[i]] = fixedCoord[i];  // 热启动
+    }
+    cache.coupling.multiply(fixedCoord.data(), rhs.data());
+    for (double& r : rhs) r = -r;
+    
+    if (cache.factorValid) {
+        x = rhs;
+        cache.factor.solve(x);
+        
+        // 直接法不迭代，残差只用来发现病态分解
+        cache.reduced.multiply(x.data(), ax.data());
+        double rr = 0, bb = 0;
+        for (int i = 0; i < numFree; i++) {
+            double r = ax[i] - rhs[i];
+            rr += r * r;
+            bb += rhs[i] * rhs[i];
+        }
+        stats.residual = bb > 0 ? std::sqrt(rr / bb) : std::sqrt(rr);
+        stats.converged = stats.residual <= solverOptions.tolerance;
+    } else {
+        stats = solvePCG(cache.reduced, rhs, x, solverOptions);
+        BFF_PROFILE_COUNT("pcgIterations", stats.iterations);
+    }
+    
+    for (int i = 0; i < 2 * n; i++) {
+        int fi = cache.freeIndex[i];
+        if (fi < 0) continue;
+        if (i % 2 == 0) uvs[i / 2].x = x[fi];
+        else uvs[i / 2].y = x[fi];
+    }
+    
+    // 只有锚点时坐标系是任意取的，重新归一化；固定点给定了坐标系，保持不动
+    if (pinned.empty()) normalizeToUnitSquare(uvs);
+    return stats;
 }
 
 } // namespace bff
@@ -10,74 +10,138 @@
 #include <cmath>
 #include <map>
 #include <set>
+#include <unordered_set>
+#include <string>
+#include <cstdint>
 #include <algorithm>
+#include <unordered_map>
+#include <chrono>
+#include "scalar_types.h"
+#include "sparse_solver.h"
+#include "arap_solver.h"
+#include "geometry_kernels.h"
+#include "arena.h"
+#include "mesh_reorder.h"
+#include "uv_packer.h"
+#include "island_lod.h"
+#include "distortion_metrics.h"
+#include "topology_repair.h"
+#include "task_scheduler.h"
 
 namespace bff {
 
-// 2D向量
-struct Vec2 {
-    double x, y;
-    Vec2() : x(0), y(0) {}
-    Vec2(double x_, double y_) : x(x_), y(y_) {}
-    Vec2 operator+(const Vec2& v) const { return Vec2(x + v.x, y + v.y); }
-    Vec2 operator-(const Vec2& v) const { return Vec2(x - v.x, y - v.y); }
-    Vec2 operator*(double s) const { return Vec2(x * s, y * s); }
-    double dot(const Vec2& v) const { return x * v.x + y * v.y; }
-    double length() const { return std::sqrt(x * x + y * y); }
-    Vec2 normalize() const {
-        double len = length();
-        return len > 1e-10 ? Vec2(x / len, y / len) : Vec2(0, 0);
-    }
-};
-
-// 3D向量
-struct Vec3 {
-    double x, y, z;
-    Vec3() : x(0), y(0), z(0) {}
-    Vec3(double x_, double y_, double z_) : x(x_), y(y_), z(z_) {}
-    Vec3 operator+(const Vec3& v) const { return Vec3(x + v.x, y + v.y, z + v.z); }
-    Vec3 operator-(const Vec3& v) const { return Vec3(x - v.x, y - v.y, z - v.z); }
-    Vec3 operator*(double s) const { return Vec3(x * s, y * s, z * s); }
-    double dot(const Vec3& v) const { return x * v.x + y * v.y + z * v.z; }
-    Vec3 cross(const Vec3& v) const {
-        return Vec3(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x);
-    }
-    double length() const { return std::sqrt(x * x + y * y + z * z); }
-    Vec3 normalize() const {
-        double len = length();
-        return len > 1e-10 ? Vec3(x / len, y / len, z / len) : Vec3(0, 0, 0);
-    }
-};
-
-// 半边数据结构
+// 半边数据结构：面f的半边为 3f, 3f+1, 3f+2，所属面和前后半边由编号算出，不单独存储
 struct HalfEdge {
     int vertex;      // 目标顶点
-    int face;        // 所属面
-    int next;        // 同一面中的下一条半边
     int twin;        // 对偶半边
-    int prev;        // 同一面中的上一条半边
     bool isBoundary; // 是否为边界边
     bool isSeam;     // 是否为缝线边
 };
 
+inline int heFace(int heIdx) { return heIdx / 3; }
+inline int heNext(int heIdx) { return heIdx % 3 == 2 ? heIdx - 2 : heIdx + 1; }
+inline int hePrev(int heIdx) { return heIdx % 3 == 0 ? heIdx + 2 : heIdx - 1; }
+
 // 网格数据
 struct Mesh {
     std::vector<Vec3> vertices;
-    std::vector<std::vector<int>> faces;
+    std::vector<int> triangles;       // 三角形顶点索引 [3*F]，面f的第i个角为 triangles[3f+i]
     std::vector<HalfEdge> halfEdges;
     std::vector<int> vertexHalfEdge;  // 每个顶点关联的一条半边
     std::vector<bool> isBoundaryVertex;
-    std::vector<std::set<int>> seamEdges; // 缝线边集合
+    std::unordered_set<uint64_t> seamEdges; // 缝线边集合（无向边key）
+    std::vector<std::pair<int, int>> nonManifoldEdges; // 被超过两个面共享的边（调用方顶点编号）
+    FaceGeometry geometry;            // 逐面边长、余切、面积（上传网格时预计算）
+    
+    int numVertices() const { return vertices.size(); }
+    int numFaces() const { return triangles.size() / 3; }
+};
+
+// 沿缝线切开后的独立片段（UV岛）
+struct Island {
+    std::vector<int> faces;          // 网格面索引（内部编号）
+    std::vector<int> vertices;       // 局部顶点 -> 网格顶点（内部编号，取3D坐标）
+    std::vector<int> splitVertices;  // 局部顶点 -> 切分后顶点（UV输出索引）
+    std::vector<int> triangles;      // 局部三角形 [a0,b0,c0, a1,b1,c1, ...]
     
     int numVertices() const { return vertices.size(); }
     int numFaces() const { return faces.size(); }
 };
 
+// 片段求解缓存：片段拓扑不变时复用铺展结果和拉普拉斯分解，
+// 只有固定点位置变化时重新展开只需回代
+struct IslandCache {
+    uint64_t signature = 0;              // 片段拓扑哈希
+    std::vector<Vec2> unfolded;          // 归一化后的铺展结果（锚点坐标来源）
+    std::vector<char> isBoundary;        // 片段边界顶点
+    std::vector<int> boundaryEdges;      // 片段边界有向边 [a0,b0, ...]，与三角形同向
+    CSRMatrix laplacian;                 // 余切拉普拉斯（只依赖3D几何）
+    
+    // 以下依赖固定顶点集合（固定点 + 锚点）
+    std::vector<int> fixedVertices;      // 当前分解对应的固定顶点，升序
+    std::vector<int> freeIndex;          // LSCM变量（2v为u，2v+1为v）-> 自由变量编号，固定为-1
+    int numFree = 0;
+    CSRMatrix reduced;                   // M_ff
+    CSRMatrix coupling;                  // M_fc
+    LDLTFactorization factor;
+    bool factorValid = false;
+    
+    ARAPSolver arap;                     // ARAP模式的预分解（参数变化时重建）
+    
+    IslandLOD lod;                       // 预览用的粗网格（目标顶点数或固定顶点变化时重建）
+    std::vector<Vec2> warmStart;         // 预览结果，下一次完整展开作为迭代初值后清空
+};
+
+// 展开方法
+enum class FlattenMethod {
+    Conformal = 0,   // 铺展 + 余切拉普拉斯共形优化
+    ARAP = 1         // 在共形结果上继续ARAP迭代
+};
+
+// 单个片段的求解统计
+struct PieceStats {
+    int conformalIterations = 0;   // PCG迭代次数，直接分解回代为0
+    double conformalResidual = 0;  // 相对残差 ||Ax-b|| / ||b||（两个坐标轴取较大者）
+    int arapIterations = 0;        // ARAP模式下实际迭代次数
+    double arapEnergy = 0;         // 最终ARAP能量
+    bool converged = true;         // 共形与ARAP均达到容差
+    double unfoldMs = 0;           // 铺展（命中缓存时为0）
+    double conformalMs = 0;
+    double arapMs = 0;
+};
+
+// 一次flatten的统计
+struct FlattenStats {
+    std::vector<PieceStats> pieces;  // 与 FlattenResult::pieces 一一对应
+    double splitMs = 0;              // 沿缝线切分和匹配缓存
+    double unfoldMs = 0;             // 以下三项为各片段耗时之和，多线程时可能超过totalMs
+    double conformalMs = 0;
+    double arapMs = 0;
+    double totalMs = 0;              // beginFlatten到finishFlatten的墙钟时间
+    int totalIterations = 0;         // 所有片段的共形与ARAP迭代次数之和
+    double maxResidual = 0;          // 所有片段中最大的共形相对残差
+    int unconvergedPieces = 0;
+    bool preview = false;            // flattenPreview的粗网格近似结果
+};
+
+// 一次上传网格（commitMeshUpload / setMesh）的分阶段耗时
+struct MeshSetupStats {
+    double repairMs = 0;     // 焊接和拆分非流形顶点（setRepairOptions）
+    double reorderMs = 0;    // 顶点和面重排（setMeshOrdering）
+    double geometryMs = 0;   // 逐面边长、余切、面积
+    double halfEdgeMs = 0;   // 半边和twin
+    double boundaryMs = 0;   // 边界半边和边界顶点
+    double totalMs = 0;      // 含索引检查
+};
+
 // 展开结果
 struct FlattenResult {
-    std::vector<Vec2> uvCoords;
     std::vector<std::vector<int>> pieces;  // 每个片段包含的面索引
-    bool success;
+    std::vector<int> facePiece;            // 面 -> 片段索引
+    std::vector<int> uvFaces;              // 每个面三个角对应的切分后顶点 [3*F]
+    std::vector<int> splitVertexSource;    // 切分后顶点 -> 原网格顶点
+    FlattenStats stats;                    // 迭代次数、残差和耗时
+    bool success = false;
     std::string errorMessage;
 };
 
@@ -90,7 +154,7 @@ public:
     ~BFFFlattener();
     
     /**
-     * 设置网格数据
+     * 设置网格数据（顶点按Real精度存储）
      * @param vertices 顶点数组 [x0,y0,z0, x1,y1,z1, ...]
      * @param numVertices 顶点数量
      * @param faces 面索引数组（三角形）[v0,v1,v2, v3,v4,v5, ...]
@@ -99,6 +163,83 @@ public:
     void setMesh(const double* vertices, int numVertices,
                  const int* faces, int numFaces);
     
+    /**
+     * 零拷贝上传：返回可直接写入的顶点缓冲区 [x0,y0,z0, ...]（Real精度）
+     * 缓冲区即网格内部存储，写完后调用commitMeshUpload()
+     * @param numVertices 顶点数量
+     */
+    Real* vertexUploadBuffer(int numVertices);
+    
+    /**
+     * 零拷贝上传：返回可直接写入的面索引缓冲区 [v0,v1,v2, ...]
+     * @param numFaces 面数量
+     */
+    int* faceUploadBuffer(int numFaces);
+    
+    /**
+     * 用已写入上传缓冲区的数据构建网格拓扑
+     * @return 索引越界时返回false
+     */
+    bool commitMeshUpload();
+    
+    /**
+     * 设置上传网格时的重排方式，下次setMesh/commitMeshUpload生效
+     * 重排只改变内部存储顺序：顶点、面、缝线、UV和展开结果仍按调用方编号，
+     * 因此结果与不重排时等价，但片段编号和铺展起点可能不同
+     */
+    void setMeshOrdering(MeshOrdering ordering) { meshOrdering = ordering; }
+    
+    /**
+     * 设置上传网格时的拓扑修复（见topology_repair.h），下次setMesh/commitMeshUpload生效
+     * 修复后的网格即调用方此后使用的编号：缝线、固定点、uvFaces和splitVertexSource都按修复后的
+     * 顶点和面编号，与上传时编号的对应见 getRepairVertexSource / getRepairFaceSource
+     */
+    void setRepairOptions(const RepairOptions& options) { repairOptions = options; }
+    
+    /**
+     * 上一次上传网格的修复统计
+     */
+    const RepairStats& getRepairStats() const { return repairStats; }
+    
+    /**
+     * 修复后的顶点 -> 上传的顶点（位置相同），未启用修复时为空
+     */
+    const std::vector<int>& getRepairVertexSource() const { return repairVertexSource; }
+    
+    /**
+     * 修复后的面 -> 上传的面，未启用修复时为空
+     */
+    const std::vector<int>& getRepairFaceSource() const { return repairFaceSource; }
+    
+    /**
+     * 当前网格的三角形（调用方编号，即修复后的网格），角的顺序与上传时相同
+     */
+    void getMeshTriangles(std::vector<int>& out) const;
+    
+    /**
+     * 把网格、半边拓扑、缝线、片段划分和UV写成缓存容器（布局见mesh_cache.h）
+     * 缝线在上次展开后改动过时不写片段划分和UV；固定点和求解缓存不保存
+     * @return 容器字节，下一次saveCache或cacheUploadBuffer前有效
+     */
+    const std::vector<uint8_t>& saveCache();
+    
+    /**
+     * 零拷贝载入：返回可直接写入缓存容器的缓冲区，写完后调用commitCacheUpload()
+     */
+    uint8_t* cacheUploadBuffer(size_t size);
+    
+    /**
+     * 载入已写入上传缓冲区的缓存容器，随后释放该缓冲区
+     */
+    bool commitCacheUpload();
+    
+    /**
+     * 从缓存容器恢复网格、缝线、片段划分和UV（替换当前网格，固定点清空）
+     * 只做复制和线性校验，不重建半边、不重新切分；含UV时getUVCoords立即可用
+     * @return 容器损坏或版本不符时返回false，网格被清空
+     */
+    bool loadCache(const uint8_t* data, size_t size);
+    
     /**
      * 添加缝线边
      * @param v1 顶点1索引
@@ -106,70 +247,286 @@ public:
      */
     void addSeamEdge(int v1, int v2);
     
+    /**
+     * 一次性替换全部缝线，缝线集合不变时不触发重新切分
+     * @param edges 顶点对 [a0,b0, a1,b1, ...]
+     * @param numEdges 边数
+     */
+    void setSeamEdges(const int* edges, int numEdges);
+    
+    /**
+     * 沿网格边用最短路径依次连接路标顶点（MeshCutter.connectRedVertices），路径上的边加入缝线
+     * 相邻路标不连通时跳过该段
+     * @param path 路标顶点 [v0, v1, ...]
+     * @param closed 是否连接最后一个路标和第一个
+     * @return 新增的缝线边数，路标越界时返回-1
+     */
+    int addSeamPath(const int* path, int count, bool closed);
+    
     /**
      * 清除所有缝线
      */
     void clearSeams();
     
+    /**
+     * 固定某个UV顶点的位置（片段归一化坐标系），下次flatten生效
+     * 只移动已有固定点时重新展开复用缓存的分解，只做回代
+     * @param uvIndex 切分后顶点索引（即UV坐标索引）
+     */
+    void setPin(int uvIndex, double u, double v);
+    
+    /**
+     * 取消固定
+     */
+    void removePin(int uvIndex);
+    
+    /**
+     * 清除所有固定点
+     */
+    void clearPins();
+    
+    /**
+     * 设置展开方法
+     */
+    void setMethod(FlattenMethod m) { method = m; }
+    
+    /**
+     * 设置ARAP参数（ARAP模式下生效），权重、平滑参数或固定点变化时各片段重新预分解
+     */
+    void setARAPOptions(const ARAPOptions& options) { arapOptions = options; }
+    
+    /**
+     * ARAP模式的初值（同 ARAPFlattener.js 的 initialUV），代替共形结果；固定点仍取固定UV
+     * 按UV坐标索引（切分后顶点）或按网格顶点给出，长度与两者都不符时忽略；count为0时清除
+     * @param uvs [u0,v0, u1,v1, ...]
+     * @param count UV个数
+     */
+    void setARAPInitialUV(const double* uvs, int count);
+    
+    /**
+     * 设置共形求解的迭代参数（只在直接分解失败、退回PCG时起作用）
+     */
+    void setSolverOptions(const SolverOptions& options) { solverOptions = options; }
+    
     /**
      * 执行展开
+     * 缝线未变化时沿用上次的片段划分；各片段的铺展结果和分解按拓扑缓存，
+     * 修改缝线只会使拓扑发生变化的片段缓存失效
      * @return 是否成功
      */
     bool flatten();
     
     /**
-     * 获取UV坐标
+     * 分步展开：beginFlatten切分片段并准备结果缓冲区，之后反复调用flattenStep，
+     * 全部片段完成后由finishFlatten给出结果。调用方可在两步之间处理取消和进度，
+     * flatten()等价于一次完成全部步骤
+     * @return beginFlatten：网格为空时返回false
+     */
+    bool beginFlatten();
+    
+    /**
+     * 展开接下来的最多maxIslands个片段
+     * @return 剩余未展开的片段数
+     */
+    int flattenStep(int maxIslands);
+    
+    /**
+     * 结束分步展开，未全部完成或有片段失败时返回false
+     */
+    bool finishFlatten();
+    
+    /**
+     * 快速预览：顶点多于targetVertices的片段收缩到约targetVertices个顶点（保留片段边界和固定点），
+     * 在粗网格上求共形解后插值回全部顶点；不执行ARAP。结果与flatten()相同方式读取，
+     * stats.preview为true；下一次完整展开以预览结果作为PCG的初值
+     * @return 网格为空时返回false
+     */
+    bool flattenPreview(int targetVertices);
+    
+    /**
+     * 片段数量，beginFlatten后有效
+     */
+    int getIslandCount() const { return islands.size(); }
+    
+    /**
+     * 获取UV坐标（Real精度）
      * @return UV坐标数组 [u0,v0, u1,v1, ...]
      */
-    const std::vector<double>& getUVCoords() const { return uvResult; }
+    const std::vector<Real>& getUVCoords() const { return uvResult; }
+    
+    /**
+     * 获取单精度UV坐标（双精度构建中首次调用时转换，flatten后重新生成）
+     * @return UV坐标数组 [u0,v0, u1,v1, ...]
+     */
+    const std::vector<float>& getUVCoordsFloat();
     
     /**
      * 获取UV坐标数量
      */
     int getUVCount() const { return uvResult.size() / 2; }
     
+    /**
+     * 把展开后的各片段排进定宽条带（见uv_packer.h），flatten成功后调用
+     * 各片段先按3D面积与UV面积之比缩放回网格单位，stripWidth和spacing也按网格单位给出；
+     * 结果另存，不改动getUVCoords（固定点仍按片段归一化坐标）
+     * @return 没有展开结果时返回false
+     */
+    bool packIslands(const PackOptions& options);
+    
+    /**
+     * 排料结果，transforms与 FlattenResult::pieces 一一对应
+     */
+    const PackResult& getPackResult() const { return packResult; }
+    
+    /**
+     * 排料后的UV坐标 [u0,v0, u1,v1, ...]（Real精度，按切分后顶点索引）
+     */
+    const std::vector<Real>& getPackedUVCoords() const { return packedUV; }
+    
+    /**
+     * 当前展开结果的畸变指标（见distortion_metrics.h），逐面数组按调用方的面编号
+     * 首次调用时计算，之后直到下一次flatten前直接返回
+     * @return 没有展开结果时返回空指标
+     */
+    const DistortionMetrics& getDistortion();
+    
+    /**
+     * 获取展开结果（片段划分和切分后顶点映射）
+     * 沿缝线切开后缝线上的顶点会被复制：切分后顶点的前numVertices个与原顶点一一对应，
+     * 复制出的顶点追加在后面，UV坐标按切分后顶点索引存储
+     */
+    const FlattenResult& getResult() const { return result; }
+    
+    /**
+     * 上一次上传网格的分阶段耗时
+     */
+    const MeshSetupStats& getSetupStats() const { return setupStats; }
+    
     /**
      * 获取错误信息
      */
     const char* getError() const { return errorMsg.c_str(); }
+    
+    /**
+     * 获取非流形边（被三个及以上面共享），setMesh后有效
+     * 这些边不设置twin，展开时按边界处理；启用splitNonManifold时为拆分前检测到的边
+     */
+    const std::vector<std::pair<int, int>>& getNonManifoldEdges() const { return mesh.nonManifoldEdges; }
 
 private:
     Mesh mesh;
-    std::vector<double> uvResult;
+    std::vector<Island> islands;
+    std::vector<IslandCache> islandCaches;  // 与islands一一对应
+    std::vector<int> faceLocalIndex;        // 面 -> 所在片段内的局部面编号
+    std::unordered_map<int, Vec2> pins;     // 切分后顶点 -> 固定UV
+    FlattenMethod method = FlattenMethod::Conformal;
+    MeshOrdering meshOrdering = MeshOrdering::Original;
+    RepairOptions repairOptions;
+    RepairStats repairStats;
+    std::vector<int> repairVertexSource;    // 修复后顶点 -> 上传的顶点
+    std::vector<int> repairFaceSource;      // 修复后面 -> 上传的面
+    EdgePathFinder pathFinder;              // addSeamPath用，按需建立，网格变化后清空
+    std::vector<int> vertexOrder;           // 内部顶点 -> 调用方顶点，未重排时为空
+    std::vector<int> vertexRank;            // 调用方顶点 -> 内部顶点
+    std::vector<int> faceOrder;             // 内部面 -> 调用方面
+    ARAPOptions arapOptions;
+    std::vector<Vec2> arapInitialUV;        // ARAP模式的初值，空为使用共形结果
+    SolverOptions solverOptions;
+    bool topologyDirty = true;              // 缝线或网格变化后需要重新切分
+    FlattenResult result;
+    MeshSetupStats setupStats;
+    int nextIsland = 0;                     // 分步展开：下一个待展开的片段
+    std::chrono::steady_clock::time_point flattenStart;
+    std::vector<char> pieceOk;              // 分步展开：各片段是否成功
+    std::vector<Real> uvResult;
+    std::vector<float> uvResultFloat;  // uvResult的单精度副本，按需生成
+    PackResult packResult;
+    std::vector<Real> packedUV;        // 排料后的UV，flatten后清空
+    bool uvFloatValid = false;
+    DistortionMetrics distortion;      // 按需计算，flatten后失效
+    bool distortionValid = false;
+    Arena arena;                  // 拓扑构建的临时内存，跨setMesh保留容量
+    std::vector<uint8_t> cacheBuffer;  // saveCache输出 / cacheUploadBuffer输入
     std::string errorMsg;
     
     // 内部方法
+    void resetMeshState();        // 清空拓扑、缝线、片段和结果（不动顶点和面）
+    void weldMesh();              // 按repairOptions焊接顶点、删除退化面（调用方编号）
+    void reorderMesh();           // 按meshOrdering重排顶点和面并记录顺序
+    void repairTopology();        // 在半边结构上拆分非流形顶点（新顶点追加在末尾）并统计边界环
+    void initFaceHalfEdges();     // 按面建立半边（twin置-1）和顶点半边
     void buildHalfEdgeStructure();
     void identifyBoundaries();
     void splitBySeams();
     
-    // 基于角度的展开（简化版BFF）
-    bool flattenPiece(const std::vector<int>& faceIndices, 
-                      std::vector<Vec2>& uvs,
-                      std::map<int, int>& vertexMap);
+    // 按缝线边集合设置半边的isSeam
+    void markSeamHalfEdges();
+    
+    // 由 result.facePiece / uvFaces / splitVertexSource 建立各片段的局部网格
+    void buildIslands(int islandCount);
+    
+    // 重新切分后为各片段匹配旧缓存
+    void rebindIslandCaches();
+    
+    // 取ARAP初值中片段的部分（固定点除外），长度不符时返回false
+    bool applyARAPInitialUV(const Island& island, const std::vector<int>& pinned, std::vector<Vec2>& uvs) const;
+    
+    // 铺展（命中缓存时直接复制）并应用固定点，pinned为升序的局部顶点
+    void preparePiece(const Island& island, IslandCache& cache, std::vector<Vec2>& uvs,
+                      std::vector<int>& pinned, PieceStats& stats) const;
     
-    // 三角形铺展
-    bool unfoldTriangle(int faceIdx, 
-                        const std::map<int, int>& vertexMap,
-                        std::vector<Vec2>& uvs,
-                        std::set<int>& placedVertices);
+    // 建立片段边界顶点标记和边界有向边（缝线边和无twin的边），已建立时不做任何事
+    void markIslandBoundary(const Island& island, IslandCache& cache) const;
     
-    // 计算角度
-    double computeAngle(const Vec3& a, const Vec3& b, const Vec3& c);
+    // 粗网格预览，顶点数不超过targetVertices的片段直接做完整的共形求解
+    bool previewPiece(const Island& island, IslandCache& cache, std::vector<Vec2>& uvs,
+                      PieceStats& stats, int targetVertices) const;
     
-    // 计算边长
-    double edgeLength(int v1, int v2);
+    // 基于角度的展开（简化版BFF），uvs按片段局部顶点索引
+    bool flattenPiece(const Island& island, IslandCache& cache, std::vector<Vec2>& uvs,
+                      PieceStats& stats) const;
     
-    // 共形映射优化
-    void optimizeConformal(std::vector<Vec2>& uvs, 
-                          const std::vector<int>& faceIndices,
-                          const std::map<int, int>& vertexMap,
-                          int iterations);
+    // BFS铺展并归一化到单位正方形
+    void unfoldPiece(const Island& island, std::vector<Vec2>& uvs) const;
+    
+    // 在当前UV上执行ARAP迭代，固定点保持不动；没有固定点时归一化
+    ARAPStats optimizeARAP(std::vector<Vec2>& uvs, const Island& island, IslandCache& cache,
+                           const std::vector<int>& pinned) const;
+    
+    // 共形固定顶点：固定点不足两个时按铺展坐标补上边界上相距最远的顶点（锚点），升序
+    std::vector<int> conformalAnchors(const Island& island, const IslandCache& cache,
+                                      const std::vector<int>& pinned) const;
+    
+    // 共形映射优化（LSCM，边界自由）：只固定固定点和锚点，在余切拉普拉斯加边界面积项上求解，
+    // 没有固定点时结果归一化到单位正方形
+    // 优先使用缓存的LDL^T分解，分解失败时退回PCG（solverOptions控制迭代次数和容差）
+    // 返回相对残差和PCG迭代次数
+    SolveStats optimizeConformal(std::vector<Vec2>& uvs, 
+                                 const Island& island,
+                                 IslandCache& cache,
+                                 const std::vector<int>& pinned) const;
     
     // 获取边的key
     std::pair<int, int> edgeKey(int v1, int v2) {
         return v1 < v2 ? std::make_pair(v1, v2) : std::make_pair(v2, v1);
     }
+    
+    // 无向边的64位整数key，用于哈希表
+    static uint64_t edgeHashKey(int v1, int v2) {
+        if (v1 > v2) std::swap(v1, v2);
+        return (static_cast<uint64_t>(static_cast<uint32_t>(v1)) << 32) | static_cast<uint32_t>(v2);
+    }
+    
+    // 内部编号与调用方编号的换算，未重排时为恒等
+    int callerVertex(int v) const { return vertexOrder.empty() ? v : vertexOrder[v]; }
+    int callerHalfEdge(int heIdx) const {
+        return faceOrder.empty() ? heIdx : faceOrder[heIdx / 3] * 3 + heIdx % 3;
+    }
+    
+    // 半边的起点（三角形中上一条半边的目标顶点）
+    int heOrigin(int heIdx) const {
+        return mesh.halfEdges[hePrev(heIdx)].vertex;
+    }
 };
 
 } // namespace bff
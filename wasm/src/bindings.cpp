@@ -5,112 +5,1278 @@
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
 #include "bff_flattener.h"
+#include "physics_solver.h"
+#include "obj_reader.h"
+#include "spatial_index.h"
+#include "flood_segmenter.h"
+#include "uv_packer.h"
+#include "distortion_metrics.h"
+#include "pattern_export.h"
+#include "topology_repair.h"
+#include "batch_flatten.h"
+#include "profiler.h"
+#include <memory>
+#include <unordered_set>
 
 using namespace emscripten;
 
-// 全局flattener实例
-static bff::BFFFlattener* g_flattener = nullptr;
+// 实例表：句柄即下标，一个模块（Worker）内可同时持有多个实例
+// 销毁后槽位置空，下次创建时复用
+template <typename T>
+struct HandleTable {
+    std::vector<std::unique_ptr<T>> slots;
+    
+    T* get(int handle) const {
+        if (handle < 0 || handle >= (int)slots.size()) return nullptr;
+        return slots[handle].get();
+    }
+    
+    int create() {
+        for (int i = 0; i < (int)slots.size(); i++) {
+            if (!slots[i]) {
+                slots[i].reset(new T());
+                return i;
+            }
+        }
+        slots.emplace_back(new T());
+        return slots.size() - 1;
+    }
+    
+    void destroy(int handle) {
+        if (get(handle)) slots[handle].reset();
+    }
+};
+
+static HandleTable<bff::BFFFlattener> g_flatteners;
+static HandleTable<bff::PhysicsSolver> g_physicsSolvers;
+static HandleTable<bff::FloodSegmenter> g_segmenters;
+
+static bff::BFFFlattener* getFlattener(int handle) {
+    return g_flatteners.get(handle);
+}
+
+// 创建展开器，返回句柄
+int createFlattener() {
+    return g_flatteners.create();
+}
+
+// 销毁展开器，句柄随后失效
+void destroyFlattener(int handle) {
+    g_flatteners.destroy(handle);
+}
+
+// 设置网格数据（兼容接口，接受普通数组或TypedArray）
+bool setMesh(int handle, val vertices, val faces) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return false;
+    
+    // 获取数组长度
+    int numVertices = vertices["length"].as<int>() / 3;
+    int numFaces = faces["length"].as<int>() / 3;
+    
+    // 由JS侧TypedArray.set一次性复制到WASM内存，避免逐元素读取
+    BFF_PROFILE_SCOPE("uploadCopy");
+    bff::Real* vertBuffer = flattener->vertexUploadBuffer(numVertices);
+    val(typed_memory_view(numVertices * 3, vertBuffer)).call<void>("set", vertices);
+    
+    int* faceBuffer = flattener->faceUploadBuffer(numFaces);
+    val(typed_memory_view(numFaces * 3, faceBuffer)).call<void>("set", faces);
+    
+    return flattener->commitMeshUpload();
+}
+
+// 零拷贝上传：返回指向WASM内存的顶点视图，JS直接写入顶点
+// 双精度构建为Float64Array，单精度构建（make float32）为Float32Array，set()时自动转换
+// 视图在下一次WASM内存分配（内存增长）后失效，应取得后立即填充
+val getVertexUploadView(int handle, int numVertices) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    bff::Real* buffer = flattener->vertexUploadBuffer(numVertices);
+    return val(typed_memory_view(numVertices * 3, buffer));
+}
+
+// 零拷贝上传：返回面索引的Int32Array视图，有效期同上
+val getFaceUploadView(int handle, int numFaces) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    int* buffer = flattener->faceUploadBuffer(numFaces);
+    return val(typed_memory_view(numFaces * 3, buffer));
+}
+
+// 用已上传的缓冲区构建网格
+bool commitMesh(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return false;
+    return flattener->commitMeshUpload();
+}
+
+// 网格缓存容器（布局见mesh_cache.h）的Uint8Array视图，下一次saveCache或内存增长后失效
+// 存入IndexedDB前复制一份（slice）
+val saveCache(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    const std::vector<uint8_t>& data = flattener->saveCache();
+    return val(typed_memory_view(data.size(), data.data()));
+}
+
+// 零拷贝载入：返回WASM内存中的Uint8Array视图，JS写入缓存容器后调用commitCache
+val getCacheUploadView(int handle, int size) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    uint8_t* buffer = flattener->cacheUploadBuffer(size);
+    return val(typed_memory_view(size, buffer));
+}
+
+// 从已上传的缓存容器恢复网格、缝线、片段划分和UV
+bool commitCache(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return false;
+    return flattener->commitCacheUpload();
+}
+
+// 一次替换全部缝线，edges为Int32Array或数组 [a0,b0, a1,b1, ...]
+void setSeams(int handle, val edges) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return;
+    std::vector<int> pairs(edges["length"].as<int>());
+    val(typed_memory_view(pairs.size(), pairs.data())).call<void>("set", edges);
+    flattener->setSeamEdges(pairs.data(), pairs.size() / 2);
+}
+
+// 添加缝线边
+void addSeamEdge(int handle, int v1, int v2) {
+    if (bff::BFFFlattener* flattener = getFlattener(handle)) {
+        flattener->addSeamEdge(v1, v2);
+    }
+}
+
+// 沿网格边的最短路径依次连接路标顶点并加入缝线，path为Int32Array或数组；返回新增的缝线边数，越界时返回-1
+int addSeamPath(int handle, val path, bool closed) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return -1;
+    std::vector<int> points(path["length"].as<int>());
+    val(typed_memory_view(points.size(), points.data())).call<void>("set", path);
+    return flattener->addSeamPath(points.data(), points.size(), closed);
+}
+
+// 清除缝线
+void clearSeams(int handle) {
+    if (bff::BFFFlattener* flattener = getFlattener(handle)) {
+        flattener->clearSeams();
+    }
+}
+
+// 固定UV顶点（切分后顶点索引，片段归一化坐标）
+void setPin(int handle, int uvIndex, double u, double v) {
+    if (bff::BFFFlattener* flattener = getFlattener(handle)) {
+        flattener->setPin(uvIndex, u, v);
+    }
+}
+
+// 取消固定
+void removePin(int handle, int uvIndex) {
+    if (bff::BFFFlattener* flattener = getFlattener(handle)) {
+        flattener->removePin(uvIndex);
+    }
+}
+
+// 清除所有固定点
+void clearPins(int handle) {
+    if (bff::BFFFlattener* flattener = getFlattener(handle)) {
+        flattener->clearPins();
+    }
+}
+
+// 设置展开方法：0 = 共形，1 = ARAP
+void setFlattenMethod(int handle, int method) {
+    if (bff::BFFFlattener* flattener = getFlattener(handle)) {
+        flattener->setMethod(method == 1 ? bff::FlattenMethod::ARAP : bff::FlattenMethod::Conformal);
+    }
+}
+
+// 设置上传网格时的重排方式：0 = 保持原顺序，1 = RCM，2 = Morton曲线（下次上传网格生效）
+void setMeshOrdering(int handle, int ordering) {
+    if (bff::BFFFlattener* flattener = getFlattener(handle)) {
+        flattener->setMeshOrdering(ordering == 1 ? bff::MeshOrdering::RCM :
+                                   ordering == 2 ? bff::MeshOrdering::Morton : bff::MeshOrdering::Original);
+    }
+}
+
+// 设置上传网格时的拓扑修复（下次上传网格生效）
+// options字段：weldTolerance（>0 焊接）/ splitNonManifold
+void setRepairOptions(int handle, val options) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return;
+    bff::RepairOptions opts;
+    if (!options.isUndefined() && !options.isNull()) {
+        if (!options["weldTolerance"].isUndefined()) opts.weldTolerance = options["weldTolerance"].as<double>();
+        if (!options["splitNonManifold"].isUndefined()) opts.splitNonManifold = options["splitNonManifold"].as<bool>();
+    }
+    flattener->setRepairOptions(opts);
+}
+
+// ARAP参数，字段与ARAPFlattener.js的options相同，缺省字段使用默认值
+static bff::ARAPOptions arapOptionsFromJS(int iterations, val options) {
+    bff::ARAPOptions opts;
+    opts.iterations = iterations;
+    if (!options.isUndefined() && !options.isNull()) {
+        if (!options["boundaryConstraints"].isUndefined())
+            opts.boundaryConstraints = options["boundaryConstraints"].as<bool>();
+        if (!options["smoothBoundary"].isUndefined())
+            opts.smoothBoundary = options["smoothBoundary"].as<bool>();
+        if (!options["smoothIterations"].isUndefined())
+            opts.smoothIterations = options["smoothIterations"].as<int>();
+        if (!options["boundaryStiffness"].isUndefined())
+            opts.boundaryStiffness = options["boundaryStiffness"].as<double>();
+        if (!options["internalStiffness"].isUndefined())
+            opts.internalStiffness = options["internalStiffness"].as<double>();
+        if (!options["tolerance"].isUndefined())
+            opts.tolerance = options["tolerance"].as<double>();
+    }
+    return opts;
+}
+
+// 设置ARAP参数
+void setARAPOptions(int handle, int iterations, val options) {
+    if (bff::BFFFlattener* flattener = getFlattener(handle)) {
+        flattener->setARAPOptions(arapOptionsFromJS(iterations, options));
+    }
+}
+
+// ARAP模式的初值（Float64Array [u0,v0, ...]，按UV索引或按网格顶点），空数组为清除
+void setARAPInitialUV(int handle, val uvs) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return;
+    std::vector<double> buffer(uvs["length"].as<int>());
+    val(typed_memory_view(buffer.size(), buffer.data())).call<void>("set", uvs);
+    flattener->setARAPInitialUV(buffer.data(), buffer.size() / 2);
+}
 
-// 初始化
-void init() {
-    if (g_flattener) {
-        delete g_flattener;
+// 设置共形求解的PCG参数（直接分解失败时使用）
+void setSolverOptions(int handle, int maxIterations, double tolerance) {
+    if (bff::BFFFlattener* flattener = getFlattener(handle)) {
+        bff::SolverOptions opts;
+        opts.maxIterations = maxIterations;
+        opts.tolerance = tolerance;
+        flattener->setSolverOptions(opts);
     }
-    g_flattener = new bff::BFFFlattener();
 }
 
-// 清理
-void cleanup() {
-    if (g_flattener) {
-        delete g_flattener;
-        g_flattener = nullptr;
+// 执行展开
+bool flatten(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return false;
+    return flattener->flatten();
+}
+
+// 分步展开（Worker在两步之间处理取消和进度）：beginFlatten后反复调用flattenStep，
+// 返回0时调用finishFlatten取得结果
+bool beginFlatten(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return false;
+    return flattener->beginFlatten();
+}
+
+// 展开接下来的最多maxIslands个片段，返回剩余片段数
+int flattenStep(int handle, int maxIslands) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return 0;
+    return flattener->flattenStep(maxIslands);
+}
+
+bool finishFlatten(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return false;
+    return flattener->finishFlatten();
+}
+
+// 快速预览：大片段在约targetVertices个顶点的粗网格上求解，结果的读取方式同flatten
+bool flattenPreview(int handle, int targetVertices) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return false;
+    return flattener->flattenPreview(targetVertices);
+}
+
+// 片段数量，beginFlatten后有效
+int getIslandCount(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return 0;
+    return flattener->getIslandCount();
+}
+
+// 获取UV结果（复制一份，调用方可长期持有）
+val getUVCoords(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    
+    BFF_PROFILE_SCOPE("readback");
+    const std::vector<bff::Real>& uvs = flattener->getUVCoords();
+    return val(typed_memory_view(uvs.size(), uvs.data())).call<val>("slice");
+}
+
+// 获取UV结果的零拷贝视图（直接指向WASM内存，数组类型同getVertexUploadView）
+// 有效期：下一次setMesh/commitMesh/flatten/destroyFlattener之前，且期间没有WASM内存增长
+// 需要长期保存时调用方应自行slice()
+val getUVCoordsView(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    
+    const std::vector<bff::Real>& uvs = flattener->getUVCoords();
+    return val(typed_memory_view(uvs.size(), uvs.data()));
+}
+
+// 获取单精度UV结果的零拷贝视图（Float32Array），有效期同getUVCoordsView
+// 首次调用会分配单精度缓冲区，因此应在取得双精度视图之前调用
+val getUVCoordsF32View(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    
+    const std::vector<float>& uvs = flattener->getUVCoordsFloat();
+    return val(typed_memory_view(uvs.size(), uvs.data()));
+}
+
+// 获取UV数量
+int getUVCount(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return 0;
+    return flattener->getUVCount();
+}
+
+// 获取片段（UV岛）数量，flatten后有效
+int getPieceCount(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return 0;
+    return flattener->getResult().pieces.size();
+}
+
+// 以下结果视图有效期同getUVCoordsView
+
+// 面 -> 片段索引（Int32Array视图）
+val getFacePieces(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    const auto& data = flattener->getResult().facePiece;
+    return val(typed_memory_view(data.size(), data.data()));
+}
+
+// 每个面三个角对应的切分后顶点，即UV坐标索引（Int32Array视图）
+val getUVFaces(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    const auto& data = flattener->getResult().uvFaces;
+    return val(typed_memory_view(data.size(), data.data()));
+}
+
+// 切分后顶点 -> 原网格顶点（Int32Array视图）
+val getSplitVertexSource(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    const auto& data = flattener->getResult().splitVertexSource;
+    return val(typed_memory_view(data.size(), data.data()));
+}
+
+// 最近一次展开的统计：汇总字段和逐片段数组（复制，可长期持有）
+val getFlattenStats(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    const bff::FlattenStats& s = flattener->getResult().stats;
+    
+    int n = s.pieces.size();
+    std::vector<int> conformalIterations(n), arapIterations(n), converged(n);
+    std::vector<double> residual(n), energy(n), timeMs(n);
+    for (int i = 0; i < n; i++) {
+        const bff::PieceStats& p = s.pieces[i];
+        conformalIterations[i] = p.conformalIterations;
+        arapIterations[i] = p.arapIterations;
+        converged[i] = p.converged;
+        residual[i] = p.conformalResidual;
+        energy[i] = p.arapEnergy;
+        timeMs[i] = p.unfoldMs + p.conformalMs + p.arapMs;
     }
+    auto copyInt = [](const std::vector<int>& v) {
+        return val(typed_memory_view(v.size(), v.data())).call<val>("slice");
+    };
+    auto copyDouble = [](const std::vector<double>& v) {
+        return val(typed_memory_view(v.size(), v.data())).call<val>("slice");
+    };
+    
+    val stats = val::object();
+    stats.set("splitMs", s.splitMs);
+    stats.set("unfoldMs", s.unfoldMs);
+    stats.set("conformalMs", s.conformalMs);
+    stats.set("arapMs", s.arapMs);
+    stats.set("totalMs", s.totalMs);
+    stats.set("totalIterations", s.totalIterations);
+    stats.set("maxResidual", s.maxResidual);
+    stats.set("unconvergedPieces", s.unconvergedPieces);
+    stats.set("preview", s.preview);
+    stats.set("conformalIterations", copyInt(conformalIterations));
+    stats.set("conformalResidual", copyDouble(residual));
+    stats.set("arapIterations", copyInt(arapIterations));
+    stats.set("arapEnergy", copyDouble(energy));
+    stats.set("converged", copyInt(converged));
+    stats.set("pieceMs", copyDouble(timeMs));
+    return stats;
 }
 
-// 设置网格数据
-void setMesh(val vertices, val faces) {
-    if (!g_flattener) {
-        init();
+// 获取非流形边 [a0,b0, a1,b1, ...]
+val getNonManifoldEdges(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    
+    const auto& edges = flattener->getNonManifoldEdges();
+    std::vector<int> flat(edges.size() * 2);
+    for (size_t i = 0; i < edges.size(); i++) {
+        flat[i * 2] = edges[i].first;
+        flat[i * 2 + 1] = edges[i].second;
     }
     
-    // 获取数组长度
+    return val(typed_memory_view(flat.size(), flat.data())).call<val>("slice");
+}
+
+// 上一次上传网格的修复结果（复制）：统计字段，修复后的面 faces，
+// vertexSource（修复后顶点 -> 上传的顶点）和 faceSource（修复后面 -> 上传的面），未启用修复时两者为空
+val getRepairResult(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    const bff::RepairStats& s = flattener->getRepairStats();
+    const std::vector<int>& vertexSource = flattener->getRepairVertexSource();
+    const std::vector<int>& faceSource = flattener->getRepairFaceSource();
+    std::vector<int> faces;
+    flattener->getMeshTriangles(faces);
+    
+    val result = val::object();
+    result.set("inputVertices", s.inputVertices);
+    result.set("inputFaces", s.inputFaces);
+    result.set("weldedVertices", s.weldedVertices);
+    result.set("degenerateFaces", s.degenerateFaces);
+    result.set("splitVertices", s.splitVertices);
+    result.set("boundaryLoops", s.boundaryLoops);
+    result.set("weldMs", s.weldMs);
+    result.set("splitMs", s.splitMs);
+    result.set("faces", val(typed_memory_view(faces.size(), faces.data())).call<val>("slice"));
+    result.set("vertexSource", val(typed_memory_view(vertexSource.size(), vertexSource.data())).call<val>("slice"));
+    result.set("faceSource", val(typed_memory_view(faceSource.size(), faceSource.data())).call<val>("slice"));
+    return result;
+}
+
+// 获取错误信息
+std::string getError(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return "Invalid flattener handle";
+    return flattener->getError();
+}
+
+// ---------------------------------------------------------------------------
+// 弹性松弛（PhysicsFlattener的原生实现），独立于展开器，句柄单独编号
+// ---------------------------------------------------------------------------
+
+int createPhysicsSolver() {
+    return g_physicsSolvers.create();
+}
+
+void destroyPhysicsSolver(int handle) {
+    g_physicsSolvers.destroy(handle);
+}
+
+// 建立约束：vertices为Float64Array [x,y,z,...]，faces为Int32Array [a,b,c,...]
+// options字段与PhysicsFlattener.relaxDifferentiated相同，缺省字段使用默认值
+bool physicsSetup(int handle, val vertices, val faces, val options) {
+    bff::PhysicsSolver* solver = g_physicsSolvers.get(handle);
+    if (!solver) return false;
+    
     int numVertices = vertices["length"].as<int>() / 3;
     int numFaces = faces["length"].as<int>() / 3;
+    std::vector<bff::Vec3> points(numVertices);
+    std::vector<int> triangles(numFaces * 3);
+    val(typed_memory_view(numVertices * 3, reinterpret_cast<bff::Real*>(points.data()))).call<void>("set", vertices);
+    val(typed_memory_view(numFaces * 3, triangles.data())).call<void>("set", faces);
+    for (int idx : triangles) {
+        if (idx < 0 || idx >= numVertices) return false;
+    }
     
-    // 复制顶点数据
-    std::vector<double> verts(numVertices * 3);
-    for (int i = 0; i < numVertices * 3; i++) {
-        verts[i] = vertices[i].as<double>();
+    bff::PhysicsOptions opts;
+    if (!options.isUndefined() && !options.isNull()) {
+        if (!options["boundaryStiffness"].isUndefined())
+            opts.boundaryStiffness = options["boundaryStiffness"].as<double>();
+        if (!options["internalStiffness"].isUndefined())
+            opts.internalStiffness = options["internalStiffness"].as<double>();
+        if (!options["pinBoundary"].isUndefined())
+            opts.pinBoundary = options["pinBoundary"].as<bool>();
+        if (!options["damping"].isUndefined())
+            opts.damping = options["damping"].as<double>();
+        if (!options["timeStep"].isUndefined())
+            opts.timeStep = options["timeStep"].as<double>();
+        if (!options["solverIterations"].isUndefined())
+            opts.solverIterations = options["solverIterations"].as<int>();
+        if (!options["tolerance"].isUndefined())
+            opts.tolerance = options["tolerance"].as<double>();
     }
+    solver->setup(points.data(), numVertices, triangles.data(), numFaces, opts);
+    return true;
+}
+
+// 设置初始UV（Float64Array [u0,v0, ...]），长度不足 2 * 顶点数 时返回false
+bool physicsSetUVs(int handle, val uvs) {
+    bff::PhysicsSolver* solver = g_physicsSolvers.get(handle);
+    if (!solver) return false;
+    std::vector<double> buffer(uvs["length"].as<int>());
+    val(typed_memory_view(buffer.size(), buffer.data())).call<void>("set", uvs);
+    return solver->setPositions(buffer.data(), buffer.size());
+}
+
+// 连续执行最多steps步（收敛时提前结束），返回实际步数
+int physicsStep(int handle, int steps) {
+    bff::PhysicsSolver* solver = g_physicsSolvers.get(handle);
+    if (!solver) return 0;
+    return solver->step(steps);
+}
+
+// 当前UV的零拷贝视图（Float64Array），下一次physicsStep或内存增长后失效
+val getPhysicsUVsView(int handle) {
+    bff::PhysicsSolver* solver = g_physicsSolvers.get(handle);
+    if (!solver) return val::null();
+    const std::vector<double>& uvs = solver->positions();
+    return val(typed_memory_view(uvs.size(), uvs.data()));
+}
+
+// 当前应变能、是否收敛、约束数量
+val getPhysicsStats(int handle) {
+    bff::PhysicsSolver* solver = g_physicsSolvers.get(handle);
+    if (!solver) return val::null();
+    val stats = val::object();
+    stats.set("energy", solver->energy());
+    stats.set("converged", solver->isConverged());
+    stats.set("constraints", solver->numConstraints());
+    stats.set("boundaryConstraints", solver->numBoundaryConstraints());
+    return stats;
+}
+
+// ---------------------------------------------------------------------------
+// OBJ流式读取：JS把文件分块写入暂存区后调用objReaderFeed，全部读完后objReaderFinish
+// ---------------------------------------------------------------------------
+
+struct ObjReaderSlot {
+    bff::ObjReader reader;
+    std::vector<char> chunk;   // JS写入的字节块
+};
+
+static HandleTable<ObjReaderSlot> g_objReaders;
+
+int createObjReader(bool dedupVertices) {
+    int handle = g_objReaders.create();
+    bff::ObjReadOptions opts;
+    opts.dedupVertices = dedupVertices;
+    g_objReaders.get(handle)->reader.reset(opts);
+    return handle;
+}
+
+void destroyObjReader(int handle) {
+    g_objReaders.destroy(handle);
+}
+
+// 字节块暂存区的Uint8Array视图，写入后立即调用objReaderFeed
+val getObjChunkView(int handle, int size) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    if (!slot) return val::null();
+    slot->chunk.resize(size);
+    return val(typed_memory_view(size, reinterpret_cast<unsigned char*>(slot->chunk.data())));
+}
+
+// 解析暂存区中的前size个字节
+void objReaderFeed(int handle, int size) {
+    if (ObjReaderSlot* slot = g_objReaders.get(handle)) {
+        slot->reader.feed(slot->chunk.data(), std::min<size_t>(size, slot->chunk.size()));
+    }
+}
+
+bool objReaderFinish(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    if (!slot) return false;
+    slot->chunk = std::vector<char>();
+    return slot->reader.finish();
+}
+
+// 把读到的网格设置给展开器（等同于setMesh）
+bool objReaderLoadInto(int handle, int flattenerHandle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    bff::BFFFlattener* flattener = getFlattener(flattenerHandle);
+    if (!slot || !flattener) return false;
+    return slot->reader.loadInto(*flattener);
+}
+
+val getObjInfo(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    if (!slot) return val::null();
+    const bff::ObjReader& r = slot->reader;
+    val info = val::object();
+    info.set("vertices", r.numVertices());
+    info.set("triangles", r.numTriangles());
+    info.set("polygons", r.numPolygons());
+    info.set("skippedFaces", r.numSkippedFaces());
+    info.set("hasVertexColors", r.hasVertexColors());
+    info.set("hasTexcoords", !r.triangleTexcoords().empty());
+    info.set("hasNormals", !r.triangleNormals().empty());
+    return info;
+}
+
+std::string getObjError(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    if (!slot) return "Invalid OBJ reader handle";
+    return slot->reader.getError();
+}
+
+// 以下视图指向读取器内部数组，有效期到destroyObjReader或下一次内存增长
+
+template <typename T>
+static val vectorView(const std::vector<T>& data) {
+    return val(typed_memory_view(data.size(), data.data()));
+}
+
+val getObjPositionsView(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    return slot ? vectorView(slot->reader.positions()) : val::null();
+}
+
+val getObjColorsView(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    return slot ? vectorView(slot->reader.colors()) : val::null();
+}
+
+val getObjTexcoordsView(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    return slot ? vectorView(slot->reader.texcoords()) : val::null();
+}
+
+val getObjNormalsView(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    return slot ? vectorView(slot->reader.normals()) : val::null();
+}
+
+val getObjTrianglesView(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    return slot ? vectorView(slot->reader.triangles()) : val::null();
+}
+
+val getObjTriangleTexcoordsView(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    return slot ? vectorView(slot->reader.triangleTexcoords()) : val::null();
+}
+
+val getObjTriangleNormalsView(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    return slot ? vectorView(slot->reader.triangleNormals()) : val::null();
+}
+
+val getObjTrianglePolygonsView(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    return slot ? vectorView(slot->reader.trianglePolygons()) : val::null();
+}
+
+val getObjVertexRemapView(int handle) {
+    ObjReaderSlot* slot = g_objReaders.get(handle);
+    return slot ? vectorView(slot->reader.vertexRemap()) : val::null();
+}
+
+// 缝线红点聚类（SeamExtractor的原生路径）
+
+// positions为Float64Array [x,y,z,...]（红点坐标，按SeamExtractor.redVertices顺序）
+// 返回 { offsets: Int32Array, members: Int32Array }，簇i为 members[offsets[i] .. offsets[i+1])
+val clusterSeamPoints(val positions, double eps) {
+    int count = positions["length"].as<int>() / 3;
+    std::vector<double> points(count * 3);
+    val(typed_memory_view(points.size(), points.data())).call<void>("set", positions);
+    
+    std::vector<int> offsets, members;
+    bff::clusterByDistance(points.data(), count, eps, offsets, members);
+    
+    val result = val::object();
+    result.set("offsets", val(typed_memory_view(offsets.size(), offsets.data())).call<val>("slice"));
+    result.set("members", val(typed_memory_view(members.size(), members.data())).call<val>("slice"));
+    return result;
+}
+
+// 最近邻路径：返回点编号的访问顺序（Int32Array）
+val orderSeamPath(val positions) {
+    int count = positions["length"].as<int>() / 3;
+    std::vector<double> points(count * 3);
+    val(typed_memory_view(points.size(), points.data())).call<void>("set", positions);
+    
+    std::vector<int> order = bff::orderByNearestNeighbor(points.data(), count);
+    return val(typed_memory_view(order.size(), order.data())).call<val>("slice");
+}
+
+// ---------------------------------------------------------------------------
+// 拓扑修复（独立于展开器）：JS端网格的焊接和沿缝线切开（MeshScissor的原生路径）
+// ---------------------------------------------------------------------------
+
+// positions为Float64Array [x,y,z,...]；返回 { remap: 原顶点 -> 新顶点, source: 新顶点 -> 保留的原顶点 }
+val weldVertices(val positions, double tolerance) {
+    int count = positions["length"].as<int>() / 3;
+    std::vector<double> points(count * 3);
+    val(typed_memory_view(points.size(), points.data())).call<void>("set", positions);
+    std::vector<bff::Vec3> vertices(count);
+    for (int v = 0; v < count; v++) vertices[v] = bff::Vec3(points[v * 3], points[v * 3 + 1], points[v * 3 + 2]);
+    
+    std::vector<int> remap(count), source;
+    if (tolerance > 0) {
+        bff::weldVertices(vertices.data(), count, tolerance, remap.data(), source);
+    } else {
+        source.resize(count);
+        for (int v = 0; v < count; v++) remap[v] = source[v] = v;
+    }
+    val result = val::object();
+    result.set("remap", val(typed_memory_view(remap.size(), remap.data())).call<val>("slice"));
+    result.set("source", val(typed_memory_view(source.size(), source.data())).call<val>("slice"));
+    return result;
+}
+
+// faces为Int32Array [a,b,c,...]，seamPairs为Int32Array [a0,b0, ...]；规则同MeshScissor.cutAlongEdges（cutAlongSeams）
+// 返回 { faces: 切开后的面, vertexSource: 新顶点 -> 原顶点（前numVertices个为恒等） }，索引越界时返回null
+val cutMeshAlongEdges(val faces, int numVertices, val seamPairs) {
+    int numFaces = faces["length"].as<int>() / 3;
+    std::vector<int> triangles(numFaces * 3);
+    val(typed_memory_view(triangles.size(), triangles.data())).call<void>("set", faces);
+    for (int idx : triangles) {
+        if (idx < 0 || idx >= numVertices) return val::null();
+    }
+    std::vector<int> pairs(seamPairs["length"].as<int>() / 2 * 2);
+    val(typed_memory_view(pairs.size(), pairs.data())).call<void>("set", seamPairs);
+    std::unordered_set<uint64_t> seams;
+    seams.reserve(pairs.size() / 2);
+    auto key = [](int a, int b) {
+        if (a > b) std::swap(a, b);
+        return (uint64_t(uint32_t(a)) << 32) | uint32_t(b);
+    };
+    for (size_t i = 0; i < pairs.size(); i += 2) seams.insert(key(pairs[i], pairs[i + 1]));
     
-    // 复制面数据
-    std::vector<int> faceData(numFaces * 3);
+    int numHE = numFaces * 3;
+    std::vector<int> corner(numHE), source;
+    std::vector<uint8_t> cut(numHE, 0), cutVertex(numVertices, 0);
+    for (int h = 0; h < numHE; h++) {
+        cut[h] = seams.count(key(triangles[h], triangles[h - h % 3 + (h + 1) % 3])) > 0;
+    }
+    for (int v : pairs) {
+        if (v >= 0 && v < numVertices) cutVertex[v] = 1;
+    }
+    bff::cutAlongSeams(triangles.data(), numFaces, numVertices, cut.data(), cutVertex.data(),
+                       corner.data(), source);
+    
+    val result = val::object();
+    result.set("faces", val(typed_memory_view(corner.size(), corner.data())).call<val>("slice"));
+    result.set("vertexSource", val(typed_memory_view(source.size(), source.data())).call<val>("slice"));
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// 排料：展开器结果直接排列（packIslands），或排列任意片段点集（packUVIslands）
+// ---------------------------------------------------------------------------
+
+// options字段：stripWidth / spacing / allowRotation / alignToBounds，缺省字段使用默认值
+static bff::PackOptions packOptionsFromJS(val options) {
+    bff::PackOptions opts;
+    if (options.isUndefined() || options.isNull()) return opts;
+    if (!options["stripWidth"].isUndefined()) opts.stripWidth = options["stripWidth"].as<double>();
+    if (!options["spacing"].isUndefined()) opts.spacing = options["spacing"].as<double>();
+    if (!options["allowRotation"].isUndefined()) opts.allowRotation = options["allowRotation"].as<bool>();
+    if (!options["alignToBounds"].isUndefined()) opts.alignToBounds = options["alignToBounds"].as<bool>();
+    return opts;
+}
+
+// { transforms: Float64Array [scale, rotation, tx, ty] * 片段数, width, height, utilization }
+static val packResultToJS(const bff::PackResult& packed) {
+    std::vector<double> transforms;
+    transforms.reserve(packed.transforms.size() * 4);
+    for (const bff::IslandTransform& t : packed.transforms) {
+        transforms.insert(transforms.end(), {t.scale, t.rotation, t.tx, t.ty});
+    }
+    val result = val::object();
+    result.set("transforms", val(typed_memory_view(transforms.size(), transforms.data())).call<val>("slice"));
+    result.set("width", packed.width);
+    result.set("height", packed.height);
+    result.set("utilization", packed.utilization);
+    return result;
+}
+
+// 排列展开器的各片段（按3D尺寸缩放），flatten成功后调用；失败时返回null
+val packIslands(int handle, val options) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener || !flattener->packIslands(packOptionsFromJS(options))) return val::null();
+    return packResultToJS(flattener->getPackResult());
+}
+
+// 排料后的UV零拷贝视图，有效期同getUVCoordsView
+val getPackedUVsView(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    
+    const std::vector<bff::Real>& uvs = flattener->getPackedUVCoords();
+    return val(typed_memory_view(uvs.size(), uvs.data()));
+}
+
+// points为Float64Array [u,v,...]，片段i的点为 points[2*offsets[i] .. 2*offsets[i+1])
+// scales为每个片段的预缩放（Float64Array，可为null）
+val packUVIslands(val points, val offsets, val scales, val options) {
+    int numPoints = points["length"].as<int>() / 2;
+    int numIslands = offsets["length"].as<int>() - 1;
+    if (numIslands <= 0) return packResultToJS(bff::PackResult());
+    
+    std::vector<double> pts(numPoints * 2);
+    std::vector<int> offs(numIslands + 1);
+    val(typed_memory_view(pts.size(), pts.data())).call<void>("set", points);
+    val(typed_memory_view(offs.size(), offs.data())).call<void>("set", offsets);
+    for (int i = 0; i < numIslands; i++) {
+        if (offs[i] < 0 || offs[i] > offs[i + 1] || offs[i + 1] > numPoints) return val::null();
+    }
+    
+    std::vector<double> scl;
+    if (!scales.isUndefined() && !scales.isNull()) {
+        if (scales["length"].as<int>() != numIslands) return val::null();
+        scl.resize(numIslands);
+        val(typed_memory_view(scl.size(), scl.data())).call<void>("set", scales);
+    }
+    return packResultToJS(bff::packIslands(pts.data(), offs.data(), numIslands,
+                                           scl.empty() ? nullptr : scl.data(), packOptionsFromJS(options)));
+}
+
+// ---------------------------------------------------------------------------
+// 畸变指标：展开器的当前结果（getDistortion），或任意展开结果（computeDistortionMetrics），
+// 用于UV热图，只在显示时计算
+// ---------------------------------------------------------------------------
+
+// { conformal, area: Float32Array [F], flipped: Uint8Array [F], boundaryError: Float32Array [片段数], 汇总 }
+static val distortionToJS(const bff::DistortionMetrics& m) {
+    val result = val::object();
+    result.set("conformal", val(typed_memory_view(m.conformal.size(), m.conformal.data())).call<val>("slice"));
+    result.set("area", val(typed_memory_view(m.area.size(), m.area.data())).call<val>("slice"));
+    result.set("flipped", val(typed_memory_view(m.flipped.size(), m.flipped.data())).call<val>("slice"));
+    result.set("boundaryError", val(typed_memory_view(m.boundaryError.size(), m.boundaryError.data())).call<val>("slice"));
+    result.set("flippedFaces", m.flippedFaces);
+    result.set("meanConformal", m.meanConformal);
+    result.set("maxConformal", m.maxConformal);
+    result.set("meanAreaError", m.meanAreaError);
+    result.set("maxBoundaryError", m.maxBoundaryError);
+    return result;
+}
+
+// 没有展开结果时返回null
+val getDistortion(int handle) {
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!flattener) return val::null();
+    const bff::DistortionMetrics& metrics = flattener->getDistortion();
+    return metrics.empty() ? val::null() : distortionToJS(metrics);
+}
+
+// positions: Float64Array [x,y,z,...]，faces: Int32Array [a,b,c,...]，uvs: Float64Array [u,v,...]，
+// uvFaces: Int32Array 每个面三个角的UV索引，facePieces: Int32Array 面 -> 片段（可为null）
+// 索引越界时返回null
+val computeDistortionMetrics(val positions, val faces, val uvs, val uvFaces, val facePieces) {
+    int numVertices = positions["length"].as<int>() / 3;
+    int numFaces = faces["length"].as<int>() / 3;
+    int numUVs = uvs["length"].as<int>() / 2;
+    if (numFaces == 0 || uvFaces["length"].as<int>() != numFaces * 3) return val::null();
+    
+    std::vector<double> points(numVertices * 3), uvIn(numUVs * 2);
+    std::vector<int> tris(numFaces * 3), uvTris(numFaces * 3), pieces;
+    val(typed_memory_view(points.size(), points.data())).call<void>("set", positions);
+    val(typed_memory_view(tris.size(), tris.data())).call<void>("set", faces);
+    val(typed_memory_view(uvIn.size(), uvIn.data())).call<void>("set", uvs);
+    val(typed_memory_view(uvTris.size(), uvTris.data())).call<void>("set", uvFaces);
     for (int i = 0; i < numFaces * 3; i++) {
-        faceData[i] = faces[i].as<int>();
+        if (tris[i] < 0 || tris[i] >= numVertices || uvTris[i] < 0 || uvTris[i] >= numUVs) return val::null();
+    }
+    int numPieces = 1;
+    if (!facePieces.isUndefined() && !facePieces.isNull()) {
+        if (facePieces["length"].as<int>() != numFaces) return val::null();
+        pieces.resize(numFaces);
+        val(typed_memory_view(pieces.size(), pieces.data())).call<void>("set", facePieces);
+        for (int p : pieces) {
+            if (p < 0) return val::null();
+            numPieces = std::max(numPieces, p + 1);
+        }
+    }
+    
+    std::vector<bff::Vec3> vertices(numVertices);
+    for (int v = 0; v < numVertices; v++) {
+        vertices[v] = bff::Vec3(points[v * 3], points[v * 3 + 1], points[v * 3 + 2]);
     }
+    std::vector<bff::Real> uvReal(uvIn.begin(), uvIn.end());
+    bff::FaceGeometry geometry;
+    bff::computeFaceGeometry(vertices.data(), tris.data(), numFaces, geometry);
     
-    g_flattener->setMesh(verts.data(), numVertices, faceData.data(), numFaces);
+    bff::DistortionInput input;
+    input.numFaces = numFaces;
+    input.cotan = geometry.cotan.data();
+    input.edgeLength = geometry.edgeLength.data();
+    input.area = geometry.area.data();
+    input.uvFaces = uvTris.data();
+    input.uvs = uvReal.data();
+    input.numUVs = numUVs;
+    input.facePiece = pieces.empty() ? nullptr : pieces.data();
+    input.numPieces = numPieces;
+    bff::DistortionMetrics metrics;
+    bff::computeDistortion(input, metrics);
+    return distortionToJS(metrics);
 }
 
-// 添加缝线边
-void addSeamEdge(int v1, int v2) {
-    if (g_flattener) {
-        g_flattener->addSeamEdge(v1, v2);
+// ---------------------------------------------------------------------------
+// 纸样导出（SVG / DXF）：createPatternExport取得导出句柄，beginPatternExport* 复制UV和面后，
+// 反复调用nextPatternExportChunk逐块取得输出并写入文件或WritableStream，
+// 整个文件不在WASM堆或JS中拼成一个字符串；各句柄互不影响，可同时进行多个导出
+// ---------------------------------------------------------------------------
+
+struct ExportJob {
+    bff::PatternExporter exporter;
+    std::vector<bff::Real> uvs;
+    std::vector<int> faces;
+    std::vector<int> pieces;
+    std::string chunk;
+};
+
+static HandleTable<ExportJob> g_exportJobs;
+
+int createPatternExport() {
+    return g_exportJobs.create();
+}
+
+// 释放导出句柄及其副本（未读完的输出一并丢弃）
+void destroyPatternExport(int job) {
+    g_exportJobs.destroy(job);
+}
+
+// options字段：format（'svg' / 'dxf'）/ interior / scale / padding（<0自动）/ chunkSize
+static bff::ExportOptions exportOptionsFromJS(val options) {
+    bff::ExportOptions opts;
+    if (options.isUndefined() || options.isNull()) return opts;
+    if (!options["format"].isUndefined() && options["format"].as<std::string>() == "dxf")
+        opts.format = bff::ExportFormat::DXF;
+    if (!options["interior"].isUndefined()) opts.interiorEdges = options["interior"].as<bool>();
+    if (!options["scale"].isUndefined()) opts.scale = options["scale"].as<double>();
+    if (!options["padding"].isUndefined()) opts.padding = options["padding"].as<double>();
+    if (!options["chunkSize"].isUndefined()) opts.chunkSize = options["chunkSize"].as<int>();
+    return opts;
+}
+
+static int beginExport(ExportJob& job, int numPieces, val options) {
+    bff::ExportSource source;
+    source.uvs = job.uvs.data();
+    source.numUVs = job.uvs.size() / 2;
+    source.uvFaces = job.faces.data();
+    source.numFaces = job.faces.size() / 3;
+    source.facePiece = job.pieces.empty() ? nullptr : job.pieces.data();
+    source.numPieces = numPieces;
+    job.exporter.begin(source, exportOptionsFromJS(options));
+    return job.exporter.loopCount();
+}
+
+// 导出展开器的当前结果（已排料时用排料后的UV）；返回边界环数，句柄无效或没有结果时返回-1
+int beginPatternExport(int jobHandle, int handle, val options) {
+    ExportJob* job = g_exportJobs.get(jobHandle);
+    bff::BFFFlattener* flattener = getFlattener(handle);
+    if (!job || !flattener || flattener->getUVCount() == 0) return -1;
+    job->exporter = bff::PatternExporter();   // 进行中的导出引用的缓冲区即将被覆盖
+    const bff::FlattenResult& result = flattener->getResult();
+    const std::vector<bff::Real>& packed = flattener->getPackedUVCoords();
+    job->uvs = packed.empty() ? flattener->getUVCoords() : packed;
+    job->faces = result.uvFaces;
+    job->pieces = result.facePiece;
+    return beginExport(*job, std::max<int>(result.pieces.size(), 1), options);
+}
+
+// uvs: Float64Array [u,v,...]，uvFaces: Int32Array 每个面三个角的UV索引，facePieces: Int32Array（可为null）
+// 返回边界环数，句柄无效或索引越界时返回-1
+int beginPatternExportFrom(int jobHandle, val uvs, val uvFaces, val facePieces, val options) {
+    ExportJob* job = g_exportJobs.get(jobHandle);
+    if (!job) return -1;
+    job->exporter = bff::PatternExporter();
+    int numUVs = uvs["length"].as<int>() / 2;
+    int numFaces = uvFaces["length"].as<int>() / 3;
+    std::vector<double> uvIn(numUVs * 2);
+    val(typed_memory_view(uvIn.size(), uvIn.data())).call<void>("set", uvs);
+    job->uvs.assign(uvIn.begin(), uvIn.end());
+    job->faces.resize(numFaces * 3);
+    val(typed_memory_view(job->faces.size(), job->faces.data())).call<void>("set", uvFaces);
+    for (int i : job->faces) {
+        if (i < 0 || i >= numUVs) return -1;
+    }
+    int numPieces = 1;
+    job->pieces.clear();
+    if (!facePieces.isUndefined() && !facePieces.isNull()) {
+        if (facePieces["length"].as<int>() != numFaces) return -1;
+        job->pieces.resize(numFaces);
+        val(typed_memory_view(job->pieces.size(), job->pieces.data())).call<void>("set", facePieces);
+        for (int p : job->pieces) {
+            if (p < 0) return -1;
+            numPieces = std::max(numPieces, p + 1);
+        }
     }
+    return beginExport(*job, numPieces, options);
 }
 
-// 清除缝线
-void clearSeams() {
-    if (g_flattener) {
-        g_flattener->clearSeams();
+// 下一块输出的Uint8Array视图（UTF-8），下一次调用前有效；全部输出后（或句柄无效时）返回null，
+// 副本在destroyPatternExport时释放
+val nextPatternExportChunk(int jobHandle) {
+    ExportJob* job = g_exportJobs.get(jobHandle);
+    if (!job || !job->exporter.next(job->chunk)) return val::null();
+    return val(typed_memory_view(job->chunk.size(), reinterpret_cast<const uint8_t*>(job->chunk.data())));
+}
+
+// ---------------------------------------------------------------------------
+// 批量展开：一个输入容器装多个零件及其缝线（布局见batch_flatten.h），一次调用全部展开
+// 每个批次一个句柄（createBatchJob），输入、输出和错误信息各自保存，多个批次互不影响
+// ---------------------------------------------------------------------------
+
+struct BatchJob {
+    std::vector<uint8_t> input;
+    std::vector<uint8_t> output;
+    std::string error;
+};
+
+static HandleTable<BatchJob> g_batchJobs;
+
+int createBatchJob() {
+    return g_batchJobs.create();
+}
+
+void destroyBatchJob(int job) {
+    g_batchJobs.destroy(job);
+}
+
+// 零拷贝上传：返回输入容器的Uint8Array视图，写完后调用flattenBatch；有效期同getVertexUploadView
+val getBatchUploadView(int jobHandle, int size) {
+    BatchJob* job = g_batchJobs.get(jobHandle);
+    if (!job) return val::null();
+    job->input.resize(size);
+    return val(typed_memory_view(job->input.size(), job->input.data()));
+}
+
+// options字段：method（0 = 共形，1 = ARAP）/ iterations / arap（同setARAPOptions）/ ordering（同setMeshOrdering）
+// 返回输出容器的Uint8Array视图，下一次flattenBatch、destroyBatchJob或内存增长后失效；
+// 句柄无效或输入容器损坏时返回null
+val flattenBatch(int jobHandle, val options) {
+    BatchJob* job = g_batchJobs.get(jobHandle);
+    if (!job) return val::null();
+    bff::BatchOptions opts;
+    if (!options.isUndefined() && !options.isNull()) {
+        if (!options["method"].isUndefined() && options["method"].as<int>() == 1)
+            opts.method = bff::FlattenMethod::ARAP;
+        int iterations = options["iterations"].isUndefined() ? opts.arap.iterations : options["iterations"].as<int>();
+        opts.arap = arapOptionsFromJS(iterations, options["arap"]);
+        if (!options["ordering"].isUndefined()) {
+            int ordering = options["ordering"].as<int>();
+            opts.ordering = ordering == 1 ? bff::MeshOrdering::RCM :
+                            ordering == 2 ? bff::MeshOrdering::Morton : bff::MeshOrdering::Original;
+        }
     }
+    
+    bool ok = bff::flattenBatch(job->input.data(), job->input.size(), opts, job->output, job->error);
+    std::vector<uint8_t>().swap(job->input);
+    if (!ok) return val::null();
+    return val(typed_memory_view(job->output.size(), job->output.data()));
 }
 
-// 执行展开
-bool flatten() {
-    if (!g_flattener) return false;
-    return g_flattener->flatten();
+// 该批次上一次flattenBatch返回null的原因
+std::string getBatchError(int jobHandle) {
+    BatchJob* job = g_batchJobs.get(jobHandle);
+    if (!job) return "Invalid batch handle";
+    return job->error;
 }
 
-// 获取UV结果
-val getUVCoords() {
-    if (!g_flattener) {
-        return val::null();
+// ---------------------------------------------------------------------------
+// 泛洪分割：网格设置一次，每次编辑缝线后调用segmentFaces（增量更新）
+// ---------------------------------------------------------------------------
+
+int createSegmenter() {
+    return g_segmenters.create();
+}
+
+void destroySegmenter(int handle) {
+    g_segmenters.destroy(handle);
+}
+
+// faces为Int32Array [a,b,c,...]
+bool segmenterSetMesh(int handle, val faces, int numVertices) {
+    bff::FloodSegmenter* segmenter = g_segmenters.get(handle);
+    if (!segmenter) return false;
+    int numFaces = faces["length"].as<int>() / 3;
+    std::vector<int> triangles(numFaces * 3);
+    val(typed_memory_view(triangles.size(), triangles.data())).call<void>("set", faces);
+    return segmenter->setMesh(triangles.data(), numFaces, numVertices);
+}
+
+// seamPairs为Int32Array [a0,b0, ...]；redMask为每顶点一个字节的Uint8Array，可为null
+// options字段与FloodSegmenter.segmentWithSeams相同（minFaces, assignBoundaryFaces）
+// 返回 { labels, offsets, faces, dirty, islands, boundaryFaces, unassignedFaces, refloodedFaces, revotedFaces }，
+// labels为Int32Array 面 -> Patch（-1为丢弃），Patch p 的面为 faces[offsets[p] .. offsets[p+1])，
+// dirty[p]为0表示与上一次调用的同一Patch完全相同（同一网格上再次调用时只重算改动的区域）
+val segmentFaces(int handle, val seamPairs, val redMask, val options) {
+    bff::FloodSegmenter* segmenter = g_segmenters.get(handle);
+    if (!segmenter) return val::null();
+    
+    std::vector<int> pairs(seamPairs["length"].as<int>() / 2 * 2);
+    val(typed_memory_view(pairs.size(), pairs.data())).call<void>("set", seamPairs);
+    
+    std::vector<uint8_t> mask;
+    if (!redMask.isUndefined() && !redMask.isNull()) {
+        mask.resize(redMask["length"].as<int>());
+        val(typed_memory_view(mask.size(), mask.data())).call<void>("set", redMask);
+        // 长度不足时视为非红点
+        mask.resize(std::max<size_t>(mask.size(), segmenter->numVertices()), 0);
     }
     
-    const std::vector<double>& uvs = g_flattener->getUVCoords();
+    bff::SegmentOptions opts;
+    if (!options.isUndefined() && !options.isNull()) {
+        if (!options["minFaces"].isUndefined())
+            opts.minFaces = options["minFaces"].as<int>();
+        if (!options["assignBoundaryFaces"].isUndefined())
+            opts.assignBoundaryFaces = options["assignBoundaryFaces"].as<bool>();
+    }
+    segmenter->segment(pairs.data(), pairs.size() / 2, mask.empty() ? nullptr : mask.data(), opts);
     
-    // 创建Float64Array返回
-    val result = val::global("Float64Array").new_(uvs.size());
-    for (size_t i = 0; i < uvs.size(); i++) {
-        result.set(i, uvs[i]);
+    val result = val::object();
+    result.set("labels", vectorView(segmenter->labels()).call<val>("slice"));
+    result.set("offsets", vectorView(segmenter->patchOffsets()).call<val>("slice"));
+    result.set("faces", vectorView(segmenter->patchFaces()).call<val>("slice"));
+    result.set("dirty", vectorView(segmenter->patchDirty()).call<val>("slice"));
+    result.set("islands", segmenter->numIslands());
+    result.set("boundaryFaces", segmenter->numBoundaryFaces());
+    result.set("unassignedFaces", segmenter->numUnassignedFaces());
+    result.set("refloodedFaces", segmenter->numRefloodedFaces());
+    result.set("revotedFaces", segmenter->numRevotedFaces());
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// 剖析数据（make profile 构建中有效，其他构建返回 enabled: false 的空结果）
+// ---------------------------------------------------------------------------
+
+// 各阶段的调用次数和耗时、计数器、内存高水位，全模块共用（不分句柄）
+val getProfile() {
+    bff::ProfileData data = bff::profileSnapshot();
+    val stages = val::array();
+    for (const bff::ProfileStage& s : data.stages) {
+        val stage = val::object();
+        stage.set("name", s.name);
+        stage.set("calls", double(s.calls));
+        stage.set("totalMs", s.totalMs);
+        stage.set("maxMs", s.maxMs);
+        stages.call<void>("push", stage);
     }
+    val counters = val::object();
+    for (const bff::ProfileCounter& c : data.counters) counters.set(c.name, double(c.value));
+    val memory = val::object();
+    for (const bff::ProfileMemory& m : data.memory) memory.set(m.name, double(m.peakBytes));
     
+    val result = val::object();
+    result.set("enabled", data.enabled);
+    result.set("stages", stages);
+    result.set("counters", counters);
+    result.set("peakBytes", memory);
+    result.set("events", double(data.events));
+    result.set("droppedEvents", double(data.droppedEvents));
     return result;
 }
 
-// 获取UV数量
-int getUVCount() {
-    if (!g_flattener) return 0;
-    return g_flattener->getUVCount();
+// Chrome trace-event JSON字符串，可保存为文件后在 chrome://tracing 或 Perfetto 中打开
+std::string getProfileTrace() {
+    return bff::profileTraceJson();
 }
 
-// 获取错误信息
-std::string getError() {
-    if (!g_flattener) return "Not initialized";
-    return g_flattener->getError();
+void resetProfile() {
+    bff::profileReset();
 }
 
 // 导出到JavaScript
 EMSCRIPTEN_BINDINGS(bff_module) {
-    function("init", &init);
-    function("cleanup", &cleanup);
+    function("createFlattener", &createFlattener);
+    function("destroyFlattener", &destroyFlattener);
     function("setMesh", &setMesh);
+    function("getVertexUploadView", &getVertexUploadView);
+    function("getFaceUploadView", &getFaceUploadView);
+    function("commitMesh", &commitMesh);
+    function("saveCache", &saveCache);
+    function("getCacheUploadView", &getCacheUploadView);
+    function("commitCache", &commitCache);
     function("addSeamEdge", &addSeamEdge);
+    function("addSeamPath", &addSeamPath);
+    function("setSeams", &setSeams);
     function("clearSeams", &clearSeams);
+    function("setPin", &setPin);
+    function("removePin", &removePin);
+    function("clearPins", &clearPins);
+    function("setFlattenMethod", &setFlattenMethod);
+    function("setMeshOrdering", &setMeshOrdering);
+    function("setRepairOptions", &setRepairOptions);
+    function("setARAPOptions", &setARAPOptions);
+    function("setARAPInitialUV", &setARAPInitialUV);
+    function("setSolverOptions", &setSolverOptions);
     function("flatten", &flatten);
+    function("beginFlatten", &beginFlatten);
+    function("flattenStep", &flattenStep);
+    function("finishFlatten", &finishFlatten);
+    function("flattenPreview", &flattenPreview);
+    function("getIslandCount", &getIslandCount);
     function("getUVCoords", &getUVCoords);
+    function("getUVCoordsView", &getUVCoordsView);
+    function("getUVCoordsF32View", &getUVCoordsF32View);
     function("getUVCount", &getUVCount);
+    function("getNonManifoldEdges", &getNonManifoldEdges);
+    function("getRepairResult", &getRepairResult);
+    function("getPieceCount", &getPieceCount);
+    function("getFacePieces", &getFacePieces);
+    function("getUVFaces", &getUVFaces);
+    function("getSplitVertexSource", &getSplitVertexSource);
+    function("getFlattenStats", &getFlattenStats);
     function("getError", &getError);
+    function("createPhysicsSolver", &createPhysicsSolver);
+    function("destroyPhysicsSolver", &destroyPhysicsSolver);
+    function("physicsSetup", &physicsSetup);
+    function("physicsSetUVs", &physicsSetUVs);
+    function("physicsStep", &physicsStep);
+    function("getPhysicsUVsView", &getPhysicsUVsView);
+    function("getPhysicsStats", &getPhysicsStats);
+    function("createObjReader", &createObjReader);
+    function("destroyObjReader", &destroyObjReader);
+    function("getObjChunkView", &getObjChunkView);
+    function("objReaderFeed", &objReaderFeed);
+    function("objReaderFinish", &objReaderFinish);
+    function("objReaderLoadInto", &objReaderLoadInto);
+    function("getObjInfo", &getObjInfo);
+    function("getObjError", &getObjError);
+    function("getObjPositionsView", &getObjPositionsView);
+    function("getObjColorsView", &getObjColorsView);
+    function("getObjTexcoordsView", &getObjTexcoordsView);
+    function("getObjNormalsView", &getObjNormalsView);
+    function("getObjTrianglesView", &getObjTrianglesView);
+    function("getObjTriangleTexcoordsView", &getObjTriangleTexcoordsView);
+    function("getObjTriangleNormalsView", &getObjTriangleNormalsView);
+    function("getObjTrianglePolygonsView", &getObjTrianglePolygonsView);
+    function("getObjVertexRemapView", &getObjVertexRemapView);
+    function("clusterSeamPoints", &clusterSeamPoints);
+    function("orderSeamPath", &orderSeamPath);
+    function("weldVertices", &weldVertices);
+    function("cutMeshAlongEdges", &cutMeshAlongEdges);
+    function("packIslands", &packIslands);
+    function("getPackedUVsView", &getPackedUVsView);
+    function("packUVIslands", &packUVIslands);
+    function("getDistortion", &getDistortion);
+    function("computeDistortionMetrics", &computeDistortionMetrics);
+    function("createPatternExport", &createPatternExport);
+    function("destroyPatternExport", &destroyPatternExport);
+    function("beginPatternExport", &beginPatternExport);
+    function("beginPatternExportFrom", &beginPatternExportFrom);
+    function("nextPatternExportChunk", &nextPatternExportChunk);
+    function("createBatchJob", &createBatchJob);
+    function("destroyBatchJob", &destroyBatchJob);
+    function("getBatchUploadView", &getBatchUploadView);
+    function("flattenBatch", &flattenBatch);
+    function("getBatchError", &getBatchError);
+    function("createSegmenter", &createSegmenter);
+    function("destroySegmenter", &destroySegmenter);
+    function("segmenterSetMesh", &segmenterSetMesh);
+    function("segmentFaces", &segmentFaces);
+    function("getProfile", &getProfile);
+    function("getProfileTrace", &getProfileTrace);
+    function("resetProfile", &resetProfile);
 }
 
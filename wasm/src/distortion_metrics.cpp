@@ -0,0 +1,226 @@
+/**
+ * 展开质量指标实现
+ */
+
+#include "distortion_metrics.h"
+#include "task_scheduler.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+namespace bff {
+
+namespace {
+
+// 面积和能量在double中计算，与网格精度无关
+struct FaceCorners {
+    double u[3], v[3];
+    double cot[3];
+    double area;
+};
+
+// e = (σ1² + σ2²) / 2，d = σ1σ2，σ1 / σ2 = σ1² / d = (e + sqrt(e² - d²)) / d
+inline float conformalRatio(double e, double d) {
+    if (d <= 1e-300) return kDegenerateDistortion;
+    double r = (e + std::sqrt(std::max(e * e - d * d, 0.0))) / d;
+    return float(std::min(std::max(r, 1.0), double(kDegenerateDistortion)));
+}
+
+// 返回UV有向面积的2倍
+inline double faceDistortionScalar(const FaceCorners& c, float& conformal) {
+    double du1 = c.u[1] - c.u[0], dv1 = c.v[1] - c.v[0];
+    double du2 = c.u[2] - c.u[0], dv2 = c.v[2] - c.v[0];
+    double uvArea2 = du1 * dv2 - du2 * dv1;
+    if (c.area <= 1e-12) {
+        conformal = 1;
+        return uvArea2;
+    }
+
+    // 角k对边 (k+1, k+2) 的UV长度平方
+    double dirichlet = 0;
+    for (int k = 0; k < 3; k++) {
+        int a = (k + 1) % 3, b = (k + 2) % 3;
+        double eu = c.u[b] - c.u[a], ev = c.v[b] - c.v[a];
+        dirichlet += c.cot[k] * (eu * eu + ev * ev);
+    }
+    conformal = conformalRatio(dirichlet / (4 * c.area), 0.5 * std::fabs(uvArea2) / c.area);
+    return uvArea2;
+}
+
+#ifdef __wasm_simd128__
+// 两个面一组（f64x2），UV和几何量按通道收集，只有最后的比值逐通道计算
+inline void faceDistortionSimd(const FaceCorners& c0, const FaceCorners& c1,
+                               double uvArea2[2], double e[2], double d[2]) {
+    v128_t u[3], v[3];
+    for (int k = 0; k < 3; k++) {
+        u[k] = wasm_f64x2_make(c0.u[k], c1.u[k]);
+        v[k] = wasm_f64x2_make(c0.v[k], c1.v[k]);
+    }
+    v128_t du1 = wasm_f64x2_sub(u[1], u[0]), dv1 = wasm_f64x2_sub(v[1], v[0]);
+    v128_t du2 = wasm_f64x2_sub(u[2], u[0]), dv2 = wasm_f64x2_sub(v[2], v[0]);
+    v128_t area2 = wasm_f64x2_sub(wasm_f64x2_mul(du1, dv2), wasm_f64x2_mul(du2, dv1));
+
+    v128_t dirichlet = wasm_f64x2_splat(0.0);
+    for (int k = 0; k < 3; k++) {
+        int a = (k + 1) % 3, b = (k + 2) % 3;
+        v128_t eu = wasm_f64x2_sub(u[b], u[a]), ev = wasm_f64x2_sub(v[b], v[a]);
+        v128_t len2 = wasm_f64x2_add(wasm_f64x2_mul(eu, eu), wasm_f64x2_mul(ev, ev));
+        dirichlet = wasm_f64x2_add(dirichlet, wasm_f64x2_mul(wasm_f64x2_make(c0.cot[k], c1.cot[k]), len2));
+    }
+
+    // 3D退化的面在调用方单独处理，这里只避免除零
+    v128_t area = wasm_f64x2_max(wasm_f64x2_make(c0.area, c1.area), wasm_f64x2_splat(1e-300));
+    v128_t ev = wasm_f64x2_div(dirichlet, wasm_f64x2_mul(wasm_f64x2_splat(4.0), area));
+    v128_t dv = wasm_f64x2_div(wasm_f64x2_mul(wasm_f64x2_splat(0.5), wasm_f64x2_abs(area2)), area);
+    wasm_v128_store(uvArea2, area2);
+    wasm_v128_store(e, ev);
+    wasm_v128_store(d, dv);
+}
+#endif
+
+} // namespace
+
+void computeDistortion(const DistortionInput& in, DistortionMetrics& out) {
+    BFF_PROFILE_SCOPE("distortion");
+    int numFaces = in.numFaces;
+    int numPieces = std::max(in.numPieces, 1);
+    auto outFace = [&](int g) { return in.faceOrder ? in.faceOrder[g] : g; };
+    auto pieceOf = [&](int f) { return in.facePiece ? in.facePiece[f] : 0; };
+
+    out = DistortionMetrics();
+    out.conformal.resize(numFaces);
+    out.area.resize(numFaces);
+    out.flipped.resize(numFaces);
+    out.boundaryError.assign(numPieces, 0.0f);
+
+    // UV有向边的邻接表（CSR），边 a -> b 没有反向边 b -> a 时为边界边
+    std::vector<int> edgeStart(in.numUVs + 1, 0), edgeTarget(numFaces * 3);
+    for (int h = 0; h < numFaces * 3; h++) edgeStart[in.uvFaces[h] + 1]++;
+    for (int i = 0; i < in.numUVs; i++) edgeStart[i + 1] += edgeStart[i];
+    {
+        std::vector<int> fill(edgeStart.begin(), edgeStart.end() - 1);
+        for (int h = 0; h < numFaces * 3; h++) {
+            edgeTarget[fill[in.uvFaces[h]]++] = in.uvFaces[h - h % 3 + (h + 1) % 3];
+        }
+    }
+    auto hasEdge = [&](int a, int b) {
+        for (int i = edgeStart[a]; i < edgeStart[a + 1]; i++) {
+            if (edgeTarget[i] == b) return true;
+        }
+        return false;
+    };
+
+    // 第一遍（逐面独立）：UV有向面积、共形畸变、边界边的UV长度和3D长度
+    std::vector<double> uvArea2(numFaces), boundaryUV(numFaces), boundary3D(numFaces);
+    parallelFor(numFaces, 4096, [&](int begin, int end) {
+        auto gather = [&](int g, FaceCorners& c) {
+            const int* tri = &in.uvFaces[outFace(g) * 3];
+            for (int k = 0; k < 3; k++) {
+                c.u[k] = in.uvs[tri[k] * 2];
+                c.v[k] = in.uvs[tri[k] * 2 + 1];
+                c.cot[k] = in.cotan[g * 3 + k];
+            }
+            c.area = in.area[g];
+        };
+
+        int g = begin;
+#ifdef __wasm_simd128__
+        for (; g + 2 <= end; g += 2) {
+            FaceCorners c0, c1;
+            gather(g, c0);
+            gather(g + 1, c1);
+            double a2[2], e[2], d[2];
+            faceDistortionSimd(c0, c1, a2, e, d);
+            for (int lane = 0; lane < 2; lane++) {
+                int f = outFace(g + lane);
+                uvArea2[f] = a2[lane];
+                out.conformal[f] = in.area[g + lane] > 1e-12 ? conformalRatio(e[lane], d[lane]) : 1.0f;
+            }
+        }
+#endif
+        for (; g < end; g++) {
+            FaceCorners c;
+            gather(g, c);
+            int f = outFace(g);
+            uvArea2[f] = faceDistortionScalar(c, out.conformal[f]);
+        }
+
+        for (g = begin; g < end; g++) {
+            int f = outFace(g);
+            const int* tri = &in.uvFaces[f * 3];
+            double lengthUV = 0, length3D = 0;
+            for (int k = 0; k < 3; k++) {
+                int a = tri[k], b = tri[(k + 1) % 3];
+                if (hasEdge(b, a)) continue;
+                double du = in.uvs[b * 2] - in.uvs[a * 2], dv = in.uvs[b * 2 + 1] - in.uvs[a * 2 + 1];
+                lengthUV += std::sqrt(du * du + dv * dv);
+                length3D += in.edgeLength[g * 3 + (k + 2) % 3];   // 边 (k, k+1) 是角k+2的对边
+            }
+            boundaryUV[f] = lengthUV;
+            boundary3D[f] = length3D;
+        }
+    });
+
+    // 各片段的总体朝向和缩放
+    std::vector<double> pieceArea3D(numPieces, 0), pieceAreaUV(numPieces, 0), pieceSigned(numPieces, 0);
+    std::vector<double> pieceBoundaryUV(numPieces, 0), pieceBoundary3D(numPieces, 0);
+    for (int g = 0; g < numFaces; g++) {
+        int f = outFace(g);
+        int p = pieceOf(f);
+        pieceArea3D[p] += in.area[g];
+        pieceAreaUV[p] += 0.5 * std::fabs(uvArea2[f]);
+        pieceSigned[p] += uvArea2[f];
+        pieceBoundaryUV[p] += boundaryUV[f];
+        pieceBoundary3D[p] += boundary3D[f];
+    }
+    std::vector<double> pieceScale2(numPieces, 1);
+    for (int p = 0; p < numPieces; p++) {
+        if (pieceAreaUV[p] > 0) pieceScale2[p] = pieceArea3D[p] / pieceAreaUV[p];
+        if (pieceBoundary3D[p] > 0) {
+            out.boundaryError[p] = float((std::sqrt(pieceScale2[p]) * pieceBoundaryUV[p] - pieceBoundary3D[p]) /
+                                         pieceBoundary3D[p]);
+        }
+        out.maxBoundaryError = std::max(out.maxBoundaryError, double(std::fabs(out.boundaryError[p])));
+    }
+
+    // 第二遍：面积畸变和翻转
+    parallelFor(numFaces, 4096, [&](int begin, int end) {
+        for (int g = begin; g < end; g++) {
+            int f = outFace(g);
+            int p = pieceOf(f);
+            double a3 = in.area[g];
+            double auv = 0.5 * std::fabs(uvArea2[f]) * pieceScale2[p];
+            if (a3 <= 1e-12) {
+                out.area[f] = 0;
+                out.flipped[f] = 0;
+            } else if (auv <= 1e-12 * a3) {
+                out.area[f] = -std::log2(double(kDegenerateDistortion));
+                out.flipped[f] = 1;
+            } else {
+                out.area[f] = float(std::log2(auv / a3));
+                out.flipped[f] = (uvArea2[f] < 0) != (pieceSigned[p] < 0);
+            }
+        }
+    });
+
+    double totalArea = 0;
+    for (int g = 0; g < numFaces; g++) {
+        int f = outFace(g);
+        double w = in.area[g];
+        totalArea += w;
+        out.meanConformal += w * out.conformal[f];
+        out.meanAreaError += w * std::fabs(out.area[f]);
+        out.maxConformal = std::max(out.maxConformal, double(out.conformal[f]));
+        out.flippedFaces += out.flipped[f];
+    }
+    if (totalArea > 0) {
+        out.meanConformal /= totalArea;
+        out.meanAreaError /= totalArea;
+    }
+    BFF_PROFILE_COUNT("flippedFaces", out.flippedFaces);
+}
+
+} // namespace bff
@@ -0,0 +1,60 @@
+/**
+ * 展开质量的逐面和逐片段指标，供UV热图显示
+ * 每个面的UV映射是线性的，奇异值 σ1 >= σ2 由余切公式直接得到：
+ *   (σ1² + σ2²) / 2 = Σ cot_k |ũ_k|² / (4A)，σ1σ2 = A_uv / A
+ * 其中 ũ_k 为角k对边的UV向量，A为3D面积，因此只需预计算的余切和面积（geometry_kernels）与UV
+ * 各片段先按 sqrt(3D面积 / UV面积) 缩放回网格单位（同 BFFFlattener::packIslands）再比较面积和边界长度
+ * 编译时启用 -msimd128 则两个面一组向量化计算；多线程构建中按块并行
+ */
+
+#ifndef BFF_DISTORTION_METRICS_H
+#define BFF_DISTORTION_METRICS_H
+
+#include <cstdint>
+#include <vector>
+#include "scalar_types.h"
+
+namespace bff {
+
+// UV退化（面积为0）的面的共形畸变取此值
+constexpr float kDegenerateDistortion = 1e6f;
+
+struct DistortionInput {
+    int numFaces = 0;
+    const Real* cotan = nullptr;        // FaceGeometry::cotan [3F]
+    const Real* edgeLength = nullptr;   // FaceGeometry::edgeLength [3F]
+    const Real* area = nullptr;         // FaceGeometry::area [F]
+    const int* faceOrder = nullptr;     // 几何量的面 -> 输出面（角的顺序相同），nullptr为恒等
+    const int* uvFaces = nullptr;       // 输出面f的三个角的UV索引 [3F]
+    const Real* uvs = nullptr;          // [u0,v0, u1,v1, ...]
+    int numUVs = 0;
+    const int* facePiece = nullptr;     // 输出面 -> 片段，nullptr时全部面属于片段0
+    int numPieces = 1;
+};
+
+// 逐面数组按输出面编号，3D面积为0的面计为 conformal = 1、area = 0、未翻转
+struct DistortionMetrics {
+    std::vector<float> conformal;       // σ1 / σ2，1为保角
+    std::vector<float> area;            // log2(缩放后的UV面积 / 3D面积)，0为等面积
+    std::vector<uint8_t> flipped;       // 朝向与所在片段的总体朝向相反，或UV面积为0
+    std::vector<float> boundaryError;   // 每个片段：(缩放后的UV边界长度 - 3D边界长度) / 3D边界长度
+
+    // 汇总（按3D面积加权）
+    int flippedFaces = 0;
+    double meanConformal = 0;
+    double maxConformal = 0;
+    double meanAreaError = 0;           // |area| 的加权平均
+    double maxBoundaryError = 0;        // |boundaryError| 的最大值
+
+    bool empty() const { return conformal.empty(); }
+};
+
+/**
+ * 计算全部指标；边界边为UV中没有反向边的边（缝线切开后两侧的UV顶点不同，因此缝线也计入边界）
+ * uvFaces和facePiece的编号需在范围内（调用方检查）
+ */
+void computeDistortion(const DistortionInput& input, DistortionMetrics& out);
+
+} // namespace bff
+
+#endif // BFF_DISTORTION_METRICS_H
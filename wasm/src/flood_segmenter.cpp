@@ -0,0 +1,471 @@
+/**
+ * 泛洪分割实现
+ */
+
+#include "flood_segmenter.h"
+#include <algorithm>
+#include <cstring>
+
+namespace bff {
+
+namespace {
+
+const uint64_t kEmptyKey = ~uint64_t(0);
+const int kVoteRounds = 5;   // 与JS的assignBoundaryFacesByAdjacency相同
+
+inline uint64_t undirectedKey(int v1, int v2) {
+    if (v1 > v2) std::swap(v1, v2);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(v1)) << 32) | static_cast<uint32_t>(v2);
+}
+
+inline size_t hashSlot(uint64_t key, uint64_t mask) {
+    return ((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+} // namespace
+
+bool FloodSegmenter::setMesh(const int* tris, int numFaces, int numVertices) {
+    faceCount = 0;
+    vertexCount = 0;
+    hasState = false;
+    triangles.clear();
+    twin.clear();
+    edgeOf.clear();
+    cornerOrder.clear();
+    edgeHalfEdgeOffsets.clear();
+    edgeHalfEdges.clear();
+    edgeKeys.clear();
+    edgeIds.clear();
+    wall.clear();
+    islands.clear();
+    freeSlots.clear();
+    faceLabels.clear();
+    offsets.assign(1, 0);
+    faces.clear();
+    dirtyPatches.clear();
+    islandCount = boundaryCount = unassignedCount = 0;
+    refloodCount = revoteCount = 0;
+
+    for (int i = 0; i < numFaces * 3; i++) {
+        if (tris[i] < 0 || tris[i] >= numVertices) return false;
+    }
+    faceCount = numFaces;
+    vertexCount = numVertices;
+    triangles.assign(tris, tris + numFaces * 3);
+
+    // 边按首次出现的顺序编号，与JS中边->面Map的插入顺序相同
+    int numHE = numFaces * 3;
+    size_t tableSize = 16;
+    while (tableSize < (size_t)numHE * 2) tableSize <<= 1;
+    hashMask = tableSize - 1;
+    edgeKeys.assign(tableSize, kEmptyKey);
+    edgeIds.assign(tableSize, -1);
+
+    std::vector<int> count;
+    count.reserve(numHE);
+    edgeOf.resize(numHE);
+    for (int he = 0; he < numHE; he++) {
+        int f = he / 3;
+        uint64_t key = undirectedKey(triangles[he], triangles[f * 3 + (he % 3 + 1) % 3]);
+        size_t h = hashSlot(key, hashMask);
+        while (edgeKeys[h] != kEmptyKey && edgeKeys[h] != key) h = (h + 1) & hashMask;
+        if (edgeKeys[h] == kEmptyKey) {
+            edgeKeys[h] = key;
+            edgeIds[h] = count.size();
+            count.push_back(0);
+        }
+        int e = edgeIds[h];
+        count[e]++;
+        edgeOf[he] = e;
+    }
+
+    // 边 -> 半边（按半边编号升序）
+    int numEdges = count.size();
+    edgeHalfEdgeOffsets.assign(numEdges + 1, 0);
+    for (int e = 0; e < numEdges; e++) edgeHalfEdgeOffsets[e + 1] = edgeHalfEdgeOffsets[e] + count[e];
+    edgeHalfEdges.resize(numHE);
+    std::vector<int> fill(edgeHalfEdgeOffsets.begin(), edgeHalfEdgeOffsets.end() - 1);
+    for (int he = 0; he < numHE; he++) edgeHalfEdges[fill[edgeOf[he]]++] = he;
+
+    // 恰好两个面共享的边才相邻（同一面出现两次的退化边也算，邻居是自己）
+    twin.assign(numHE, -1);
+    for (int e = 0; e < numEdges; e++) {
+        if (count[e] != 2) continue;
+        int a = edgeHalfEdges[edgeHalfEdgeOffsets[e]];
+        int b = edgeHalfEdges[edgeHalfEdgeOffsets[e] + 1];
+        twin[a] = b;
+        twin[b] = a;
+    }
+
+    cornerOrder.resize(numHE);
+    for (int f = 0; f < numFaces; f++) {
+        uint8_t* order = &cornerOrder[f * 3];
+        const int* e = &edgeOf[f * 3];
+        order[0] = 0;
+        order[1] = 1;
+        order[2] = 2;
+        // 三个元素的稳定插入排序
+        for (int i = 1; i < 3; i++) {
+            for (int j = i; j > 0 && e[order[j]] < e[order[j - 1]]; j--) std::swap(order[j], order[j - 1]);
+        }
+    }
+
+    wall.assign(numEdges, 0);
+    return true;
+}
+
+int FloodSegmenter::findEdge(int v1, int v2) const {
+    if (edgeKeys.empty()) return -1;
+    uint64_t key = undirectedKey(v1, v2);
+    size_t h = hashSlot(key, hashMask);
+    while (edgeKeys[h] != kEmptyKey) {
+        if (edgeKeys[h] == key) return edgeIds[h];
+        h = (h + 1) & hashMask;
+    }
+    return -1;
+}
+
+bool FloodSegmenter::isRedFace(int f) const {
+    const int* t = &triangles[f * 3];
+    return red[t[0]] || red[t[1]] || red[t[2]];
+}
+
+int FloodSegmenter::allocIsland() {
+    int slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = islands.size();
+        islands.emplace_back();
+    }
+    Island& island = islands[slot];
+    island.flood.clear();
+    island.assigned.clear();
+    island.clean = 0;
+    island.alive = true;
+    island.dirty = true;
+    island.emitted = false;
+    return slot;
+}
+
+void FloodSegmenter::releaseIsland(int slot) {
+    Island& island = islands[slot];
+    for (int f : island.flood) {
+        islandOf[f] = -1;
+        ownerOf[f] = -1;
+        assignRound[f] = -1;
+    }
+    for (int f : island.assigned) {
+        if (ownerOf[f] == slot) {
+            ownerOf[f] = -1;
+            assignRound[f] = -1;
+        }
+    }
+    island.flood.clear();
+    island.assigned.clear();
+    island.alive = false;
+    freeSlots.push_back(slot);
+}
+
+// 与JS相同用栈，邻居按邻接表顺序入栈；region按面编号升序，其中的面当前都不属于任何岛屿。
+// 岛屿只由自身的面决定（从编号最小的面出发），区域外的岛屿不受影响
+void FloodSegmenter::reflood(const std::vector<int>& region) {
+    std::vector<int> stack;
+    for (int start : region) {
+        if (boundary[start] || islandOf[start] >= 0) continue;
+        int slot = allocIsland();
+        std::vector<int>& flood = islands[slot].flood;
+        stack.assign(1, start);
+        islandOf[start] = slot;
+        while (!stack.empty()) {
+            int f = stack.back();
+            stack.pop_back();
+            flood.push_back(f);
+            ownerOf[f] = slot;
+            assignRound[f] = 0;
+            for (int k = 0; k < 3; k++) {
+                int t = twin[f * 3 + cornerOrder[f * 3 + k]];
+                if (t < 0) continue;
+                int n = t / 3;
+                // 缝线边两侧的面都是边界面，不会越过缝线
+                if (boundary[n] || islandOf[n] >= 0) continue;
+                islandOf[n] = slot;
+                stack.push_back(n);
+            }
+        }
+        refloodCount += flood.size();
+    }
+}
+
+// 边界面按相邻岛屿投票归属，第r轮只看前r-1轮的结果；candidates按面编号升序。
+// 全局某一轮没有新归属时之后各轮也不会有，固定执行5轮与JS提前结束的结果相同
+void FloodSegmenter::revote(const std::vector<int>& candidates, bool assign) {
+    std::vector<int> pending, oldOwner;
+    std::vector<int8_t> oldRound;
+    for (int f : candidates) {
+        if (!boundary[f]) continue;
+        oldOwner.push_back(ownerOf[f]);
+        oldRound.push_back(assignRound[f]);
+        ownerOf[f] = -1;
+        assignRound[f] = -1;
+        pending.push_back(f);
+    }
+    revoteCount += pending.size();
+    std::vector<int> voted = pending;
+
+    std::vector<std::pair<int, int>> toAdd;
+    std::vector<int> kept;
+    for (int round = 1; assign && round <= kVoteRounds && !pending.empty(); round++) {
+        toAdd.clear();
+        kept.clear();
+        for (int f : pending) {
+            // 票数相同时取邻接表中先出现的岛屿
+            int votePatch[3], voteCount[3], numVotes = 0;
+            for (int k = 0; k < 3; k++) {
+                int t = twin[f * 3 + cornerOrder[f * 3 + k]];
+                if (t < 0) continue;
+                int n = t / 3;
+                if (assignRound[n] < 0 || assignRound[n] >= round) continue;
+                int p = ownerOf[n];
+                int j = 0;
+                while (j < numVotes && votePatch[j] != p) j++;
+                if (j == numVotes) {
+                    votePatch[numVotes] = p;
+                    voteCount[numVotes++] = 0;
+                }
+                voteCount[j]++;
+            }
+            int best = -1, maxVotes = 0;
+            for (int j = 0; j < numVotes; j++) {
+                if (voteCount[j] > maxVotes) {
+                    maxVotes = voteCount[j];
+                    best = votePatch[j];
+                }
+            }
+            if (best >= 0) {
+                toAdd.emplace_back(f, best);
+            } else {
+                kept.push_back(f);
+            }
+        }
+        for (const std::pair<int, int>& item : toAdd) {
+            ownerOf[item.first] = item.second;
+            assignRound[item.first] = round;
+        }
+        pending.swap(kept);
+    }
+
+    // 归属或轮次（决定面的顺序）变化时，新旧岛屿都需要重建；未变的面仍在原岛屿的列表中
+    for (size_t i = 0; i < voted.size(); i++) {
+        int f = voted[i];
+        if (ownerOf[f] == oldOwner[i] && assignRound[f] == oldRound[i]) continue;
+        if (oldOwner[i] >= 0) islands[oldOwner[i]].dirty = true;
+        if (ownerOf[f] >= 0) {
+            islands[ownerOf[f]].assigned.push_back(f);
+            islands[ownerOf[f]].dirty = true;
+        }
+    }
+}
+
+// 有变化的岛屿去掉已归属到别处的面，按（轮次，面编号）即JS追加的顺序重排，并重新统计切缝
+void FloodSegmenter::rebuildDirtyIslands() {
+    for (int slot = 0; slot < (int)islands.size(); slot++) {
+        Island& island = islands[slot];
+        if (!island.alive || !island.dirty) continue;
+        std::vector<int>& assigned = island.assigned;
+        assigned.erase(std::remove_if(assigned.begin(), assigned.end(),
+                                      [this, slot](int f) { return ownerOf[f] != slot || assignRound[f] < 1; }),
+                       assigned.end());
+        std::sort(assigned.begin(), assigned.end(), [this](int a, int b) {
+            return assignRound[a] != assignRound[b] ? assignRound[a] < assignRound[b] : a < b;
+        });
+        assigned.erase(std::unique(assigned.begin(), assigned.end()), assigned.end());
+
+        island.clean = 0;
+        for (int f : island.flood) island.clean += !isRedFace(f);
+        for (int f : assigned) island.clean += !isRedFace(f);
+    }
+}
+
+void FloodSegmenter::segment(const int* seamPairs, int numSeams, const uint8_t* redMask,
+                             const SegmentOptions& options) {
+    refloodCount = revoteCount = 0;
+
+    std::vector<uint8_t> newWall(wall.size(), 0);
+    for (int i = 0; i < numSeams; i++) {
+        int v1 = seamPairs[i * 2];
+        int v2 = seamPairs[i * 2 + 1];
+        if (v1 < 0 || v2 < 0 || v1 >= vertexCount || v2 >= vertexCount) continue;
+        int e = findEdge(v1, v2);
+        if (e >= 0) newWall[e] = 1;
+    }
+    std::vector<uint8_t> newRed(vertexCount, 0);
+    if (redMask) {
+        for (int v = 0; v < vertexCount; v++) newRed[v] = redMask[v] != 0;
+    }
+
+    for (Island& island : islands) island.dirty = false;
+
+    bool full = !hasState || options.minFaces != lastOptions.minFaces ||
+                options.assignBoundaryFaces != lastOptions.assignBoundaryFaces;
+    if (full) {
+        wall.swap(newWall);
+        red.swap(newRed);
+        islands.clear();
+        freeSlots.clear();
+        islandOf.assign(faceCount, -1);
+        ownerOf.assign(faceCount, -1);
+        assignRound.assign(faceCount, -1);
+        boundary.assign(faceCount, 0);
+
+        // 含缝线边的面为边界面，第一轮不参与扩张
+        std::vector<int> all(faceCount), boundaryFaces;
+        for (int f = 0; f < faceCount; f++) {
+            all[f] = f;
+            const int* e = &edgeOf[f * 3];
+            if (wall[e[0]] || wall[e[1]] || wall[e[2]]) {
+                boundary[f] = 1;
+                boundaryFaces.push_back(f);
+            }
+        }
+        reflood(all);
+        revote(boundaryFaces, options.assignBoundaryFaces);
+    } else {
+        // 1. 改动的缝线边所在的面（边界面状态可能变化）
+        std::vector<uint8_t> mark(faceCount, 0);
+        std::vector<int> seeds;
+        for (int e = 0; e < (int)wall.size(); e++) {
+            if (wall[e] == newWall[e]) continue;
+            for (int i = edgeHalfEdgeOffsets[e]; i < edgeHalfEdgeOffsets[e + 1]; i++) {
+                int f = edgeHalfEdges[i] / 3;
+                if (!mark[f]) {
+                    mark[f] = 1;
+                    seeds.push_back(f);
+                }
+            }
+        }
+        wall.swap(newWall);
+
+        // 2. 释放含这些面或与之相邻的岛屿（面变为边界面会切开岛屿，变为普通面会连通相邻岛屿）
+        std::vector<int> region, changed;
+        auto release = [&](int slot) {
+            if (slot < 0 || !islands[slot].alive) return;
+            for (int f : islands[slot].flood) region.push_back(f);
+            for (int f : islands[slot].assigned) {
+                if (ownerOf[f] == slot) changed.push_back(f);
+            }
+            releaseIsland(slot);
+        };
+        for (int f : seeds) {
+            release(islandOf[f]);
+            for (int k = 0; k < 3; k++) {
+                int t = twin[f * 3 + k];
+                if (t >= 0) release(islandOf[t / 3]);
+            }
+        }
+        for (int f : seeds) {
+            const int* e = &edgeOf[f * 3];
+            uint8_t b = wall[e[0]] || wall[e[1]] || wall[e[2]];
+            if (!b && boundary[f] && ownerOf[f] >= 0) {
+                islands[ownerOf[f]].dirty = true;
+                ownerOf[f] = -1;
+                assignRound[f] = -1;
+            }
+            boundary[f] = b;
+            region.push_back(f);
+        }
+        std::sort(region.begin(), region.end());
+        region.erase(std::unique(region.begin(), region.end()), region.end());
+
+        // 3. 区域内重新泛洪
+        reflood(region);
+
+        // 4. 距区域5步以内的边界面重新投票
+        std::vector<int> frontier = region;
+        frontier.insert(frontier.end(), changed.begin(), changed.end());
+        std::fill(mark.begin(), mark.end(), 0);
+        for (int f : frontier) mark[f] = 1;
+        std::vector<int> candidates = frontier;
+        std::vector<int> next;
+        for (int depth = 0; depth < kVoteRounds; depth++) {
+            next.clear();
+            for (int f : frontier) {
+                for (int k = 0; k < 3; k++) {
+                    int t = twin[f * 3 + k];
+                    if (t < 0 || mark[t / 3]) continue;
+                    mark[t / 3] = 1;
+                    next.push_back(t / 3);
+                }
+            }
+            candidates.insert(candidates.end(), next.begin(), next.end());
+            frontier.swap(next);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        revote(candidates, options.assignBoundaryFaces);
+
+        // 5. 红点变化只影响切缝：重新统计含这些顶点的岛屿
+        if (std::memcmp(red.data(), newRed.data(), vertexCount) != 0) {
+            for (int f = 0; f < faceCount; f++) {
+                const int* t = &triangles[f * 3];
+                bool touched = red[t[0]] != newRed[t[0]] || red[t[1]] != newRed[t[1]] ||
+                               red[t[2]] != newRed[t[2]];
+                if (touched && ownerOf[f] >= 0) islands[ownerOf[f]].dirty = true;
+            }
+        }
+        red.swap(newRed);
+    }
+
+    hasState = true;
+    lastOptions = options;
+    rebuildDirtyIslands();
+    buildOutput();
+}
+
+// 岛屿按第一轮泛洪的面数降序、同面数按起始面（发现顺序）排列，与JS的稳定排序相同；
+// 丢弃小岛屿，剔除含红点的面后仍不少于minFaces的岛屿成为Patch
+void FloodSegmenter::buildOutput() {
+    std::vector<int> order;
+    for (int slot = 0; slot < (int)islands.size(); slot++) {
+        if (islands[slot].alive) order.push_back(slot);
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        const Island& ia = islands[a];
+        const Island& ib = islands[b];
+        if (ia.flood.size() != ib.flood.size()) return ia.flood.size() > ib.flood.size();
+        return ia.flood[0] < ib.flood[0];
+    });
+    islandCount = order.size();
+
+    boundaryCount = unassignedCount = 0;
+    for (int f = 0; f < faceCount; f++) {
+        boundaryCount += boundary[f];
+        unassignedCount += boundary[f] && ownerOf[f] < 0;
+    }
+
+    int minFaces = lastOptions.minFaces;
+    faceLabels.assign(faceCount, -1);
+    offsets.assign(1, 0);
+    faces.clear();
+    dirtyPatches.clear();
+    for (int slot : order) {
+        Island& island = islands[slot];
+        int total = island.flood.size() + island.assigned.size();
+        bool keep = total >= minFaces && island.clean > 0 && island.clean >= minFaces;
+        if (keep) {
+            int patch = numPatches();
+            for (const std::vector<int>* list : {&island.flood, &island.assigned}) {
+                for (int f : *list) {
+                    if (!isRedFace(f)) faceLabels[f] = patch;
+                }
+                faces.insert(faces.end(), list->begin(), list->end());
+            }
+            offsets.push_back(faces.size());
+            dirtyPatches.push_back(island.dirty || !island.emitted);
+        }
+        island.emitted = keep;
+    }
+}
+
+} // namespace bff
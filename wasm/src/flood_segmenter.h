@@ -0,0 +1,120 @@
+/**
+ * 按缝线泛洪分割面片（FloodSegmenter.segmentWithSeams 的原生实现）
+ * 网格设置一次后建立半边对偶和边编号，每次编辑缝线只需重新泛洪：
+ * 缝线边按整数对传入，不生成字符串key
+ *
+ * 增量更新：两次segment之间只改动了少量缝线边时，只重新泛洪与改动边相连的岛屿，
+ * 只对距改动处5步以内的边界面重新投票（投票最多5轮，更远的面结果不变），
+ * 结果与从头分割完全相同
+ */
+
+#ifndef BFF_FLOOD_SEGMENTER_H
+#define BFF_FLOOD_SEGMENTER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace bff {
+
+// 与 FloodSegmenter.segmentWithSeams(mesh, seamEdges, options) 对应
+struct SegmentOptions {
+    int minFaces = 500;                // 保留的最小面数
+    bool assignBoundaryFaces = true;   // 把含缝线边的面分配回相邻票数最多的Patch
+};
+
+class FloodSegmenter {
+public:
+    /**
+     * 建立面邻接（恰好被两个面共享的边相邻，不要求朝向一致）
+     * @param triangles 三角形索引 [a0,b0,c0, ...]
+     * @return 索引越界时返回false
+     */
+    bool setMesh(const int* triangles, int numFaces, int numVertices);
+
+    /**
+     * 泛洪分割，结果与JS实现相同（Patch编号、面的顺序一致）
+     * 同一网格上再次调用时只重算缝线或红点改动影响到的区域
+     * @param seamPairs 缝线边 [a0,b0, a1,b1, ...]，不在网格中的边忽略
+     * @param redMask 每个顶点一个字节，非0为红点；含红点的面作为切缝剔除，可为nullptr
+     */
+    void segment(const int* seamPairs, int numSeams, const uint8_t* redMask,
+                 const SegmentOptions& options);
+
+    // 面 -> Patch，被剔除的面为-1
+    const std::vector<int>& labels() const { return faceLabels; }
+
+    // Patch p 剔除切缝前的面为 faces[offsets[p] .. offsets[p+1])，顺序与JS的岛屿相同
+    const std::vector<int>& patchOffsets() const { return offsets; }
+    const std::vector<int>& patchFaces() const { return faces; }
+
+    // Patch p 的面（含顺序）或切缝是否与上一次segment不同；第一次分割时全部为1
+    const std::vector<uint8_t>& patchDirty() const { return dirtyPatches; }
+
+    int numPatches() const { return (int)offsets.size() - 1; }
+    int numFaces() const { return faceCount; }
+    int numVertices() const { return vertexCount; }
+    int numIslands() const { return islandCount; }                 // 第一轮泛洪得到的岛屿数
+    int numBoundaryFaces() const { return boundaryCount; }
+    int numUnassignedFaces() const { return unassignedCount; }     // 未能归属的含缝线边的面
+    int numRefloodedFaces() const { return refloodCount; }         // 本次重新泛洪的面数
+    int numRevotedFaces() const { return revoteCount; }            // 本次重新投票的边界面数
+
+private:
+    // 第一轮泛洪得到的岛屿；槽位在岛屿被重新泛洪前保持不变
+    struct Island {
+        std::vector<int> flood;      // 泛洪顺序的面，flood[0]为编号最小的面
+        std::vector<int> assigned;   // 投票归属的边界面，按（轮次，面编号）排列
+        int clean = 0;               // 不含红点的面数
+        bool alive = false;
+        bool dirty = false;          // 本次面或切缝有变化
+        bool emitted = false;        // 上一次是否输出为Patch
+    };
+
+    int faceCount = 0;
+    int vertexCount = 0;
+    std::vector<int> triangles;
+    std::vector<int> twin;          // 半边3f+i的对偶半边，非恰好两面共享的边为-1
+    std::vector<int> edgeOf;        // 半边 -> 无向边编号
+    std::vector<uint8_t> cornerOrder; // 每个面的三个角按所在边首次出现的顺序排列（JS邻接表的顺序）
+    std::vector<int> edgeHalfEdgeOffsets, edgeHalfEdges;  // 无向边 -> 半边
+
+    // 无向边的开放寻址哈希表，查缝线边的编号
+    std::vector<uint64_t> edgeKeys;
+    std::vector<int> edgeIds;
+    uint64_t hashMask = 0;
+
+    // 上一次分割的状态
+    bool hasState = false;
+    SegmentOptions lastOptions;
+    std::vector<uint8_t> wall;      // 无向边 -> 是否为缝线
+    std::vector<uint8_t> red;       // 顶点 -> 是否为红点
+    std::vector<uint8_t> boundary;  // 面 -> 是否含缝线边
+    std::vector<int> islandOf;      // 面 -> 泛洪岛屿槽位，边界面为-1
+    std::vector<int> ownerOf;       // 面 -> 最终所属岛屿槽位（含投票归属），-1为未归属
+    std::vector<int8_t> assignRound; // 面 -> 0为泛洪面，1..5为归属轮次，-1为未归属
+    std::vector<Island> islands;
+    std::vector<int> freeSlots;
+
+    std::vector<int> faceLabels;
+    std::vector<int> offsets;
+    std::vector<int> faces;
+    std::vector<uint8_t> dirtyPatches;
+    int islandCount = 0;
+    int boundaryCount = 0;
+    int unassignedCount = 0;
+    int refloodCount = 0;
+    int revoteCount = 0;
+
+    int findEdge(int v1, int v2) const;
+    bool isRedFace(int f) const;
+    int allocIsland();
+    void releaseIsland(int slot);
+    void reflood(const std::vector<int>& region);
+    void revote(const std::vector<int>& candidates, bool assign);
+    void rebuildDirtyIslands();
+    void buildOutput();
+};
+
+} // namespace bff
+
+#endif // BFF_FLOOD_SEGMENTER_H
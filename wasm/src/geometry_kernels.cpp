@@ -0,0 +1,192 @@
+/**
+ * 逐三角形几何预计算实现
+ */
+
+#include "geometry_kernels.h"
+#include "task_scheduler.h"
+#include "profiler.h"
+#include <cmath>
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+namespace bff {
+
+// 单个三角形
+template <typename T>
+static inline void faceGeometryScalar(const Vec3T<T>* vertices, const int* tri, int f,
+                                      FaceGeometryT<T>& out) {
+    const Vec3T<T>& p0 = vertices[tri[0]];
+    const Vec3T<T>& p1 = vertices[tri[1]];
+    const Vec3T<T>& p2 = vertices[tri[2]];
+
+    // 从角k出发的两条边
+    Vec3T<T> a[3] = {p1 - p0, p2 - p1, p0 - p2};  // 角k -> 角k+1
+    Vec3T<T> b[3] = {p2 - p0, p0 - p1, p1 - p2};  // 角k -> 角k+2
+
+    T cross = a[0].cross(b[0]).length();  // 三个角的叉积模相同，等于面积的2倍
+    out.area[f] = T(0.5) * cross;
+    for (int k = 0; k < 3; k++) {
+        T d = a[k].dot(b[k]);
+        out.edgeLength[f * 3 + k] = (a[(k + 1) % 3]).length();
+        out.cotan[f * 3 + k] = cross > T(1e-12) ? d / cross : T(0);
+    }
+}
+
+#ifdef __wasm_simd128__
+// 两个三角形一组（f64x2），返回第一个未处理的面
+static int faceGeometrySimd(const Vec3T<double>* vertices, const int* triangles, int begin, int end,
+                            FaceGeometryT<double>& out) {
+    int f = begin;
+    const v128_t eps = wasm_f64x2_splat(1e-12);
+    const v128_t zero = wasm_f64x2_splat(0.0);
+    const v128_t half = wasm_f64x2_splat(0.5);
+    for (; f + 2 <= end; f += 2) {
+        // 收集两个三角形的顶点坐标，每条通道一个三角形
+        v128_t px[3], py[3], pz[3];
+        for (int k = 0; k < 3; k++) {
+            const Vec3T<double>& q0 = vertices[triangles[f * 3 + k]];
+            const Vec3T<double>& q1 = vertices[triangles[f * 3 + 3 + k]];
+            px[k] = wasm_f64x2_make(q0.x, q1.x);
+            py[k] = wasm_f64x2_make(q0.y, q1.y);
+            pz[k] = wasm_f64x2_make(q0.z, q1.z);
+        }
+
+        // 边 e_k = p_{k+1} - p_k，角k的两条边为 e_k 和 -e_{k+2}
+        v128_t ex[3], ey[3], ez[3], len[3];
+        for (int k = 0; k < 3; k++) {
+            int n = (k + 1) % 3;
+            ex[k] = wasm_f64x2_sub(px[n], px[k]);
+            ey[k] = wasm_f64x2_sub(py[n], py[k]);
+            ez[k] = wasm_f64x2_sub(pz[n], pz[k]);
+            len[k] = wasm_f64x2_sqrt(wasm_f64x2_add(wasm_f64x2_add(
+                wasm_f64x2_mul(ex[k], ex[k]), wasm_f64x2_mul(ey[k], ey[k])),
+                wasm_f64x2_mul(ez[k], ez[k])));
+        }
+
+        // |e0 x e2| 即面积的2倍
+        v128_t cx = wasm_f64x2_sub(wasm_f64x2_mul(ey[0], ez[2]), wasm_f64x2_mul(ez[0], ey[2]));
+        v128_t cy = wasm_f64x2_sub(wasm_f64x2_mul(ez[0], ex[2]), wasm_f64x2_mul(ex[0], ez[2]));
+        v128_t cz = wasm_f64x2_sub(wasm_f64x2_mul(ex[0], ey[2]), wasm_f64x2_mul(ey[0], ex[2]));
+        v128_t cross = wasm_f64x2_sqrt(wasm_f64x2_add(wasm_f64x2_add(
+            wasm_f64x2_mul(cx, cx), wasm_f64x2_mul(cy, cy)), wasm_f64x2_mul(cz, cz)));
+        v128_t valid = wasm_f64x2_gt(cross, eps);
+        v128_t safeCross = wasm_v128_bitselect(cross, wasm_f64x2_splat(1.0), valid);
+
+        v128_t area = wasm_f64x2_mul(half, cross);
+        out.area[f] = wasm_f64x2_extract_lane(area, 0);
+        out.area[f + 1] = wasm_f64x2_extract_lane(area, 1);
+
+        for (int k = 0; k < 3; k++) {
+            int p = (k + 2) % 3;
+            // 角k: dot(e_k, -e_p)
+            v128_t d = wasm_f64x2_sub(zero, wasm_f64x2_add(wasm_f64x2_add(
+                wasm_f64x2_mul(ex[k], ex[p]), wasm_f64x2_mul(ey[k], ey[p])),
+                wasm_f64x2_mul(ez[k], ez[p])));
+            v128_t cot = wasm_v128_bitselect(wasm_f64x2_div(d, safeCross), zero, valid);
+            // 角k的对边为 e_{k+1}
+            v128_t opposite = len[(k + 1) % 3];
+
+            for (int lane = 0; lane < 2; lane++) {
+                int idx = (f + lane) * 3 + k;
+                out.edgeLength[idx] = lane == 0 ? wasm_f64x2_extract_lane(opposite, 0)
+                                                : wasm_f64x2_extract_lane(opposite, 1);
+                out.cotan[idx] = lane == 0 ? wasm_f64x2_extract_lane(cot, 0)
+                                           : wasm_f64x2_extract_lane(cot, 1);
+            }
+        }
+    }
+    return f;
+}
+
+// 四个三角形一组（f32x4），步骤与双精度版本相同
+static int faceGeometrySimd(const Vec3T<float>* vertices, const int* triangles, int begin, int end,
+                            FaceGeometryT<float>& out) {
+    int f = begin;
+    const v128_t eps = wasm_f32x4_splat(1e-12f);
+    const v128_t zero = wasm_f32x4_splat(0.0f);
+    const v128_t half = wasm_f32x4_splat(0.5f);
+    for (; f + 4 <= end; f += 4) {
+        v128_t px[3], py[3], pz[3];
+        for (int k = 0; k < 3; k++) {
+            const Vec3T<float>& q0 = vertices[triangles[f * 3 + k]];
+            const Vec3T<float>& q1 = vertices[triangles[f * 3 + 3 + k]];
+            const Vec3T<float>& q2 = vertices[triangles[f * 3 + 6 + k]];
+            const Vec3T<float>& q3 = vertices[triangles[f * 3 + 9 + k]];
+            px[k] = wasm_f32x4_make(q0.x, q1.x, q2.x, q3.x);
+            py[k] = wasm_f32x4_make(q0.y, q1.y, q2.y, q3.y);
+            pz[k] = wasm_f32x4_make(q0.z, q1.z, q2.z, q3.z);
+        }
+
+        v128_t ex[3], ey[3], ez[3], len[3];
+        for (int k = 0; k < 3; k++) {
+            int n = (k + 1) % 3;
+            ex[k] = wasm_f32x4_sub(px[n], px[k]);
+            ey[k] = wasm_f32x4_sub(py[n], py[k]);
+            ez[k] = wasm_f32x4_sub(pz[n], pz[k]);
+            len[k] = wasm_f32x4_sqrt(wasm_f32x4_add(wasm_f32x4_add(
+                wasm_f32x4_mul(ex[k], ex[k]), wasm_f32x4_mul(ey[k], ey[k])),
+                wasm_f32x4_mul(ez[k], ez[k])));
+        }
+
+        v128_t cx = wasm_f32x4_sub(wasm_f32x4_mul(ey[0], ez[2]), wasm_f32x4_mul(ez[0], ey[2]));
+        v128_t cy = wasm_f32x4_sub(wasm_f32x4_mul(ez[0], ex[2]), wasm_f32x4_mul(ex[0], ez[2]));
+        v128_t cz = wasm_f32x4_sub(wasm_f32x4_mul(ex[0], ey[2]), wasm_f32x4_mul(ey[0], ex[2]));
+        v128_t cross = wasm_f32x4_sqrt(wasm_f32x4_add(wasm_f32x4_add(
+            wasm_f32x4_mul(cx, cx), wasm_f32x4_mul(cy, cy)), wasm_f32x4_mul(cz, cz)));
+        v128_t valid = wasm_f32x4_gt(cross, eps);
+        v128_t safeCross = wasm_v128_bitselect(cross, wasm_f32x4_splat(1.0f), valid);
+
+        // 四条通道的结果按面写回（各面的三个角在输出中相邻）
+        float lane[4];
+        wasm_v128_store(lane, wasm_f32x4_mul(half, cross));
+        for (int i = 0; i < 4; i++) out.area[f + i] = lane[i];
+
+        for (int k = 0; k < 3; k++) {
+            int p = (k + 2) % 3;
+            v128_t d = wasm_f32x4_sub(zero, wasm_f32x4_add(wasm_f32x4_add(
+                wasm_f32x4_mul(ex[k], ex[p]), wasm_f32x4_mul(ey[k], ey[p])),
+                wasm_f32x4_mul(ez[k], ez[p])));
+            v128_t cot = wasm_v128_bitselect(wasm_f32x4_div(d, safeCross), zero, valid);
+
+            wasm_v128_store(lane, len[(k + 1) % 3]);
+            for (int i = 0; i < 4; i++) out.edgeLength[(f + i) * 3 + k] = lane[i];
+            wasm_v128_store(lane, cot);
+            for (int i = 0; i < 4; i++) out.cotan[(f + i) * 3 + k] = lane[i];
+        }
+    }
+    return f;
+}
+#endif
+
+// 面 [begin, end)
+template <typename T>
+static void faceGeometryRange(const Vec3T<T>* vertices, const int* triangles, int begin, int end,
+                              FaceGeometryT<T>& out) {
+    int f = begin;
+#ifdef __wasm_simd128__
+    f = faceGeometrySimd(vertices, triangles, begin, end, out);
+#endif
+    for (; f < end; f++) {
+        faceGeometryScalar(vertices, triangles + f * 3, f, out);
+    }
+}
+
+template <typename T>
+void computeFaceGeometry(const Vec3T<T>* vertices, const int* triangles, int numFaces,
+                         FaceGeometryT<T>& out) {
+    BFF_PROFILE_SCOPE("geometry");
+    out.edgeLength.resize(numFaces * 3);
+    out.cotan.resize(numFaces * 3);
+    out.area.resize(numFaces);
+
+    // 各面互不相关，按块分给调度器
+    parallelFor(numFaces, 4096, [&](int begin, int end) {
+        faceGeometryRange(vertices, triangles, begin, end, out);
+    });
+}
+
+template void computeFaceGeometry<float>(const Vec3T<float>*, const int*, int, FaceGeometryT<float>&);
+template void computeFaceGeometry<double>(const Vec3T<double>*, const int*, int, FaceGeometryT<double>&);
+
+} // namespace bff
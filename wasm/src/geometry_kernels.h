@@ -0,0 +1,44 @@
+/**
+ * 逐三角形几何预计算（边长、余切、面积）
+ * 编译时启用 -msimd128 则一组三角形向量化计算（double两个一组，float四个一组），
+ * 否则使用标量实现；多线程构建中按块并行
+ */
+
+#ifndef GEOMETRY_KERNELS_H
+#define GEOMETRY_KERNELS_H
+
+#include <vector>
+#include "scalar_types.h"
+
+namespace bff {
+
+// 每个面的几何量，按量分别存储（SoA）；三个角的数据位于 3*f + k，角k的对边为 (k+1, k+2)
+template <typename T>
+struct FaceGeometryT {
+    std::vector<T> edgeLength;  // 角k对边的长度 [3*F]
+    std::vector<T> cotan;       // 角k的余切，退化三角形为0 [3*F]
+    std::vector<T> area;        // 面积 [F]
+
+    void clear() {
+        edgeLength.clear();
+        cotan.clear();
+        area.clear();
+    }
+};
+
+using FaceGeometry = FaceGeometryT<Real>;
+
+/**
+ * 计算所有三角形的几何量（float和double两种精度均已实例化，可与网格精度无关地单独调用）
+ * @param vertices 顶点坐标
+ * @param triangles 三角形索引 [a0,b0,c0, ...]
+ * @param numFaces 三角形数量
+ * @param out 输出
+ */
+template <typename T>
+void computeFaceGeometry(const Vec3T<T>* vertices, const int* triangles, int numFaces,
+                         FaceGeometryT<T>& out);
+
+} // namespace bff
+
+#endif // GEOMETRY_KERNELS_H
@@ -0,0 +1,284 @@
+/**
+ * 片段多分辨率近似实现
+ */
+
+#include "island_lod.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace bff {
+
+namespace {
+
+struct Collapse {
+    double cost;                 // 边长的平方，短边先收缩
+    int from;                    // 被移除的顶点
+    int to;
+
+    bool operator>(const Collapse& o) const { return cost > o.cost; }
+};
+
+// 收缩过程中的可变网格：三角形原地改写，顶点记录关联面
+class CollapseMesh {
+public:
+    CollapseMesh(const std::vector<Vec3>& points, const std::vector<int>& triangles)
+        : points(points), tris(triangles), faceAlive(triangles.size() / 3, 1), vertexFaces(points.size()) {
+        for (int f = 0; f < (int)faceAlive.size(); f++) {
+            for (int k = 0; k < 3; k++) vertexFaces[tris[f * 3 + k]].push_back(f);
+        }
+    }
+
+    // v的一环邻居（去重）
+    void neighbors(int v, std::vector<int>& out) const {
+        out.clear();
+        for (int f : vertexFaces[v]) {
+            for (int k = 0; k < 3; k++) {
+                int w = tris[f * 3 + k];
+                if (w != v && std::find(out.begin(), out.end(), w) == out.end()) out.push_back(w);
+            }
+        }
+    }
+
+    /**
+     * u -> v 可收缩：u与v相邻，共同邻居恰为两个（流形连接条件），
+     * 其余关联面把u移到v后法向不翻转、不退化
+     */
+    bool canCollapse(int u, int v, std::vector<int>& ringU, std::vector<int>& ringV) const {
+        neighbors(u, ringU);
+        if (std::find(ringU.begin(), ringU.end(), v) == ringU.end()) return false;
+        neighbors(v, ringV);
+        int common = 0;
+        for (int w : ringU) {
+            if (std::find(ringV.begin(), ringV.end(), w) != ringV.end()) common++;
+        }
+        if (common != 2) return false;
+
+        const Vec3& pv = points[v];
+        for (int f : vertexFaces[u]) {
+            const int* t = &tris[f * 3];
+            if (t[0] == v || t[1] == v || t[2] == v) continue;
+            Vec3 p[3], q[3];
+            for (int k = 0; k < 3; k++) {
+                p[k] = points[t[k]];
+                q[k] = t[k] == u ? pv : p[k];
+            }
+            Vec3 before = (p[1] - p[0]).cross(p[2] - p[0]);
+            Vec3 after = (q[1] - q[0]).cross(q[2] - q[0]);
+            double lb = before.length(), la = after.length();
+            if (la <= 1e-3 * lb || after.dot(before) < 0.2 * la * lb) return false;
+        }
+        return true;
+    }
+
+    // 执行 u -> v：删除共享uv边的两个面，其余面中u换成v
+    void collapse(int u, int v) {
+        for (int f : vertexFaces[u]) {
+            int* t = &tris[f * 3];
+            if (t[0] == v || t[1] == v || t[2] == v) {
+                faceAlive[f] = 0;
+                for (int k = 0; k < 3; k++) {
+                    if (t[k] == u) continue;
+                    std::vector<int>& list = vertexFaces[t[k]];
+                    list.erase(std::find(list.begin(), list.end(), f));
+                }
+            } else {
+                for (int k = 0; k < 3; k++) {
+                    if (t[k] == u) t[k] = v;
+                }
+                vertexFaces[v].push_back(f);
+            }
+        }
+        vertexFaces[u].clear();
+    }
+
+    bool isFaceAlive(int f) const { return faceAlive[f] != 0; }
+    const int* face(int f) const { return &tris[f * 3]; }
+    int numFaces() const { return faceAlive.size(); }
+
+private:
+    const std::vector<Vec3>& points;
+    std::vector<int> tris;
+    std::vector<char> faceAlive;
+    std::vector<std::vector<int>> vertexFaces;
+};
+
+// 只属于一个三角形的边，按三角形中的方向 [a0,b0, ...]
+std::vector<int> boundaryEdgesOf(const std::vector<int>& triangles) {
+    std::vector<std::pair<uint64_t, int>> keys(triangles.size());
+    for (size_t h = 0; h < triangles.size(); h++) {
+        uint32_t a = triangles[h];
+        uint32_t b = triangles[h - h % 3 + (h + 1) % 3];
+        keys[h] = {uint64_t(std::min(a, b)) << 32 | std::max(a, b), int(h)};
+    }
+    std::sort(keys.begin(), keys.end());
+    std::vector<int> edges;
+    for (size_t i = 0; i < keys.size();) {
+        size_t j = i;
+        while (j < keys.size() && keys[j].first == keys[i].first) j++;
+        if (j - i == 1) {
+            int h = keys[i].second;
+            edges.push_back(triangles[h]);
+            edges.push_back(triangles[h - h % 3 + (h + 1) % 3]);
+        }
+        i = j;
+    }
+    return edges;
+}
+
+} // namespace
+
+void IslandLOD::build(const std::vector<Vec3>& points, const std::vector<int>& triangles,
+                      const std::vector<char>& keep, int targetVertices) {
+    BFF_PROFILE_SCOPE("lodBuild");
+    int n = points.size();
+    built = true;
+    target = targetVertices;
+    keepMask = keep;
+    removed.clear();
+    ringStart.assign(1, 0);
+    ringVertex.clear();
+    ringWeight.clear();
+
+    CollapseMesh mesh(points, triangles);
+    auto cost = [&](int a, int b) {
+        Vec3 d = points[a] - points[b];
+        return double(d.dot(d));
+    };
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+    for (size_t h = 0; h < triangles.size(); h++) {
+        int a = triangles[h];
+        int b = triangles[h - h % 3 + (h + 1) % 3];
+        if (!keep[a]) heap.push(Collapse{cost(a, b), a, b});
+        if (!keep[b]) heap.push(Collapse{cost(a, b), b, a});
+    }
+
+    // 顶点位置不变，边长即代价不会过期；边是否仍存在、能否收缩在出堆时检查
+    std::vector<char> alive(n, 1);
+    int aliveCount = n;
+    std::vector<int> ringU, ringV;
+    while (aliveCount > targetVertices && !heap.empty()) {
+        Collapse c = heap.top();
+        heap.pop();
+        if (!alive[c.from] || !alive[c.to]) continue;
+        if (!mesh.canCollapse(c.from, c.to, ringU, ringV)) continue;
+
+        // 插值权重取收缩前的一环邻居，它们在逆序恢复时均已有坐标
+        removed.push_back(c.from);
+        for (int w : ringU) {
+            double d = std::sqrt(cost(c.from, w));
+            ringVertex.push_back(w);
+            ringWeight.push_back(1.0 / std::max(d, 1e-12));
+        }
+        ringStart.push_back(ringVertex.size());
+
+        mesh.collapse(c.from, c.to);
+        alive[c.from] = 0;
+        aliveCount--;
+
+        // u的邻居与v之间出现的新边
+        for (int w : ringU) {
+            if (w == c.to || std::find(ringV.begin(), ringV.end(), w) != ringV.end()) continue;
+            double e = cost(w, c.to);
+            if (!keep[w]) heap.push(Collapse{e, w, c.to});
+            if (!keep[c.to]) heap.push(Collapse{e, c.to, w});
+        }
+    }
+
+    std::vector<int> coarseIndex(n, -1);
+    coarseVertex.clear();
+    for (int v = 0; v < n; v++) {
+        if (alive[v]) {
+            coarseIndex[v] = coarseVertex.size();
+            coarseVertex.push_back(v);
+        }
+    }
+    coarseTriangles.clear();
+    for (int f = 0; f < mesh.numFaces(); f++) {
+        if (!mesh.isFaceAlive(f)) continue;
+        const int* t = mesh.face(f);
+        for (int k = 0; k < 3; k++) coarseTriangles.push_back(coarseIndex[t[k]]);
+    }
+    BFF_PROFILE_COUNT("lodCollapses", removed.size());
+
+    // 粗网格的LSCM矩阵；固定顶点只在求解时给定，分解留到求解时按固定顶点建立
+    int m = coarseVertex.size();
+    std::vector<Vec3> coarsePoints(m);
+    for (int i = 0; i < m; i++) coarsePoints[i] = points[coarseVertex[i]];
+    CSRMatrix laplacian = assembleCotanLaplacian(m, coarseTriangles, cotanWeights(coarsePoints, coarseTriangles));
+    lscm = assembleLSCM(laplacian, boundaryEdgesOf(coarseTriangles));
+    fixedVertices.clear();
+    freeIndex.clear();
+    numFree = 0;
+    factorValid = false;
+}
+
+SolveStats IslandLOD::solve(std::vector<Vec2>& uvs, const std::vector<int>& fixed,
+                            const SolverOptions& options) {
+    BFF_PROFILE_SCOPE("lodSolve");
+    SolveStats stats;
+    stats.converged = true;
+    int m = coarseVertex.size();
+
+    // 少于两个固定顶点时保持输入（同全分辨率的共形求解）
+    if (fixed.size() < 2) return stats;
+
+    if (freeIndex.empty() || fixed != fixedVertices) {
+        fixedVertices = fixed;
+        std::vector<char> isFixed(m, 0);
+        for (int v : fixed) {
+            auto it = std::lower_bound(coarseVertex.begin(), coarseVertex.end(), v);
+            if (it != coarseVertex.end() && *it == v) isFixed[it - coarseVertex.begin()] = 1;
+        }
+        freeIndex.assign(2 * m, -1);
+        numFree = 0;
+        for (int i = 0; i < 2 * m; i++) {
+            if (!isFixed[i / 2]) freeIndex[i] = numFree++;
+        }
+        reduceDirichlet(lscm, freeIndex, numFree, reduced, coupling);
+        factor = LDLTFactorization();
+        factorValid = false;
+        if (numFree > 0) factorValid = factor.analyze(reduced) && factor.factorize(reduced);
+    }
+    if (numFree == 0) return stats;
+
+    std::vector<double> fixedCoord(2 * m), rhs(numFree), x(numFree);
+    for (int i = 0; i < m; i++) {
+        const Vec2& uv = uvs[coarseVertex[i]];
+        fixedCoord[2 * i] = uv.x;
+        fixedCoord[2 * i + 1] = uv.y;
+    }
+    for (int i = 0; i < 2 * m; i++) {
+        if (freeIndex[i] >= 0) x[freeIndex[i]] = fixedCoord[i];
+    }
+    coupling.multiply(fixedCoord.data(), rhs.data());
+    for (double& r : rhs) r = -r;
+
+    if (factorValid) {
+        x = rhs;
+        factor.solve(x);
+    } else {
+        stats = solvePCG(reduced, rhs, x, options);
+    }
+    for (int i = 0; i < 2 * m; i++) {
+        if (freeIndex[i] < 0) continue;
+        if (i % 2 == 0) uvs[coarseVertex[i / 2]].x = x[freeIndex[i]];
+        else uvs[coarseVertex[i / 2]].y = x[freeIndex[i]];
+    }
+
+    // 按收缩的逆序恢复被移除的顶点
+    for (int k = removed.size() - 1; k >= 0; k--) {
+        double u = 0, v = 0, w = 0;
+        for (int r = ringStart[k]; r < ringStart[k + 1]; r++) {
+            const Vec2& p = uvs[ringVertex[r]];
+            u += ringWeight[r] * p.x;
+            v += ringWeight[r] * p.y;
+            w += ringWeight[r];
+        }
+        uvs[removed[k]] = Vec2(Real(u / w), Real(v / w));
+    }
+    return stats;
+}
+
+} // namespace bff
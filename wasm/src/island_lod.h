@@ -0,0 +1,67 @@
+/**
+ * 片段的多分辨率近似，用于交互放置缝线时的快速预览
+ * 半边收缩只移除内部顶点（u -> v，u不是片段边界或固定点），片段边界（缝线和网格边界）原样保留，
+ * 粗网格与全分辨率网格的边界和固定顶点相同；在粗网格上求LSCM解，再按收缩的逆序把移除的顶点
+ * 插值回来（收缩时一环邻居按3D距离倒数加权的平均）
+ */
+
+#ifndef BFF_ISLAND_LOD_H
+#define BFF_ISLAND_LOD_H
+
+#include <vector>
+#include "scalar_types.h"
+#include "sparse_solver.h"
+
+namespace bff {
+
+class IslandLOD {
+public:
+    /**
+     * 收缩到至多targetVertices个顶点；保留顶点多于target或没有可收缩的边时提前停止
+     * @param points 片段局部顶点的3D坐标
+     * @param triangles 片段局部三角形
+     * @param keep 不可移除的顶点（片段边界和固定点）
+     */
+    void build(const std::vector<Vec3>& points, const std::vector<int>& triangles,
+               const std::vector<char>& keep, int targetVertices);
+
+    // 已按相同的目标顶点数和保留顶点集合建立
+    bool matches(int targetVertices, const std::vector<char>& keep) const {
+        return built && target == targetVertices && keep == keepMask;
+    }
+
+    int coarseVertexCount() const { return coarseVertex.size(); }
+    int coarseFaceCount() const { return coarseTriangles.size() / 3; }
+
+    /**
+     * 固定fixed中的顶点（取uvs中的坐标）求粗网格的LSCM解，再插值出全部顶点
+     * 固定顶点集合变化时重新分解，分解失败时退回PCG（options控制迭代次数和容差）
+     * @param fixed 固定的局部顶点（升序，须为保留顶点），少于两个时保持输入
+     */
+    SolveStats solve(std::vector<Vec2>& uvs, const std::vector<int>& fixed, const SolverOptions& options);
+
+private:
+    bool built = false;
+    int target = 0;
+    std::vector<char> keepMask;
+    std::vector<int> coarseVertex;       // 粗网格顶点 -> 局部顶点
+    std::vector<int> coarseTriangles;    // 粗网格三角形（粗网格顶点编号）
+    std::vector<int> removed;            // 按收缩顺序被移除的局部顶点
+    std::vector<int> ringStart;          // removed[k] 的插值邻居为 ringVertex[ringStart[k] .. ringStart[k+1])
+    std::vector<int> ringVertex;
+    std::vector<double> ringWeight;
+
+    // 粗网格上的LSCM系统（同 IslandCache 的共形求解）
+    CSRMatrix lscm;
+    std::vector<int> fixedVertices;      // 当前分解对应的固定顶点（局部编号）
+    std::vector<int> freeIndex;          // 粗网格LSCM变量 -> 自由变量编号，固定为-1
+    int numFree = 0;
+    CSRMatrix reduced;
+    CSRMatrix coupling;
+    LDLTFactorization factor;
+    bool factorValid = false;
+};
+
+} // namespace bff
+
+#endif // BFF_ISLAND_LOD_H
@@ -0,0 +1,87 @@
+/**
+ * 网格缓存容器的读写
+ */
+
+#include "mesh_cache.h"
+
+namespace bff {
+
+namespace {
+
+inline uint64_t align8(uint64_t x) {
+    return (x + 7) & ~uint64_t(7);
+}
+
+} // namespace
+
+void CacheWriter::finish(CacheHeader header, std::vector<uint8_t>& out) const {
+    uint64_t offset = align8(sizeof(CacheHeader) + sizeof(CacheSection) * sections.size());
+    std::vector<CacheSection> table;
+    table.reserve(sections.size());
+    for (const Pending& p : sections) {
+        table.push_back(CacheSection{p.id, p.elementSize, offset, p.count});
+        offset = align8(offset + uint64_t(p.elementSize) * p.count);
+    }
+
+    header.magic = kCacheMagic;
+    header.version = kCacheVersion;
+    header.headerSize = sizeof(CacheHeader);
+    header.sectionCount = sections.size();
+    header.totalSize = offset;
+
+    // 对齐填充为0，相同内容的缓存逐字节相同
+    out.assign(offset, 0);
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + sizeof(header), table.data(), sizeof(CacheSection) * table.size());
+    for (size_t i = 0; i < sections.size(); i++) {
+        size_t bytes = size_t(sections[i].elementSize) * sections[i].count;
+        if (bytes > 0) std::memcpy(out.data() + table[i].offset, sections[i].data, bytes);
+    }
+}
+
+bool CacheReader::open(const uint8_t* data, size_t size, std::string& error) {
+    base = data;
+    table.clear();
+
+    if (!data || size < sizeof(CacheHeader)) {
+        error = "Cache too small";
+        return false;
+    }
+    std::memcpy(&head, data, sizeof(head));
+    if (head.magic != kCacheMagic) {
+        error = "Not a BFF cache";
+        return false;
+    }
+    if (head.version != kCacheVersion || head.headerSize != sizeof(CacheHeader)) {
+        error = "Unsupported cache version";
+        return false;
+    }
+    uint64_t tableEnd = sizeof(CacheHeader) + uint64_t(sizeof(CacheSection)) * head.sectionCount;
+    if (head.totalSize > size || tableEnd > head.totalSize) {
+        error = "Truncated cache";
+        return false;
+    }
+
+    table.resize(head.sectionCount);
+    std::memcpy(table.data(), data + sizeof(CacheHeader), sizeof(CacheSection) * table.size());
+    for (const CacheSection& s : table) {
+        // 先检查元素大小和个数，避免乘法溢出
+        if (s.elementSize == 0 || s.elementSize > 64 || s.count > head.totalSize ||
+            s.offset < tableEnd || s.offset > head.totalSize ||
+            s.count * s.elementSize > head.totalSize - s.offset) {
+            error = "Corrupt cache section table";
+            table.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+const CacheSection* CacheReader::find(uint32_t id) const {
+    for (const CacheSection& s : table) {
+        if (s.id == id) return &s;
+    }
+    return nullptr;
+}
+
+} // namespace bff
@@ -0,0 +1,129 @@
+/**
+ * 网格缓存容器：网格、半边拓扑、缝线、片段划分和UV的二进制快照
+ * 重新打开同一网格时直接复制数组，跳过OBJ/JSON解析、半边构建和展开
+ *
+ * 布局（小端）：
+ *   CacheHeader（64字节）
+ *   CacheSection[sectionCount]（每项24字节）
+ *   各段数据，起始偏移8字节对齐
+ * 同一版本内只追加新的段类型；读取时忽略不认识的段
+ * 带顶点/面顺序段时，顶点、三角形、半边和缝线按内部编号存储，
+ * 非流形边、片段划分、切分后顶点和UV按调用方编号存储
+ */
+
+#ifndef BFF_MESH_CACHE_H
+#define BFF_MESH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "mesh cache layout assumes a little-endian target"
+#endif
+
+namespace bff {
+
+const uint32_t kCacheMagic = 0x43464642;   // "BFFC"
+const uint32_t kCacheVersion = 1;
+
+enum CacheSectionId : uint32_t {
+    CacheVertices = 1,           // double [3V]
+    CacheTriangles = 2,          // int32 [3F]
+    CacheHalfEdgeTwins = 3,      // int32 [3F]，半边3f+i的对偶半边，-1为边界
+    CacheNonManifoldEdges = 4,   // int32 [2N]，被超过两个面共享的边
+    CacheSeamEdges = 5,          // int32 [2S]，缝线边（无向，较小顶点在前）
+    CacheFacePieces = 6,         // int32 [F]，面 -> 片段
+    CacheUVFaces = 7,            // int32 [3F]，面的角 -> 切分后顶点
+    CacheSplitVertexSource = 8,  // int32 [V']，切分后顶点 -> 原顶点
+    CacheUVs = 9,                // double [2V']
+    CacheVertexOrder = 10,       // int32 [V]，内部顶点 -> 调用方顶点（仅重排过的网格）
+    CacheFaceOrder = 11          // int32 [F]，内部面 -> 调用方面
+};
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;         // sizeof(CacheHeader)
+    uint32_t sectionCount;
+    uint32_t numVertices;
+    uint32_t numFaces;
+    uint32_t numSplitVertices;   // 无片段划分时为0
+    uint32_t numIslands;
+    uint64_t totalSize;          // 整个容器的字节数
+    uint32_t reserved[6];
+};
+
+struct CacheSection {
+    uint32_t id;
+    uint32_t elementSize;
+    uint64_t offset;             // 相对容器起点
+    uint64_t count;              // 元素个数
+};
+
+static_assert(sizeof(CacheHeader) == 64, "CacheHeader layout is fixed");
+static_assert(sizeof(CacheSection) == 24, "CacheSection layout is fixed");
+
+/**
+ * 按顺序添加各段，finish时写出段表和数据
+ */
+class CacheWriter {
+public:
+    template <typename T>
+    void add(uint32_t id, const T* data, size_t count) {
+        sections.push_back(Pending{id, sizeof(T), count, reinterpret_cast<const uint8_t*>(data)});
+    }
+
+    void finish(CacheHeader header, std::vector<uint8_t>& out) const;
+
+private:
+    struct Pending {
+        uint32_t id;
+        uint32_t elementSize;
+        size_t count;
+        const uint8_t* data;
+    };
+    std::vector<Pending> sections;
+};
+
+/**
+ * 校验容器的头和段表（段越界、元素大小不符时失败），随后按类型取出段
+ * 不复制数据，data在读取期间须保持有效
+ */
+class CacheReader {
+public:
+    bool open(const uint8_t* data, size_t size, std::string& error);
+
+    const CacheHeader& header() const { return head; }
+
+    bool has(uint32_t id) const { return find(id) != nullptr; }
+
+    // 段的元素个数（不存在或元素大小不符时为0）
+    template <typename T>
+    size_t count(uint32_t id) const {
+        const CacheSection* s = find(id);
+        return s && s->elementSize == sizeof(T) ? s->count : 0;
+    }
+
+    // 把段复制到dst（段可能未按T对齐，逐字节复制）
+    template <typename T>
+    bool read(uint32_t id, T* dst, size_t expectedCount) const {
+        const CacheSection* s = find(id);
+        if (!s || s->elementSize != sizeof(T) || s->count != expectedCount) return false;
+        if (expectedCount > 0) std::memcpy(dst, base + s->offset, expectedCount * sizeof(T));
+        return true;
+    }
+
+private:
+    const uint8_t* base = nullptr;
+    CacheHeader head{};
+    std::vector<CacheSection> table;
+
+    const CacheSection* find(uint32_t id) const;
+};
+
+} // namespace bff
+
+#endif // BFF_MESH_CACHE_H
@@ -0,0 +1,125 @@
+/**
+ * 网格重排实现
+ */
+
+#include "mesh_reorder.h"
+#include "sparse_solver.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace bff {
+
+std::vector<int> rcmVertexOrder(const int* triangles, int numFaces, int numVertices) {
+    // 邻接图按CSR存储（只用稀疏结构，不填values），内部边两侧各记一次，排序后去重
+    CSRMatrix graph;
+    graph.rows = graph.cols = numVertices;
+    graph.rowPtr.assign(numVertices + 1, 0);
+    for (int h = 0; h < numFaces * 3; h++) {
+        graph.rowPtr[triangles[h] + 1] += 2;
+    }
+    for (int v = 0; v < numVertices; v++) graph.rowPtr[v + 1] += graph.rowPtr[v];
+
+    std::vector<int> fill(graph.rowPtr.begin(), graph.rowPtr.end() - 1);
+    graph.colIdx.resize(graph.rowPtr[numVertices]);
+    for (int f = 0; f < numFaces; f++) {
+        const int* face = &triangles[f * 3];
+        for (int i = 0; i < 3; i++) {
+            int a = face[i];
+            graph.colIdx[fill[a]++] = face[(i + 1) % 3];
+            graph.colIdx[fill[a]++] = face[(i + 2) % 3];
+        }
+    }
+
+    int out = 0;
+    for (int v = 0; v < numVertices; v++) {
+        int begin = graph.rowPtr[v];
+        int end = graph.rowPtr[v + 1];
+        std::sort(graph.colIdx.begin() + begin, graph.colIdx.begin() + end);
+        graph.rowPtr[v] = out;
+        for (int k = begin; k < end; k++) {
+            int c = graph.colIdx[k];
+            if (c != v && (out == graph.rowPtr[v] || graph.colIdx[out - 1] != c)) graph.colIdx[out++] = c;
+        }
+    }
+    graph.rowPtr[numVertices] = out;
+    graph.colIdx.resize(out);
+
+    return reverseCuthillMcKee(graph);
+}
+
+// 21位整数的每一位之间插入两个0
+static uint64_t spreadBits3(uint64_t x) {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffull;
+    x = (x | x << 16) & 0x1f0000ff0000ffull;
+    x = (x | x << 8) & 0x100f00f00f00f00full;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+    x = (x | x << 2) & 0x1249249249249249ull;
+    return x;
+}
+
+std::vector<int> mortonVertexOrder(const Vec3* vertices, int numVertices) {
+    std::vector<int> order(numVertices);
+    std::iota(order.begin(), order.end(), 0);
+    if (numVertices == 0) return order;
+
+    double lo[3] = {vertices[0].x, vertices[0].y, vertices[0].z};
+    double hi[3] = {lo[0], lo[1], lo[2]};
+    for (int v = 1; v < numVertices; v++) {
+        const double p[3] = {vertices[v].x, vertices[v].y, vertices[v].z};
+        for (int k = 0; k < 3; k++) {
+            lo[k] = std::min(lo[k], p[k]);
+            hi[k] = std::max(hi[k], p[k]);
+        }
+    }
+    // 三轴共用一个缩放，保持包围盒的长宽比
+    double extent = std::max(hi[0] - lo[0], std::max(hi[1] - lo[1], hi[2] - lo[2]));
+    double scale = extent > 0 ? double((1 << 21) - 1) / extent : 0;
+
+    std::vector<uint64_t> codes(numVertices);
+    for (int v = 0; v < numVertices; v++) {
+        const double p[3] = {vertices[v].x, vertices[v].y, vertices[v].z};
+        uint64_t code = 0;
+        for (int k = 0; k < 3; k++) {
+            // NaN坐标落在0格
+            double q = (p[k] - lo[k]) * scale;
+            uint64_t cell = q > 0 ? static_cast<uint64_t>(std::min(q, double((1 << 21) - 1))) : 0;
+            code |= spreadBits3(cell) << (2 - k);
+        }
+        codes[v] = code;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return codes[a] < codes[b]; });
+    return order;
+}
+
+std::vector<int> faceOrderByVertex(const int* triangles, int numFaces, const std::vector<int>& vertexRank) {
+    int numVertices = vertexRank.size();
+    std::vector<int> start(numVertices + 1, 0);
+    std::vector<int> key(numFaces);
+    for (int f = 0; f < numFaces; f++) {
+        const int* face = &triangles[f * 3];
+        key[f] = std::min(vertexRank[face[0]], std::min(vertexRank[face[1]], vertexRank[face[2]]));
+        start[key[f] + 1]++;
+    }
+    for (int v = 0; v < numVertices; v++) start[v + 1] += start[v];
+
+    std::vector<int> order(numFaces);
+    for (int f = 0; f < numFaces; f++) order[start[key[f]]++] = f;
+    return order;
+}
+
+void applyMeshOrder(std::vector<Vec3>& vertices, std::vector<int>& triangles,
+                    const std::vector<int>& vertexOrder, const std::vector<int>& vertexRank,
+                    const std::vector<int>& faceOrder) {
+    std::vector<Vec3> oldVertices(vertices);
+    for (size_t v = 0; v < vertexOrder.size(); v++) vertices[v] = oldVertices[vertexOrder[v]];
+
+    std::vector<int> oldTriangles(triangles);
+    for (size_t f = 0; f < faceOrder.size(); f++) {
+        const int* face = &oldTriangles[faceOrder[f] * 3];
+        for (int i = 0; i < 3; i++) triangles[f * 3 + i] = vertexRank[face[i]];
+    }
+}
+
+} // namespace bff
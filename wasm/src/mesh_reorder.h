@@ -0,0 +1,48 @@
+/**
+ * 网格顶点和面的重排
+ * 扫描得到的网格索引顺序接近随机，按连通关系（RCM）或空间位置（Morton曲线）重新编号后，
+ * 铺展、拉普拉斯组装、分解和ARAP对顶点数组的访问大体连续
+ * 所有顺序数组均为 新编号 -> 原编号
+ */
+
+#ifndef BFF_MESH_REORDER_H
+#define BFF_MESH_REORDER_H
+
+#include <vector>
+#include "scalar_types.h"
+
+namespace bff {
+
+// 上传网格时的重排方式
+enum class MeshOrdering {
+    Original = 0,   // 保持调用方顺序
+    RCM = 1,        // 顶点邻接图上的Reverse Cuthill-McKee
+    Morton = 2      // 顶点坐标的Morton（Z序）曲线
+};
+
+/**
+ * 顶点邻接图（共享一条边即相邻）上的RCM顺序，各连通分量从度数最小的顶点开始
+ */
+std::vector<int> rcmVertexOrder(const int* triangles, int numFaces, int numVertices);
+
+/**
+ * 按包围盒量化到每轴21位后的Morton码排序，码相同时保持原顺序
+ */
+std::vector<int> mortonVertexOrder(const Vec3* vertices, int numVertices);
+
+/**
+ * 面按其最小的顶点新编号稳定排序（计数排序）
+ * @param vertexRank 原顶点 -> 新编号
+ */
+std::vector<int> faceOrderByVertex(const int* triangles, int numFaces, const std::vector<int>& vertexRank);
+
+/**
+ * 按顺序原地重排顶点和面，并把面索引换成新顶点编号；每个面的角顺序不变
+ */
+void applyMeshOrder(std::vector<Vec3>& vertices, std::vector<int>& triangles,
+                    const std::vector<int>& vertexOrder, const std::vector<int>& vertexRank,
+                    const std::vector<int>& faceOrder);
+
+} // namespace bff
+
+#endif // BFF_MESH_REORDER_H
@@ -0,0 +1,406 @@
+/**
+ * OBJ流式读取实现
+ */
+
+#include "obj_reader.h"
+#include "bff_flattener.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+
+namespace bff {
+
+namespace {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline const char* skipSpace(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) p++;
+    return p;
+}
+
+/**
+ * 解析浮点数并前移p
+ * 有效数字不超过15位且十进制指数不超过22时，m * 10^e 只有一次舍入，结果与strtod相同；
+ * 其余情况（以及nan/inf）交给strtod。行末总有'\n'或'\0'，strtod不会越过行尾
+ */
+bool parseDouble(const char*& p, const char* end, double& out) {
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    p = skipSpace(p, end);
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+    uint64_t mantissa = 0;
+    int digits = 0;        // 有效数字位数（去掉前导零）
+    int exponent = 0;
+    bool any = false;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        any = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa) digits++;
+        } else {
+            exponent++;
+            digits++;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+            any = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa) digits++;
+                exponent--;
+            } else {
+                digits++;
+            }
+        }
+    }
+    if (any && p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool expNegative = false;
+        if (q < end && (*q == '-' || *q == '+')) expNegative = *q++ == '-';
+        if (q < end && *q >= '0' && *q <= '9') {
+            int e = 0;
+            for (; q < end && *q >= '0' && *q <= '9'; q++) {
+                if (e < 100000) e = e * 10 + (*q - '0');
+            }
+            exponent += expNegative ? -e : e;
+            p = q;
+        }
+    }
+
+    if (any && digits <= 15 && exponent >= -22 && exponent <= 22) {
+        double value = double(mantissa);
+        value = exponent < 0 ? value / pow10[-exponent] : value * pow10[exponent];
+        out = negative ? -value : value;
+        return true;
+    }
+
+    char* stop = nullptr;
+    double value = std::strtod(start, &stop);
+    if (stop == start) {
+        p = start;
+        return false;
+    }
+    p = stop;
+    out = value;
+    return true;
+}
+
+bool parseInt(const char*& p, const char* end, int& out) {
+    bool negative = false;
+    const char* q = p;
+    if (q < end && (*q == '-' || *q == '+')) negative = *q++ == '-';
+    if (q >= end || *q < '0' || *q > '9') return false;
+    long long value = 0;
+    for (; q < end && *q >= '0' && *q <= '9'; q++) {
+        if (value < (1ll << 40)) value = value * 10 + (*q - '0');
+    }
+    p = q;
+    value = negative ? -value : value;
+    out = value > INT32_MAX ? INT32_MAX : value < INT32_MIN ? INT32_MIN : int(value);
+    return true;
+}
+
+// OBJ索引从1开始，负数相对于当前已读的元素数
+inline int resolveIndex(int index, int count) {
+    if (index > 0) return index - 1;
+    if (index < 0) return count + index;
+    return -1;
+}
+
+inline uint64_t coordBits(double x) {
+    x += 0.0;   // -0 与 +0 合并
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+} // namespace
+
+ObjReader::ObjReader(const ObjReadOptions& opts) {
+    reset(opts);
+}
+
+void ObjReader::reset(const ObjReadOptions& opts) {
+    options = opts;
+    carry.clear();
+    finished = false;
+    positionData.clear();
+    colorData.clear();
+    texcoordData.clear();
+    normalData.clear();
+    triangleData.clear();
+    cornerTexcoord.clear();
+    cornerNormal.clear();
+    trianglePolygon.clear();
+    remap.clear();
+    polygonCount = 0;
+    skippedFaces = 0;
+    errorMsg.clear();
+}
+
+void ObjReader::feed(const char* data, size_t size) {
+    if (finished || size == 0) return;
+    const char* p = data;
+    const char* end = data + size;
+
+    // 先补全上一块留下的半行
+    if (!carry.empty()) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', size));
+        if (!nl) {
+            carry.append(p, size);
+            return;
+        }
+        carry.append(p, nl - p);
+        parseLine(carry.data(), carry.data() + carry.size());
+        carry.clear();
+        p = nl + 1;
+    }
+
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!nl) {
+            carry.assign(p, end - p);
+            break;
+        }
+        parseLine(p, nl);
+        p = nl + 1;
+    }
+}
+
+void ObjReader::parseLine(const char* p, const char* end) {
+    p = skipSpace(p, end);
+    if (end - p < 2) return;
+
+    if (p[0] == 'v') {
+        if (isSpace(p[1])) {
+            parseVertex(p + 1, end);
+        } else if (p[1] == 't' && end - p > 2 && isSpace(p[2])) {
+            const char* q = p + 2;
+            double u = 0, v = 0;
+            parseDouble(q, end, u) && parseDouble(q, end, v);
+            texcoordData.push_back(u);
+            texcoordData.push_back(v);
+        } else if (p[1] == 'n' && end - p > 2 && isSpace(p[2])) {
+            const char* q = p + 2;
+            double n[3] = {0, 0, 0};
+            for (int i = 0; i < 3 && parseDouble(q, end, n[i]); i++) {}
+            normalData.insert(normalData.end(), {float(n[0]), float(n[1]), float(n[2])});
+        }
+    } else if (p[0] == 'f' && isSpace(p[1])) {
+        parseFace(p + 1, end);
+    }
+    // 注释、o/g/usemtl/s 等其他行忽略
+}
+
+void ObjReader::parseVertex(const char* p, const char* end) {
+    double value[6] = {0, 0, 0, 0, 0, 0};
+    int count = 0;
+    while (count < 6 && parseDouble(p, end, value[count])) count++;
+
+    int index = positionData.size() / 3;
+    positionData.insert(positionData.end(), {value[0], value[1], value[2]});
+
+    // 第一个带颜色的顶点出现时，之前的顶点补白色
+    if (count >= 6) {
+        if (colorData.empty() && index > 0) colorData.assign(index * 3, 1.0f);
+        colorData.insert(colorData.end(), {float(value[3]), float(value[4]), float(value[5])});
+    } else if (!colorData.empty()) {
+        colorData.insert(colorData.end(), {1.0f, 1.0f, 1.0f});
+    }
+}
+
+void ObjReader::parseFace(const char* p, const char* end) {
+    int polygon = polygonCount++;
+    int numPositions = positionData.size() / 3;
+    int numTexcoords = texcoordData.size() / 2;
+    int numNormals = normalData.size() / 3;
+
+    polyVertex.clear();
+    polyTexcoord.clear();
+    polyNormal.clear();
+    bool valid = true;
+    bool anyTexcoord = false, anyNormal = false;
+
+    // 角的格式：v、v/vt、v//vn、v/vt/vn
+    for (;;) {
+        p = skipSpace(p, end);
+        if (p >= end) break;
+
+        int v = 0, vt = 0, vn = 0;
+        if (!parseInt(p, end, v)) valid = false;
+        if (p < end && *p == '/') {
+            p++;
+            parseInt(p, end, vt);
+            if (p < end && *p == '/') {
+                p++;
+                parseInt(p, end, vn);
+            }
+        }
+        while (p < end && !isSpace(*p)) p++;
+
+        int vi = resolveIndex(v, numPositions);
+        if (vi < 0) valid = false;
+        polyVertex.push_back(vi);
+        polyTexcoord.push_back(vt ? resolveIndex(vt, numTexcoords) : -1);
+        polyNormal.push_back(vn ? resolveIndex(vn, numNormals) : -1);
+        anyTexcoord = anyTexcoord || vt != 0;
+        anyNormal = anyNormal || vn != 0;
+    }
+
+    int corners = polyVertex.size();
+    if (!valid || corners < 3) {
+        skippedFaces++;
+        return;
+    }
+
+    // 第一个带vt/vn的面出现时，之前的角补-1
+    if (anyTexcoord && cornerTexcoord.empty()) cornerTexcoord.assign(triangleData.size(), -1);
+    if (anyNormal && cornerNormal.empty()) cornerNormal.assign(triangleData.size(), -1);
+
+    // 扇形三角化 (0, k, k+1)
+    for (int k = 1; k + 1 < corners; k++) {
+        const int corner[3] = {0, k, k + 1};
+        for (int c : corner) {
+            triangleData.push_back(polyVertex[c]);
+            if (!cornerTexcoord.empty()) cornerTexcoord.push_back(polyTexcoord[c]);
+            if (!cornerNormal.empty()) cornerNormal.push_back(polyNormal[c]);
+        }
+        trianglePolygon.push_back(polygon);
+    }
+}
+
+bool ObjReader::finish() {
+    if (!finished) {
+        if (!carry.empty()) {
+            parseLine(carry.data(), carry.data() + carry.size());
+            carry.clear();
+            carry.shrink_to_fit();
+        }
+        dedupVertices();
+        validateTriangles();
+        finished = true;
+    }
+
+    if (triangleData.empty()) {
+        errorMsg = "No valid faces in OBJ";
+        return false;
+    }
+    return true;
+}
+
+void ObjReader::dedupVertices() {
+    int n = positionData.size() / 3;
+    remap.resize(n);
+    if (!options.dedupVertices) {
+        std::iota(remap.begin(), remap.end(), 0);
+        return;
+    }
+
+    // 开放寻址：表中存合并后的顶点，合并后的坐标原地前移（新下标不大于旧下标）
+    size_t capacity = 16;
+    while (capacity < size_t(n) * 2) capacity <<= 1;
+    std::vector<int> table(capacity, -1);
+    size_t mask = capacity - 1;
+    double* pos = positionData.data();
+    bool colors = !colorData.empty();
+
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        double x = pos[i * 3], y = pos[i * 3 + 1], z = pos[i * 3 + 2];
+        uint64_t h = coordBits(x) * 0x9E3779B97F4A7C15ull;
+        h = (h ^ coordBits(y)) * 0xC2B2AE3D27D4EB4Full;
+        h = (h ^ coordBits(z)) * 0x165667B19E3779F9ull;
+        size_t slot = (h ^ (h >> 32)) & mask;
+
+        int found = -1;
+        while (table[slot] >= 0) {
+            int j = table[slot];
+            if (pos[j * 3] == x && pos[j * 3 + 1] == y && pos[j * 3 + 2] == z) {
+                found = j;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (found >= 0) {
+            remap[i] = found;
+            continue;
+        }
+
+        table[slot] = count;
+        pos[count * 3] = x;
+        pos[count * 3 + 1] = y;
+        pos[count * 3 + 2] = z;
+        if (colors) {
+            for (int c = 0; c < 3; c++) colorData[count * 3 + c] = colorData[i * 3 + c];
+        }
+        remap[i] = count++;
+    }
+    positionData.resize(count * 3);
+    if (colors) colorData.resize(count * 3);
+}
+
+void ObjReader::validateTriangles() {
+    int numFileVertices = remap.size();
+    int numTexcoords = texcoordData.size() / 2;
+    int numNormals = normalData.size() / 3;
+    bool texcoords = !cornerTexcoord.empty();
+    bool normals = !cornerNormal.empty();
+
+    // 索引越界的三角形和合并顶点后退化的三角形剔除，其余原地前移
+    int numTris = triangleData.size() / 3;
+    int out = 0;
+    for (int t = 0; t < numTris; t++) {
+        int v[3];
+        bool valid = true;
+        for (int k = 0; k < 3; k++) {
+            int raw = triangleData[t * 3 + k];
+            valid = valid && raw >= 0 && raw < numFileVertices;
+            v[k] = valid ? remap[raw] : -1;
+        }
+        if (!valid || v[0] == v[1] || v[1] == v[2] || v[2] == v[0]) {
+            skippedFaces++;
+            continue;
+        }
+
+        for (int k = 0; k < 3; k++) {
+            triangleData[out * 3 + k] = v[k];
+            if (texcoords) {
+                int vt = cornerTexcoord[t * 3 + k];
+                cornerTexcoord[out * 3 + k] = vt >= 0 && vt < numTexcoords ? vt : -1;
+            }
+            if (normals) {
+                int vn = cornerNormal[t * 3 + k];
+                cornerNormal[out * 3 + k] = vn >= 0 && vn < numNormals ? vn : -1;
+            }
+        }
+        trianglePolygon[out] = trianglePolygon[t];
+        out++;
+    }
+
+    triangleData.resize(out * 3);
+    trianglePolygon.resize(out);
+    if (texcoords) cornerTexcoord.resize(out * 3);
+    if (normals) cornerNormal.resize(out * 3);
+}
+
+bool ObjReader::loadInto(BFFFlattener& flattener) const {
+    if (!finished || triangleData.empty()) return false;
+    Real* vertices = flattener.vertexUploadBuffer(numVertices());
+    for (size_t i = 0; i < positionData.size(); i++) vertices[i] = static_cast<Real>(positionData[i]);
+    std::memcpy(flattener.faceUploadBuffer(numTriangles()), triangleData.data(),
+                sizeof(int) * triangleData.size());
+    return flattener.commitMeshUpload();
+}
+
+} // namespace bff
@@ -0,0 +1,98 @@
+/**
+ * OBJ流式读取（OBJParser.js 的原生实现）
+ * 按任意大小的字节块读入，逐行解析 v / vt / vn / f，直接得到展开器需要的扁平数组，
+ * 不经过JS字符串和逐顶点对象；多边形按扇形三角化
+ * 支持带顶点颜色的格式：v x y z r g b（SeamExtractor按颜色提取缝线）
+ */
+
+#ifndef BFF_OBJ_READER_H
+#define BFF_OBJ_READER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace bff {
+
+class BFFFlattener;
+
+struct ObjReadOptions {
+    // 合并坐标完全相同的顶点（扫描和导出工具常按面重复输出顶点，不合并时网格处处是边界）
+    bool dedupVertices = true;
+};
+
+class ObjReader {
+public:
+    explicit ObjReader(const ObjReadOptions& options = ObjReadOptions());
+
+    /**
+     * 清空结果，开始读取新文件
+     */
+    void reset(const ObjReadOptions& options);
+
+    /**
+     * 读入一块字节，块边界可以落在行中间（未结束的行留到下一块）
+     */
+    void feed(const char* data, size_t size);
+
+    /**
+     * 文件读完：解析最后一行，合并重复顶点，检查索引并剔除退化三角形
+     * @return 至少有一个有效三角形
+     */
+    bool finish();
+
+    /**
+     * 把顶点和三角形写入展开器的网格存储（等同于 setMesh）
+     */
+    bool loadInto(BFFFlattener& flattener) const;
+
+    // 以下结果在finish后有效
+    int numVertices() const { return positionData.size() / 3; }
+    int numTriangles() const { return triangleData.size() / 3; }
+    int numPolygons() const { return polygonCount; }
+    int numSkippedFaces() const { return skippedFaces; }
+    bool hasVertexColors() const { return !colorData.empty(); }
+
+    const std::vector<double>& positions() const { return positionData; }    // [x,y,z, ...]
+    const std::vector<float>& colors() const { return colorData; }           // [r,g,b, ...]，无颜色时为空，未标颜色的顶点为白色
+    const std::vector<float>& texcoords() const { return texcoordData; }     // [u,v, ...]
+    const std::vector<float>& normals() const { return normalData; }         // [x,y,z, ...]
+    const std::vector<int>& triangles() const { return triangleData; }       // [a,b,c, ...]
+    const std::vector<int>& triangleTexcoords() const { return cornerTexcoord; }  // 每个角的vt索引（-1为无），文件无vt时为空
+    const std::vector<int>& triangleNormals() const { return cornerNormal; }      // 每个角的vn索引（-1为无），文件无vn时为空
+    const std::vector<int>& trianglePolygons() const { return trianglePolygon; }  // 三角形 -> 文件中的f行序号
+    const std::vector<int>& vertexRemap() const { return remap; }                 // 文件中的顶点 -> 合并后顶点
+
+    const std::string& getError() const { return errorMsg; }
+
+private:
+    ObjReadOptions options;
+    std::string carry;             // 上一块末尾未结束的行
+    bool finished = false;
+
+    std::vector<double> positionData;
+    std::vector<float> colorData;
+    std::vector<float> texcoordData;
+    std::vector<float> normalData;
+    std::vector<int> triangleData;
+    std::vector<int> cornerTexcoord;
+    std::vector<int> cornerNormal;
+    std::vector<int> trianglePolygon;
+    std::vector<int> remap;
+    int polygonCount = 0;
+    int skippedFaces = 0;
+    std::string errorMsg;
+
+    // f行的角，解析时复用
+    std::vector<int> polyVertex, polyTexcoord, polyNormal;
+
+    void parseLine(const char* p, const char* end);
+    void parseVertex(const char* p, const char* end);
+    void parseFace(const char* p, const char* end);
+    void dedupVertices();
+    void validateTriangles();
+};
+
+} // namespace bff
+
+#endif // BFF_OBJ_READER_H
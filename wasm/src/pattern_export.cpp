@@ -0,0 +1,276 @@
+/**
+ * 纸样导出实现
+ */
+
+#include "pattern_export.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace bff {
+
+namespace {
+
+void appendf(std::string& out, const char* format, double a, double b) {
+    char buffer[96];
+    int n = std::snprintf(buffer, sizeof(buffer), format, a, b);
+    if (n > 0) out.append(buffer, std::min(n, int(sizeof(buffer)) - 1));
+}
+
+} // namespace
+
+bool PatternExporter::hasEdge(int a, int b) const {
+    for (int i = edgeStart[a]; i < edgeStart[a + 1]; i++) {
+        if (edgeTarget[i] == b) return true;
+    }
+    return false;
+}
+
+void PatternExporter::begin(const ExportSource& source, const ExportOptions& options) {
+    BFF_PROFILE_SCOPE("exportBegin");
+    src = source;
+    opts = options;
+    opts.chunkSize = std::max(opts.chunkSize, 256);
+    int numPieces = std::max(src.numPieces, 1);
+    int numHE = src.numFaces * 3;
+    auto pieceOf = [&](int f) { return src.facePiece ? src.facePiece[f] : 0; };
+    auto nextCorner = [](int h) { return h - h % 3 + (h + 1) % 3; };
+
+    edgeStart.assign(src.numUVs + 1, 0);
+    edgeTarget.resize(numHE);
+    for (int h = 0; h < numHE; h++) edgeStart[src.uvFaces[h] + 1]++;
+    for (int i = 0; i < src.numUVs; i++) edgeStart[i + 1] += edgeStart[i];
+    {
+        std::vector<int> fill(edgeStart.begin(), edgeStart.end() - 1);
+        for (int h = 0; h < numHE; h++) edgeTarget[fill[src.uvFaces[h]]++] = src.uvFaces[nextCorner(h)];
+    }
+
+    // 边界边按起点建表，沿终点查下一条边得到闭合环；边界上的非流形顶点有多条出边时任取一条
+    std::vector<int> boundaryStart(src.numUVs + 1, 0), boundaryTarget, boundaryPiece;
+    std::vector<int> boundaryHE;
+    for (int h = 0; h < numHE; h++) {
+        int a = src.uvFaces[h], b = src.uvFaces[nextCorner(h)];
+        if (!hasEdge(b, a)) {
+            boundaryStart[a + 1]++;
+            boundaryHE.push_back(h);
+        }
+    }
+    for (int i = 0; i < src.numUVs; i++) boundaryStart[i + 1] += boundaryStart[i];
+    boundaryTarget.resize(boundaryHE.size());
+    boundaryPiece.resize(boundaryHE.size());
+    {
+        std::vector<int> fill(boundaryStart.begin(), boundaryStart.end() - 1);
+        for (int h : boundaryHE) {
+            int i = fill[src.uvFaces[h]]++;
+            boundaryTarget[i] = src.uvFaces[nextCorner(h)];
+            boundaryPiece[i] = pieceOf(h / 3);
+        }
+    }
+
+    std::vector<int> rawStart(1, 0), rawVertex, rawPiece;
+    std::vector<char> used(boundaryTarget.size(), 0);
+    std::vector<int> unusedFrom(boundaryStart.begin(), boundaryStart.end() - 1);
+    auto takeEdge = [&](int v) {
+        for (int& i = unusedFrom[v]; i < boundaryStart[v + 1]; i++) {
+            if (!used[i]) {
+                used[i] = 1;
+                return i;
+            }
+        }
+        return -1;
+    };
+    for (int v = 0; v < src.numUVs; v++) {
+        int e;
+        while ((e = takeEdge(v)) >= 0) {
+            rawPiece.push_back(boundaryPiece[e]);
+            rawVertex.push_back(v);
+            for (int w = boundaryTarget[e]; w != v && (e = takeEdge(w)) >= 0; w = boundaryTarget[e]) {
+                rawVertex.push_back(w);
+            }
+            rawStart.push_back(rawVertex.size());
+        }
+    }
+
+    // 环按片段排序（片段内保持发现顺序）
+    int numLoops = rawPiece.size();
+    std::vector<int> order(numLoops);
+    for (int i = 0; i < numLoops; i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return rawPiece[a] < rawPiece[b]; });
+    loopStart.assign(1, 0);
+    loopVertex.clear();
+    loopVertex.reserve(rawVertex.size());
+    loopPiece.resize(numLoops);
+    for (int i = 0; i < numLoops; i++) {
+        int l = order[i];
+        loopVertex.insert(loopVertex.end(), rawVertex.begin() + rawStart[l], rawVertex.begin() + rawStart[l + 1]);
+        loopStart.push_back(loopVertex.size());
+        loopPiece[i] = rawPiece[l];
+    }
+
+    pieceFaceStart.assign(numPieces + 1, 0);
+    pieceFace.clear();
+    if (opts.interiorEdges) {
+        for (int f = 0; f < src.numFaces; f++) pieceFaceStart[pieceOf(f) + 1]++;
+        for (int p = 0; p < numPieces; p++) pieceFaceStart[p + 1] += pieceFaceStart[p];
+        pieceFace.resize(src.numFaces);
+        std::vector<int> fill(pieceFaceStart.begin(), pieceFaceStart.end() - 1);
+        for (int f = 0; f < src.numFaces; f++) pieceFace[fill[pieceOf(f)]++] = f;
+    }
+
+    // 包围盒只统计被面引用的UV
+    bool any = false;
+    for (int h = 0; h < numHE; h++) {
+        double u = src.uvs[src.uvFaces[h] * 2], v = src.uvs[src.uvFaces[h] * 2 + 1];
+        if (!any || u < minU) minU = u;
+        if (!any || u > maxU) maxU = u;
+        if (!any || v < minV) minV = v;
+        if (!any || v > maxV) maxV = v;
+        any = true;
+    }
+    if (!any) minU = minV = maxU = maxV = 0;
+    pad = opts.padding >= 0 ? opts.padding : 0.02 * std::max(maxU - minU, maxV - minV) * opts.scale;
+
+    stage = Stage::Header;
+    piece = 0;
+    loop = 0;
+    loopPos = 0;
+    cursor = 0;
+    svgPath = 0;
+}
+
+bool PatternExporter::next(std::string& chunk) {
+    chunk.clear();
+    while (stage != Stage::Done && (int)chunk.size() < opts.chunkSize) step(chunk);
+    return !chunk.empty();
+}
+
+void PatternExporter::point(int uv, double& x, double& y) const {
+    double u = src.uvs[uv * 2], v = src.uvs[uv * 2 + 1];
+    if (opts.format == ExportFormat::SVG) {
+        x = (u - minU) * opts.scale + pad;
+        y = (maxV - v) * opts.scale + pad;
+    } else {
+        x = (u - minU) * opts.scale;
+        y = (v - minV) * opts.scale;
+    }
+}
+
+void PatternExporter::emitHeader(std::string& out) const {
+    double width = (maxU - minU) * opts.scale;
+    double height = (maxV - minV) * opts.scale;
+    if (opts.format == ExportFormat::SVG) {
+        double w = width + pad * 2, h = height + pad * 2;
+        char buffer[512];
+        std::snprintf(buffer, sizeof(buffer),
+                      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                      "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%.6g\" height=\"%.6g\" viewBox=\"0 0 %.6g %.6g\">\n"
+                      "  <style>.piece { fill: none; stroke: #000; stroke-width: %.6g; fill-rule: evenodd; }"
+                      " .mesh { fill: none; stroke: #888; stroke-width: %.6g; }</style>\n",
+                      w, h, w, h, std::max(w, h) * 1e-3, std::max(w, h) * 5e-4);
+        out += buffer;
+    } else {
+        out += "0\nSECTION\n2\nHEADER\n9\n$ACADVER\n1\nAC1009\n";
+        appendf(out, "9\n$EXTMIN\n10\n%.6f\n20\n%.6f\n", 0, 0);
+        appendf(out, "9\n$EXTMAX\n10\n%.6f\n20\n%.6f\n", width, height);
+        out += "0\nENDSEC\n0\nSECTION\n2\nENTITIES\n";
+    }
+}
+
+// SVG：切换当前片段的path（1边界，2内部网格边，0关闭）
+void PatternExporter::setSvgPath(int path, std::string& out) {
+    if (svgPath == path) return;
+    if (svgPath != 0) out += "\"/>\n";
+    svgPath = path;
+    if (path != 0) {
+        out += path == 1 ? "  <path class=\"piece\" data-piece=\"" : "  <path class=\"mesh\" data-piece=\"";
+        out += std::to_string(piece);
+        out += "\" d=\"";
+    }
+}
+
+void PatternExporter::emitLoopVertex(std::string& out) {
+    int begin = loopStart[loop], count = loopStart[loop + 1] - begin;
+    double x, y;
+    if (opts.format == ExportFormat::SVG) {
+        setSvgPath(1, out);
+        if (loopPos < count) {
+            point(loopVertex[begin + loopPos], x, y);
+            appendf(out, loopPos == 0 ? "M%.4f %.4f" : "L%.4f %.4f", x, y);
+        } else {
+            out += "Z";
+        }
+    } else {
+        if (loopPos == 0) out += "0\nPOLYLINE\n8\n1\n66\n1\n70\n1\n10\n0.0\n20\n0.0\n30\n0.0\n";
+        if (loopPos < count) {
+            point(loopVertex[begin + loopPos], x, y);
+            appendf(out, "0\nVERTEX\n8\n1\n10\n%.6f\n20\n%.6f\n30\n0.0\n", x, y);
+        } else {
+            out += "0\nSEQEND\n8\n1\n";
+        }
+    }
+    if (++loopPos > count) {
+        loop++;
+        loopPos = 0;
+    }
+}
+
+// 每条内部边只在 a < b 的一侧输出
+void PatternExporter::emitInteriorFace(int face, std::string& out) {
+    if (opts.format == ExportFormat::SVG) setSvgPath(2, out);
+    for (int k = 0; k < 3; k++) {
+        int a = src.uvFaces[face * 3 + k], b = src.uvFaces[face * 3 + (k + 1) % 3];
+        if (a >= b || !hasEdge(b, a)) continue;
+        double x1, y1, x2, y2;
+        point(a, x1, y1);
+        point(b, x2, y2);
+        if (opts.format == ExportFormat::SVG) {
+            appendf(out, "M%.4f %.4f", x1, y1);
+            appendf(out, "L%.4f %.4f", x2, y2);
+        } else {
+            out += "0\nLINE\n8\n8\n";
+            appendf(out, "10\n%.6f\n20\n%.6f\n30\n0.0\n", x1, y1);
+            appendf(out, "11\n%.6f\n21\n%.6f\n31\n0.0\n", x2, y2);
+        }
+    }
+}
+
+void PatternExporter::step(std::string& out) {
+    int numPieces = std::max(src.numPieces, 1);
+    switch (stage) {
+        case Stage::Header:
+            emitHeader(out);
+            stage = Stage::Loops;
+            break;
+        case Stage::Loops:
+            if (piece >= numPieces) {
+                stage = Stage::Footer;
+            } else if (loop < (int)loopPiece.size() && loopPiece[loop] == piece) {
+                emitLoopVertex(out);
+            } else if (opts.interiorEdges) {
+                cursor = pieceFaceStart[piece];
+                stage = Stage::Interior;
+            } else {
+                setSvgPath(0, out);
+                piece++;
+            }
+            break;
+        case Stage::Interior:
+            if (cursor < pieceFaceStart[piece + 1]) {
+                emitInteriorFace(pieceFace[cursor++], out);
+            } else {
+                setSvgPath(0, out);
+                piece++;
+                stage = Stage::Loops;
+            }
+            break;
+        case Stage::Footer:
+            setSvgPath(0, out);
+            out += opts.format == ExportFormat::SVG ? "</svg>\n" : "0\nENDSEC\n0\nEOF\n";
+            stage = Stage::Done;
+            break;
+        case Stage::Done:
+            break;
+    }
+}
+
+} // namespace bff
@@ -0,0 +1,99 @@
+/**
+ * 纸样导出（SVG / DXF），分块生成
+ * 直接读取UV和片段缓冲区：每个片段的边界（切分后网格中没有反向边的边，缝线切开后也是边界）
+ * 首尾相接成闭合折线，可选输出片段内部的网格边；输出按块生成，调用方逐块写出（文件、WritableStream），
+ * 无论纸样多大，同时存在的输出文本只有一块
+ *
+ * DXF为R12 ASCII（POLYLINE/VERTEX、LINE），边界在图层 "1"、内部网格边在图层 "8"（同AAMA纸样DXF的
+ * 裁剪线和内部线图层），坐标v轴向上；SVG的y轴向下，画布按全部UV的包围盒
+ */
+
+#ifndef BFF_PATTERN_EXPORT_H
+#define BFF_PATTERN_EXPORT_H
+
+#include <string>
+#include <vector>
+#include "scalar_types.h"
+
+namespace bff {
+
+enum class ExportFormat {
+    SVG = 0,
+    DXF = 1
+};
+
+struct ExportOptions {
+    ExportFormat format = ExportFormat::SVG;
+    bool interiorEdges = false;      // 同时输出片段内部的网格边
+    double scale = 1;                // UV单位 -> 输出单位
+    double padding = 0;              // SVG画布四周的留白（输出单位）；<0时取包围盒较长边的2%
+    int chunkSize = 64 * 1024;       // 每块的目标字节数
+};
+
+// 导出的数据，不复制：导出结束前各缓冲区必须保持不变
+struct ExportSource {
+    const Real* uvs = nullptr;       // [u0,v0, u1,v1, ...]
+    int numUVs = 0;
+    const int* uvFaces = nullptr;    // 每个面三个角的UV索引 [3F]
+    int numFaces = 0;
+    const int* facePiece = nullptr;  // 面 -> 片段，nullptr时全部面属于片段0
+    int numPieces = 1;
+};
+
+class PatternExporter {
+public:
+    /**
+     * 开始导出：建立各片段的边界环，之后反复调用next取得输出
+     * uvFaces和facePiece的编号需在范围内（调用方检查）
+     */
+    void begin(const ExportSource& source, const ExportOptions& options);
+
+    /**
+     * 生成下一块，通常不短于chunkSize字节（最后一块可能更短）
+     * @return 全部输出后返回false，chunk为空
+     */
+    bool next(std::string& chunk);
+
+    bool finished() const { return stage == Stage::Done; }
+
+    int loopCount() const { return loopPiece.size(); }
+
+private:
+    enum class Stage { Header, Loops, Interior, Footer, Done };
+
+    ExportSource src;
+    ExportOptions opts;
+    double minU = 0, minV = 0, maxU = 0, maxV = 0;
+    double pad = 0;
+
+    // UV有向边的邻接表（CSR），边 a -> b 没有反向边时为边界边
+    std::vector<int> edgeStart;
+    std::vector<int> edgeTarget;
+
+    // 边界环，按片段排序
+    std::vector<int> loopStart;      // 环i的顶点为 loopVertex[loopStart[i] .. loopStart[i+1])
+    std::vector<int> loopVertex;
+    std::vector<int> loopPiece;
+    std::vector<int> pieceFaceStart; // 片段p的面为 pieceFace[pieceFaceStart[p] .. pieceFaceStart[p+1])
+    std::vector<int> pieceFace;
+
+    // 生成位置
+    Stage stage = Stage::Done;
+    int piece = 0;                   // 当前片段
+    int loop = 0;                    // 当前边界环
+    int loopPos = 0;                 // 当前环内的下一个顶点
+    int cursor = 0;                  // 当前片段内的下一个面
+    int svgPath = 0;                 // SVG：当前片段已打开的path，0无，1边界，2内部网格边
+
+    bool hasEdge(int a, int b) const;
+    void step(std::string& out);
+    void emitHeader(std::string& out) const;
+    void emitLoopVertex(std::string& out);
+    void emitInteriorFace(int face, std::string& out);
+    void setSvgPath(int path, std::string& out);
+    void point(int uv, double& x, double& y) const;
+};
+
+} // namespace bff
+
+#endif // BFF_PATTERN_EXPORT_H
@@ -0,0 +1,207 @@
+/**
+ * 差异化弹性松弛实现（XPBD）
+ */
+
+#include "physics_solver.h"
+#include "bff_flattener.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace bff {
+
+void PhysicsSolver::setup(const Vec3* vertices, int numVerts,
+                          const int* triangles, int numFaces,
+                          const PhysicsOptions& opts) {
+    options = opts;
+    numVertices = numVerts;
+    converged = false;
+
+    // 无向边排序分组，出现一次的为边界边
+    std::vector<uint64_t> edges;
+    edges.reserve(numFaces * 3);
+    for (int f = 0; f < numFaces; f++) {
+        for (int i = 0; i < 3; i++) {
+            uint32_t a = triangles[f * 3 + i];
+            uint32_t b = triangles[f * 3 + (i + 1) % 3];
+            if (a > b) std::swap(a, b);
+            edges.push_back((uint64_t(a) << 32) | b);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    constraintA.clear();
+    constraintB.clear();
+    restLength.clear();
+    stiffness.clear();
+    boundaryCount = 0;
+    double restSum = 0;
+
+    // 边界边排在前面，投影时先满足刚性约束
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < edges.size();) {
+            size_t j = i;
+            while (j < edges.size() && edges[j] == edges[i]) j++;
+            bool isBoundary = j - i == 1;
+            if (isBoundary == (pass == 0)) {
+                int a = edges[i] >> 32;
+                int b = edges[i] & 0xffffffffu;
+                double len = (vertices[b] - vertices[a]).length();
+                if (len >= 1e-10) {
+                    constraintA.push_back(a);
+                    constraintB.push_back(b);
+                    restLength.push_back(len);
+                    stiffness.push_back(isBoundary ? opts.boundaryStiffness : opts.internalStiffness);
+                    restSum += len;
+                    if (isBoundary) boundaryCount++;
+                }
+            }
+            i = j;
+        }
+    }
+
+    int numC = constraintA.size();
+    meanRest = numC > 0 ? restSum / numC : 1.0;
+    double dt2 = opts.timeStep * opts.timeStep;
+    compliance.resize(numC);
+    for (int c = 0; c < numC; c++) {
+        compliance[c] = stiffness[c] > 0 ? 1.0 / (stiffness[c] * dt2) : 1e30;
+    }
+    lambda.assign(numC, 0.0);
+
+    invMass.assign(numVertices, 1.0);
+    if (opts.pinBoundary) {
+        for (int c = 0; c < boundaryCount; c++) {
+            invMass[constraintA[c]] = 0.0;
+            invMass[constraintB[c]] = 0.0;
+        }
+    }
+
+    posX.assign(numVertices, 0.0);
+    posY.assign(numVertices, 0.0);
+    prevX.assign(numVertices, 0.0);
+    prevY.assign(numVertices, 0.0);
+    velX.assign(numVertices, 0.0);
+    velY.assign(numVertices, 0.0);
+}
+
+bool PhysicsSolver::setPositions(const double* uvs, int count) {
+    if (count < numVertices * 2) return false;
+    anchorX = anchorY = 0;
+    for (int i = 0; i < numVertices; i++) {
+        posX[i] = uvs[i * 2];
+        posY[i] = uvs[i * 2 + 1];
+        anchorX += posX[i];
+        anchorY += posY[i];
+    }
+    if (numVertices > 0) {
+        anchorX /= numVertices;
+        anchorY /= numVertices;
+    }
+    std::fill(velX.begin(), velX.end(), 0.0);
+    std::fill(velY.begin(), velY.end(), 0.0);
+    converged = false;
+    return true;
+}
+
+int PhysicsSolver::step(int steps) {
+    int n = numVertices;
+    int numC = constraintA.size();
+    const int* ca = constraintA.data();
+    const int* cb = constraintB.data();
+    const double* rest = restLength.data();
+    const double* alpha = compliance.data();
+    double* x = posX.data();
+    double* y = posY.data();
+    const double* w = invMass.data();
+
+    int done = 0;
+    for (; done < steps; done++) {
+        // 预测：沿阻尼后的速度前进（速度以每步位移计）
+        for (int i = 0; i < n; i++) {
+            prevX[i] = x[i];
+            prevY[i] = y[i];
+            x[i] += velX[i] * w[i];
+            y[i] += velY[i] * w[i];
+        }
+
+        std::fill(lambda.begin(), lambda.end(), 0.0);
+        for (int it = 0; it < options.solverIterations; it++) {
+            for (int c = 0; c < numC; c++) {
+                int a = ca[c];
+                int b = cb[c];
+                double wsum = w[a] + w[b];
+                if (wsum == 0) continue;
+
+                double dx = x[b] - x[a];
+                double dy = y[b] - y[a];
+                double len = std::sqrt(dx * dx + dy * dy);
+                if (len < 1e-12) continue;
+
+                double C = len - rest[c];
+                double dl = (-C - alpha[c] * lambda[c]) / (wsum + alpha[c]);
+                lambda[c] += dl;
+
+                double s = dl / len;
+                x[a] -= w[a] * s * dx;
+                y[a] -= w[a] * s * dy;
+                x[b] += w[b] * s * dx;
+                y[b] += w[b] * s * dy;
+            }
+        }
+
+        // 质心锚定：防止整体漂移
+        if (!options.pinBoundary && n > 0) {
+            double cx = 0, cy = 0;
+            for (int i = 0; i < n; i++) {
+                cx += x[i];
+                cy += y[i];
+            }
+            double driftX = anchorX - cx / n;
+            double driftY = anchorY - cy / n;
+            for (int i = 0; i < n; i++) {
+                x[i] += driftX;
+                y[i] += driftY;
+            }
+        }
+
+        // 速度更新，记录本步最大位移用于收敛判断
+        double maxMove2 = 0;
+        for (int i = 0; i < n; i++) {
+            double mx = x[i] - prevX[i];
+            double my = y[i] - prevY[i];
+            velX[i] = mx * options.damping;
+            velY[i] = my * options.damping;
+            maxMove2 = std::max(maxMove2, mx * mx + my * my);
+        }
+
+        if (std::sqrt(maxMove2) < options.tolerance * meanRest) {
+            converged = true;
+            done++;
+            break;
+        }
+    }
+    return done;
+}
+
+const std::vector<double>& PhysicsSolver::positions() {
+    packed.resize(numVertices * 2);
+    for (int i = 0; i < numVertices; i++) {
+        packed[i * 2] = posX[i];
+        packed[i * 2 + 1] = posY[i];
+    }
+    return packed;
+}
+
+double PhysicsSolver::energy() const {
+    double e = 0;
+    for (int c = 0; c < (int)constraintA.size(); c++) {
+        double dx = posX[constraintB[c]] - posX[constraintA[c]];
+        double dy = posY[constraintB[c]] - posY[constraintA[c]];
+        double C = std::sqrt(dx * dx + dy * dy) - restLength[c];
+        e += 0.5 * stiffness[c] * C * C;
+    }
+    return e;
+}
+
+} // namespace bff
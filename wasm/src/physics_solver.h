@@ -0,0 +1,86 @@
+/**
+ * 差异化弹性松弛（PhysicsFlattener.js 的原生实现）
+ * "外刚内柔"：边界边高刚度保持3D长度，内部边低刚度允许收缩/膨胀
+ * 使用XPBD距离约束（柔度 = 1/刚度）代替显式欧拉弹簧，少量步数即可收敛
+ */
+
+#ifndef BFF_PHYSICS_SOLVER_H
+#define BFF_PHYSICS_SOLVER_H
+
+#include <vector>
+#include "scalar_types.h"
+
+namespace bff {
+
+// 与 PhysicsFlattener.relaxDifferentiated(subMesh, initialUV, options) 对应
+struct PhysicsOptions {
+    double boundaryStiffness = 50.0;   // 边界刚度：钢丝
+    double internalStiffness = 0.2;    // 内部刚度：橡皮筋
+    bool pinBoundary = false;          // 钉死边界顶点；否则只做质心锚定防漂移
+    double damping = 0.9;              // 每步保留的速度比例
+    double timeStep = 1.0;             // XPBD时间步，柔度按 1/(k*dt^2) 换算
+    int solverIterations = 4;          // 每步的约束投影次数（Gauss-Seidel）
+    double tolerance = 1e-5;           // 单步最大位移 / 平均边长 低于此值视为收敛
+};
+
+class PhysicsSolver {
+public:
+    /**
+     * 由3D网格建立距离约束（每条无向边一个，只出现在一个面中的边为边界边）
+     * @param vertices 顶点坐标
+     * @param numVertices 顶点数量
+     * @param triangles 三角形索引 [a0,b0,c0, ...]
+     * @param numFaces 三角形数量
+     */
+    void setup(const Vec3* vertices, int numVertices,
+               const int* triangles, int numFaces,
+               const PhysicsOptions& options);
+
+    /**
+     * 设置初始UV [u0,v0, u1,v1, ...]，并清零速度
+     * @param count uvs的长度，不足 2 * numVertices 时不修改并返回false
+     */
+    bool setPositions(const double* uvs, int count);
+
+    /**
+     * 连续执行最多steps步，收敛时提前结束
+     * @return 实际执行的步数
+     */
+    int step(int steps);
+
+    // 当前UV [u0,v0, ...]，每次step后更新
+    const std::vector<double>& positions();
+
+    // 加权应变能 Σ k (|e| - L)^2 / 2
+    double energy() const;
+
+    bool isConverged() const { return converged; }
+    int numConstraints() const { return constraintA.size(); }
+    int numBoundaryConstraints() const { return boundaryCount; }
+
+private:
+    PhysicsOptions options;
+    int numVertices = 0;
+    int boundaryCount = 0;
+    double meanRest = 0;
+    bool converged = false;
+
+    // 约束（SoA）
+    std::vector<int> constraintA, constraintB;
+    std::vector<double> restLength;
+    std::vector<double> stiffness;
+    std::vector<double> compliance;   // 1/(k*dt^2)
+    std::vector<double> lambda;       // XPBD拉格朗日乘子，每步清零
+
+    // 顶点（SoA）
+    std::vector<double> posX, posY;
+    std::vector<double> prevX, prevY;
+    std::vector<double> velX, velY;
+    std::vector<double> invMass;      // 钉死的顶点为0
+    std::vector<double> packed;       // positions()的交错输出
+    double anchorX = 0, anchorY = 0;  // 初始质心
+};
+
+} // namespace bff
+
+#endif // BFF_PHYSICS_SOLVER_H
@@ -0,0 +1,231 @@
+/**
+ * 热路径剖析实现
+ * 计时区间先追加到明细数组（有上限），同时按名字累计汇总；
+ * 多线程构建中各线程共用一把锁，剖析构建只用于定位热点，不追求最低开销
+ */
+
+#include "profiler.h"
+#include "task_scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#if BFF_PROFILE && BFF_USE_THREADS
+#include <atomic>
+#include <mutex>
+#endif
+#if BFF_PROFILE && defined(__EMSCRIPTEN__)
+#include <malloc.h>
+#endif
+
+namespace bff {
+
+#if BFF_PROFILE
+
+namespace {
+
+struct Event {
+    const char* name;
+    double startUs;
+    double durUs;
+    int thread;
+};
+
+// 明细上限，约24MB；超出后只累计汇总
+const size_t kMaxEvents = 1 << 20;
+
+// 名字指针 -> stages中的下标
+struct StageKey {
+    const char* name;
+    size_t stage;
+};
+
+struct Profiler {
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::vector<Event> events;
+    std::vector<ProfileStage> stages;
+    std::vector<StageKey> stageKeys;        // 按指针比较，命中时不做字符串比较；同名的不同指针各占一项
+    std::vector<ProfileCounter> counters;
+    std::vector<ProfileMemory> memory;
+    int64_t dropped = 0;
+#if BFF_USE_THREADS
+    std::mutex mutex;
+#endif
+};
+
+Profiler& profiler() {
+    static Profiler instance;
+    return instance;
+}
+
+#if BFF_USE_THREADS
+#define BFF_PROFILE_LOCK std::lock_guard<std::mutex> lock(profiler().mutex)
+#else
+#define BFF_PROFILE_LOCK ((void)0)
+#endif
+
+int threadIndex() {
+#if BFF_USE_THREADS
+    static std::atomic<int> next{0};
+    thread_local int index = next.fetch_add(1);
+    return index;
+#else
+    return 0;
+#endif
+}
+
+double nowUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - profiler().origin).count();
+}
+
+template <typename T>
+T& findByName(std::vector<T>& list, const char* name) {
+    for (T& item : list) {
+        if (item.name == name) return item;
+    }
+    list.push_back(T());
+    list.back().name = name;
+    return list.back();
+}
+
+void recordMemory(Profiler& p, const char* name, size_t bytes) {
+    ProfileMemory& m = findByName(p.memory, name);
+    m.peakBytes = std::max(m.peakBytes, bytes);
+}
+
+// 当前线程中未结束的计时区间数；堆用量只在最外层区间开始和结束时采样（mallinfo遍历堆，开销不小）
+#if BFF_USE_THREADS
+thread_local int scopeDepth = 0;
+#else
+int scopeDepth = 0;
+#endif
+
+void sampleHeap() {
+#ifdef __EMSCRIPTEN__
+    // WASM堆中正在使用的字节数
+    size_t bytes = mallinfo().uordblks;
+    Profiler& p = profiler();
+    BFF_PROFILE_LOCK;
+    recordMemory(p, "heapInUse", bytes);
+#endif
+}
+
+} // namespace
+
+ProfileScope::ProfileScope(const char* name_) : name(name_) {
+    if (scopeDepth++ == 0) sampleHeap();
+    startUs = nowUs();
+}
+
+ProfileScope::~ProfileScope() {
+    double endUs = nowUs();
+    int thread = threadIndex();
+    if (--scopeDepth == 0) sampleHeap();
+    Profiler& p = profiler();
+    BFF_PROFILE_LOCK;
+
+    if (p.events.size() < kMaxEvents) {
+        p.events.push_back(Event{name, startUs, endUs - startUs, thread});
+    } else {
+        p.dropped++;
+    }
+
+    size_t k = 0;
+    while (k < p.stageKeys.size() && p.stageKeys[k].name != name) k++;
+    if (k == p.stageKeys.size()) {
+        // 不同编译单元里同名的字符串常量可能地址不同，按内容再找一次，并记下这个指针
+        ProfileStage& stage = findByName(p.stages, name);
+        p.stageKeys.push_back(StageKey{name, size_t(&stage - p.stages.data())});
+    }
+    ProfileStage& stage = p.stages[p.stageKeys[k].stage];
+    double ms = (endUs - startUs) / 1000.0;
+    stage.calls++;
+    stage.totalMs += ms;
+    stage.maxMs = std::max(stage.maxMs, ms);
+}
+
+void profileCount(const char* name, int64_t delta) {
+    Profiler& p = profiler();
+    BFF_PROFILE_LOCK;
+    findByName(p.counters, name).value += delta;
+}
+
+void profileMemory(const char* name, size_t bytes) {
+    Profiler& p = profiler();
+    BFF_PROFILE_LOCK;
+    recordMemory(p, name, bytes);
+}
+
+void profileReset() {
+    Profiler& p = profiler();
+    BFF_PROFILE_LOCK;
+    p.origin = std::chrono::steady_clock::now();
+    p.events.clear();
+    p.stages.clear();
+    p.stageKeys.clear();
+    p.counters.clear();
+    p.memory.clear();
+    p.dropped = 0;
+}
+
+ProfileData profileSnapshot() {
+    Profiler& p = profiler();
+    BFF_PROFILE_LOCK;
+    ProfileData data;
+    data.enabled = true;
+    data.stages = p.stages;
+    data.counters = p.counters;
+    data.memory = p.memory;
+    data.events = p.events.size() + p.dropped;
+    data.droppedEvents = p.dropped;
+    return data;
+}
+
+std::string profileTraceJson() {
+    Profiler& p = profiler();
+    double endUs = nowUs();
+    BFF_PROFILE_LOCK;
+    std::string out;
+    out.reserve(p.events.size() * 96 + 256);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    char buf[256];
+    bool first = true;
+    auto append = [&](int n) {
+        if (!first) out += ',';
+        out.append(buf, std::min(n, (int)sizeof(buf) - 1));
+        first = false;
+    };
+    for (const Event& e : p.events) {
+        append(std::snprintf(buf, sizeof(buf),
+            "{\"name\":\"%s\",\"cat\":\"bff\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+            e.name, e.startUs, e.durUs, e.thread));
+    }
+    for (const ProfileCounter& c : p.counters) {
+        append(std::snprintf(buf, sizeof(buf),
+            "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"value\":%lld}}",
+            c.name.c_str(), endUs, (long long)c.value));
+    }
+    for (const ProfileMemory& m : p.memory) {
+        append(std::snprintf(buf, sizeof(buf),
+            "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"peakBytes\":%zu}}",
+            m.name.c_str(), endUs, m.peakBytes));
+    }
+    out += "]}";
+    return out;
+}
+
+#else
+
+void profileReset() {
+}
+
+ProfileData profileSnapshot() {
+    return ProfileData();
+}
+
+std::string profileTraceJson() {
+    return "{\"traceEvents\":[]}";
+}
+
+#endif
+
+} // namespace bff
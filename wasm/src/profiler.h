@@ -0,0 +1,96 @@
+/**
+ * 热路径剖析：分阶段计时、计数器和内存高水位
+ * 只在定义 BFF_PROFILE=1 时记录（make profile）；发布版本中宏展开为空，
+ * 不产生任何代码，查询接口返回空结果
+ * 结果可汇总为各阶段的调用次数和耗时，或导出为Chrome trace-event JSON（chrome://tracing、Perfetto）
+ */
+
+#ifndef BFF_PROFILER_H
+#define BFF_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef BFF_PROFILE
+#define BFF_PROFILE 0
+#endif
+
+namespace bff {
+
+// 一个阶段（同名计时区间）的汇总
+struct ProfileStage {
+    std::string name;
+    int64_t calls = 0;
+    double totalMs = 0;
+    double maxMs = 0;
+};
+
+struct ProfileCounter {
+    std::string name;
+    int64_t value = 0;
+};
+
+// 内存高水位：同名记录取最大值
+struct ProfileMemory {
+    std::string name;
+    size_t peakBytes = 0;
+};
+
+struct ProfileData {
+    bool enabled = false;              // 是否为剖析构建
+    std::vector<ProfileStage> stages;  // 按首次出现的顺序
+    std::vector<ProfileCounter> counters;
+    std::vector<ProfileMemory> memory;
+    int64_t events = 0;                // 记录的计时区间数
+    int64_t droppedEvents = 0;         // 超过上限未保存明细（仍计入汇总）的区间数
+};
+
+// 清空已记录的数据，时间原点重置为当前时刻
+void profileReset();
+
+// 自上次profileReset以来的汇总
+ProfileData profileSnapshot();
+
+/**
+ * Chrome trace-event JSON：每个计时区间一个 "ph":"X" 事件，
+ * 计数器和内存高水位以 "ph":"C" 事件附在末尾
+ */
+std::string profileTraceJson();
+
+#if BFF_PROFILE
+
+// 计时区间，析构时记录；name须为字符串常量
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    double startUs;
+};
+
+void profileCount(const char* name, int64_t delta);
+void profileMemory(const char* name, size_t bytes);
+
+#define BFF_PROFILE_JOIN2(a, b) a##b
+#define BFF_PROFILE_JOIN(a, b) BFF_PROFILE_JOIN2(a, b)
+#define BFF_PROFILE_SCOPE(name) ::bff::ProfileScope BFF_PROFILE_JOIN(bffProfileScope, __LINE__)(name)
+#define BFF_PROFILE_COUNT(name, delta) ::bff::profileCount(name, delta)
+#define BFF_PROFILE_MEMORY(name, bytes) ::bff::profileMemory(name, bytes)
+
+#else
+
+#define BFF_PROFILE_SCOPE(name) ((void)0)
+#define BFF_PROFILE_COUNT(name, delta) ((void)0)
+#define BFF_PROFILE_MEMORY(name, bytes) ((void)0)
+
+#endif
+
+} // namespace bff
+
+#endif // BFF_PROFILER_H
@@ -0,0 +1,64 @@
+/**
+ * 几何核心的标量类型和向量类型
+ * Real 为网格顶点、逐面几何量和UV结果的精度，编译时用 -DBFF_SCALAR=float 选择单精度
+ * （make float32）；稀疏分解和迭代求解内部始终使用double累加
+ */
+
+#ifndef BFF_SCALAR_TYPES_H
+#define BFF_SCALAR_TYPES_H
+
+#include <cmath>
+
+#ifndef BFF_SCALAR
+#define BFF_SCALAR double
+#endif
+
+namespace bff {
+
+using Real = BFF_SCALAR;
+
+// 2D向量
+template <typename T>
+struct Vec2T {
+    T x, y;
+    Vec2T() : x(0), y(0) {}
+    Vec2T(T x_, T y_) : x(x_), y(y_) {}
+    Vec2T operator+(const Vec2T& v) const { return Vec2T(x + v.x, y + v.y); }
+    Vec2T operator-(const Vec2T& v) const { return Vec2T(x - v.x, y - v.y); }
+    Vec2T operator*(T s) const { return Vec2T(x * s, y * s); }
+    T dot(const Vec2T& v) const { return x * v.x + y * v.y; }
+    T length() const { return std::sqrt(x * x + y * y); }
+    Vec2T normalize() const {
+        T len = length();
+        return len > T(1e-10) ? Vec2T(x / len, y / len) : Vec2T(0, 0);
+    }
+};
+
+// 3D向量
+template <typename T>
+struct Vec3T {
+    T x, y, z;
+    Vec3T() : x(0), y(0), z(0) {}
+    Vec3T(T x_, T y_, T z_) : x(x_), y(y_), z(z_) {}
+    Vec3T operator+(const Vec3T& v) const { return Vec3T(x + v.x, y + v.y, z + v.z); }
+    Vec3T operator-(const Vec3T& v) const { return Vec3T(x - v.x, y - v.y, z - v.z); }
+    Vec3T operator*(T s) const { return Vec3T(x * s, y * s, z * s); }
+    T dot(const Vec3T& v) const { return x * v.x + y * v.y + z * v.z; }
+    Vec3T cross(const Vec3T& v) const {
+        return Vec3T(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x);
+    }
+    T length() const { return std::sqrt(x * x + y * y + z * z); }
+    Vec3T normalize() const {
+        T len = length();
+        return len > T(1e-10) ? Vec3T(x / len, y / len, z / len) : Vec3T(0, 0, 0);
+    }
+};
+
+using Vec2 = Vec2T<Real>;
+using Vec3 = Vec3T<Real>;
+
+static_assert(sizeof(Vec3) == 3 * sizeof(Real), "Vec3 must match Real[3] layout");
+
+} // namespace bff
+
+#endif // BFF_SCALAR_TYPES_H
@@ -0,0 +1,536 @@
+/**
+ * 稀疏线性代数实现
+ */
+
+#include "sparse_solver.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace bff {
+
+void CSRMatrix::multiply(const double* x, double* y) const {
+    for (int r = 0; r < rows; r++) {
+        double sum = 0;
+        for (int k = rowPtr[r]; k < rowPtr[r + 1]; k++) {
+            sum += values[k] * x[colIdx[k]];
+        }
+        y[r] = sum;
+    }
+}
+
+std::vector<double> CSRMatrix::diagonal() const {
+    std::vector<double> diag(rows, 0.0);
+    for (int r = 0; r < rows; r++) {
+        for (int k = rowPtr[r]; k < rowPtr[r + 1]; k++) {
+            if (colIdx[k] == r) {
+                diag[r] = values[k];
+                break;
+            }
+        }
+    }
+    return diag;
+}
+
+CSRMatrix CSRMatrix::fromTriplets(int rows, int cols, std::vector<Triplet>& triplets) {
+    std::sort(triplets.begin(), triplets.end(), [](const Triplet& a, const Triplet& b) {
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+
+    CSRMatrix m;
+    m.rows = rows;
+    m.cols = cols;
+    m.rowPtr.assign(rows + 1, 0);
+    m.colIdx.reserve(triplets.size());
+    m.values.reserve(triplets.size());
+
+    for (size_t i = 0; i < triplets.size(); i++) {
+        const Triplet& t = triplets[i];
+        if (i > 0 && t.row == triplets[i - 1].row && t.col == triplets[i - 1].col) {
+            m.values.back() += t.value;
+            continue;
+        }
+        m.colIdx.push_back(t.col);
+        m.values.push_back(t.value);
+        m.rowPtr[t.row + 1]++;
+    }
+
+    for (int r = 0; r < rows; r++) {
+        m.rowPtr[r + 1] += m.rowPtr[r];
+    }
+    return m;
+}
+
+std::vector<double> cotanWeights(const std::vector<Vec3>& points,
+                                 const std::vector<int>& triangles) {
+    int numFaces = triangles.size() / 3;
+    std::vector<double> cotans(triangles.size(), 0.0);
+
+    for (int f = 0; f < numFaces; f++) {
+        const int* tri = &triangles[f * 3];
+        for (int i = 0; i < 3; i++) {
+            const Vec3& p = points[tri[i]];
+            Vec3 a = points[tri[(i + 1) % 3]] - p;
+            Vec3 b = points[tri[(i + 2) % 3]] - p;
+
+            // cot = cos/sin = (a·b) / |a×b|
+            double sinArea = a.cross(b).length();
+            cotans[f * 3 + i] = sinArea > 1e-12 ? a.dot(b) / sinArea : 0.0;
+        }
+    }
+    return cotans;
+}
+
+CSRMatrix assembleCotanLaplacian(int numVertices,
+                                 const std::vector<int>& triangles,
+                                 const std::vector<double>& cotans) {
+    std::vector<Triplet> triplets;
+    triplets.reserve(triangles.size() * 4);
+
+    int numFaces = triangles.size() / 3;
+    for (int f = 0; f < numFaces; f++) {
+        const int* tri = &triangles[f * 3];
+        for (int i = 0; i < 3; i++) {
+            int a = tri[(i + 1) % 3];
+            int b = tri[(i + 2) % 3];
+            double w = 0.5 * cotans[f * 3 + i];
+
+            triplets.push_back({a, b, -w});
+            triplets.push_back({b, a, -w});
+            triplets.push_back({a, a, w});
+            triplets.push_back({b, b, w});
+        }
+    }
+
+    return CSRMatrix::fromTriplets(numVertices, numVertices, triplets);
+}
+
+CSRMatrix assembleLSCM(const CSRMatrix& laplacian, const std::vector<int>& boundaryEdges) {
+    int n = laplacian.rows;
+    std::vector<Triplet> triplets;
+    triplets.reserve(laplacian.nonZeros() * 2 + boundaryEdges.size() * 2);
+
+    // E_D = 1/2 (u^T L u + v^T L v)
+    for (int r = 0; r < n; r++) {
+        for (int k = laplacian.rowPtr[r]; k < laplacian.rowPtr[r + 1]; k++) {
+            int c = laplacian.colIdx[k];
+            triplets.push_back({2 * r, 2 * c, laplacian.values[k]});
+            triplets.push_back({2 * r + 1, 2 * c + 1, laplacian.values[k]});
+        }
+    }
+
+    // A = 1/2 Σ (u_a v_b - u_b v_a)，取其Hessian的相反数
+    for (size_t e = 0; e + 1 < boundaryEdges.size(); e += 2) {
+        int a = boundaryEdges[e];
+        int b = boundaryEdges[e + 1];
+        triplets.push_back({2 * a, 2 * b + 1, -0.5});
+        triplets.push_back({2 * b + 1, 2 * a, -0.5});
+        triplets.push_back({2 * b, 2 * a + 1, 0.5});
+        triplets.push_back({2 * a + 1, 2 * b, 0.5});
+    }
+
+    return CSRMatrix::fromTriplets(2 * n, 2 * n, triplets);
+}
+
+void reduceDirichlet(const CSRMatrix& A,
+                     const std::vector<int>& freeIndex,
+                     int numFree,
+                     CSRMatrix& reduced,
+                     CSRMatrix& coupling) {
+    reduced = CSRMatrix();
+    coupling = CSRMatrix();
+    reduced.rows = reduced.cols = numFree;
+    coupling.rows = numFree;
+    coupling.cols = A.cols;
+    reduced.rowPtr.assign(numFree + 1, 0);
+    coupling.rowPtr.assign(numFree + 1, 0);
+
+    // A的行按全局顺序遍历，自由变量编号随全局编号递增，保证行序正确
+    for (int r = 0; r < A.rows; r++) {
+        int fr = freeIndex[r];
+        if (fr < 0) continue;
+
+        for (int k = A.rowPtr[r]; k < A.rowPtr[r + 1]; k++) {
+            int c = A.colIdx[k];
+            int fc = freeIndex[c];
+            if (fc >= 0) {
+                reduced.colIdx.push_back(fc);
+                reduced.values.push_back(A.values[k]);
+            } else {
+                coupling.colIdx.push_back(c);
+                coupling.values.push_back(A.values[k]);
+            }
+        }
+        reduced.rowPtr[fr + 1] = reduced.values.size();
+        coupling.rowPtr[fr + 1] = coupling.values.size();
+    }
+}
+
+SolveStats solvePCG(const CSRMatrix& A,
+                    const std::vector<double>& b,
+                    std::vector<double>& x,
+                    const SolverOptions& options) {
+    SolveStats stats;
+    int n = A.rows;
+    x.resize(n, 0.0);
+
+    double bNorm = 0;
+    for (double v : b) bNorm += v * v;
+    bNorm = std::sqrt(bNorm);
+    if (bNorm < 1e-30) bNorm = 1.0;
+
+    // Jacobi预条件
+    std::vector<double> invDiag = A.diagonal();
+    for (double& d : invDiag) {
+        d = std::fabs(d) > 1e-30 ? 1.0 / d : 1.0;
+    }
+
+    std::vector<double> r(n), z(n), p(n), Ap(n);
+    A.multiply(x.data(), Ap.data());
+    double rNorm = 0;
+    for (int i = 0; i < n; i++) {
+        r[i] = b[i] - Ap[i];
+        rNorm += r[i] * r[i];
+    }
+    stats.residual = std::sqrt(rNorm) / bNorm;
+    if (stats.residual <= options.tolerance) {
+        stats.converged = true;
+        return stats;
+    }
+
+    double rz = 0;
+    for (int i = 0; i < n; i++) {
+        z[i] = invDiag[i] * r[i];
+        p[i] = z[i];
+        rz += r[i] * z[i];
+    }
+
+    for (int iter = 0; iter < options.maxIterations; iter++) {
+        A.multiply(p.data(), Ap.data());
+        double pAp = 0;
+        for (int i = 0; i < n; i++) pAp += p[i] * Ap[i];
+        if (std::fabs(pAp) < 1e-30) break;
+
+        double alpha = rz / pAp;
+        rNorm = 0;
+        for (int i = 0; i < n; i++) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * Ap[i];
+            rNorm += r[i] * r[i];
+        }
+
+        stats.iterations = iter + 1;
+        stats.residual = std::sqrt(rNorm) / bNorm;
+        if (stats.residual <= options.tolerance) {
+            stats.converged = true;
+            break;
+        }
+
+        double rzNew = 0;
+        for (int i = 0; i < n; i++) {
+            z[i] = invDiag[i] * r[i];
+            rzNew += r[i] * z[i];
+        }
+        double beta = rzNew / rz;
+        rz = rzNew;
+        for (int i = 0; i < n; i++) {
+            p[i] = z[i] + beta * p[i];
+        }
+    }
+
+    return stats;
+}
+
+std::vector<int> reverseCuthillMcKee(const CSRMatrix& A) {
+    int n = A.rows;
+    std::vector<int> degree(n);
+    for (int r = 0; r < n; r++) {
+        degree[r] = A.rowPtr[r + 1] - A.rowPtr[r];
+    }
+
+    // 按度数从小到大选择每个连通分量的起点
+    std::vector<int> seeds(n);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::stable_sort(seeds.begin(), seeds.end(), [&](int a, int b) {
+        return degree[a] < degree[b];
+    });
+
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<char> visited(n, 0);
+    std::vector<int> neighbors;
+
+    for (int seed : seeds) {
+        if (visited[seed]) continue;
+        visited[seed] = 1;
+        size_t head = order.size();
+        order.push_back(seed);
+
+        while (head < order.size()) {
+            int v = order[head++];
+            neighbors.clear();
+            for (int k = A.rowPtr[v]; k < A.rowPtr[v + 1]; k++) {
+                int c = A.colIdx[k];
+                if (!visited[c]) {
+                    visited[c] = 1;
+                    neighbors.push_back(c);
+                }
+            }
+            std::sort(neighbors.begin(), neighbors.end(), [&](int a, int b) {
+                return degree[a] < degree[b];
+            });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector<int> nestedDissection(const CSRMatrix& A, int leafSize) {
+    int n = A.rows;
+    std::vector<int> order;
+    order.reserve(n);
+
+    // label[v]：v所在的待处理子图；子图用顶点列表表示，分隔集在两侧之后输出
+    std::vector<int> label(n, 0);
+    std::vector<int> level(n, -1);
+    int nextLabel = 1;
+    struct Task {
+        std::vector<int> vertices;
+        bool emit;               // 分隔集：直接输出
+    };
+    std::vector<Task> stack;
+    std::vector<int> all(n);
+    std::iota(all.begin(), all.end(), 0);
+    stack.push_back(Task{std::move(all), false});
+
+    std::vector<int> queue;
+    // 子图内从start出发的BFS层次，返回访问顺序
+    auto bfs = [&](int start, int id) {
+        queue.clear();
+        queue.push_back(start);
+        level[start] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            int v = queue[head];
+            for (int k = A.rowPtr[v]; k < A.rowPtr[v + 1]; k++) {
+                int c = A.colIdx[k];
+                if (label[c] == id && level[c] < 0) {
+                    level[c] = level[v] + 1;
+                    queue.push_back(c);
+                }
+            }
+        }
+    };
+    auto resetLevels = [&]() {
+        for (int v : queue) level[v] = -1;
+    };
+
+    while (!stack.empty()) {
+        Task task = std::move(stack.back());
+        stack.pop_back();
+        std::vector<int>& vs = task.vertices;
+        if (task.emit || (int)vs.size() <= leafSize) {
+            order.insert(order.end(), vs.begin(), vs.end());
+            continue;
+        }
+
+        int id = nextLabel++;
+        for (int v : vs) label[v] = id;
+
+        // 两次BFS找伪外围顶点，再按其BFS层次取中间一层作分隔集
+        bfs(vs[0], id);
+        int far = queue.back();
+        resetLevels();
+        bfs(far, id);
+
+        // 不连通的子图：BFS到达的分量和其余顶点各自独立处理，不需要分隔集
+        if (queue.size() < vs.size()) {
+            std::vector<int> rest;
+            for (int v : vs) {
+                if (level[v] < 0) rest.push_back(v);
+            }
+            std::vector<int> reached = queue;
+            resetLevels();
+            stack.push_back(Task{std::move(rest), false});
+            stack.push_back(Task{std::move(reached), false});
+            continue;
+        }
+
+        int depth = level[queue.back()];
+        if (depth < 2) {
+            resetLevels();
+            order.insert(order.end(), vs.begin(), vs.end());
+            continue;
+        }
+        std::vector<int> levelCount(depth + 1, 0);
+        for (int v : queue) levelCount[level[v]]++;
+        int mid = 1, below = levelCount[0];
+        while (mid < depth - 1 && below + levelCount[mid] < (int)vs.size() / 2) below += levelCount[mid++];
+
+        // 中间层中与下一层相邻的顶点才需要分隔，其余归入前半部分
+        std::vector<int> first, second, separator;
+        for (int v : queue) {
+            int l = level[v];
+            if (l < mid) {
+                first.push_back(v);
+            } else if (l > mid) {
+                second.push_back(v);
+            } else {
+                bool touches = false;
+                for (int k = A.rowPtr[v]; k < A.rowPtr[v + 1] && !touches; k++) {
+                    int c = A.colIdx[k];
+                    touches = label[c] == id && level[c] == mid + 1;
+                }
+                (touches ? separator : first).push_back(v);
+            }
+        }
+        resetLevels();
+        stack.push_back(Task{std::move(separator), true});
+        stack.push_back(Task{std::move(second), false});
+        stack.push_back(Task{std::move(first), false});
+    }
+    return order;
+}
+
+bool LDLTFactorization::analyze(const CSRMatrix& A, int64_t maxFactorNonZeros) {
+    n = A.rows;
+    analyzed = false;
+    factorized = false;
+    perm = nestedDissection(A);
+    std::vector<int> invPerm(n);
+    for (int i = 0; i < n; i++) invPerm[perm[i]] = i;
+
+    // 重排后的矩阵 P A P^T；对称矩阵的CSR即CSC，按列存储
+    std::vector<Triplet> entries;
+    entries.reserve(A.nonZeros());
+    for (int r = 0; r < n; r++) {
+        for (int k = A.rowPtr[r]; k < A.rowPtr[r + 1]; k++) {
+            // value字段暂存原下标
+            entries.push_back({invPerm[A.colIdx[k]], invPerm[r], static_cast<double>(k)});
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Triplet& a, const Triplet& b) {
+        return a.col != b.col ? a.col < b.col : a.row < b.row;
+    });
+
+    Ap.assign(n + 1, 0);
+    Ai.resize(entries.size());
+    valueMap.resize(entries.size());
+    for (size_t p = 0; p < entries.size(); p++) {
+        Ap[entries[p].col + 1]++;
+        Ai[p] = entries[p].row;
+        valueMap[static_cast<int>(entries[p].value)] = p;
+    }
+    for (int k = 0; k < n; k++) Ap[k + 1] += Ap[k];
+    Ax.assign(entries.size(), 0.0);
+
+    // 符号分解：消去树和每列非零数
+    Parent.assign(n, -1);
+    Lnz.assign(n, 0);
+    std::vector<int> flag(n);
+    for (int k = 0; k < n; k++) {
+        flag[k] = k;
+        for (int p = Ap[k]; p < Ap[k + 1]; p++) {
+            int i = Ai[p];
+            if (i >= k) continue;
+            for (; flag[i] != k; i = Parent[i]) {
+                if (Parent[i] == -1) Parent[i] = k;
+                Lnz[i]++;
+                flag[i] = k;
+            }
+        }
+    }
+
+    // 填充过多时不分配因子，由调用方改用PCG
+    int64_t factorNonZeros = 0;
+    for (int k = 0; k < n; k++) factorNonZeros += Lnz[k];
+    if (factorNonZeros > maxFactorNonZeros) return false;
+
+    Lp.assign(n + 1, 0);
+    for (int k = 0; k < n; k++) Lp[k + 1] = Lp[k] + Lnz[k];
+    Li.assign(Lp[n], 0);
+    Lx.assign(Lp[n], 0.0);
+    D.assign(n, 0.0);
+
+    analyzed = true;
+    return true;
+}
+
+bool LDLTFactorization::factorize(const CSRMatrix& A) {
+    factorized = false;
+    if (!analyzed || A.rows != n || A.nonZeros() != (int)valueMap.size()) {
+        return false;
+    }
+
+    for (int k = 0; k < A.nonZeros(); k++) {
+        Ax[valueMap[k]] = A.values[k];
+    }
+
+    // 上视（up-looking）数值分解
+    std::vector<double> y(n, 0.0);
+    std::vector<int> pattern(n), flag(n);
+    for (int k = 0; k < n; k++) {
+        int top = n;
+        flag[k] = k;
+        Lnz[k] = 0;
+
+        for (int p = Ap[k]; p < Ap[k + 1]; p++) {
+            int i = Ai[p];
+            if (i > k) continue;
+            y[i] += Ax[p];
+            int len = 0;
+            for (; flag[i] != k; i = Parent[i]) {
+                pattern[len++] = i;
+                flag[i] = k;
+            }
+            while (len > 0) pattern[--top] = pattern[--len];
+        }
+
+        D[k] = y[k];
+        y[k] = 0.0;
+        for (; top < n; top++) {
+            int i = pattern[top];
+            double yi = y[i];
+            y[i] = 0.0;
+            int p2 = Lp[i] + Lnz[i];
+            for (int p = Lp[i]; p < p2; p++) {
+                y[Li[p]] -= Lx[p] * yi;
+            }
+            double lki = yi / D[i];
+            D[k] -= lki * yi;
+            Li[p2] = k;
+            Lx[p2] = lki;
+            Lnz[i]++;
+        }
+
+        if (std::fabs(D[k]) < 1e-300) return false;
+    }
+
+    factorized = true;
+    return true;
+}
+
+void LDLTFactorization::solve(std::vector<double>& x) const {
+    std::vector<double> y(n);
+    for (int i = 0; i < n; i++) y[i] = x[perm[i]];
+
+    // L y = b
+    for (int j = 0; j < n; j++) {
+        for (int p = Lp[j]; p < Lp[j + 1]; p++) {
+            y[Li[p]] -= Lx[p] * y[j];
+        }
+    }
+    // D y = y
+    for (int j = 0; j < n; j++) y[j] /= D[j];
+    // L^T y = y
+    for (int j = n - 1; j >= 0; j--) {
+        for (int p = Lp[j]; p < Lp[j + 1]; p++) {
+            y[j] -= Lx[p] * y[Li[p]];
+        }
+    }
+
+    for (int i = 0; i < n; i++) x[perm[i]] = y[i];
+}
+
+} // namespace bff
@@ -0,0 +1,159 @@
+/**
+ * 稀疏线性代数：CSR矩阵、余切拉普拉斯与LSCM组装、预条件共轭梯度求解
+ * 供共形展开和ARAP全局步骤共用
+ */
+
+#ifndef SPARSE_SOLVER_H
+#define SPARSE_SOLVER_H
+
+#include <cstdint>
+#include <vector>
+#include "scalar_types.h"
+
+namespace bff {
+
+// 稀疏矩阵三元组 (row, col, value)，重复项在组装时累加
+struct Triplet {
+    int row;
+    int col;
+    double value;
+};
+
+// 压缩行存储（CSR）稀疏矩阵
+struct CSRMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int> rowPtr;     // 大小 rows+1
+    std::vector<int> colIdx;     // 每行内按列升序
+    std::vector<double> values;
+
+    int nonZeros() const { return values.size(); }
+
+    // y = A * x
+    void multiply(const double* x, double* y) const;
+
+    // 对角元素，缺失的对角项为0
+    std::vector<double> diagonal() const;
+
+    // 由三元组组装，重复项累加
+    static CSRMatrix fromTriplets(int rows, int cols, std::vector<Triplet>& triplets);
+};
+
+// 迭代求解参数
+struct SolverOptions {
+    int maxIterations = 200;
+    double tolerance = 1e-8;   // 相对残差 ||r|| / ||b||
+};
+
+// 迭代求解统计
+struct SolveStats {
+    int iterations = 0;
+    double residual = 0;       // 最终相对残差
+    bool converged = false;
+};
+
+/**
+ * 计算每个三角形三个角的余切值
+ * @param points 顶点坐标
+ * @param triangles 三角形索引 [a0,b0,c0, ...]
+ * @return 每个角的余切 [cot(a0),cot(b0),cot(c0), ...]，角i对边为 (i+1, i+2)
+ */
+std::vector<double> cotanWeights(const std::vector<Vec3>& points,
+                                 const std::vector<int>& triangles);
+
+/**
+ * 组装余切拉普拉斯矩阵 L = D - W（半正定，行和为0）
+ * 边 (i,j) 的权重为两侧对角余切之和的一半
+ */
+CSRMatrix assembleCotanLaplacian(int numVertices,
+                                 const std::vector<int>& triangles,
+                                 const std::vector<double>& cotans);
+
+/**
+ * 组装最小二乘共形（LSCM）矩阵 [2n x 2n]，变量 2i 为 u_i、2i+1 为 v_i
+ * 共形能量 E_C = E_D - A：对角块为拉普拉斯，边界有向边 (a,b) 上的UV面积项给出u、v之间的交叉项；
+ * 至少固定两个顶点后正定，边界自由
+ * @param laplacian 余切拉普拉斯（assembleCotanLaplacian）
+ * @param boundaryEdges 边界有向边 [a0,b0, a1,b1, ...]，方向与所在三角形一致
+ */
+CSRMatrix assembleLSCM(const CSRMatrix& laplacian, const std::vector<int>& boundaryEdges);
+
+/**
+ * 消去固定（Dirichlet）变量，得到只含自由变量的系统
+ * A_ff x_f = b_f - A_fc x_c
+ * @param A 完整矩阵
+ * @param freeIndex 全局变量 -> 自由变量编号，固定变量为-1
+ * @param numFree 自由变量数量
+ * @param reduced 输出 A_ff
+ * @param coupling 输出 A_fc（列为全局编号），用于计算右端项
+ */
+void reduceDirichlet(const CSRMatrix& A,
+                     const std::vector<int>& freeIndex,
+                     int numFree,
+                     CSRMatrix& reduced,
+                     CSRMatrix& coupling);
+
+/**
+ * Jacobi预条件共轭梯度法求解对称正定系统 A x = b
+ * x 的初值作为热启动
+ */
+SolveStats solvePCG(const CSRMatrix& A,
+                    const std::vector<double>& b,
+                    std::vector<double>& x,
+                    const SolverOptions& options = SolverOptions());
+
+/**
+ * Reverse Cuthill-McKee排序，降低带宽（网格重排使用）
+ * @return 新顺序 -> 原编号
+ */
+std::vector<int> reverseCuthillMcKee(const CSRMatrix& A);
+
+/**
+ * 嵌套剖分排序：按BFS层次取中间一层作分隔集，递归排序两侧后把分隔集排在最后；
+ * 二维网格上分解填充约为 O(n log n)，RCM的带状填充约为 O(n^1.5)
+ * @param leafSize 不超过此大小的子图不再剖分
+ * @return 新顺序 -> 原编号
+ */
+std::vector<int> nestedDissection(const CSRMatrix& A, int leafSize = 64);
+
+// 分解因子的非零元上限（约800MB，百万面片段的LSCM系统恰好在内），超过时analyze返回false
+constexpr int64_t kMaxFactorNonZeros = int64_t(1) << 26;
+
+/**
+ * 稀疏LDL^T分解（对称矩阵，按嵌套剖分重排）
+ * analyze只依赖稀疏结构，factorize只依赖数值，
+ * 结构不变时可只重做数值分解，矩阵不变时可反复solve
+ */
+class LDLTFactorization {
+public:
+    // 排序和符号分解；因子非零元超过maxFactorNonZeros时不分配因子并返回false（之后factorize也返回false）
+    bool analyze(const CSRMatrix& A, int64_t maxFactorNonZeros = kMaxFactorNonZeros);
+
+    // 数值分解，A的稀疏结构必须与analyze时一致；遇到零主元返回false
+    bool factorize(const CSRMatrix& A);
+
+    // 原地求解 A x = b（输入b，输出x）
+    void solve(std::vector<double>& x) const;
+
+    bool isAnalyzed() const { return analyzed; }
+    bool isFactorized() const { return factorized; }
+    int size() const { return n; }
+    int factorNonZeros() const { return Li.size(); }
+
+private:
+    int n = 0;
+    bool analyzed = false;
+    bool factorized = false;
+
+    std::vector<int> perm;       // 新编号 -> 原编号
+    std::vector<int> Ap, Ai;     // 重排后矩阵（按列存储）
+    std::vector<int> valueMap;   // A.values下标 -> 重排后矩阵下标
+    std::vector<double> Ax;
+
+    std::vector<int> Lp, Parent, Lnz, Li;
+    std::vector<double> Lx, D;
+};
+
+} // namespace bff
+
+#endif // SPARSE_SOLVER_H
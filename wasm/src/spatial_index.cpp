@@ -0,0 +1,243 @@
+/**
+ * k-d树与缝线红点聚类实现
+ */
+
+#include "spatial_index.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace bff {
+
+namespace {
+
+const int kLeafSize = 8;
+
+} // namespace
+
+void KdTree::build(const double* points, int count) {
+    pts = points;
+    nodes.clear();
+    ids.resize(count);
+    for (int i = 0; i < count; i++) ids[i] = i;
+    leafOf.assign(count, -1);
+    removed.assign(count, 0);
+    if (count == 0) return;
+    nodes.reserve(2 * (count / kLeafSize + 1));
+    buildNode(0, count, -1);
+}
+
+int KdTree::buildNode(int begin, int end, int parent) {
+    int index = nodes.size();
+    nodes.push_back(Node());
+    Node node;
+    node.begin = begin;
+    node.end = end;
+    node.left = node.right = -1;
+    node.parent = parent;
+    node.alive = end - begin;
+    for (int d = 0; d < 3; d++) {
+        node.lo[d] = std::numeric_limits<double>::infinity();
+        node.hi[d] = -std::numeric_limits<double>::infinity();
+    }
+    for (int i = begin; i < end; i++) {
+        const double* p = pts + ids[i] * 3;
+        for (int d = 0; d < 3; d++) {
+            node.lo[d] = std::min(node.lo[d], p[d]);
+            node.hi[d] = std::max(node.hi[d], p[d]);
+        }
+    }
+
+    if (end - begin <= kLeafSize) {
+        for (int i = begin; i < end; i++) leafOf[ids[i]] = index;
+        nodes[index] = node;
+        return index;
+    }
+
+    // 沿包围盒最长的轴在中位数处划分
+    int axis = 0;
+    for (int d = 1; d < 3; d++) {
+        if (node.hi[d] - node.lo[d] > node.hi[axis] - node.lo[axis]) axis = d;
+    }
+    int mid = (begin + end) / 2;
+    std::nth_element(ids.begin() + begin, ids.begin() + mid, ids.begin() + end,
+                     [this, axis](int a, int b) { return pts[a * 3 + axis] < pts[b * 3 + axis]; });
+
+    nodes[index] = node;
+    int left = buildNode(begin, mid, index);
+    int right = buildNode(mid, end, index);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+}
+
+void KdTree::remove(int id) {
+    if (id < 0 || id >= (int)removed.size() || removed[id]) return;
+    removed[id] = 1;
+    for (int n = leafOf[id]; n >= 0; n = nodes[n].parent) nodes[n].alive--;
+}
+
+// 包围盒各轴的差值取自盒内某个点的坐标，逐轴不大于到该点的差值，
+// 按同样的顺序累加开方后也不大于点距离，剪枝不会漏掉边界上的点
+double KdTree::boxDistance(const Node& node, const double* c) const {
+    double sum = 0;
+    for (int d = 0; d < 3; d++) {
+        double delta = c[d] < node.lo[d] ? node.lo[d] - c[d] :
+                       c[d] > node.hi[d] ? c[d] - node.hi[d] : 0.0;
+        sum += delta * delta;
+    }
+    return std::sqrt(sum);
+}
+
+double KdTree::pointDistance(int id, const double* c) const {
+    const double* p = pts + id * 3;
+    double dx = p[0] - c[0];
+    double dy = p[1] - c[1];
+    double dz = p[2] - c[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void KdTree::radiusQuery(const double* center, double radius, std::vector<int>& out) const {
+    size_t first = out.size();
+    if (!nodes.empty()) radiusRecurse(0, center, radius, out);
+    std::sort(out.begin() + first, out.end());
+}
+
+void KdTree::radiusRecurse(int index, const double* c, double radius, std::vector<int>& out) const {
+    const Node& node = nodes[index];
+    if (node.alive == 0 || boxDistance(node, c) > radius) return;
+    if (node.left < 0) {
+        for (int i = node.begin; i < node.end; i++) {
+            int id = ids[i];
+            if (!removed[id] && pointDistance(id, c) <= radius) out.push_back(id);
+        }
+        return;
+    }
+    radiusRecurse(node.left, c, radius, out);
+    radiusRecurse(node.right, c, radius, out);
+}
+
+int KdTree::nearest(const double* center) const {
+    double bestDist = std::numeric_limits<double>::infinity();
+    int bestId = -1;
+    if (!nodes.empty()) nearestRecurse(0, center, bestDist, bestId);
+    return bestId;
+}
+
+void KdTree::nearestRecurse(int index, const double* c, double& bestDist, int& bestId) const {
+    const Node& node = nodes[index];
+    // 距离相等的点可能编号更小，只剪掉严格更远的子树
+    if (node.alive == 0 || boxDistance(node, c) > bestDist) return;
+    if (node.left < 0) {
+        for (int i = node.begin; i < node.end; i++) {
+            int id = ids[i];
+            if (removed[id]) continue;
+            double d = pointDistance(id, c);
+            if (d < bestDist || (d == bestDist && (bestId < 0 || id < bestId))) {
+                bestDist = d;
+                bestId = id;
+            }
+        }
+        return;
+    }
+    // 先进入包含查询点一侧的子树
+    double dl = boxDistance(nodes[node.left], c);
+    double dr = boxDistance(nodes[node.right], c);
+    if (dl <= dr) {
+        nearestRecurse(node.left, c, bestDist, bestId);
+        nearestRecurse(node.right, c, bestDist, bestId);
+    } else {
+        nearestRecurse(node.right, c, bestDist, bestId);
+        nearestRecurse(node.left, c, bestDist, bestId);
+    }
+}
+
+void clusterByDistance(const double* points, int count, double eps,
+                       std::vector<int>& offsets, std::vector<int>& members) {
+    KdTree tree;
+    tree.build(points, count);
+
+    // JS实现用数组栈，已访问的点出栈后跳过，同一点可能多次入栈；
+    // 一个点只有最后一次入栈的位置有效，这里用双向链表栈把重复入栈改成移到栈顶，
+    // 访问顺序不变，栈大小不超过点数
+    const int none = -1;
+    std::vector<int> below(count, none), above(count, none);
+    std::vector<char> inStack(count, 0);
+    int top = none;
+    auto push = [&](int id) {
+        if (inStack[id]) {
+            if (above[id] != none) below[above[id]] = below[id];
+            if (below[id] != none) above[below[id]] = above[id];
+            if (top == id) top = below[id];
+        }
+        below[id] = top;
+        above[id] = none;
+        if (top != none) above[top] = id;
+        top = id;
+        inStack[id] = 1;
+    };
+    auto pop = [&]() {
+        int id = top;
+        top = below[id];
+        if (top != none) above[top] = none;
+        inStack[id] = 0;
+        return id;
+    };
+
+    std::vector<std::vector<int>> clusters;
+    std::vector<int> cluster, neighbors;
+    std::vector<char> visited(count, 0);
+    for (int seed = 0; seed < count; seed++) {
+        if (visited[seed]) continue;
+        cluster.clear();
+        push(seed);
+        while (top != none) {
+            int current = pop();
+            visited[current] = 1;
+            tree.remove(current);
+            cluster.push_back(current);
+
+            // 未访问的邻居按原顺序入栈
+            neighbors.clear();
+            tree.radiusQuery(points + current * 3, eps, neighbors);
+            for (int other : neighbors) push(other);
+        }
+        if (cluster.size() >= 2) clusters.push_back(cluster);
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const std::vector<int>& a, const std::vector<int>& b) { return a.size() > b.size(); });
+
+    offsets.assign(1, 0);
+    members.clear();
+    for (const std::vector<int>& c : clusters) {
+        members.insert(members.end(), c.begin(), c.end());
+        offsets.push_back(members.size());
+    }
+}
+
+std::vector<int> orderByNearestNeighbor(const double* points, int count) {
+    std::vector<int> order;
+    if (count <= 0) return order;
+    order.reserve(count);
+    if (count <= 2) {
+        for (int i = 0; i < count; i++) order.push_back(i);
+        return order;
+    }
+
+    KdTree tree;
+    tree.build(points, count);
+    int current = 0;
+    order.push_back(current);
+    tree.remove(current);
+    while (tree.aliveCount() > 0) {
+        int next = tree.nearest(points + current * 3);
+        if (next < 0) break;
+        order.push_back(next);
+        tree.remove(next);
+        current = next;
+    }
+    return order;
+}
+
+} // namespace bff
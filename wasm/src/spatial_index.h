@@ -0,0 +1,81 @@
+/**
+ * 点集空间索引（k-d树）及缝线红点的聚类和排序
+ * SeamExtractor.dbscanCluster / orderByNearestNeighbor 的原生实现：
+ * 邻域查询只访问与查询球相交、且仍有未处理点的子树，代替两两比较
+ */
+
+#ifndef BFF_SPATIAL_INDEX_H
+#define BFF_SPATIAL_INDEX_H
+
+#include <vector>
+
+namespace bff {
+
+/**
+ * 静态k-d树，点可以删除（删除后不再出现在查询结果中）
+ * 距离按 sqrt(dx*dx + dy*dy + dz*dz) 计算，与JS实现逐位一致
+ */
+class KdTree {
+public:
+    /**
+     * @param points 点坐标 [x0,y0,z0, ...]，查询期间须保持有效
+     * @param count 点数，点编号即数组下标
+     */
+    void build(const double* points, int count);
+
+    // 删除点
+    void remove(int id);
+
+    /**
+     * 距离不超过radius的未删除点，按编号升序追加到out
+     */
+    void radiusQuery(const double* center, double radius, std::vector<int>& out) const;
+
+    /**
+     * 距离最近的未删除点，距离相同时取编号最小者；没有未删除点时返回-1
+     */
+    int nearest(const double* center) const;
+
+    int aliveCount() const { return nodes.empty() ? 0 : nodes[0].alive; }
+
+private:
+    struct Node {
+        double lo[3], hi[3];   // 包围盒
+        int begin, end;        // ids中的范围
+        int left, right;       // 子节点，叶子为-1
+        int parent;
+        int alive;             // 子树中未删除的点数
+    };
+
+    const double* pts = nullptr;
+    std::vector<Node> nodes;
+    std::vector<int> ids;          // 按树的划分重排后的点编号
+    std::vector<int> leafOf;       // 点 -> 所在叶子
+    std::vector<char> removed;
+
+    int buildNode(int begin, int end, int parent);
+    double boxDistance(const Node& node, const double* c) const;
+    double pointDistance(int id, const double* c) const;
+    void radiusRecurse(int node, const double* c, double radius, std::vector<int>& out) const;
+    void nearestRecurse(int node, const double* c, double& bestDist, int& bestId) const;
+};
+
+/**
+ * 按距离阈值聚类（与 SeamExtractor.dbscanCluster 结果相同）：
+ * 距离不超过eps的点连通，按种子顺序深度优先展开，单点簇丢弃，按簇大小降序稳定排序
+ * @param points 点坐标 [x0,y0,z0, ...]
+ * @param offsets 输出：簇i的成员为 members[offsets[i] .. offsets[i+1])
+ * @param members 输出：点编号，簇内顺序与JS实现的访问顺序相同
+ */
+void clusterByDistance(const double* points, int count, double eps,
+                       std::vector<int>& offsets, std::vector<int>& members);
+
+/**
+ * 从第0个点出发，每次走到最近的未访问点（与 SeamExtractor.orderByNearestNeighbor 相同）
+ * @return 点编号的访问顺序
+ */
+std::vector<int> orderByNearestNeighbor(const double* points, int count);
+
+} // namespace bff
+
+#endif // BFF_SPATIAL_INDEX_H
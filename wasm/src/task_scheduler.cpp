@@ -0,0 +1,173 @@
+/**
+ * 任务调度器实现
+ * 每个线程一个任务队列（外部调用线程共用一个注入队列），
+ * 线程优先从自己的队列尾部取任务，空闲时从其他队列头部窃取
+ */
+
+#include "task_scheduler.h"
+#include <algorithm>
+#if BFF_USE_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace bff {
+
+#if BFF_USE_THREADS
+
+namespace {
+
+struct Task {
+    const std::function<void(int, int)>* fn;
+    int begin;
+    int end;
+    std::atomic<int>* remaining;   // 所属parallelFor未完成的块数
+};
+
+struct TaskQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+};
+
+// 当前线程对应的队列，非工作线程为-1
+thread_local int tlsQueue = -1;
+
+class Scheduler {
+public:
+    Scheduler() {
+        int hw = std::thread::hardware_concurrency();
+        numWorkers = std::max(0, std::min(hw, 64) - 1);
+        for (int i = 0; i <= numWorkers; i++) {
+            queues.emplace_back(new TaskQueue());
+        }
+        for (int i = 0; i < numWorkers; i++) {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    int threadCount() const { return numWorkers + 1; }
+
+    void run(int count, int grain, const std::function<void(int, int)>& fn) {
+        // 块数约为线程数的4倍，便于负载均衡
+        int chunk = std::max(grain, (count + threadCount() * 4 - 1) / (threadCount() * 4));
+        int numChunks = (count + chunk - 1) / chunk;
+        if (numWorkers == 0 || numChunks <= 1) {
+            fn(0, count);
+            return;
+        }
+
+        std::atomic<int> remaining(numChunks);
+        int self = tlsQueue >= 0 ? tlsQueue : numWorkers;
+        {
+            TaskQueue& q = *queues[self];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            for (int c = 1; c < numChunks; c++) {
+                q.tasks.push_back(Task{&fn, c * chunk, std::min(count, (c + 1) * chunk), &remaining});
+            }
+        }
+        queued.fetch_add(numChunks - 1);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wake.notify_all();
+
+        fn(0, std::min(count, chunk));
+        remaining.fetch_sub(1);
+
+        // 等待期间执行其他任务（包括嵌套parallelFor提交的任务）
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!runOne(self)) std::this_thread::yield();
+        }
+    }
+
+private:
+    int numWorkers = 0;
+    std::vector<std::unique_ptr<TaskQueue>> queues;   // 下标numWorkers为注入队列
+    std::vector<std::thread> workers;
+    std::atomic<int> queued{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stop = false;
+
+    bool take(int queueIndex, bool fromBack, Task& task) {
+        TaskQueue& q = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        if (fromBack) {
+            task = q.tasks.back();
+            q.tasks.pop_back();
+        } else {
+            task = q.tasks.front();
+            q.tasks.pop_front();
+        }
+        queued.fetch_sub(1);
+        return true;
+    }
+
+    bool runOne(int self) {
+        Task task;
+        bool found = take(self, true, task);
+        for (int i = 1; !found && i < (int)queues.size(); i++) {
+            found = take((self + i) % queues.size(), false, task);
+        }
+        if (!found) return false;
+        (*task.fn)(task.begin, task.end);
+        task.remaining->fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void workerLoop(int index) {
+        tlsQueue = index;
+        for (;;) {
+            if (runOne(index)) continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return stop || queued.load() > 0; });
+            if (stop) return;
+        }
+    }
+};
+
+Scheduler& scheduler() {
+    static Scheduler instance;
+    return instance;
+}
+
+} // namespace
+
+void parallelFor(int count, int grain, const std::function<void(int, int)>& fn) {
+    if (count <= 0) return;
+    scheduler().run(count, std::max(1, grain), fn);
+}
+
+int schedulerThreadCount() {
+    return scheduler().threadCount();
+}
+
+#else
+
+void parallelFor(int count, int grain, const std::function<void(int, int)>& fn) {
+    (void)grain;
+    if (count > 0) fn(0, count);
+}
+
+int schedulerThreadCount() {
+    return 1;
+}
+
+#endif
+
+} // namespace bff
@@ -0,0 +1,37 @@
+/**
+ * 任务调度器：工作窃取线程池
+ * 片段展开、逐三角形预计算和ARAP局部步骤都通过parallelFor提交任务；
+ * 等待中的线程会执行其他任务，因此可以在并行任务内部再次调用parallelFor
+ * 未启用多线程（BFF_USE_THREADS为0）时parallelFor在调用线程内顺序执行
+ */
+
+#ifndef BFF_TASK_SCHEDULER_H
+#define BFF_TASK_SCHEDULER_H
+
+#include <functional>
+
+// 多线程构建（em++ -pthread 会定义 __EMSCRIPTEN_PTHREADS__）
+#ifndef BFF_USE_THREADS
+#if defined(__EMSCRIPTEN_PTHREADS__)
+#define BFF_USE_THREADS 1
+#else
+#define BFF_USE_THREADS 0
+#endif
+#endif
+
+namespace bff {
+
+/**
+ * 并行执行 fn(begin, end)，把 [0, count) 切成不小于grain的块
+ * 调用线程参与执行，返回时所有块均已完成
+ */
+void parallelFor(int count, int grain, const std::function<void(int, int)>& fn);
+
+/**
+ * 参与执行任务的线程数（含调用线程），单线程构建为1
+ */
+int schedulerThreadCount();
+
+} // namespace bff
+
+#endif // BFF_TASK_SCHEDULER_H
@@ -0,0 +1,337 @@
+/**
+ * 网格拓扑修复实现
+ */
+
+#include "topology_repair.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace bff {
+
+namespace {
+
+inline uint64_t mixKey(uint64_t key) {
+    return (key * 0x9E3779B97F4A7C15ull) >> 32;
+}
+
+// 并查集查找（路径减半）
+int findRoot(std::vector<int>& parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+inline double distance(const Vec3& a, const Vec3& b) {
+    double dx = double(a.x) - b.x, dy = double(a.y) - b.y, dz = double(a.z) - b.z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+} // namespace
+
+int weldVertices(const Vec3* positions, int numVertices, double tolerance, int* remap, std::vector<int>& source) {
+    BFF_PROFILE_SCOPE("weld");
+    source.clear();
+    if (numVertices == 0) return 0;
+
+    // 格子坐标为完整的int64（仅防止转换溢出），三个坐标一起混合作为哈希，键比较完整的三元组
+    struct Cell {
+        int64_t x, y, z;
+        bool operator==(const Cell& o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+    const double limit = 4.0e18;
+    auto cellOf = [&](double x) {
+        double c = std::floor(x / tolerance);
+        if (!(c == c)) c = 0;
+        return int64_t(std::min(std::max(c, -limit), limit));
+    };
+    auto cellHash = [](const Cell& c) {
+        uint64_t h = uint64_t(c.x) * 0x9E3779B97F4A7C15ull;
+        h ^= (h >> 29) ^ (uint64_t(c.y) * 0xC2B2AE3D27D4EB4Full);
+        h ^= (h >> 32) ^ (uint64_t(c.z) * 0x165667B19E3779F9ull);
+        return h ^ (h >> 31);
+    };
+
+    // 开放寻址：格子 -> 该格子中已保留顶点链表的表头（新顶点编号），next串起同一格子的顶点
+    size_t tableSize = 16;
+    while (tableSize < size_t(numVertices) * 2) tableSize <<= 1;
+    size_t mask = tableSize - 1;
+    std::vector<Cell> keys(tableSize);
+    std::vector<int> heads(tableSize, -1);
+    std::vector<int> next;
+    next.reserve(numVertices);
+    source.reserve(numVertices);
+
+    // 空槽位的heads为-1（每个被占用的格子至少有一个顶点）
+    auto slotOf = [&](const Cell& key) {
+        size_t h = cellHash(key) & mask;
+        while (heads[h] >= 0 && !(keys[h] == key)) h = (h + 1) & mask;
+        return h;
+    };
+
+    double tol2 = tolerance * tolerance;
+    for (int v = 0; v < numVertices; v++) {
+        const Vec3& p = positions[v];
+        int64_t cx = cellOf(p.x), cy = cellOf(p.y), cz = cellOf(p.z);
+        int best = -1;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dz = -1; dz <= 1; dz++) {
+                    size_t h = slotOf(Cell{cx + dx, cy + dy, cz + dz});
+                    for (int w = heads[h]; w >= 0; w = next[w]) {
+                        if (best >= 0 && w >= best) continue;
+                        const Vec3& q = positions[source[w]];
+                        double ex = double(p.x) - q.x, ey = double(p.y) - q.y, ez = double(p.z) - q.z;
+                        if (ex * ex + ey * ey + ez * ez <= tol2) best = w;
+                    }
+                }
+            }
+        }
+        if (best >= 0) {
+            remap[v] = best;
+            continue;
+        }
+        int id = source.size();
+        source.push_back(v);
+        Cell cell{cx, cy, cz};
+        size_t h = slotOf(cell);
+        keys[h] = cell;
+        next.push_back(heads[h]);
+        heads[h] = id;
+        remap[v] = id;
+    }
+    BFF_PROFILE_COUNT("weldedVertices", numVertices - int(source.size()));
+    return source.size();
+}
+
+int removeDegenerateFaces(int* triangles, int numFaces, std::vector<int>& faceSource) {
+    faceSource.clear();
+    faceSource.reserve(numFaces);
+    for (int f = 0; f < numFaces; f++) {
+        int a = triangles[f * 3], b = triangles[f * 3 + 1], c = triangles[f * 3 + 2];
+        if (a == b || b == c || c == a) continue;
+        int* dst = &triangles[faceSource.size() * 3];
+        dst[0] = a;
+        dst[1] = b;
+        dst[2] = c;
+        faceSource.push_back(f);
+    }
+    return faceSource.size();
+}
+
+void buildTwins(const int* triangles, int numFaces, int* twin, bool requireOpposite) {
+    int numHE = numFaces * 3;
+    struct EdgeSlot {
+        uint64_t key;
+        int first;
+        int second;
+        int count;
+    };
+    const uint64_t emptyKey = ~uint64_t(0);
+    size_t tableSize = 16;
+    while (tableSize < size_t(numHE) * 2) tableSize <<= 1;
+    size_t mask = tableSize - 1;
+    std::vector<EdgeSlot> slots(tableSize, EdgeSlot{emptyKey, -1, -1, 0});
+
+    auto origin = [&](int h) { return triangles[h]; };
+    auto target = [&](int h) { return triangles[h - h % 3 + (h + 1) % 3]; };
+    for (int h = 0; h < numHE; h++) {
+        twin[h] = -1;
+        int a = origin(h), b = target(h);
+        if (a > b) std::swap(a, b);
+        uint64_t key = (uint64_t(uint32_t(a)) << 32) | uint32_t(b);
+        size_t s = mixKey(key) & mask;
+        while (slots[s].key != emptyKey && slots[s].key != key) s = (s + 1) & mask;
+        EdgeSlot& slot = slots[s];
+        if (slot.key == emptyKey) {
+            slot = EdgeSlot{key, h, -1, 1};
+            continue;
+        }
+        if (slot.count == 1) slot.second = h;
+        slot.count++;
+    }
+    for (const EdgeSlot& slot : slots) {
+        if (slot.count != 2 || (requireOpposite && origin(slot.first) != target(slot.second))) continue;
+        twin[slot.first] = slot.second;
+        twin[slot.second] = slot.first;
+    }
+}
+
+int splitCornerFans(const int* triangles, const int* twin, const uint8_t* cut, const int* order,
+                    int numFaces, int numVertices, int* cornerVertex, std::vector<int>& vertexSource) {
+    int numHE = numFaces * 3;
+    auto next = [](int h) { return h - h % 3 + (h + 1) % 3; };
+
+    // 角点（以半边起点表示）跨未切开的内部边合并，同splitBySeams
+    std::vector<int> parent(numHE);
+    for (int h = 0; h < numHE; h++) parent[h] = h;
+    auto unite = [&](int a, int b) {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a != b) parent[b] = a;
+    };
+    for (int h = 0; h < numHE; h++) {
+        int t = twin[h];
+        if (t < h || (cut && (cut[h] || cut[t]))) continue;
+        unite(h, next(t));
+        unite(next(h), t);
+    }
+
+    vertexSource.resize(numVertices);
+    for (int v = 0; v < numVertices; v++) vertexSource[v] = v;
+    std::vector<int> rootVertex(numHE, -1);
+    std::vector<char> used(numVertices, 0);
+    for (int i = 0; i < numHE; i++) {
+        int h = order ? order[i] : i;
+        int root = findRoot(parent, h);
+        if (rootVertex[root] == -1) {
+            int v = triangles[h];
+            if (!used[v]) {
+                used[v] = 1;
+                rootVertex[root] = v;
+            } else {
+                rootVertex[root] = vertexSource.size();
+                vertexSource.push_back(v);
+            }
+        }
+        cornerVertex[h] = rootVertex[root];
+    }
+    return int(vertexSource.size()) - numVertices;
+}
+
+int cutAlongSeams(const int* triangles, int numFaces, int numVertices, const uint8_t* cutEdge,
+                  const uint8_t* cutVertex, int* cornerVertex, std::vector<int>& vertexSource) {
+    int numHE = numFaces * 3;
+    std::vector<int> twin(numHE);
+    buildTwins(triangles, numFaces, twin.data(), false);
+
+    std::vector<int> group(numFaces);
+    for (int f = 0; f < numFaces; f++) group[f] = f;
+    for (int h = 0; h < numHE; h++) {
+        int t = twin[h];
+        if (t < h || cutEdge[h] || cutEdge[t]) continue;
+        int a = findRoot(group, h / 3), b = findRoot(group, t / 3);
+        if (a != b) group[b] = a;
+    }
+
+    vertexSource.resize(numVertices);
+    for (int v = 0; v < numVertices; v++) vertexSource[v] = v;
+    std::unordered_map<uint64_t, int> copies;   // (端点, 组) -> 新顶点
+    std::vector<char> used(numVertices, 0);
+    for (int h = 0; h < numHE; h++) {
+        int v = triangles[h];
+        if (!cutVertex[v]) {
+            cornerVertex[h] = v;
+            continue;
+        }
+        uint64_t key = (uint64_t(uint32_t(v)) << 32) | uint32_t(findRoot(group, h / 3));
+        auto it = copies.find(key);
+        if (it == copies.end()) {
+            int id = v;
+            if (used[v]) {
+                id = vertexSource.size();
+                vertexSource.push_back(v);
+            }
+            used[v] = 1;
+            it = copies.emplace(key, id).first;
+        }
+        cornerVertex[h] = it->second;
+    }
+    return int(vertexSource.size()) - numVertices;
+}
+
+int countBoundaryLoops(const int* triangles, const int* twin, int numFaces, int numVertices) {
+    int numHE = numFaces * 3;
+    auto target = [&](int h) { return triangles[h - h % 3 + (h + 1) % 3]; };
+
+    // 边界半边按起点建表，沿终点依次取未用过的边界半边
+    std::vector<int> start(numVertices + 1, 0), edges;
+    for (int h = 0; h < numHE; h++) {
+        if (twin[h] < 0) start[triangles[h] + 1]++;
+    }
+    for (int v = 0; v < numVertices; v++) start[v + 1] += start[v];
+    edges.resize(start[numVertices]);
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    for (int h = 0; h < numHE; h++) {
+        if (twin[h] < 0) edges[fill[triangles[h]]++] = h;
+    }
+
+    std::vector<int> cursor(start.begin(), start.end() - 1);
+    auto take = [&](int v) { return cursor[v] < start[v + 1] ? edges[cursor[v]++] : -1; };
+    int loops = 0;
+    for (int v = 0; v < numVertices; v++) {
+        int h;
+        while ((h = take(v)) >= 0) {
+            loops++;
+            for (int w = target(h); w != v && (h = take(w)) >= 0; w = target(h)) {}
+        }
+    }
+    return loops;
+}
+
+void EdgePathFinder::build(const Vec3* positions, int numVertices, const int* triangles, int numFaces) {
+    pts = positions;
+    adjStart.assign(numVertices + 1, 0);
+    for (int h = 0; h < numFaces * 3; h++) adjStart[triangles[h] + 1] += 2;
+    for (int v = 0; v < numVertices; v++) adjStart[v + 1] += adjStart[v];
+    adjVertex.resize(adjStart[numVertices]);
+    std::vector<int> fill(adjStart.begin(), adjStart.end() - 1);
+    for (int f = 0; f < numFaces; f++) {
+        for (int k = 0; k < 3; k++) {
+            int a = triangles[f * 3 + k];
+            adjVertex[fill[a]++] = triangles[f * 3 + (k + 1) % 3];
+            adjVertex[fill[a]++] = triangles[f * 3 + (k + 2) % 3];
+        }
+    }
+    dist.assign(numVertices, std::numeric_limits<double>::infinity());
+    prev.assign(numVertices, -1);
+    closed.assign(numVertices, 0);
+    touched.clear();
+}
+
+bool EdgePathFinder::find(int from, int to, std::vector<int>& path) {
+    path.clear();
+    for (int v : touched) {
+        dist[v] = std::numeric_limits<double>::infinity();
+        prev[v] = -1;
+        closed[v] = 0;
+    }
+    touched.clear();
+
+    // 直线距离是路径长度的下界且满足三角不等式，A*取出顶点时即为最短
+    const Vec3& goal = pts[to];
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    dist[from] = 0;
+    touched.push_back(from);
+    open.push({distance(pts[from], goal), from});
+    while (!open.empty()) {
+        int v = open.top().second;
+        open.pop();
+        if (closed[v]) continue;
+        closed[v] = 1;
+        if (v == to) break;
+        for (int i = adjStart[v]; i < adjStart[v + 1]; i++) {
+            int w = adjVertex[i];
+            if (closed[w]) continue;
+            double d = dist[v] + distance(pts[v], pts[w]);
+            if (d < dist[w]) {
+                if (prev[w] == -1 && w != from) touched.push_back(w);
+                dist[w] = d;
+                prev[w] = v;
+                open.push({d + distance(pts[w], goal), w});
+            }
+        }
+    }
+    if (!closed[to]) return false;
+    for (int v = to; v != -1; v = prev[v]) path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+} // namespace bff
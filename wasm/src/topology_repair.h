@@ -0,0 +1,118 @@
+/**
+ * 网格拓扑修复和沿缝线切开（MeshScissor.mergeVertices / cutAlongEdges、MeshCutter.connectRedVertices
+ * 预处理的原生实现），在上传后的网格上进行，不生成字符串key
+ *
+ * - 焊接：空间哈希，格子边长等于容差，每个顶点只与相邻27格内已保留的顶点比较
+ * - 扇区拆分：同一顶点的角点跨“成对”的内部边（恰好两个面共享且朝向一致）合并为扇区，
+ *   每个扇区一个顶点，用于拆开非流形顶点（蝴蝶结顶点、三个以上面共享的边的端点）
+ * - 沿缝线切开：按面组复制缝线端点，与JS的切开结果相同
+ * - 缝线路径：沿网格边连接相邻路标的最短路径（A*，边长为3D距离）
+ */
+
+#ifndef BFF_TOPOLOGY_REPAIR_H
+#define BFF_TOPOLOGY_REPAIR_H
+
+#include <cstdint>
+#include <vector>
+#include "scalar_types.h"
+
+namespace bff {
+
+// 上传网格时的拓扑修复（BFFFlattener::setRepairOptions）
+struct RepairOptions {
+    double weldTolerance = 0;        // >0 时焊接距离不超过该值的顶点，并删除焊接后退化的面
+    bool splitNonManifold = false;   // 拆分非流形顶点
+
+    bool enabled() const { return weldTolerance > 0 || splitNonManifold; }
+};
+
+struct RepairStats {
+    int inputVertices = 0;
+    int inputFaces = 0;
+    int weldedVertices = 0;          // 被合并掉的顶点数
+    int degenerateFaces = 0;         // 焊接后有重复角点而删除的面
+    int splitVertices = 0;           // 拆分非流形顶点新增的顶点数
+    int boundaryLoops = 0;           // 修复后的边界环数（孔洞和开口）
+    double weldMs = 0;
+    double splitMs = 0;
+};
+
+/**
+ * 焊接：按编号顺序处理，顶点并入距离不超过tolerance的编号最小的已保留顶点，否则自己保留
+ * @param remap 输出 原顶点 -> 新顶点 [numVertices]
+ * @param source 输出 新顶点 -> 保留的原顶点（新顶点的位置即该原顶点的位置）
+ * @return 新顶点数
+ */
+int weldVertices(const Vec3* positions, int numVertices, double tolerance, int* remap, std::vector<int>& source);
+
+/**
+ * 原地删除有重复角点的面，保留的面保持顺序
+ * @param faceSource 输出 保留的面 -> 原面
+ * @return 保留的面数
+ */
+int removeDegenerateFaces(int* triangles, int numFaces, std::vector<int>& faceSource);
+
+/**
+ * 对偶半边（半边3f+i 从 triangles[3f+i] 指向 triangles[3f+(i+1)%3]），规则同BFFFlattener：
+ * 只有恰好两条、方向相反的半边互为对偶，其余为-1
+ * @param requireOpposite 为false时恰好两个面共享的边不论朝向都互为对偶（同MeshScissor的面邻接）
+ */
+void buildTwins(const int* triangles, int numFaces, int* twin, bool requireOpposite = true);
+
+/**
+ * 扇区拆分：每个顶点的第一个扇区沿用原编号，其余扇区按出现顺序追加在末尾
+ * @param cut 每条半边一个标记，非0的边不合并（任一侧标记即可），可为nullptr
+ * @param order 确定“第一个”和追加顺序的半边访问顺序 [3F]，nullptr为按编号
+ * @param cornerVertex 输出 半边 -> 其起点角所在扇区的顶点 [3F]
+ * @param vertexSource 输出 新顶点 -> 原顶点（前numVertices个为恒等）
+ * @return 新增的顶点数
+ */
+int splitCornerFans(const int* triangles, const int* twin, const uint8_t* cut, const int* order,
+                    int numFaces, int numVertices, int* cornerVertex, std::vector<int>& vertexSource);
+
+/**
+ * 沿缝线切开，规则同 MeshScissor.cutAlongEdges：面跨恰好两个面共享的非切边（不论朝向）连成组，
+ * 切边端点在它出现的每个组中各有一个顶点，其余顶点（包括非流形顶点）不拆
+ * 面按编号、角点按顺序访问，端点第一次出现的组沿用原编号，其余组的副本按出现顺序追加在末尾
+ * @param cutEdge 每条半边一个标记，非0的边不连接两侧的面
+ * @param cutVertex 每个顶点一个标记，非0为切边端点
+ * @param cornerVertex 输出 半边 -> 其起点角的新顶点 [3F]
+ * @param vertexSource 输出 新顶点 -> 原顶点（前numVertices个为恒等）
+ * @return 新增的顶点数
+ */
+int cutAlongSeams(const int* triangles, int numFaces, int numVertices, const uint8_t* cutEdge,
+                  const uint8_t* cutVertex, int* cornerVertex, std::vector<int>& vertexSource);
+
+/**
+ * 边界环数：没有对偶的半边按终点处的下一条边界半边首尾相接
+ */
+int countBoundaryLoops(const int* triangles, const int* twin, int numFaces, int numVertices);
+
+/**
+ * 网格边上的最短路径，多次查询共用邻接表，每次查询只重置访问过的顶点
+ */
+class EdgePathFinder {
+public:
+    void build(const Vec3* positions, int numVertices, const int* triangles, int numFaces);
+
+    bool empty() const { return adjStart.empty(); }
+
+    /**
+     * @param path 输出 from ... to 的顶点序列
+     * @return 不连通时返回false
+     */
+    bool find(int from, int to, std::vector<int>& path);
+
+private:
+    const Vec3* pts = nullptr;
+    std::vector<int> adjStart;
+    std::vector<int> adjVertex;
+    std::vector<double> dist;
+    std::vector<int> prev;
+    std::vector<char> closed;
+    std::vector<int> touched;
+};
+
+} // namespace bff
+
+#endif // BFF_TOPOLOGY_REPAIR_H
@@ -0,0 +1,262 @@
+/**
+ * UV排料实现
+ */
+
+#include "uv_packer.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace bff {
+
+namespace {
+
+const double kHalfPi = 1.57079632679489661923;
+
+struct Point {
+    double x, y;
+};
+
+double cross(const Point& o, const Point& a, const Point& b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// Andrew单调链，逆时针，不含共线点
+std::vector<Point> convexHull(std::vector<Point> pts) {
+    std::sort(pts.begin(), pts.end(), [](const Point& a, const Point& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    pts.erase(std::unique(pts.begin(), pts.end(), [](const Point& a, const Point& b) {
+        return a.x == b.x && a.y == b.y;
+    }), pts.end());
+    if (pts.size() < 3) return pts;
+
+    std::vector<Point> hull(pts.size() * 2);
+    size_t k = 0;
+    for (size_t i = 0; i < pts.size(); i++) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+        hull[k++] = pts[i];
+    }
+    for (size_t i = pts.size() - 1, lower = k + 1; i > 0; i--) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], pts[i - 1]) <= 0) k--;
+        hull[k++] = pts[i - 1];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+double polygonArea(const std::vector<Point>& poly) {
+    double area = 0;
+    for (size_t i = 0, n = poly.size(); i < n; i++) {
+        const Point& a = poly[i];
+        const Point& b = poly[(i + 1) % n];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return std::fabs(area) * 0.5;
+}
+
+// 旋转angle后的包围盒
+void rotatedBounds(const std::vector<Point>& pts, double angle,
+                   double& minX, double& minY, double& maxX, double& maxY) {
+    double c = std::cos(angle), s = std::sin(angle);
+    minX = minY = std::numeric_limits<double>::infinity();
+    maxX = maxY = -std::numeric_limits<double>::infinity();
+    for (const Point& p : pts) {
+        double x = c * p.x - s * p.y;
+        double y = s * p.x + c * p.y;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+    if (pts.empty()) minX = minY = maxX = maxY = 0;
+}
+
+// 最小面积包围矩形的某一边与凸包的某条边平行，逐边试探，O(h²)；片段凸包通常只有几十到几百个点
+double minAreaAngle(const std::vector<Point>& hull) {
+    double bestAngle = 0;
+    double bestArea = std::numeric_limits<double>::infinity();
+    for (size_t i = 0, n = hull.size(); i < n; i++) {
+        const Point& a = hull[i];
+        const Point& b = hull[(i + 1) % n];
+        double angle = -std::atan2(b.y - a.y, b.x - a.x);
+        double minX, minY, maxX, maxY;
+        rotatedBounds(hull, angle, minX, minY, maxX, maxY);
+        double area = (maxX - minX) * (maxY - minY);
+        if (area < bestArea * (1 - 1e-9)) {
+            bestArea = area;
+            bestAngle = angle;
+        }
+    }
+    return bestAngle;
+}
+
+struct Item {
+    std::vector<Point> hull;     // 已缩放
+    double angle = 0;            // 对齐旋转
+    double width = 0;            // 对齐后的包围盒
+    double height = 0;
+};
+
+// skyline的一段：[x, x+width) 上已占用到高度y
+struct Segment {
+    double x, y, width;
+};
+
+class Skyline {
+public:
+    explicit Skyline(double width) : stripWidth(width) {
+        segments.push_back(Segment{0, 0, width});
+    }
+
+    /**
+     * 宽w的矩形（不含间距）左端放在第i段起点时的底边高度；超出条带时返回false
+     * wide为计入间距的宽度，用于判断压住哪些段
+     */
+    bool fit(size_t i, double w, double wide, double& y) const {
+        double x = segments[i].x;
+        if (x + w > stripWidth * (1 + 1e-12)) return false;
+        y = 0;
+        double right = x + std::min(wide, stripWidth - x);
+        for (size_t j = i; j < segments.size() && segments[j].x < right; j++) {
+            y = std::max(y, segments[j].y);
+        }
+        return true;
+    }
+
+    // 在第i段起点放入占用宽wide、顶部在top的矩形
+    void place(size_t i, double wide, double top) {
+        double x = segments[i].x;
+        double right = std::min(x + wide, stripWidth);
+        Segment added{x, top, right - x};
+
+        // 去掉被覆盖的段，截短部分覆盖的段
+        size_t j = i;
+        while (j < segments.size() && segments[j].x + segments[j].width <= right) j++;
+        if (j < segments.size() && segments[j].x < right) {
+            Segment& s = segments[j];
+            s.width -= right - s.x;
+            s.x = right;
+        }
+        segments.erase(segments.begin() + i, segments.begin() + j);
+        segments.insert(segments.begin() + i, added);
+
+        // 合并相邻同高的段
+        for (size_t k = 0; k + 1 < segments.size();) {
+            if (segments[k].y == segments[k + 1].y) {
+                segments[k].width += segments[k + 1].width;
+                segments.erase(segments.begin() + k + 1);
+            } else {
+                k++;
+            }
+        }
+    }
+
+    size_t size() const { return segments.size(); }
+    double segmentX(size_t i) const { return segments[i].x; }
+
+private:
+    double stripWidth;
+    std::vector<Segment> segments;
+};
+
+} // namespace
+
+PackResult packIslands(const double* points, const int* offsets, int numIslands,
+                       const double* scales, const PackOptions& options) {
+    PackResult result;
+    result.transforms.resize(numIslands);
+    if (numIslands <= 0) return result;
+
+    std::vector<Item> items(numIslands);
+    double totalArea = 0;
+    double hullArea = 0;
+    double minStrip = 0;   // 最宽片段（可旋转时取较短边）
+    for (int i = 0; i < numIslands; i++) {
+        double s = scales ? scales[i] : 1.0;
+        std::vector<Point> pts;
+        pts.reserve(offsets[i + 1] - offsets[i]);
+        for (int p = offsets[i]; p < offsets[i + 1]; p++) {
+            pts.push_back(Point{points[p * 2] * s, points[p * 2 + 1] * s});
+        }
+        Item& item = items[i];
+        item.hull = convexHull(std::move(pts));
+        item.angle = options.alignToBounds && item.hull.size() >= 3 ? minAreaAngle(item.hull) : 0;
+
+        double minX, minY, maxX, maxY;
+        rotatedBounds(item.hull, item.angle, minX, minY, maxX, maxY);
+        item.width = maxX - minX;
+        item.height = maxY - minY;
+        result.transforms[i].scale = s;
+
+        hullArea += polygonArea(item.hull);
+        totalArea += (item.width + options.spacing) * (item.height + options.spacing);
+        double need = options.allowRotation ? std::min(item.width, item.height) : item.width;
+        minStrip = std::max(minStrip, need);
+    }
+
+    double stripWidth = options.stripWidth > 0 ? options.stripWidth : std::sqrt(totalArea);
+    stripWidth = std::max(stripWidth, minStrip);
+
+    // 先放高的片段：skyline对高度递减的序列浪费最少
+    std::vector<int> order(numIslands);
+    std::iota(order.begin(), order.end(), 0);
+    auto longSide = [&](int i) {
+        const Item& it = items[i];
+        return options.allowRotation ? std::max(it.width, it.height) : it.height;
+    };
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        double la = longSide(a), lb = longSide(b);
+        if (la != lb) return la > lb;
+        return items[a].width * items[a].height > items[b].width * items[b].height;
+    });
+
+    Skyline skyline(stripWidth);
+    for (int i : order) {
+        const Item& item = items[i];
+
+        // 放入后顶部最低者优先，同高取最左；可旋转时两个方向都试
+        double bestTop = std::numeric_limits<double>::infinity();
+        double bestX = std::numeric_limits<double>::infinity();
+        size_t bestSegment = 0;
+        bool bestRotated = false;
+        double bestY = 0;
+        for (int rotated = 0; rotated < (options.allowRotation ? 2 : 1); rotated++) {
+            double w = rotated ? item.height : item.width;
+            double h = rotated ? item.width : item.height;
+            for (size_t k = 0; k < skyline.size(); k++) {
+                double y;
+                if (!skyline.fit(k, w, w + options.spacing, y)) continue;
+                double top = y + h;
+                double x = skyline.segmentX(k);
+                if (top < bestTop || (top == bestTop && x < bestX)) {
+                    bestTop = top;
+                    bestX = x;
+                    bestSegment = k;
+                    bestRotated = rotated;
+                    bestY = y;
+                }
+            }
+        }
+
+        double w = bestRotated ? item.height : item.width;
+        skyline.place(bestSegment, w + options.spacing, bestTop + options.spacing);
+
+        // 合成旋转后求包围盒最小角，平移到放置位置
+        IslandTransform& t = result.transforms[i];
+        t.rotation = item.angle + (bestRotated ? kHalfPi : 0);
+        double minX, minY, maxX, maxY;
+        rotatedBounds(item.hull, t.rotation, minX, minY, maxX, maxY);
+        t.tx = bestX - minX;
+        t.ty = bestY - minY;
+
+        result.width = std::max(result.width, bestX + w);
+        result.height = std::max(result.height, bestTop);
+    }
+
+    double used = result.width * result.height;
+    result.utilization = used > 0 ? hullArea / used : 0;
+    return result;
+}
+
+} // namespace bff
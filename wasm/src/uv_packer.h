@@ -0,0 +1,53 @@
+/**
+ * 多片段UV排料：把各片段放进定宽条带（布料幅宽），条带长度尽量短
+ * 片段按凸包的包围矩形参与排列，用skyline算法（放入后顶部最低者优先），可旋转90度；
+ * 结果为每个片段的变换 u' = R(rotation) * (scale * u) + t，不改动输入坐标
+ */
+
+#ifndef BFF_UV_PACKER_H
+#define BFF_UV_PACKER_H
+
+#include <cmath>
+#include <vector>
+
+namespace bff {
+
+struct PackOptions {
+    double stripWidth = 0;       // 条带宽度；<=0时按总面积取近似正方形的宽度，比最宽片段窄时放宽到该片段
+    double spacing = 0;          // 片段之间的最小间距
+    bool allowRotation = true;   // 允许旋转90度（布纹方向变为纬向）
+    bool alignToBounds = false;  // 先旋转到最小面积包围矩形（任意角度，会改变布纹方向）
+};
+
+// 先缩放，再绕原点旋转，再平移
+struct IslandTransform {
+    double scale = 1;
+    double rotation = 0;         // 弧度，逆时针
+    double tx = 0;
+    double ty = 0;
+
+    void apply(double u, double v, double& outU, double& outV) const {
+        double c = std::cos(rotation), s = std::sin(rotation);
+        outU = scale * (c * u - s * v) + tx;
+        outV = scale * (s * u + c * v) + ty;
+    }
+};
+
+struct PackResult {
+    std::vector<IslandTransform> transforms;   // 与输入片段一一对应
+    double width = 0;            // 实际占用宽度
+    double height = 0;           // 条带长度
+    double utilization = 0;      // 片段凸包面积之和 / (width * height)
+};
+
+/**
+ * @param points 各片段的UV点 [u0,v0, u1,v1, ...]，只用凸包，传边界点即可
+ * @param offsets 片段i的点为 points[2*offsets[i] .. 2*offsets[i+1])，大小numIslands+1
+ * @param scales 各片段的预缩放（例如恢复实际尺寸），可为nullptr
+ */
+PackResult packIslands(const double* points, const int* offsets, int numIslands,
+                       const double* scales, const PackOptions& options);
+
+} // namespace bff
+
+#endif // BFF_UV_PACKER_H